@@ -0,0 +1,616 @@
+#include "access_log.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include <openssl/err.h>
+#include "traffic_capture.h"
+
+#define ACCESS_LOG_MAX_PRODUCERS 64
+#define ACCESS_LOG_DEFAULT_RING 8192
+#define ACCESS_LOG_DEFAULT_FLUSH_MS 50
+#define ACCESS_LOG_BATCH_SIZE (256 * 1024)
+#define ACCESS_LOG_LINE_MAX 1024
+
+// capture 형식: 한 번 비울 때 모은 레코드를 시각 순으로 정렬하기 위한 항목
+typedef struct {
+    int64_t timestamp_us;
+    size_t order;               // 모은 순서 (같은 시각이면 이 순서를 지킨다)
+    const AccessLogRecord* record;
+} CaptureEntry;
+
+// 워커별 SPSC 링 (생산자: 워커, 소비자: writer 스레드)
+struct AccessLogProducer {
+    _Alignas(64) _Atomic size_t head;
+    size_t cached_tail;
+    uint64_t rng_state;         // 샘플링용 xorshift 상태 (워커 전용)
+    uint64_t sample_threshold;  // 난수가 이 값 이하이면 기록
+    _Atomic uint64_t dropped;
+    _Alignas(64) _Atomic size_t tail;
+    _Alignas(64) size_t mask;
+    AccessLogRecord* records;
+};
+
+struct AccessLog {
+    AccessLogConfig config;
+    uint64_t sample_threshold;
+    int fd;
+    int owns_fd;
+    size_t file_size;
+    char* batch;
+    size_t batch_len;
+    AccessLogProducer* producers[ACCESS_LOG_MAX_PRODUCERS];
+    _Atomic int producer_count;
+    pthread_mutex_t register_lock;
+    _Atomic int stop;
+    pthread_t thread;
+    time_t cached_second;
+    char cached_clf_time[40];
+    int64_t capture_last_us;    // capture 형식: 마지막으로 기록한 요청 시각 (간격 계산)
+    CaptureEntry* capture_order;    // capture 형식: 정렬용 작업 배열 (writer 스레드 전용)
+    size_t capture_order_cap;
+};
+
+static size_t round_up_pow2(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+void access_log_default_config(AccessLogConfig* config) {
+    memset(config, 0, sizeof(*config));
+    config->format = ACCESS_LOG_TLS;
+    config->sample_rate = 1.0;
+    config->max_bytes = 64 * 1024 * 1024;
+    config->max_files = 5;
+    config->ring_capacity = ACCESS_LOG_DEFAULT_RING;
+    config->flush_interval_ms = ACCESS_LOG_DEFAULT_FLUSH_MS;
+}
+
+// AccessLogFormat 순서대로 (파싱과 이름 출력이 같은 표를 쓴다)
+static const char* const FORMAT_NAMES[] = { "common", "tls", "json", "capture" };
+_Static_assert(sizeof(FORMAT_NAMES) / sizeof(FORMAT_NAMES[0]) == ACCESS_LOG_CAPTURE + 1,
+               "FORMAT_NAMES는 AccessLogFormat과 같은 순서, 같은 개수여야 합니다");
+
+int access_log_parse_format(const char* name, AccessLogFormat* format) {
+    for (size_t i = 0; i < sizeof(FORMAT_NAMES) / sizeof(FORMAT_NAMES[0]); i++) {
+        if (strcasecmp(name, FORMAT_NAMES[i]) == 0) {
+            *format = (AccessLogFormat)i;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+const char* access_log_format_name(AccessLogFormat format) {
+    if ((size_t)format >= sizeof(FORMAT_NAMES) / sizeof(FORMAT_NAMES[0])) {
+        return "unknown";
+    }
+    return FORMAT_NAMES[format];
+}
+
+static int64_t wall_clock_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// capture 형식은 빈 파일(새 파일, 회전 직후)에 파일 머리를 먼저 쓴다. stdout에는 쓰지 않는다.
+// 기존 캡처에 이어 쓰면 앞 실행과의 간격은 새 실행을 시작한 시점부터 센다.
+// 회전할 때는 간격 기준을 바꾸지 않는다 (이미 모은 레코드는 회전 시각보다 이르다)
+static void access_log_start_capture(AccessLog* log) {
+    if (log->config.format != ACCESS_LOG_CAPTURE) {
+        return;
+    }
+    int64_t now = wall_clock_us();
+    if (log->capture_last_us == 0) {
+        log->capture_last_us = now;
+    }
+    if (log->file_size == 0) {
+        unsigned char header[TRAFFIC_CAPTURE_HEADER_SIZE];
+        traffic_capture_header(header, now);
+        if (write(log->fd, header, sizeof(header)) == (ssize_t)sizeof(header)) {
+            log->file_size = sizeof(header);
+        }
+    }
+}
+
+static int access_log_open_file(AccessLog* log) {
+    log->fd = open(log->config.path, O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (log->fd < 0) {
+        perror("접근 로그 파일 열기 실패");
+        return -1;
+    }
+    log->owns_fd = 1;
+
+    struct stat st;
+    log->file_size = fstat(log->fd, &st) == 0 ? (size_t)st.st_size : 0;
+    access_log_start_capture(log);
+    return 0;
+}
+
+// path -> path.1 -> ... -> path.N 순서로 밀어내고 새 파일을 연다
+static void access_log_rotate(AccessLog* log) {
+    char from[1024];
+    char to[1024];
+
+    close(log->fd);
+    for (int i = log->config.max_files - 1; i >= 1; i--) {
+        snprintf(from, sizeof(from), "%s.%d", log->config.path, i);
+        snprintf(to, sizeof(to), "%s.%d", log->config.path, i + 1);
+        rename(from, to);
+    }
+    if (log->config.max_files > 0) {
+        snprintf(to, sizeof(to), "%s.1", log->config.path);
+        rename(log->config.path, to);
+    } else {
+        unlink(log->config.path);
+    }
+
+    if (access_log_open_file(log) != 0) {
+        log->fd = -1;
+    }
+}
+
+static void access_log_write_batch(AccessLog* log) {
+    if (log->batch_len == 0) {
+        return;
+    }
+    if (log->fd < 0) {
+        log->batch_len = 0;
+        return;
+    }
+
+    if (log->owns_fd && log->config.max_bytes > 0 &&
+        log->file_size > 0 && log->file_size + log->batch_len > log->config.max_bytes) {
+        access_log_rotate(log);
+        if (log->fd < 0) {
+            log->batch_len = 0;
+            return;
+        }
+    }
+
+    size_t offset = 0;
+    while (offset < log->batch_len) {
+        ssize_t n = write(log->fd, log->batch + offset, log->batch_len - offset);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        offset += (size_t)n;
+    }
+    log->file_size += offset;
+    log->batch_len = 0;
+}
+
+static void format_client_ip(const AccessLogRecord* record, char* out, size_t size) {
+    if (!inet_ntop(record->family, record->client_addr, out, (socklen_t)size)) {
+        snprintf(out, size, "-");
+    }
+}
+
+// CLF 시간 형식 ([19/Oct/2026:12:00:00 +0000]), 초 단위로 캐시
+static const char* clf_time(AccessLog* log, int64_t timestamp_us) {
+    time_t seconds = (time_t)(timestamp_us / 1000000);
+    if (seconds != log->cached_second) {
+        struct tm tm_utc;
+        gmtime_r(&seconds, &tm_utc);
+        strftime(log->cached_clf_time, sizeof(log->cached_clf_time), "%d/%b/%Y:%H:%M:%S +0000", &tm_utc);
+        log->cached_second = seconds;
+    }
+    return log->cached_clf_time;
+}
+
+// 경로의 따옴표/제어 문자를 로그 한 줄이 깨지지 않게 치환
+static void sanitize(const char* in, char* out, size_t size) {
+    size_t i = 0;
+    for (; in[i] && i + 1 < size; i++) {
+        unsigned char c = (unsigned char)in[i];
+        out[i] = (c < 0x20 || c == '"' || c == '\\' || c == 0x7f) ? '_' : (char)c;
+    }
+    out[i] = '\0';
+}
+
+static size_t format_record(AccessLog* log, const AccessLogRecord* record, char* line, size_t size) {
+    char ip[INET6_ADDRSTRLEN];
+    char path[sizeof(record->path)];
+    char method[sizeof(record->method)];
+    int n;
+
+    format_client_ip(record, ip, sizeof(ip));
+    sanitize(record->path[0] ? record->path : "-", path, sizeof(path));
+    sanitize(record->method[0] ? record->method : "-", method, sizeof(method));
+
+    switch (log->config.format) {
+        case ACCESS_LOG_COMMON:
+            n = snprintf(line, size, "%s - - [%s] \"%s %s HTTP/1.1\" %u %u\n",
+                         ip, clf_time(log, record->timestamp_us), method, path,
+                         record->status, record->bytes_out);
+            break;
+        case ACCESS_LOG_TLS: {
+            char error[128] = "-";
+            if (record->flags & ACCESS_LOG_FLAG_HANDSHAKE_FAILED) {
+                ERR_error_string_n(record->ssl_error, error, sizeof(error));
+            }
+            n = snprintf(line, size, "%s - - [%s] \"%s %s HTTP/1.1\" %u %u %s %s %s %.3f %.3f w%u %s\n",
+                         ip, clf_time(log, record->timestamp_us), method, path,
+                         record->status, record->bytes_out,
+                         record->tls_version ? record->tls_version : "-",
+                         record->cipher ? record->cipher : "-",
+                         (record->flags & ACCESS_LOG_FLAG_EARLY_DATA) ? "0rtt" :
+                         (record->flags & ACCESS_LOG_FLAG_RESUMED) ? "resumed" : "full",
+                         record->handshake_us / 1000.0, record->duration_us / 1000.0,
+                         record->worker, error);
+            break;
+        }
+        case ACCESS_LOG_JSON:
+        default:
+            n = snprintf(line, size,
+                         "{\"ts_us\":%lld,\"client\":\"%s\",\"port\":%u,\"method\":\"%s\",\"path\":\"%s\","
+                         "\"status\":%u,\"bytes_in\":%u,\"bytes_out\":%u,\"tls_version\":\"%s\",\"cipher\":\"%s\","
+                         "\"resumed\":%s,\"handshake_ms\":%.3f,\"duration_ms\":%.3f,\"worker\":%u,\"handshake_failed\":%s,\"early_data\":%s}\n",
+                         (long long)record->timestamp_us, ip, record->client_port, method, path,
+                         record->status, record->bytes_in, record->bytes_out,
+                         record->tls_version ? record->tls_version : "",
+                         record->cipher ? record->cipher : "",
+                         (record->flags & ACCESS_LOG_FLAG_RESUMED) ? "true" : "false",
+                         record->handshake_us / 1000.0, record->duration_us / 1000.0, record->worker,
+                         (record->flags & ACCESS_LOG_FLAG_HANDSHAKE_FAILED) ? "true" : "false",
+                         (record->flags & ACCESS_LOG_FLAG_EARLY_DATA) ? "true" : "false");
+            break;
+    }
+
+    if (n < 0) {
+        return 0;
+    }
+    return (size_t)n < size ? (size_t)n : size - 1;
+}
+
+// 재생용 바이너리 레코드. 한 번 비울 때 모은 레코드는 시각 순으로 오지만, 앞서 비울 때 이미 기록한 요청보다
+// 이른 요청(늦게 링에 들어온 요청)은 간격 0으로 둔다
+static size_t capture_record(AccessLog* log, const AccessLogRecord* record, unsigned char* out, size_t size) {
+    TrafficEvent event;
+    memset(&event, 0, sizeof(event));
+
+    if (record->timestamp_us > log->capture_last_us) {
+        int64_t gap = record->timestamp_us - log->capture_last_us;
+        event.gap_us = gap > (int64_t)UINT32_MAX ? UINT32_MAX : (uint32_t)gap;
+        log->capture_last_us = record->timestamp_us;
+    }
+    event.connection = record->connection;
+    event.bytes_in = record->bytes_in;
+    event.bytes_out = record->bytes_out;
+    event.duration_us = record->duration_us;
+    event.handshake_us = record->handshake_us;
+    event.status = record->status;
+    event.request_index = record->request_index;
+    event.method = (uint8_t)traffic_method_code(record->method);
+    event.flags = record->flags;
+    event.family = record->family;
+    event.path_len = (uint8_t)strnlen(record->path, sizeof(record->path));
+    event.path = record->path;
+    return traffic_capture_encode(&event, out, size);
+}
+
+// 구조화 결과 레코드로 변환해 ResultWriter에 전달
+static void emit_result(AccessLog* log, const AccessLogRecord* record) {
+    char ip[INET6_ADDRSTRLEN];
+    char error[128];
+    TestResult result;
+
+    format_client_ip(record, ip, sizeof(ip));
+    result_init(&result, log->config.server_name, "connection");
+    result.timestamp_us = record->timestamp_us;
+    result.target = record->path[0] ? record->path : NULL;
+    result.method = record->method[0] ? record->method : NULL;
+    result.host = ip;
+    result.port = record->client_port;
+    result.ip_version = record->family == AF_INET6 ? "IPv6" : "IPv4";
+    result.protocol = record->status ? "HTTP/1.1" : NULL;
+    result.tls_version = record->tls_version;
+    result.cipher = record->cipher;
+    result.socket_profile = log->config.socket_profile;
+    result.status = record->status;
+    result.bytes_in = record->bytes_in;
+    result.bytes_out = record->bytes_out;
+    result.tls_time = record->handshake_us / 1e6;
+    result.total_time = record->duration_us / 1e6;
+    result.success = !(record->flags & ACCESS_LOG_FLAG_HANDSHAKE_FAILED);
+    if (!result.success) {
+        ERR_error_string_n(record->ssl_error, error, sizeof(error));
+        result.error = error;
+    }
+    result_emit(log->config.results, &result);
+}
+
+// 레코드 하나를 배치(파일/stdout)와 구조화 결과로 내보낸다
+static void access_log_output(AccessLog* log, const AccessLogRecord* record) {
+    if (log->fd >= 0) {
+        if (log->batch_len + ACCESS_LOG_LINE_MAX > ACCESS_LOG_BATCH_SIZE) {
+            access_log_write_batch(log);
+        }
+        if (log->config.format == ACCESS_LOG_CAPTURE) {
+            log->batch_len += capture_record(log, record, (unsigned char*)log->batch + log->batch_len,
+                                             ACCESS_LOG_LINE_MAX);
+        } else {
+            log->batch_len += format_record(log, record, log->batch + log->batch_len, ACCESS_LOG_LINE_MAX);
+        }
+    }
+    if (log->config.results) {
+        emit_result(log, record);
+    }
+}
+
+static int compare_capture_entry(const void* a, const void* b) {
+    const CaptureEntry* x = (const CaptureEntry*)a;
+    const CaptureEntry* y = (const CaptureEntry*)b;
+    if (x->timestamp_us != y->timestamp_us) {
+        return x->timestamp_us < y->timestamp_us ? -1 : 1;
+    }
+    return x->order < y->order ? -1 : x->order > y->order;
+}
+
+// capture 형식: 모든 링에 쌓인 레코드를 시각 순으로 합쳐서 내보낸다.
+// 링을 하나씩 비우면 워커 사이의 실제 순서가 뭉개져 재생 간격이 캡처와 달라진다
+static size_t access_log_drain_capture(AccessLog* log) {
+    size_t tails[ACCESS_LOG_MAX_PRODUCERS];
+    size_t heads[ACCESS_LOG_MAX_PRODUCERS];
+    size_t pending = 0;
+    int count = atomic_load_explicit(&log->producer_count, memory_order_acquire);
+
+    for (int p = 0; p < count; p++) {
+        tails[p] = atomic_load_explicit(&log->producers[p]->tail, memory_order_relaxed);
+        heads[p] = atomic_load_explicit(&log->producers[p]->head, memory_order_acquire);
+        pending += heads[p] - tails[p];
+    }
+    if (pending == 0) {
+        return 0;
+    }
+
+    if (pending > log->capture_order_cap) {
+        CaptureEntry* order = (CaptureEntry*)realloc(log->capture_order, pending * sizeof(CaptureEntry));
+        if (order) {
+            log->capture_order = order;
+            log->capture_order_cap = pending;
+        }
+    }
+    // 작업 배열을 늘리지 못했으면 정렬 없이 링 순서대로 기록한다
+    int sorted = pending <= log->capture_order_cap;
+
+    size_t n = 0;
+    for (int p = 0; p < count; p++) {
+        AccessLogProducer* producer = log->producers[p];
+        for (size_t tail = tails[p]; tail != heads[p]; tail++) {
+            const AccessLogRecord* record = &producer->records[tail & producer->mask];
+            if (sorted) {
+                log->capture_order[n] = (CaptureEntry){ record->timestamp_us, n, record };
+                n++;
+            } else {
+                access_log_output(log, record);
+            }
+        }
+    }
+    if (sorted) {
+        qsort(log->capture_order, n, sizeof(CaptureEntry), compare_capture_entry);
+        for (size_t i = 0; i < n; i++) {
+            access_log_output(log, log->capture_order[i].record);
+        }
+    }
+
+    for (int p = 0; p < count; p++) {
+        atomic_store_explicit(&log->producers[p]->tail, heads[p], memory_order_release);
+    }
+    return pending;
+}
+
+static size_t access_log_drain(AccessLog* log) {
+    if (log->config.format == ACCESS_LOG_CAPTURE && log->fd >= 0) {
+        return access_log_drain_capture(log);
+    }
+
+    size_t drained = 0;
+    int count = atomic_load_explicit(&log->producer_count, memory_order_acquire);
+
+    for (int p = 0; p < count; p++) {
+        AccessLogProducer* producer = log->producers[p];
+        size_t tail = atomic_load_explicit(&producer->tail, memory_order_relaxed);
+        size_t head = atomic_load_explicit(&producer->head, memory_order_acquire);
+
+        while (tail != head) {
+            access_log_output(log, &producer->records[tail & producer->mask]);
+            tail++;
+            drained++;
+        }
+        atomic_store_explicit(&producer->tail, tail, memory_order_release);
+    }
+
+    return drained;
+}
+
+static void* access_log_main(void* arg) {
+    AccessLog* log = (AccessLog*)arg;
+    struct timespec idle = {
+        .tv_sec = log->config.flush_interval_ms / 1000,
+        .tv_nsec = (long)(log->config.flush_interval_ms % 1000) * 1000000L
+    };
+
+    for (;;) {
+        int stopping = atomic_load_explicit(&log->stop, memory_order_acquire);
+        size_t drained = access_log_drain(log);
+
+        // 한 번 모은 배치는 바로 내보낸다 (유휴 간격이 곧 최대 지연 시간)
+        access_log_write_batch(log);
+        if (drained > 0) {
+            result_writer_flush(log->config.results);
+        }
+
+        if (stopping) {
+            break;
+        }
+        if (drained == 0) {
+            nanosleep(&idle, NULL);
+        }
+    }
+
+    return NULL;
+}
+
+AccessLog* access_log_start(const AccessLogConfig* config) {
+    AccessLog* log = (AccessLog*)calloc(1, sizeof(AccessLog));
+    if (!log) {
+        return NULL;
+    }
+
+    log->config = *config;
+    log->fd = -1;
+    log->cached_second = -1;
+    if (log->config.ring_capacity < 2) {
+        log->config.ring_capacity = ACCESS_LOG_DEFAULT_RING;
+    }
+    log->config.ring_capacity = round_up_pow2(log->config.ring_capacity);
+    if (log->config.flush_interval_ms == 0) {
+        log->config.flush_interval_ms = ACCESS_LOG_DEFAULT_FLUSH_MS;
+    }
+    if (log->config.sample_rate <= 0.0) {
+        log->sample_threshold = 0;
+    } else if (log->config.sample_rate >= 1.0) {
+        log->sample_threshold = UINT64_MAX;
+    } else {
+        log->sample_threshold = (uint64_t)(log->config.sample_rate * 18446744073709551615.0);
+    }
+
+    log->batch = (char*)malloc(ACCESS_LOG_BATCH_SIZE);
+    if (!log->batch) {
+        free(log);
+        return NULL;
+    }
+    pthread_mutex_init(&log->register_lock, NULL);
+
+    if (log->config.path && strcmp(log->config.path, "-") == 0) {
+        log->fd = STDOUT_FILENO;
+    } else if (log->config.path && access_log_open_file(log) != 0) {
+        free(log->batch);
+        free(log);
+        return NULL;
+    }
+
+    if (pthread_create(&log->thread, NULL, access_log_main, log) != 0) {
+        if (log->owns_fd) {
+            close(log->fd);
+        }
+        free(log->batch);
+        free(log);
+        return NULL;
+    }
+
+    return log;
+}
+
+AccessLogProducer* access_log_producer(AccessLog* log) {
+    AccessLogProducer* producer = (AccessLogProducer*)aligned_alloc(64, sizeof(AccessLogProducer));
+    if (!producer) {
+        return NULL;
+    }
+    memset(producer, 0, sizeof(*producer));
+
+    producer->records = (AccessLogRecord*)calloc(log->config.ring_capacity, sizeof(AccessLogRecord));
+    if (!producer->records) {
+        free(producer);
+        return NULL;
+    }
+    producer->mask = log->config.ring_capacity - 1;
+
+    pthread_mutex_lock(&log->register_lock);
+    int index = atomic_load_explicit(&log->producer_count, memory_order_relaxed);
+    if (index >= ACCESS_LOG_MAX_PRODUCERS) {
+        pthread_mutex_unlock(&log->register_lock);
+        free(producer->records);
+        free(producer);
+        return NULL;
+    }
+    producer->rng_state = 0x9e3779b97f4a7c15ull * (uint64_t)(index + 1);
+    producer->sample_threshold = log->sample_threshold;
+    log->producers[index] = producer;
+    atomic_store_explicit(&log->producer_count, index + 1, memory_order_release);
+    pthread_mutex_unlock(&log->register_lock);
+
+    return producer;
+}
+
+int access_log_sampled(AccessLogProducer* producer) {
+    if (producer->sample_threshold == UINT64_MAX) {
+        return 1;
+    }
+
+    uint64_t x = producer->rng_state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    producer->rng_state = x;
+    return producer->sample_threshold != 0 && x <= producer->sample_threshold;
+}
+
+int access_log_submit(AccessLogProducer* producer, const AccessLogRecord* record) {
+    size_t head = atomic_load_explicit(&producer->head, memory_order_relaxed);
+    if (head - producer->cached_tail > producer->mask) {
+        producer->cached_tail = atomic_load_explicit(&producer->tail, memory_order_acquire);
+        if (head - producer->cached_tail > producer->mask) {
+            atomic_fetch_add_explicit(&producer->dropped, 1, memory_order_relaxed);
+            return -1;
+        }
+    }
+
+    producer->records[head & producer->mask] = *record;
+    atomic_store_explicit(&producer->head, head + 1, memory_order_release);
+    return 0;
+}
+
+uint64_t access_log_dropped(AccessLog* log) {
+    uint64_t dropped = 0;
+    int count = atomic_load_explicit(&log->producer_count, memory_order_acquire);
+    for (int p = 0; p < count; p++) {
+        dropped += atomic_load_explicit(&log->producers[p]->dropped, memory_order_relaxed);
+    }
+    return dropped;
+}
+
+void access_log_stop(AccessLog* log) {
+    if (!log) {
+        return;
+    }
+
+    atomic_store_explicit(&log->stop, 1, memory_order_release);
+    pthread_join(log->thread, NULL);
+
+    uint64_t dropped = access_log_dropped(log);
+    if (dropped > 0) {
+        fprintf(stderr, "접근 로그: 링 포화로 %llu개의 레코드가 버려졌습니다.\n", (unsigned long long)dropped);
+    }
+
+    if (log->owns_fd) {
+        close(log->fd);
+    }
+    int count = atomic_load_explicit(&log->producer_count, memory_order_acquire);
+    for (int p = 0; p < count; p++) {
+        free(log->producers[p]->records);
+        free(log->producers[p]);
+    }
+    pthread_mutex_destroy(&log->register_lock);
+    free(log->capture_order);
+    free(log->batch);
+    free(log);
+}
@@ -0,0 +1,88 @@
+#ifndef ACCESS_LOG_H
+#define ACCESS_LOG_H
+
+// TLS 서버 비동기 접근 로그
+// - 워커는 요청마다 고정 크기 레코드를 자기 전용 링에 복사만 한다 (링이 가득 차면 버림).
+// - 전용 writer 스레드가 링을 모아 포맷하고, 배치 단위로 write(2) 하며 크기 기준으로 파일을 회전한다.
+// - capture 형식은 텍스트 대신 재생용 바이너리 레코드(traffic_capture.h)를 같은 경로로 기록한다.
+
+#include <stddef.h>
+#include <stdint.h>
+#include "result_output.h"
+
+typedef enum {
+    ACCESS_LOG_COMMON = 0,  // NCSA Common Log Format
+    ACCESS_LOG_TLS,         // Common + TLS 버전, 암호화 스위트, 핸드셰이크/요청 시간
+    ACCESS_LOG_JSON,        // 한 줄에 JSON 객체 하나
+    ACCESS_LOG_CAPTURE      // 트래픽 캡처 바이너리 (tls_load_test --replay로 재생)
+} AccessLogFormat;
+
+#define ACCESS_LOG_FLAG_RESUMED          0x01
+#define ACCESS_LOG_FLAG_HANDSHAKE_FAILED 0x02
+#define ACCESS_LOG_FLAG_EARLY_DATA       0x04   // early data(0-RTT)로 받아 핸드셰이크 완료 전에 응답한 요청
+
+// 요청 한 건(또는 실패한 핸드셰이크 한 건)의 레코드 (문자열 포인터는 OpenSSL이 소유한 정적 문자열만 허용)
+typedef struct {
+    int64_t timestamp_us;       // 요청 수신 시각 (벽시계, 마이크로초. 핸드셰이크 실패는 수락 시각)
+    uint32_t handshake_us;      // 연결의 첫 요청에만 기록
+    uint32_t duration_us;       // 요청 수신부터 응답 전송까지 (핸드셰이크 실패는 수락부터 실패까지)
+    uint32_t bytes_in;
+    uint32_t bytes_out;
+    uint32_t ssl_error;         // 핸드셰이크 실패 시 ERR_get_error() 값
+    uint32_t connection;        // 워커 번호 << 24 | 워커 안의 연결 순번 (캡처 재생이 연결 경계를 재현)
+    uint16_t request_index;     // 연결 안에서 몇 번째 요청인지
+    uint16_t status;
+    uint16_t client_port;
+    uint8_t family;             // AF_INET / AF_INET6
+    uint8_t flags;
+    uint8_t worker;
+    uint8_t client_addr[16];
+    const char* tls_version;
+    const char* cipher;
+    char method[8];
+    char path[96];
+} AccessLogRecord;
+
+typedef struct {
+    const char* path;           // 로그 파일 경로 ("-"이면 stdout, NULL이면 파일 출력 없음)
+    AccessLogFormat format;
+    double sample_rate;         // 0.0 ~ 1.0 (1.0이면 모든 요청 기록)
+    size_t max_bytes;           // 이 크기를 넘으면 회전 (0이면 회전 안 함)
+    int max_files;              // 회전 시 보관할 이전 파일 수 (path.1 ~ path.N)
+    size_t ring_capacity;       // 워커별 링 크기 (레코드 개수)
+    unsigned flush_interval_ms;
+    const char* server_name;
+    const char* socket_profile; // 결과 레코드에 싣는 소켓 튜닝 프로파일 이름 (NULL 가능)
+    ResultWriter* results;      // 구조화 결과 출력도 writer 스레드에서 처리 (NULL 가능)
+} AccessLogConfig;
+
+typedef struct AccessLog AccessLog;
+typedef struct AccessLogProducer AccessLogProducer;
+
+void access_log_default_config(AccessLogConfig* config);
+
+// "common", "tls", "json", "capture" 파싱. 성공 시 0
+int access_log_parse_format(const char* name, AccessLogFormat* format);
+
+// 형식 이름 (access_log_parse_format의 역)
+const char* access_log_format_name(AccessLogFormat format);
+
+// writer 스레드 시작. 실패 시 NULL
+AccessLog* access_log_start(const AccessLogConfig* config);
+
+// 워커 전용 생산자 등록 (워커 시작 시 한 번)
+AccessLogProducer* access_log_producer(AccessLog* log);
+
+// 이번 요청을 기록할지 결정 (샘플링). 0이면 레코드를 만들 필요가 없다
+int access_log_sampled(AccessLogProducer* producer);
+
+// 레코드를 링에 복사한다 (블로킹 없음, 링이 가득 차면 버리고 -1)
+int access_log_submit(AccessLogProducer* producer, const AccessLogRecord* record);
+
+// 남은 레코드를 모두 기록하고 writer 스레드를 종료한다
+void access_log_stop(AccessLog* log);
+
+// 링 포화로 버려진 레코드 수
+uint64_t access_log_dropped(AccessLog* log);
+
+#endif
@@ -2,111 +2,101 @@
 #include <stdlib.h>
 #include <string.h>
 #include <curl/curl.h>
+#include "curl_result.h"
+#include "curl_callbacks.h"
+#include "curl_harness.h"
+#include "curl_altsvc.h"
+#include "curl_async.h"
 
-// libcurl 콜백 함수 - 응답 데이터를 받아서 저장
-size_t WriteCallback(void* contents, size_t size, size_t nmemb, char** userp) {
-    size_t realsize = size * nmemb;
-    char* ptr = (char*)realloc(*userp, realsize + 1);
-    
-    if (ptr == NULL) {
-        return 0;
-    }
-    
-    *userp = ptr;
-    memcpy(*userp + strlen(*userp), contents, realsize);
-    (*userp)[strlen(*userp) + realsize] = 0;
-    
-    return realsize;
-}
+// 구조화 결과 출력 (RESULT_FORMAT 환경 변수로 활성화)
+static ResultWriter* g_result_writer = NULL;
 
-// HTTP 요청을 보내는 함수
-int SendRequest(const char* url, const char* method, const char* data, const char* content_type) {
-    CURL* curl;
-    CURLcode res;
-    char* response = (char*)malloc(1);
-    response[0] = 0;
-    
-    // libcurl 초기화
-    curl = curl_easy_init();
-    
-    if (!curl) {
-        fprintf(stderr, "libcurl 초기화 실패!\n");
-        return 1;
-    }
-    
-    // 기본 옵션 설정
-    curl_easy_setopt(curl, CURLOPT_URL, url);
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-    curl_easy_setopt(curl, CURLOPT_USERAGENT, "libcurl-test/1.0");
-    
-    // HTTP 메서드 설정
-    if (strcmp(method, "POST") == 0) {
-        curl_easy_setopt(curl, CURLOPT_POST, 1L);
-        if (data) {
-            curl_easy_setopt(curl, CURLOPT_POSTFIELDS, data);
-        }
-    } else if (strcmp(method, "PUT") == 0) {
-        curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "PUT");
-        if (data) {
-            curl_easy_setopt(curl, CURLOPT_POSTFIELDS, data);
-        }
-    } else if (strcmp(method, "DELETE") == 0) {
-        curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "DELETE");
+// HTTP 요청을 보내는 함수 (co_await하면 보내고, 응답이 오면 이어서 진행)
+curl_async::Task<curl_async::Response> SendRequest(curl_async::Client& client, const char* url, const char* method,
+                                                   const char* data, const char* content_type) {
+    curl_async::RequestOptions options;
+    options.method = method;
+    options.label = method;
+    if (data) {
+        options.body = data;
     }
-    
-    // Content-Type 헤더 설정
     if (content_type) {
-        struct curl_slist* headers = NULL;
-        char content_type_header[256];
-        snprintf(content_type_header, sizeof(content_type_header), "Content-Type: %s", content_type);
-        headers = curl_slist_append(headers, content_type_header);
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+        options.content_type = content_type;
     }
     
-    // HTTP 요청 실행
-    res = curl_easy_perform(curl);
-    
-    if (res != CURLE_OK) {
-        fprintf(stderr, "curl_easy_perform() 실패: %s\n", curl_easy_strerror(res));
-    } else {
-        // HTTP 응답 코드 확인
-        long response_code;
-        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response_code);
-        
-        printf("=== %s %s ===\n", method, url);
-        printf("HTTP 응답 코드: %ld\n", response_code);
-        printf("응답 데이터:\n%s\n\n", response);
+    // 구조화 결과 출력 (easy 핸들을 정리하기 전에 불린다)
+    options.on_complete = [url, method](CURL* curl, const curl_async::Response& response) {
+        if (!result_writer_structured(g_result_writer)) {
+            return;
+        }
+        TestResult record;
+        result_init(&record, "advanced_curl_cpp", "request");
+        record.target = url;
+        record.method = method;
+        result_fill_from_curl(&record, curl);
+        record.success = response.ok();
+        if (!response.ok()) {
+            record.error = response.error();
+        }
+        result_emit(g_result_writer, &record);
+    };
+    return client.request(url, std::move(options));
+}
+
+// 응답 출력
+void PrintResponse(const curl_async::Response& response, const char* url, const char* method) {
+    if (!response.ok()) {
+        fprintf(stderr, "%s %s 실패: %s\n", method, url, response.error());
+        return;
     }
+    printf("=== %s %s ===\n", method, url);
+    printf("HTTP 응답 코드: %ld (%s)\n", response.status(), altsvc_choice_text(&response.altsvc()));
+    printf("응답 데이터:\n%.*s\n\n", (int)response.body().size(), response.body().data());
+}
+
+// 네 요청을 동시에 보내고 모두 끝나면 보낸 순서대로 출력 (jsonplaceholder는 실제로 바꾸지 않으므로 순서와 무관)
+curl_async::Task<void> RunRequests(curl_async::Client& client) {
+    const char* post_data = "{\"title\":\"libcurl C++ test\",\"body\":\"This is a test post from C++\",\"userId\":1}";
+    const char* put_data = "{\"id\":1,\"title\":\"Updated title from C++\",\"body\":\"Updated body from C++\",\"userId\":1}";
     
-    // 메모리 정리
-    free(response);
-    
-    // libcurl 정리
-    curl_easy_cleanup(curl);
+    auto [get, post, put, del] = co_await curl_async::when_all(
+        SendRequest(client, "https://jsonplaceholder.typicode.com/posts/1", "GET", NULL, NULL),
+        SendRequest(client, "https://jsonplaceholder.typicode.com/posts", "POST", post_data, "application/json"),
+        SendRequest(client, "https://jsonplaceholder.typicode.com/posts/1", "PUT", put_data, "application/json"),
+        SendRequest(client, "https://jsonplaceholder.typicode.com/posts/1", "DELETE", NULL, NULL));
     
-    return 0;
+    PrintResponse(get, "https://jsonplaceholder.typicode.com/posts/1", "GET");
+    PrintResponse(post, "https://jsonplaceholder.typicode.com/posts", "POST");
+    PrintResponse(put, "https://jsonplaceholder.typicode.com/posts/1", "PUT");
+    PrintResponse(del, "https://jsonplaceholder.typicode.com/posts/1", "DELETE");
 }
 
 int main() {
-    printf("libcurl 고급 C++ 테스트 시작\n");
-    printf("============================\n\n");
-    
-    // GET 요청 테스트
-    SendRequest("https://jsonplaceholder.typicode.com/posts/1", "GET", NULL, NULL);
+    // 구조화 결과 출력 초기화 (RESULT_FORMAT=jsonl|csv이면 사람용 출력은 stderr로 이동)
+    g_result_writer = result_writer_from_env();
     
-    // POST 요청 테스트
-    const char* post_data = "{\"title\":\"libcurl C++ test\",\"body\":\"This is a test post from C++\",\"userId\":1}";
-    SendRequest("https://jsonplaceholder.typicode.com/posts", "POST", post_data, "application/json");
+    printf("libcurl 고급 C++ 테스트 시작\n");
+    printf("============================\n");
+    if (harness_target()) {
+        printf("연결 대상: 로컬 하네스 (%s)\n", harness_target());
+    }
+    printf("\n");
     
-    // PUT 요청 테스트
-    const char* put_data = "{\"id\":1,\"title\":\"Updated title from C++\",\"body\":\"Updated body from C++\",\"userId\":1}";
-    SendRequest("https://jsonplaceholder.typicode.com/posts/1", "PUT", put_data, "application/json");
+    // libcurl 전역 초기화와 프로세스 간 Alt-Svc/HSTS 캐시 (CURL_CACHE_DIR, HTTP3_POLICY)
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+    altsvc_init("advanced_curl_cpp");
     
-    // DELETE 요청 테스트
-    SendRequest("https://jsonplaceholder.typicode.com/posts/1", "DELETE", NULL, NULL);
+    // 요청은 모두 이 스레드의 리액터 하나가 진행한다 (클라이언트가 사라지기 전에 연결 캐시를 닫는다)
+    {
+        curl_async::Client client(curl_async::ClientConfig{"libcurl-test/1.0", 0, 0});
+        client.run(RunRequests(client));
+    }
     
     printf("C++ 테스트 완료!\n");
     
+    result_writer_close(g_result_writer);
+    altsvc_cleanup();
+    curl_global_cleanup();
+    
     return 0;
 } 
\ No newline at end of file
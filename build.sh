@@ -50,6 +50,7 @@ show_help() {
     echo "  -a, --advanced 고급 테스트만 빌드"
     echo "  -i, --ipv6     IPv4/IPv6 테스트만 빌드"
     echo "  -t, --tls      TLS 테스트만 빌드"
+    echo "  -b, --bench    마이크로벤치마크만 빌드"
     echo "  -r, --run      빌드 후 실행"
     echo "  -d, --debug    디버그 모드로 빌드"
     echo ""
@@ -59,6 +60,7 @@ show_help() {
     echo "  $0 -a -r        # 고급 테스트 빌드 후 실행"
     echo "  $0 -i -r        # IPv4/IPv6 테스트 빌드 후 실행"
     echo "  $0 -t -r        # TLS 테스트 빌드 후 실행"
+    echo "  $0 -b -r        # 마이크로벤치마크 빌드 후 실행"
     echo "  $0 -c           # 정리만 수행"
 }
 
@@ -68,6 +70,7 @@ BUILD_SIMPLE=false
 BUILD_ADVANCED=false
 BUILD_IPV6=false
 BUILD_TLS=false
+BUILD_BENCH=false
 RUN_AFTER_BUILD=false
 DEBUG_MODE=false
 COMPILER="g++" # 기본값
@@ -99,6 +102,10 @@ while [[ $# -gt 0 ]]; do
             BUILD_TLS=true
             shift
             ;;
+        -b|--bench)
+            BUILD_BENCH=true
+            shift
+            ;;
         -r|--run)
             RUN_AFTER_BUILD=true
             shift
@@ -116,11 +123,12 @@ while [[ $# -gt 0 ]]; do
 done
 
 # 기본값 설정 (옵션이 없으면 모든 테스트 빌드)
-if [[ "$BUILD_SIMPLE" == false && "$BUILD_ADVANCED" == false && "$BUILD_IPV6" == false && "$BUILD_TLS" == false ]]; then
+if [[ "$BUILD_SIMPLE" == false && "$BUILD_ADVANCED" == false && "$BUILD_IPV6" == false && "$BUILD_TLS" == false && "$BUILD_BENCH" == false ]]; then
     BUILD_SIMPLE=true
     BUILD_ADVANCED=true
     BUILD_IPV6=true
     BUILD_TLS=true
+    BUILD_BENCH=true
 fi
 
 # 컴파일러 확인
@@ -145,13 +153,14 @@ fi
 # 정리 모드
 if [[ "$CLEAN" == true ]]; then
     print_info "이전 빌드 파일들을 정리합니다..."
-    rm -f curl_cpp_simple advanced_curl_cpp ipv4_ipv6_test tls_client_test tls_server_test
+    rm -f curl_cpp_simple advanced_curl_cpp ipv4_ipv6_test tls_client_test tls_server_test tls_load_test microbench local_harness impair_proxy
+    rm -f *.o
     print_success "정리 완료"
     exit 0
 fi
 
 # 컴파일 옵션 설정
-COMPILE_FLAGS="-std=c++17 -Wall -Wextra"
+COMPILE_FLAGS="-std=c++20 -Wall -Wextra"
 if [[ "$DEBUG_MODE" == true ]]; then
     COMPILE_FLAGS="$COMPILE_FLAGS -g -O0"
     print_info "디버그 모드로 빌드합니다..."
@@ -159,10 +168,118 @@ else
     COMPILE_FLAGS="$COMPILE_FLAGS -O2"
 fi
 
+# 공용 C 모듈 컴파일 플래그
+COMMON_C_FLAGS="-Wall -Wextra"
+if [[ "$DEBUG_MODE" == true ]]; then
+    COMMON_C_FLAGS="$COMMON_C_FLAGS -g -O0"
+else
+    COMMON_C_FLAGS="$COMMON_C_FLAGS -O2"
+fi
+
+# 함수: 공용 C 모듈을 오브젝트 파일로 빌드 (C++ 테스트에서도 링크할 수 있도록 gcc 사용)
+# 사용법: build_common_object <이름> [추가 플래그]
+build_common_object() {
+    local name=$1
+    local extra_flags=$2
+    if ! gcc $COMMON_C_FLAGS $extra_flags -c -o "$name.o" "$name.c"; then
+        print_error "공용 모듈 빌드 실패: $name.c"
+        exit 1
+    fi
+}
+
+# 함수: OpenSSL 경로 설정 (OPENSSL_FLAGS, 한 번만)
+setup_openssl_flags() {
+    if [[ -n "$OPENSSL_CHECKED" ]]; then
+        return
+    fi
+    OPENSSL_CHECKED=true
+    OPENSSL_PATH=$(brew --prefix openssl@3 2>/dev/null)
+    if [[ -z "$OPENSSL_PATH" ]]; then
+        OPENSSL_PATH="/usr/local/opt/openssl@3"
+    fi
+    
+    if [[ -d "$OPENSSL_PATH" ]]; then
+        print_info "OpenSSL 경로: $OPENSSL_PATH"
+        OPENSSL_FLAGS="-I$OPENSSL_PATH/include -L$OPENSSL_PATH/lib"
+    else
+        print_warning "OpenSSL 경로를 찾을 수 없습니다. 시스템 기본값을 사용합니다."
+        OPENSSL_FLAGS=""
+    fi
+}
+
+# 함수: 서버 공용 모듈 빌드 (SERVER_OBJECTS, 한 번만)
+# 메모리 BIO TLS 엔진, 연결 slab/버퍼 풀, 타이머 휠, 리스닝 소켓 인계, 수락 제어, OCSP 스테이플링, epoll/io_uring 이벤트 루프, 핸드셰이크 풀, 메트릭, 접근 로그, 소켓 튜닝 프로파일
+build_server_objects() {
+    if [[ -n "$SERVER_OBJECTS" ]]; then
+        return
+    fi
+    build_common_object tls_engine "$OPENSSL_FLAGS"
+    build_common_object memory_pool
+    build_common_object timer_wheel
+    build_common_object server_handoff
+    build_common_object server_admission
+    build_common_object server_ocsp "$OPENSSL_FLAGS"
+    build_common_object tls_server_core "$OPENSSL_FLAGS"
+    build_common_object server_uring "$OPENSSL_FLAGS"
+    build_common_object handshake_pool "$OPENSSL_FLAGS"
+    build_common_object server_metrics
+    build_common_object traffic_capture
+    build_common_object access_log "$OPENSSL_FLAGS"
+    build_common_object socket_tuning
+    SERVER_OBJECTS="tls_engine.o memory_pool.o timer_wheel.o server_handoff.o server_admission.o server_ocsp.o tls_server_core.o server_uring.o handshake_pool.o server_metrics.o access_log.o traffic_capture.o socket_tuning.o result_output.o"
+}
+
+# 트레이스 로깅 모듈 (curl 테스트, 마이크로벤치마크에서 사용)
+if [[ "$BUILD_SIMPLE" == true || "$BUILD_ADVANCED" == true || "$BUILD_IPV6" == true || "$BUILD_BENCH" == true ]]; then
+    build_common_object trace_log
+fi
+
+# curl 콜백/응답 데이터, 본문 해시 공용 모듈 (curl 테스트, 마이크로벤치마크에서 사용)
+if [[ "$BUILD_SIMPLE" == true || "$BUILD_ADVANCED" == true || "$BUILD_IPV6" == true || "$BUILD_BENCH" == true ]]; then
+    build_common_object content_hash
+    build_common_object curl_callbacks
+fi
+
+# 로컬 하네스 연결 모듈, Alt-Svc/HSTS 캐시 모듈, 하네스 서버, 장애 프록시 (curl 테스트를 공개 엔드포인트 대신 루프백에서 실행)
+if [[ "$BUILD_SIMPLE" == true || "$BUILD_ADVANCED" == true || "$BUILD_IPV6" == true ]]; then
+    build_common_object curl_harness
+    build_common_object curl_altsvc
+    setup_openssl_flags
+    if gcc $COMMON_C_FLAGS $OPENSSL_FLAGS -o local_harness local_harness.c -lssl -lcrypto -lpthread; then
+        print_success "로컬 하네스 빌드 완료: local_harness"
+    else
+        print_error "로컬 하네스 빌드 실패"
+        exit 1
+    fi
+    if gcc $COMMON_C_FLAGS -o impair_proxy impair_proxy.c; then
+        print_success "장애 프록시 빌드 완료: impair_proxy"
+    else
+        print_error "장애 프록시 빌드 실패"
+        exit 1
+    fi
+fi
+
+# 이중 스택 연속 모니터링 모듈 (ipv4_ipv6_test --monitor, 타이머 휠은 TLS 서버와 공유)
+if [[ "$BUILD_IPV6" == true ]]; then
+    build_common_object timer_wheel
+    build_common_object probe_monitor
+fi
+
+# 코루틴 비동기 HTTP 클라이언트 (advanced_curl_cpp, ipv4_ipv6_test, C++20이라 C++ 컴파일러로 빌드)
+if [[ "$BUILD_ADVANCED" == true || "$BUILD_IPV6" == true ]]; then
+    if ! $COMPILER $COMPILE_FLAGS -c -o curl_async.o curl_async.cpp; then
+        print_error "공용 모듈 빌드 실패: curl_async.cpp"
+        exit 1
+    fi
+fi
+
+# 구조화 결과 출력 모듈 (모든 테스트에서 사용)
+build_common_object result_output
+
 # 기본 테스트 빌드
 if [[ "$BUILD_SIMPLE" == true ]]; then
     print_info "기본 테스트를 빌드합니다..."
-    if $COMPILER $COMPILE_FLAGS -o curl_cpp_simple curl_cpp_simple.cpp -lcurl; then
+    if $COMPILER $COMPILE_FLAGS -o curl_cpp_simple curl_cpp_simple.cpp curl_callbacks.o content_hash.o curl_harness.o curl_altsvc.o trace_log.o result_output.o -lcurl -lpthread; then
         print_success "기본 테스트 빌드 완료: curl_cpp_simple"
         
         if [[ "$RUN_AFTER_BUILD" == true ]]; then
@@ -180,7 +297,7 @@ fi
 # 고급 테스트 빌드
 if [[ "$BUILD_ADVANCED" == true ]]; then
     print_info "고급 테스트를 빌드합니다..."
-    if $COMPILER $COMPILE_FLAGS -o advanced_curl_cpp advanced_curl_cpp.cpp -lcurl; then
+    if $COMPILER $COMPILE_FLAGS -o advanced_curl_cpp advanced_curl_cpp.cpp curl_async.o curl_callbacks.o content_hash.o curl_harness.o curl_altsvc.o trace_log.o result_output.o -lcurl -lpthread; then
         print_success "고급 테스트 빌드 완료: advanced_curl_cpp"
         
         if [[ "$RUN_AFTER_BUILD" == true ]]; then
@@ -198,7 +315,7 @@ fi
 # IPv4/IPv6 테스트 빌드
 if [[ "$BUILD_IPV6" == true ]]; then
     print_info "IPv4/IPv6 테스트를 빌드합니다..."
-    if $COMPILER $COMPILE_FLAGS -o ipv4_ipv6_test ipv4_ipv6_test.cpp -lcurl; then
+    if $COMPILER $COMPILE_FLAGS -o ipv4_ipv6_test ipv4_ipv6_test.cpp curl_async.o probe_monitor.o timer_wheel.o curl_callbacks.o content_hash.o curl_harness.o curl_altsvc.o trace_log.o result_output.o -lcurl -lpthread; then
         print_success "IPv4/IPv6 테스트 빌드 완료: ipv4_ipv6_test"
         
         if [[ "$RUN_AFTER_BUILD" == true ]]; then
@@ -218,18 +335,14 @@ if [[ "$BUILD_TLS" == true ]]; then
     print_info "TLS 테스트를 빌드합니다..."
     
     # OpenSSL 경로 설정
-    OPENSSL_PATH=$(brew --prefix openssl@3 2>/dev/null)
-    if [[ -z "$OPENSSL_PATH" ]]; then
-        OPENSSL_PATH="/usr/local/opt/openssl@3"
-    fi
+    setup_openssl_flags
     
-    if [[ -d "$OPENSSL_PATH" ]]; then
-        print_info "OpenSSL 경로: $OPENSSL_PATH"
-        OPENSSL_FLAGS="-I$OPENSSL_PATH/include -L$OPENSSL_PATH/lib"
-    else
-        print_warning "OpenSSL 경로를 찾을 수 없습니다. 시스템 기본값을 사용합니다."
-        OPENSSL_FLAGS=""
-    fi
+    # 클라이언트 모듈 (인증서 검증: 공유 신뢰 저장소, 검증 결과 캐시, OCSP 확인 / HTTP 응답 점진 파서)
+    build_common_object tls_trust "$OPENSSL_FLAGS"
+    build_common_object http_response
+
+    # 서버 공용 모듈 (소켓 튜닝 프로파일은 클라이언트와 부하 테스트도 링크)
+    build_server_objects
     
     # C 컴파일러 플래그 설정
     C_COMPILE_FLAGS="-Wall -Wextra"
@@ -240,7 +353,7 @@ if [[ "$BUILD_TLS" == true ]]; then
     fi
     
     # TLS 클라이언트 빌드
-    if gcc $C_COMPILE_FLAGS $OPENSSL_FLAGS -o tls_client_test tls_client_test.c -lssl -lcrypto; then
+    if gcc $C_COMPILE_FLAGS $OPENSSL_FLAGS -o tls_client_test tls_client_test.c tls_trust.o http_response.o socket_tuning.o result_output.o -lssl -lcrypto -lpthread; then
         print_success "TLS 클라이언트 빌드 완료: tls_client_test"
     else
         print_error "TLS 클라이언트 빌드 실패"
@@ -248,7 +361,7 @@ if [[ "$BUILD_TLS" == true ]]; then
     fi
     
     # TLS 서버 빌드 (메모리 기반 인증서)
-    if gcc $C_COMPILE_FLAGS $OPENSSL_FLAGS -o tls_server_test tls_server_test.c -lssl -lcrypto; then
+    if gcc $C_COMPILE_FLAGS $OPENSSL_FLAGS -o tls_server_test tls_server_test.c $SERVER_OBJECTS -lssl -lcrypto -lpthread; then
         print_success "TLS 서버 빌드 완료: tls_server_test"
     else
         print_error "TLS 서버 빌드 실패"
@@ -256,13 +369,21 @@ if [[ "$BUILD_TLS" == true ]]; then
     fi
     
     # TLS 서버 빌드 (파일 기반 인증서)
-    if gcc $C_COMPILE_FLAGS $OPENSSL_FLAGS -o tls_server_file_test tls_server_file_test.c -lssl -lcrypto; then
+    if gcc $C_COMPILE_FLAGS $OPENSSL_FLAGS -o tls_server_file_test tls_server_file_test.c $SERVER_OBJECTS -lssl -lcrypto -lpthread; then
         print_success "TLS 서버 (파일 기반) 빌드 완료: tls_server_file_test"
     else
         print_error "TLS 서버 (파일 기반) 빌드 실패"
         exit 1
     fi
     
+    # TLS 서버 부하 테스트 (백엔드별 처리량/요청당 시스템 콜, 캡처 재생)
+    if gcc $C_COMPILE_FLAGS $OPENSSL_FLAGS -o tls_load_test tls_load_test.c traffic_capture.o http_response.o socket_tuning.o -lssl -lcrypto -lpthread; then
+        print_success "TLS 부하 테스트 빌드 완료: tls_load_test"
+    else
+        print_error "TLS 부하 테스트 빌드 실패"
+        exit 1
+    fi
+    
     if [[ "$RUN_AFTER_BUILD" == true ]]; then
         print_info "TLS 테스트를 실행합니다..."
         echo "----------------------------------------"
@@ -275,6 +396,26 @@ if [[ "$BUILD_TLS" == true ]]; then
     fi
 fi
 
+# 마이크로벤치마크 빌드 (curl 콜백, 서버 응답 경로, TLS 레코드 경로)
+if [[ "$BUILD_BENCH" == true ]]; then
+    print_info "마이크로벤치마크를 빌드합니다..."
+    setup_openssl_flags
+    build_server_objects
+    if gcc $COMMON_C_FLAGS $OPENSSL_FLAGS -o microbench microbench.c curl_callbacks.o content_hash.o trace_log.o $SERVER_OBJECTS -lcurl -lssl -lcrypto -lpthread; then
+        print_success "마이크로벤치마크 빌드 완료: microbench"
+        
+        if [[ "$RUN_AFTER_BUILD" == true ]]; then
+            print_info "마이크로벤치마크를 실행합니다..."
+            echo "----------------------------------------"
+            ./microbench
+            echo "----------------------------------------"
+        fi
+    else
+        print_error "마이크로벤치마크 빌드 실패"
+        exit 1
+    fi
+fi
+
 print_success "빌드 완료!"
 echo ""
 print_info "사용 가능한 실행 파일:"
@@ -296,5 +437,17 @@ fi
 if [[ -f "tls_server_file_test" ]]; then
     echo "  ./tls_server_file_test - OpenSSL TLS 서버 (파일 기반) 테스트"
 fi
+if [[ -f "tls_load_test" ]]; then
+    echo "  ./tls_load_test      - TLS 서버 부하 테스트 (처리량/시스템 콜)"
+fi
+if [[ -f "microbench" ]]; then
+    echo "  ./microbench         - 요청 경로 핫 함수 마이크로벤치마크 (JSON 출력/비교)"
+fi
+if [[ -f "local_harness" ]]; then
+    echo "  ./local_harness      - 공개 엔드포인트를 흉내 내는 로컬 하네스 서버 (./harness_run.sh로 모든 도구 실행)"
+fi
+if [[ -f "impair_proxy" ]]; then
+    echo "  ./impair_proxy       - 지연/손실/대역폭을 넣는 결정적 TCP/UDP 장애 프록시"
+fi
 echo ""
 print_info "빌드 스크립트 사용법: ./build.sh --help" 
\ No newline at end of file
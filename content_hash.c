@@ -0,0 +1,349 @@
+#include "content_hash.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <pthread.h>
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
+#define CRC32C_POLY 0x82F63B78u     // Castagnoli (반사형)
+#define JSON_MAX_DEPTH 128
+
+typedef uint32_t (*Crc32cFunction)(uint32_t crc, const unsigned char* data, size_t len);
+
+static uint32_t g_table[8][256];
+static Crc32cFunction g_crc32c = NULL;
+static const char* g_impl = "table";
+static pthread_once_t g_once = PTHREAD_ONCE_INIT;
+
+static inline uint64_t load64(const unsigned char* p) {
+    uint64_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+// 8바이트씩 테이블 8개로 처리 (리틀 엔디언 기준, 빅 엔디언이면 바이트 단위로)
+static uint32_t crc32c_table(uint32_t crc, const unsigned char* p, size_t len) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    while (len >= 8) {
+        uint64_t word = load64(p) ^ crc;
+        crc = g_table[7][word & 0xff] ^ g_table[6][(word >> 8) & 0xff] ^ g_table[5][(word >> 16) & 0xff] ^
+              g_table[4][(word >> 24) & 0xff] ^ g_table[3][(word >> 32) & 0xff] ^
+              g_table[2][(word >> 40) & 0xff] ^ g_table[1][(word >> 48) & 0xff] ^ g_table[0][word >> 56];
+        p += 8;
+        len -= 8;
+    }
+#endif
+    while (len--) {
+        crc = g_table[0][(crc ^ *p++) & 0xff] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+#if defined(__x86_64__)
+// SSE4.2 crc32 명령 (8바이트당 명령 하나, 캐시에 있는 본문은 메모리 대역폭 수준)
+__attribute__((target("sse4.2")))
+static uint32_t crc32c_sse42(uint32_t crc, const unsigned char* p, size_t len) {
+    uint64_t value = crc;
+    while (len >= 8) {
+        value = _mm_crc32_u64(value, load64(p));
+        p += 8;
+        len -= 8;
+    }
+    crc = (uint32_t)value;
+    while (len--) {
+        crc = _mm_crc32_u8(crc, *p++);
+    }
+    return crc;
+}
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+static uint32_t crc32c_armv8(uint32_t crc, const unsigned char* p, size_t len) {
+    while (len >= 8) {
+        crc = __crc32cd(crc, load64(p));
+        p += 8;
+        len -= 8;
+    }
+    while (len--) {
+        crc = __crc32cb(crc, *p++);
+    }
+    return crc;
+}
+#endif
+
+static void select_impl(void) {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (CRC32C_POLY & (0u - (crc & 1)));
+        }
+        g_table[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; i++) {
+        for (int t = 1; t < 8; t++) {
+            g_table[t][i] = g_table[0][g_table[t - 1][i] & 0xff] ^ (g_table[t - 1][i] >> 8);
+        }
+    }
+
+    g_crc32c = crc32c_table;
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2")) {
+        g_crc32c = crc32c_sse42;
+        g_impl = "sse4.2";
+    }
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+    g_crc32c = crc32c_armv8;
+    g_impl = "armv8-crc";
+#endif
+}
+
+static inline uint32_t crc32c(uint32_t crc, const void* data, size_t len) {
+    pthread_once(&g_once, select_impl);
+    return g_crc32c(crc, (const unsigned char*)data, len);
+}
+
+void content_hash_init(ContentHash* hash) {
+    hash->crc = 0xFFFFFFFFu;
+    hash->length = 0;
+}
+
+void content_hash_update(ContentHash* hash, const void* data, size_t len) {
+    hash->crc = crc32c(hash->crc, data, len);
+    hash->length += len;
+}
+
+uint32_t content_hash_value(const ContentHash* hash) {
+    return ~hash->crc;
+}
+
+int content_hash_equal(const ContentHash* a, const ContentHash* b) {
+    return a->length == b->length && a->crc == b->crc;
+}
+
+void content_hash_format(const ContentHash* hash, char* buffer, size_t size) {
+    snprintf(buffer, size, "crc32c:%08x", content_hash_value(hash));
+}
+
+const char* content_hash_impl(void) {
+    pthread_once(&g_once, select_impl);
+    return g_impl;
+}
+
+// ---------------------------------------------------------------------------
+// 정규화 JSON 해시
+
+typedef struct {
+    const char* p;
+    const char* end;
+    const char* ignore;
+    int depth;
+} JsonCursor;
+
+// 64비트 섞기 (splitmix64 마무리 단계)
+static inline uint64_t mix64(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ull;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+// 값 종류마다 다른 태그로 섞어 "1"과 1, []와 {}가 같은 해시가 되지 않게 한다
+static uint64_t hash_token(const char* data, size_t len, uint64_t tag) {
+    uint32_t crc = ~crc32c(0xFFFFFFFFu, data, len);
+    return mix64(tag ^ ((uint64_t)crc << 32) ^ (uint64_t)len);
+}
+
+static void skip_space(JsonCursor* c) {
+    while (c->p < c->end && (*c->p == ' ' || *c->p == '\t' || *c->p == '\n' || *c->p == '\r')) {
+        c->p++;
+    }
+}
+
+// 따옴표 안의 원문 범위 (이스케이프는 풀지 않고 건너뛰기만 한다)
+static int parse_string(JsonCursor* c, const char** start, size_t* len) {
+    if (c->p >= c->end || *c->p != '"') {
+        return -1;
+    }
+    const char* begin = ++c->p;
+    while (c->p < c->end && *c->p != '"') {
+        if (*c->p == '\\') {
+            c->p++;
+        }
+        c->p++;
+    }
+    if (c->p >= c->end) {
+        return -1;
+    }
+    *start = begin;
+    *len = (size_t)(c->p - begin);
+    c->p++;
+    return 0;
+}
+
+static int ignored_key(const char* ignore, const char* key, size_t len) {
+    while (ignore && *ignore) {
+        while (*ignore == ',' || *ignore == ' ') {
+            ignore++;
+        }
+        size_t name_len = strcspn(ignore, ", ");
+        if (name_len == len && len > 0 && strncasecmp(ignore, key, len) == 0) {
+            return 1;
+        }
+        ignore += name_len;
+    }
+    return 0;
+}
+
+static int parse_value(JsonCursor* c, uint64_t* out);
+
+// 멤버 해시를 더해 순서와 무관하게 만든다
+static int parse_object(JsonCursor* c, uint64_t* out) {
+    uint64_t sum = 0, count = 0;
+    c->p++;
+    skip_space(c);
+    if (c->p < c->end && *c->p == '}') {
+        c->p++;
+        *out = mix64(0x6F626A0000000000ull);
+        return 0;
+    }
+    for (;;) {
+        const char* key;
+        size_t key_len;
+        uint64_t value;
+        skip_space(c);
+        if (parse_string(c, &key, &key_len) != 0) {
+            return -1;
+        }
+        skip_space(c);
+        if (c->p >= c->end || *c->p != ':') {
+            return -1;
+        }
+        c->p++;
+        if (parse_value(c, &value) != 0) {
+            return -1;
+        }
+        if (!ignored_key(c->ignore, key, key_len)) {
+            sum += mix64(hash_token(key, key_len, 0x6B6579ull) ^ (value * 0x9E3779B97F4A7C15ull));
+            count++;
+        }
+        skip_space(c);
+        if (c->p < c->end && *c->p == ',') {
+            c->p++;
+        } else if (c->p < c->end && *c->p == '}') {
+            c->p++;
+            break;
+        } else {
+            return -1;
+        }
+    }
+    *out = mix64(0x6F626A0000000000ull ^ sum ^ (count << 1));
+    return 0;
+}
+
+static int parse_array(JsonCursor* c, uint64_t* out) {
+    uint64_t hash = 0x6172720000000000ull;
+    c->p++;
+    skip_space(c);
+    if (c->p < c->end && *c->p == ']') {
+        c->p++;
+        *out = mix64(hash);
+        return 0;
+    }
+    for (;;) {
+        uint64_t value;
+        if (parse_value(c, &value) != 0) {
+            return -1;
+        }
+        hash = mix64(hash * 0x100000001B3ull ^ value);
+        skip_space(c);
+        if (c->p < c->end && *c->p == ',') {
+            c->p++;
+        } else if (c->p < c->end && *c->p == ']') {
+            c->p++;
+            break;
+        } else {
+            return -1;
+        }
+    }
+    *out = hash;
+    return 0;
+}
+
+static int parse_literal(JsonCursor* c, const char* word, uint64_t* out) {
+    size_t len = strlen(word);
+    if ((size_t)(c->end - c->p) < len || memcmp(c->p, word, len) != 0) {
+        return -1;
+    }
+    c->p += len;
+    *out = hash_token(word, len, 0x6C6974ull);
+    return 0;
+}
+
+static int parse_value(JsonCursor* c, uint64_t* out) {
+    skip_space(c);
+    if (c->p >= c->end) {
+        return -1;
+    }
+    if (c->depth >= JSON_MAX_DEPTH) {
+        return -1;
+    }
+
+    int result;
+    const char* start = c->p;
+    size_t len;
+    switch (*c->p) {
+        case '{':
+            c->depth++;
+            result = parse_object(c, out);
+            c->depth--;
+            return result;
+        case '[':
+            c->depth++;
+            result = parse_array(c, out);
+            c->depth--;
+            return result;
+        case '"':
+            if (parse_string(c, &start, &len) != 0) {
+                return -1;
+            }
+            *out = hash_token(start, len, 0x737472ull);
+            return 0;
+        case 't':
+            return parse_literal(c, "true", out);
+        case 'f':
+            return parse_literal(c, "false", out);
+        case 'n':
+            return parse_literal(c, "null", out);
+        default:
+            // 숫자는 원문 그대로 (1.0과 1은 다르게 본다)
+            while (c->p < c->end && strchr("+-.eE0123456789", *c->p) && *c->p) {
+                c->p++;
+            }
+            if (c->p == start) {
+                return -1;
+            }
+            *out = hash_token(start, (size_t)(c->p - start), 0x6E756Dull);
+            return 0;
+    }
+}
+
+int content_json_hash(const char* data, size_t len, const char* ignore, uint64_t* out) {
+    JsonCursor cursor = {data, data + len, ignore, 0};
+    uint64_t hash;
+
+    if (parse_value(&cursor, &hash) != 0) {
+        return -1;
+    }
+    skip_space(&cursor);
+    if (cursor.p != cursor.end) {
+        return -1;
+    }
+    *out = hash;
+    return 0;
+}
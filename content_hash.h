@@ -0,0 +1,48 @@
+#ifndef CONTENT_HASH_H
+#define CONTENT_HASH_H
+
+// 응답 본문 동일성 확인용 해시 (주소 계열, 프로토콜 사이의 본문 비교)
+// - CRC32C(Castagnoli)를 본문이 도착하는 대로 조각마다 누적한다. x86-64는 SSE4.2 crc32 명령,
+//   ARMv8은 CRC32 확장을 쓰고, 없으면 8바이트씩 처리하는 테이블로 계산한다 (첫 사용 때 한 번 고름).
+// - JSON 본문은 공백, 객체 멤버 순서, 무시할 키(요청마다 바뀌는 origin, 추적 ID 등)를 뺀
+//   정규화 해시로도 비교할 수 있다.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 누적 중인 본문 해시
+typedef struct {
+    uint32_t crc;               // 반전된 중간값 (content_hash_value로 최종값을 얻는다)
+    uint64_t length;            // 지금까지 받은 바이트 수
+} ContentHash;
+
+void content_hash_init(ContentHash* hash);
+
+// 조각 하나를 이어서 누적한다
+void content_hash_update(ContentHash* hash, const void* data, size_t len);
+
+// 지금까지 누적한 CRC32C
+uint32_t content_hash_value(const ContentHash* hash);
+
+// 길이와 CRC32C가 모두 같으면 1
+int content_hash_equal(const ContentHash* a, const ContentHash* b);
+
+// "crc32c:1a2b3c4d" 형식 (buffer는 16바이트 이상)
+void content_hash_format(const ContentHash* hash, char* buffer, size_t size);
+
+// 선택된 구현 ("sse4.2", "armv8-crc", "table")
+const char* content_hash_impl(void);
+
+// 정규화한 JSON 해시. 공백과 객체 멤버 순서는 무시하고, ignore(쉼표로 구분한 키 이름, 대소문자 무시,
+// 모든 깊이에 적용, NULL이면 없음)에 있는 키는 값과 함께 뺀다. JSON이 아니면 -1
+int content_json_hash(const char* data, size_t len, const char* ignore, uint64_t* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
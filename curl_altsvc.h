@@ -0,0 +1,64 @@
+#ifndef CURL_ALTSVC_H
+#define CURL_ALTSVC_H
+
+// 프로세스 간에 유지되는 Alt-Svc/HSTS 캐시와 HTTP/3 연결 정책 (curl 테스트 공용)
+// - 캐시 파일은 CURL_CACHE_DIR (기본값 $XDG_CACHE_HOME/network_test 또는 ~/.cache/network_test)에 두고
+//   모든 도구가 같이 쓴다. CURL_CACHE_DIR=off 이면 캐시와 정책을 모두 끈다.
+// - HSTS는 프로세스 안에서 공유 핸들로 나누고, Alt-Svc는 핸들을 정리할 때 파일에 저장되어 다음 핸들이 읽는다.
+// - HTTP3_POLICY=auto(기본값): 캐시에 h3 항목이 있으면 바로 HTTP/3, 없으면 QUIC과 TCP를 경합
+//   HTTP3_POLICY=h3: 항상 HTTP/3만, HTTP3_POLICY=tcp: HTTP/3를 쓰지 않고 Alt-Svc만 학습
+// - 출처별로 프로세스의 첫 요청을 캐시 디렉토리의 first_requests.tsv에 기록해
+//   첫 요청이 QUIC으로 나간 비율과 그로 줄어든 첫 바이트 시간을 보고한다.
+
+#include <stdio.h>
+#include <curl/curl.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    ALTSVC_POLICY_AUTO = 0,     // 알려진 h3 출처는 HTTP/3 직접, 나머지는 경합
+    ALTSVC_POLICY_H3,           // 항상 HTTP/3만
+    ALTSVC_POLICY_TCP           // TCP만 (Alt-Svc는 학습)
+} AltSvcPolicy;
+
+// 요청 하나에 대해 고른 연결 방식
+typedef struct {
+    char origin[280];           // "host:port"
+    int known_h3;               // 요청 전에 캐시에 유효한 h3 항목이 있었는지
+    int first;                  // 이 프로세스에서 이 출처로 보내는 첫 요청인지
+    int forced_h3;              // HTTP/3만 시도 (실패하면 경합으로 한 번 다시 보냄)
+    int fallback;               // HTTP/3 직접 연결이 실패해 경합으로 다시 보냈는지
+} AltSvcChoice;
+
+// curl_global_init 뒤에 한 번 호출 (tool은 기록에 남는 도구 이름). 캐시가 꺼져 있으면 -1
+int altsvc_init(const char* tool);
+
+// 공유 핸들 정리 (모든 easy 핸들을 정리한 뒤 호출)
+void altsvc_cleanup(void);
+
+// 캐시 파일과 연결 정책을 핸들에 적용한다 (CURLOPT_URL 설정 뒤, 캐시가 꺼져 있으면 아무것도 하지 않음)
+void altsvc_apply(CURL* curl, const char* url, AltSvcChoice* choice);
+
+// curl_easy_perform 대신 호출: 알려진 h3 출처로의 HTTP/3 직접 연결이 실패하면 경합으로 다시 보내고,
+// 출처의 첫 요청이면 결과를 기록한다
+CURLcode altsvc_perform(CURL* curl, AltSvcChoice* choice);
+
+// altsvc_perform을 멀티 핸들용으로 나눈 것 (curl_async)
+// 전송이 끝나면 altsvc_retry를 부르고, 1이면 핸들이 경합으로 바뀌었으니 한 번 더 보낸다.
+// 최종 결과가 나오면 altsvc_finish로 출처의 첫 요청 결과를 기록한다
+int altsvc_retry(CURL* curl, AltSvcChoice* choice, CURLcode res);
+void altsvc_finish(CURL* curl, const AltSvcChoice* choice, CURLcode res);
+
+// 고른 연결 방식 설명 ("Alt-Svc 캐시 적중: HTTP/3 직접 연결" 등)
+const char* altsvc_choice_text(const AltSvcChoice* choice);
+
+// 모든 도구의 첫 요청 기록 요약 (QUIC 비율, 캐시 적중 비율, 첫 바이트 시간 절약)
+void altsvc_print_summary(FILE* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,420 @@
+#include "curl_async.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
+#include "curl_harness.h"
+
+namespace curl_async {
+
+#define ASYNC_MAX_EVENTS 256    // epoll_wait 한 번에 받는 이벤트 수
+
+// 요청 하나의 상태 (Client::request 코루틴 프레임 안에 산다)
+struct Client::Transfer {
+    std::string url;
+    RequestOptions options;
+    CURL* curl = nullptr;
+    struct curl_slist* harness = nullptr;
+    struct curl_slist* headers = nullptr;
+    AltSvcChoice altsvc;
+    Response response;
+    std::coroutine_handle<> waiter;
+    char errbuf[CURL_ERROR_SIZE];
+};
+
+Response::Response(const char* label) : data_(initResponseData(label)) {
+}
+
+Response::Response(Response&& other) noexcept
+    : data_(other.data_), code_(other.code_), error_(std::move(other.error_)), altsvc_(other.altsvc_) {
+    other.data_ = initResponseData(NULL);
+}
+
+Response& Response::operator=(Response&& other) noexcept {
+    if (this != &other) {
+        cleanupResponseData(&data_);
+        data_ = other.data_;
+        code_ = other.code_;
+        error_ = std::move(other.error_);
+        altsvc_ = other.altsvc_;
+        other.data_ = initResponseData(NULL);
+    }
+    return *this;
+}
+
+Response::~Response() {
+    cleanupResponseData(&data_);
+}
+
+const char* Response::error() const {
+    if (code_ == CURLE_OK) {
+        return "";
+    }
+    return error_.empty() ? curl_easy_strerror(code_) : error_.c_str();
+}
+
+static const char* ip_resolve_name(long ip_resolve) {
+    switch (ip_resolve) {
+    case CURL_IPRESOLVE_V4:
+        return "IPv4";
+    case CURL_IPRESOLVE_V6:
+        return "IPv6";
+    default:
+        return "default";
+    }
+}
+
+Client::Client(ClientConfig config) : config_(std::move(config)) {
+    multi_ = curl_multi_init();
+    if (!multi_) {
+        fprintf(stderr, "curl 멀티 핸들 초기화 실패!\n");
+        return;
+    }
+    if (config_.max_connections > 0) {
+        curl_multi_setopt(multi_, CURLMOPT_MAX_TOTAL_CONNECTIONS, config_.max_connections);
+    }
+    if (config_.max_host_connections > 0) {
+        curl_multi_setopt(multi_, CURLMOPT_MAX_HOST_CONNECTIONS, config_.max_host_connections);
+    }
+#ifdef __linux__
+    // curl이 소켓마다 관심 이벤트를 알려 주면 epoll에 등록하고, 준비된 소켓만 curl에 넘긴다
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd_ < 0) {
+        perror("epoll_create1");
+        curl_multi_cleanup(multi_);
+        multi_ = nullptr;
+        return;
+    }
+    curl_multi_setopt(multi_, CURLMOPT_SOCKETFUNCTION, socket_callback);
+    curl_multi_setopt(multi_, CURLMOPT_SOCKETDATA, this);
+    curl_multi_setopt(multi_, CURLMOPT_TIMERFUNCTION, timer_callback);
+    curl_multi_setopt(multi_, CURLMOPT_TIMERDATA, this);
+#endif
+}
+
+Client::~Client() {
+    // run()이 끝난 뒤에는 남은 전송이 없다 (멀티 핸들 정리가 연결 캐시를 닫는다)
+    if (multi_) {
+        curl_multi_cleanup(multi_);
+    }
+    if (epoll_fd_ >= 0) {
+        close(epoll_fd_);
+    }
+}
+
+const char* Client::backend() {
+#ifdef __linux__
+    return "epoll";
+#else
+    return "curl_multi_poll";
+#endif
+}
+
+Task<Response> Client::request(std::string url, RequestOptions options) {
+    Transfer transfer;
+    transfer.url = std::move(url);
+    transfer.options = std::move(options);
+    if (transfer.options.label.empty()) {
+        transfer.options.label = ip_resolve_name(transfer.options.ip_resolve);
+    }
+    transfer.response = Response(transfer.options.label.c_str());
+    transfer.errbuf[0] = 0;
+
+    CURL* curl = curl_easy_init();
+    if (!curl || !multi_) {
+        if (curl) {
+            curl_easy_cleanup(curl);
+        }
+        transfer.response.code_ = CURLE_FAILED_INIT;
+        co_return std::move(transfer.response);
+    }
+    transfer.curl = curl;
+    const RequestOptions& opt = transfer.options;
+
+    curl_easy_setopt(curl, CURLOPT_URL, transfer.url.c_str());
+    curl_easy_setopt(curl, CURLOPT_PRIVATE, &transfer);
+    curl_easy_setopt(curl, CURLOPT_ERRORBUFFER, transfer.errbuf);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, HashingWriteCallback);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &transfer.response.data_);
+    curl_easy_setopt(curl, CURLOPT_USERAGENT, config_.user_agent.c_str());
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, opt.timeout_ms);
+    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT_MS, opt.connect_timeout_ms);
+    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(curl, CURLOPT_IPRESOLVE, opt.ip_resolve);
+    if (opt.fresh_connection) {
+        curl_easy_setopt(curl, CURLOPT_FRESH_CONNECT, 1L);
+        curl_easy_setopt(curl, CURLOPT_FORBID_REUSE, 1L);
+    }
+
+    // HTTP 메서드와 본문 (본문은 transfer 안에 있으므로 복사하지 않는다)
+    if (opt.method == "HEAD") {
+        curl_easy_setopt(curl, CURLOPT_NOBODY, 1L);
+    } else if (opt.method != "GET") {
+        curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, opt.method.c_str());
+    }
+    if (!opt.body.empty()) {
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, opt.body.c_str());
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, (long)opt.body.size());
+    }
+    if (!opt.content_type.empty()) {
+        std::string header = "Content-Type: " + opt.content_type;
+        transfer.headers = curl_slist_append(NULL, header.c_str());
+        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, transfer.headers);
+    }
+
+    // 다른 curl 도구와 같은 연결 대상과 Alt-Svc/HSTS 정책
+    transfer.harness = harness_apply(curl);
+    altsvc_apply(curl, transfer.url.c_str(), &transfer.altsvc);
+
+    if (opt.verbose) {
+        curl_easy_setopt(curl, CURLOPT_DEBUGFUNCTION, DebugCallback);
+        curl_easy_setopt(curl, CURLOPT_VERBOSE, 1L);
+    }
+
+    co_await TransferAwaiter{*this, transfer};
+    co_return std::move(transfer.response);
+}
+
+bool Client::TransferAwaiter::await_suspend(std::coroutine_handle<> waiter) {
+    transfer.waiter = waiter;
+    CURLMcode code = curl_multi_add_handle(client.multi_, transfer.curl);
+    if (code != CURLM_OK) {
+        transfer.response.error_ = curl_multi_strerror(code);
+        client.finish_transfer(transfer, CURLE_FAILED_INIT);
+        client.ready_.pop_back();
+        return false;
+    }
+    client.in_flight_++;
+    if (client.in_flight_ > client.peak_in_flight_) {
+        client.peak_in_flight_ = client.in_flight_;
+    }
+    return true;
+}
+
+// 전송이 끝났을 때: 응답을 채우고 핸들을 정리한 뒤 기다리던 코루틴을 깨울 목록에 넣는다
+void Client::finish_transfer(Transfer& transfer, CURLcode result) {
+    CURL* curl = transfer.curl;
+    ResponseData& data = transfer.response.data_;
+    transfer.response.code_ = result;
+    transfer.response.altsvc_ = transfer.altsvc;
+    if (result != CURLE_OK && transfer.response.error_.empty() && transfer.errbuf[0]) {
+        transfer.response.error_ = transfer.errbuf;
+    }
+
+    curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME, &data.total_time);
+    curl_easy_getinfo(curl, CURLINFO_CONNECT_TIME, &data.connect_time);
+    curl_easy_getinfo(curl, CURLINFO_APPCONNECT_TIME, &data.tls_time);
+    curl_easy_getinfo(curl, CURLINFO_STARTTRANSFER_TIME, &data.ttfb);
+    if (result == CURLE_OK) {
+        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &data.response_code);
+        char* resolved_ip = nullptr;
+        curl_easy_getinfo(curl, CURLINFO_PRIMARY_IP, &resolved_ip);
+        if (resolved_ip) {
+            data.resolved_ip = strdup_safe(resolved_ip);
+        }
+        data.success = 1;
+    }
+    altsvc_finish(curl, &transfer.altsvc, result);
+    if (transfer.options.on_complete) {
+        transfer.options.on_complete(curl, transfer.response);
+    }
+
+    curl_easy_cleanup(curl);
+    curl_slist_free_all(transfer.harness);
+    curl_slist_free_all(transfer.headers);
+    transfer.curl = nullptr;
+    transfer.harness = nullptr;
+    transfer.headers = nullptr;
+    completed_++;
+    ready_.push_back(transfer.waiter);
+}
+
+void Client::process_completions() {
+    int pending = 0;
+    CURLMsg* message;
+    while ((message = curl_multi_info_read(multi_, &pending)) != nullptr) {
+        if (message->msg != CURLMSG_DONE) {
+            continue;
+        }
+        CURL* curl = message->easy_handle;
+        CURLcode result = message->data.result;
+        Transfer* transfer = nullptr;
+        curl_easy_getinfo(curl, CURLINFO_PRIVATE, &transfer);
+        curl_multi_remove_handle(multi_, curl);
+
+        // 알려진 h3 출처로의 HTTP/3 직접 연결이 실패하면 경합으로 한 번 더 보낸다 (받다 만 본문은 버린다)
+        if (altsvc_retry(curl, &transfer->altsvc, result)) {
+            cleanupResponseData(&transfer->response.data_);
+            transfer->response.data_ = initResponseData(transfer->options.label.c_str());
+            transfer->errbuf[0] = 0;
+            if (curl_multi_add_handle(multi_, curl) == CURLM_OK) {
+                continue;
+            }
+        }
+        in_flight_--;
+        finish_transfer(*transfer, result);
+    }
+}
+
+void Client::wake_sleepers() {
+    Clock::time_point now = Clock::now();
+    while (!sleepers_.empty() && sleepers_.top().deadline <= now) {
+        ready_.push_back(sleepers_.top().waiter);
+        sleepers_.pop();
+    }
+}
+
+// 깨어난 코루틴이 새 요청을 넣을 수 있으므로 목록을 떼어 낸 뒤 재개한다
+void Client::resume_ready() {
+    while (!ready_.empty()) {
+        std::vector<std::coroutine_handle<>> batch;
+        batch.swap(ready_);
+        for (std::coroutine_handle<> waiter : batch) {
+            waiter.resume();
+        }
+    }
+}
+
+// 다음에 깨어나야 하는 시각까지 남은 밀리초 (curl 타이머와 sleep 중 가까운 쪽, 둘 다 없으면 -1)
+int Client::next_timeout_ms() const {
+    std::optional<Clock::time_point> deadline = curl_deadline_;
+    if (!sleepers_.empty() && (!deadline || sleepers_.top().deadline < *deadline)) {
+        deadline = sleepers_.top().deadline;
+    }
+    if (!deadline) {
+        return -1;
+    }
+    auto remaining = std::chrono::ceil<std::chrono::milliseconds>(*deadline - Clock::now()).count();
+    return remaining <= 0 ? 0 : remaining > 60000 ? 60000 : (int)remaining;
+}
+
+#ifdef __linux__
+
+int Client::socket_callback(CURL* easy, curl_socket_t socket, int what, void* userp, void* socketp) {
+    (void)easy;
+    Client* client = static_cast<Client*>(userp);
+    if (what == CURL_POLL_REMOVE) {
+        if (socketp) {
+            epoll_ctl(client->epoll_fd_, EPOLL_CTL_DEL, socket, NULL);
+            curl_multi_assign(client->multi_, socket, NULL);
+        }
+        return 0;
+    }
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    if (what & CURL_POLL_IN) {
+        event.events |= EPOLLIN;
+    }
+    if (what & CURL_POLL_OUT) {
+        event.events |= EPOLLOUT;
+    }
+    event.data.fd = socket;
+    // socketp는 이미 epoll에 등록한 소켓인지 표시로만 쓴다
+    if (epoll_ctl(client->epoll_fd_, socketp ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, socket, &event) != 0) {
+        perror("epoll_ctl");
+        return -1;
+    }
+    if (!socketp) {
+        curl_multi_assign(client->multi_, socket, client);
+    }
+    return 0;
+}
+
+int Client::timer_callback(CURLM* multi, long timeout_ms, void* userp) {
+    (void)multi;
+    Client* client = static_cast<Client*>(userp);
+    if (timeout_ms < 0) {
+        client->curl_deadline_.reset();
+    } else {
+        client->curl_deadline_ = Clock::now() + std::chrono::milliseconds(timeout_ms);
+    }
+    return 0;
+}
+
+bool Client::poll_once() {
+    int timeout = next_timeout_ms();
+    if (timeout < 0 && in_flight_ == 0) {
+        return false;
+    }
+
+    struct epoll_event events[ASYNC_MAX_EVENTS];
+    int count = epoll_wait(epoll_fd_, events, ASYNC_MAX_EVENTS, timeout);
+    if (count < 0 && errno != EINTR) {
+        perror("epoll_wait");
+        return false;
+    }
+    int running = 0;
+    for (int i = 0; i < count; i++) {
+        int mask = 0;
+        if (events[i].events & EPOLLIN) {
+            mask |= CURL_CSELECT_IN;
+        }
+        if (events[i].events & EPOLLOUT) {
+            mask |= CURL_CSELECT_OUT;
+        }
+        if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+            mask |= CURL_CSELECT_ERR;
+        }
+        curl_multi_socket_action(multi_, events[i].data.fd, mask, &running);
+    }
+    if (curl_deadline_ && *curl_deadline_ <= Clock::now()) {
+        curl_deadline_.reset();
+        curl_multi_socket_action(multi_, CURL_SOCKET_TIMEOUT, 0, &running);
+    }
+    process_completions();
+    wake_sleepers();
+    resume_ready();
+    return true;
+}
+
+#else
+
+int Client::socket_callback(CURL*, curl_socket_t, int, void*, void*) {
+    return 0;
+}
+
+int Client::timer_callback(CURLM*, long, void*) {
+    return 0;
+}
+
+// epoll이 없는 곳: curl이 소켓 목록을 직접 poll한다 (요청 수에 비례하지만 동작은 같다)
+bool Client::poll_once() {
+    int timeout = next_timeout_ms();
+    if (timeout < 0 && in_flight_ == 0) {
+        return false;
+    }
+    int running = 0;
+    curl_multi_perform(multi_, &running);
+    process_completions();
+    if (ready_.empty() && in_flight_ > 0) {
+        curl_multi_poll(multi_, NULL, 0, timeout < 0 ? 1000 : timeout, NULL);
+        curl_multi_perform(multi_, &running);
+        process_completions();
+    } else if (ready_.empty() && timeout > 0) {
+        usleep((useconds_t)timeout * 1000);
+    }
+    wake_sleepers();
+    resume_ready();
+    return true;
+}
+
+#endif
+
+void Client::drive_to_completion(detail::Driver driver) {
+    detail::Latch latch{1};
+    driver.start(&latch);
+    while (latch.remaining != 0) {
+        if (!poll_once()) {
+            // 기다릴 전송도 타이머도 없는데 끝나지 않았다 (리액터 밖의 무언가를 기다리는 코루틴)
+            fprintf(stderr, "curl_async: 진행할 작업이 없는데 코루틴이 끝나지 않았습니다\n");
+            break;
+        }
+    }
+}
+
+}  // namespace curl_async
@@ -0,0 +1,411 @@
+#ifndef CURL_ASYNC_H
+#define CURL_ASYNC_H
+
+// C++20 코루틴 비동기 HTTP 클라이언트 (curl 멀티 핸들 위의 단일 스레드 리액터)
+// - client.get(url)이 Task<Response>를 돌려주고, 코루틴 안에서 co_await하면 응답이 올 때까지 그 코루틴만 멈춘다.
+//   스레드는 client.run()을 부른 하나뿐이고, 요청마다 easy 핸들 하나와 코루틴 프레임 하나만 든다.
+// - 리눅스에서는 curl_multi_socket_action을 epoll로 구동하므로 동시에 수천 개를 보내도
+//   한 번 깨어날 때 준비된 소켓만 처리한다 (그 밖에서는 curl_multi_poll로 대신한다).
+// - when_all(a, b, c)는 여러 Task를 동시에 진행시키고 모두 끝나면 결과를 튜플(또는 vector)로 돌려준다.
+// - 요청은 다른 curl 도구와 같은 설정을 따른다: 본문은 받는 동안 CRC32C를 누적하고(HashingWriteCallback),
+//   HARNESS/HARNESS_CA, Alt-Svc/HSTS 캐시와 HTTP3_POLICY를 적용한다.
+//
+// 사용 예:
+//   curl_async::Client client;
+//   client.run([&]() -> curl_async::Task<void> {
+//       auto [v4, v6] = co_await curl_async::when_all(client.get(url, ipv4), client.get(url, ipv6));
+//   }());
+//
+// 예외는 쓰지 않는다. 요청 실패는 Response::code()로 돌려준다.
+
+#include <array>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <optional>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include <curl/curl.h>
+#include "curl_callbacks.h"
+#include "curl_altsvc.h"
+
+namespace curl_async {
+
+template <typename T>
+class Task;
+
+namespace detail {
+
+// Task가 끝나면 기다리던 코루틴으로 바로 넘어간다 (대칭 전환이라 완료가 이어져도 스택이 쌓이지 않는다)
+struct PromiseBase {
+    std::coroutine_handle<> continuation = std::noop_coroutine();
+
+    struct FinalAwaiter {
+        bool await_ready() const noexcept { return false; }
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+            return handle.promise().continuation;
+        }
+        void await_resume() const noexcept {}
+    };
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    FinalAwaiter final_suspend() const noexcept { return {}; }
+    void unhandled_exception() const noexcept { std::terminate(); }
+};
+
+template <typename T>
+struct Promise : PromiseBase {
+    std::optional<T> value;
+
+    Task<T> get_return_object() noexcept;
+    template <typename U>
+    void return_value(U&& result) {
+        value.emplace(std::forward<U>(result));
+    }
+};
+
+template <>
+struct Promise<void> : PromiseBase {
+    Task<void> get_return_object() noexcept;
+    void return_void() const noexcept {}
+};
+
+}  // namespace detail
+
+// 지연 시작 코루틴: co_await하거나 when_all/Client::run에 넘겨야 시작한다
+template <typename T = void>
+class [[nodiscard]] Task {
+public:
+    using promise_type = detail::Promise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    Task() = default;
+    explicit Task(Handle handle) : handle_(handle) {}
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle_) {
+                handle_.destroy();
+            }
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    ~Task() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    auto operator co_await() && noexcept {
+        struct Awaiter {
+            Handle handle;
+            bool await_ready() const noexcept { return !handle || handle.done(); }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> waiter) noexcept {
+                handle.promise().continuation = waiter;
+                return handle;
+            }
+            T await_resume() {
+                if constexpr (!std::is_void_v<T>) {
+                    return std::move(*handle.promise().value);
+                }
+            }
+        };
+        return Awaiter{handle_};
+    }
+
+private:
+    Handle handle_ = nullptr;
+};
+
+namespace detail {
+
+template <typename T>
+Task<T> Promise<T>::get_return_object() noexcept {
+    return Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+}
+
+inline Task<void> Promise<void>::get_return_object() noexcept {
+    return Task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+}
+
+// when_all의 완료 카운터. 시작하는 쪽이 1을 더 들고 있다가 마지막에 놓으므로
+// 모든 작업이 멈추지 않고 바로 끝나도 기다리는 코루틴이 시작 전에 깨어나지 않는다
+struct Latch {
+    std::size_t remaining;
+    std::coroutine_handle<> waiter = std::noop_coroutine();
+};
+
+// 작업 하나를 끝까지 돌리고 Latch를 내리는 코루틴 (결과는 slot에 둔다)
+class Driver {
+public:
+    struct promise_type {
+        Latch* latch = nullptr;
+
+        struct FinalAwaiter {
+            bool await_ready() const noexcept { return false; }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept {
+                Latch* latch = handle.promise().latch;
+                return --latch->remaining == 0 ? latch->waiter : std::noop_coroutine();
+            }
+            void await_resume() const noexcept {}
+        };
+
+        Driver get_return_object() noexcept {
+            return Driver(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        FinalAwaiter final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept { std::terminate(); }
+    };
+
+    explicit Driver(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+    Driver(Driver&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+    Driver(const Driver&) = delete;
+    Driver& operator=(const Driver&) = delete;
+    Driver& operator=(Driver&&) = delete;
+    ~Driver() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    void start(Latch* latch) {
+        handle_.promise().latch = latch;
+        handle_.resume();
+    }
+
+private:
+    std::coroutine_handle<promise_type> handle_;
+};
+
+template <typename T>
+Driver drive(Task<T> task, std::optional<T>& slot) {
+    slot.emplace(co_await std::move(task));
+}
+
+inline Driver drive(Task<void> task) {
+    co_await std::move(task);
+}
+
+// 드라이버를 모두 시작하고 마지막 하나가 끝날 때까지 기다린다
+template <typename Drivers>
+struct LatchAwaiter {
+    Latch& latch;
+    Drivers& drivers;
+
+    bool await_ready() const noexcept { return false; }
+    bool await_suspend(std::coroutine_handle<> waiter) {
+        latch.waiter = waiter;
+        for (auto& driver : drivers) {
+            driver.start(&latch);
+        }
+        return --latch.remaining != 0;
+    }
+    void await_resume() const noexcept {}
+};
+
+template <typename... T, std::size_t... I>
+std::array<Driver, sizeof...(T)> make_drivers(std::tuple<Task<T>...>& tasks, std::tuple<std::optional<T>...>& slots,
+                                              std::index_sequence<I...>) {
+    return {drive(std::move(std::get<I>(tasks)), std::get<I>(slots))...};
+}
+
+}  // namespace detail
+
+// 여러 Task를 동시에 진행하고 결과를 넘긴 순서대로 튜플로 돌려준다
+template <typename... T>
+Task<std::tuple<T...>> when_all(Task<T>... tasks) {
+    std::tuple<Task<T>...> pending(std::move(tasks)...);
+    std::tuple<std::optional<T>...> slots;
+    auto drivers = detail::make_drivers(pending, slots, std::index_sequence_for<T...>{});
+    detail::Latch latch{sizeof...(T) + 1};
+    co_await detail::LatchAwaiter<decltype(drivers)>{latch, drivers};
+    co_return std::apply([](auto&... slot) { return std::tuple<T...>(std::move(*slot)...); }, slots);
+}
+
+// 같은 종류의 Task 여러 개 (요청 수가 실행 중에 정해질 때)
+template <typename T>
+Task<std::vector<T>> when_all(std::vector<Task<T>> tasks) {
+    std::vector<std::optional<T>> slots(tasks.size());
+    std::vector<detail::Driver> drivers;
+    drivers.reserve(tasks.size());
+    for (std::size_t i = 0; i < tasks.size(); i++) {
+        drivers.push_back(detail::drive(std::move(tasks[i]), slots[i]));
+    }
+    detail::Latch latch{tasks.size() + 1};
+    co_await detail::LatchAwaiter<decltype(drivers)>{latch, drivers};
+    std::vector<T> results;
+    results.reserve(slots.size());
+    for (auto& slot : slots) {
+        results.push_back(std::move(*slot));
+    }
+    co_return results;
+}
+
+inline Task<void> when_all(std::vector<Task<void>> tasks) {
+    std::vector<detail::Driver> drivers;
+    drivers.reserve(tasks.size());
+    for (auto& task : tasks) {
+        drivers.push_back(detail::drive(std::move(task)));
+    }
+    detail::Latch latch{tasks.size() + 1};
+    co_await detail::LatchAwaiter<decltype(drivers)>{latch, drivers};
+}
+
+// 응답 하나. 본문과 시간, 해시는 다른 curl 도구와 같은 ResponseData에 담는다
+class Response {
+public:
+    explicit Response(const char* label = "");
+    Response(Response&& other) noexcept;
+    Response& operator=(Response&& other) noexcept;
+    Response(const Response&) = delete;
+    Response& operator=(const Response&) = delete;
+    ~Response();
+
+    bool ok() const { return code_ == CURLE_OK; }
+    CURLcode code() const { return code_; }
+    long status() const { return data_.response_code; }
+    std::string_view body() const { return std::string_view(data_.data ? data_.data : "", data_.length); }
+    const char* error() const;                      // 실패 이유 (성공이면 빈 문자열)
+    const AltSvcChoice& altsvc() const { return altsvc_; }  // 고른 연결 방식 (altsvc_choice_text로 설명)
+
+    const ResponseData& data() const { return data_; }
+    ResponseData& data() { return data_; }
+
+private:
+    friend class Client;
+
+    ResponseData data_;
+    CURLcode code_ = CURLE_OK;
+    std::string error_;
+    AltSvcChoice altsvc_ = {};
+};
+
+// 요청 하나의 설정
+struct RequestOptions {
+    std::string label;                      // ResponseData.ip_version에 들어가는 이름 (비우면 IP 버전 이름)
+    long ip_resolve = CURL_IPRESOLVE_WHATEVER;
+    std::string method = "GET";
+    std::string body;                       // 비어 있지 않으면 요청 본문
+    std::string content_type;
+    long timeout_ms = 30000;
+    long connect_timeout_ms = 10000;
+    bool fresh_connection = false;          // 멀티 핸들의 연결 캐시를 쓰지 않는다 (연결 시간을 요청마다 재려면)
+    bool verbose = false;                   // DebugCallback으로 trace_log에 기록
+    // 전송이 끝나고 easy 핸들을 정리하기 전에 불린다 (curl_easy_getinfo로 더 읽거나 결과 레코드를 낼 때)
+    std::function<void(CURL*, const Response&)> on_complete;
+};
+
+// 클라이언트 설정
+struct ClientConfig {
+    std::string user_agent = "curl-async/1.0";
+    long max_connections = 0;               // 동시에 여는 연결 수 상한 (0이면 제한 없음, 넘는 요청은 멀티 핸들 안에서 대기)
+    long max_host_connections = 0;          // 호스트별 연결 수 상한
+};
+
+// 리액터와 요청 API. 한 스레드에서만 쓴다
+class Client {
+public:
+    explicit Client(ClientConfig config = ClientConfig());
+    ~Client();
+    Client(const Client&) = delete;
+    Client& operator=(const Client&) = delete;
+
+    bool valid() const { return multi_ != nullptr; }
+
+    // 요청을 보내고 응답을 돌려주는 코루틴 (co_await하면 그때 보낸다)
+    Task<Response> request(std::string url, RequestOptions options = RequestOptions());
+    Task<Response> get(std::string url, RequestOptions options = RequestOptions()) {
+        options.method = "GET";
+        return request(std::move(url), std::move(options));
+    }
+
+    // 리액터를 멈추지 않고 기다린다 (다른 요청은 계속 진행)
+    auto sleep(std::chrono::milliseconds duration) {
+        struct Awaiter {
+            Client& client;
+            Clock::time_point deadline;
+            bool await_ready() const noexcept { return deadline <= Clock::now(); }
+            void await_suspend(std::coroutine_handle<> waiter) { client.sleepers_.push({deadline, client.sleeper_seq_++, waiter}); }
+            void await_resume() const noexcept {}
+        };
+        return Awaiter{*this, Clock::now() + duration};
+    }
+
+    // task를 시작하고 끝날 때까지 이벤트 루프를 돌린다
+    template <typename T>
+    T run(Task<T> task) {
+        std::optional<T> slot;
+        drive_to_completion(detail::drive(std::move(task), slot));
+        return std::move(*slot);
+    }
+    void run(Task<void> task) { drive_to_completion(detail::drive(std::move(task))); }
+
+    // 지금 진행 중인 요청 수, 지금까지 가장 많았던 수, 끝난 요청 수
+    std::size_t in_flight() const { return in_flight_; }
+    std::size_t peak_in_flight() const { return peak_in_flight_; }
+    std::uint64_t completed() const { return completed_; }
+
+    // 이벤트 대기 방식 이름 ("epoll" 또는 "curl_multi_poll")
+    static const char* backend();
+
+private:
+    using Clock = std::chrono::steady_clock;
+    struct Transfer;
+
+    struct Sleeper {
+        Clock::time_point deadline;
+        std::uint64_t seq;                  // 같은 시각이면 먼저 잠든 쪽부터
+        std::coroutine_handle<> waiter;
+        bool operator>(const Sleeper& other) const {
+            return deadline != other.deadline ? deadline > other.deadline : seq > other.seq;
+        }
+    };
+
+    // 전송을 멀티 핸들에 넣고 끝나면 깨운다
+    struct TransferAwaiter {
+        Client& client;
+        Transfer& transfer;
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> waiter);
+        void await_resume() const noexcept {}
+    };
+
+    void drive_to_completion(detail::Driver driver);
+    bool poll_once();                       // 한 번 기다려 처리한다. 기다릴 것이 없으면 false
+    int next_timeout_ms() const;
+    void process_completions();
+    void finish_transfer(Transfer& transfer, CURLcode result);
+    void wake_sleepers();
+    void resume_ready();
+
+    static int socket_callback(CURL* easy, curl_socket_t socket, int what, void* userp, void* socketp);
+    static int timer_callback(CURLM* multi, long timeout_ms, void* userp);
+
+    ClientConfig config_;
+    CURLM* multi_ = nullptr;
+    int epoll_fd_ = -1;
+    std::optional<Clock::time_point> curl_deadline_;   // curl이 요청한 다음 타임아웃 (epoll 방식)
+    std::priority_queue<Sleeper, std::vector<Sleeper>, std::greater<Sleeper>> sleepers_;
+    std::uint64_t sleeper_seq_ = 0;
+    std::vector<std::coroutine_handle<>> ready_;        // 이번 차례에 끝난 전송을 기다리던 코루틴
+    std::size_t in_flight_ = 0;
+    std::size_t peak_in_flight_ = 0;
+    std::uint64_t completed_ = 0;
+};
+
+}  // namespace curl_async
+
+#endif
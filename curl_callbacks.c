@@ -0,0 +1,100 @@
+#include "curl_callbacks.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include "trace_log.h"
+
+size_t WriteCallback(void* contents, size_t size, size_t nmemb, char** userp) {
+    size_t realsize = size * nmemb;
+    size_t length = strlen(*userp);
+    char* ptr = (char*)realloc(*userp, length + realsize + 1);
+
+    if (ptr == NULL) {
+        return 0;
+    }
+
+    *userp = ptr;
+    memcpy(*userp + length, contents, realsize);
+    (*userp)[length + realsize] = 0;
+
+    return realsize;
+}
+
+size_t HashingWriteCallback(void* contents, size_t size, size_t nmemb, ResponseData* response) {
+    size_t realsize = size * nmemb;
+
+    if (response->length + realsize + 1 > response->capacity) {
+        size_t capacity = response->capacity ? response->capacity : 4096;
+        while (capacity < response->length + realsize + 1) {
+            capacity *= 2;
+        }
+        char* ptr = (char*)realloc(response->data, capacity);
+        if (ptr == NULL) {
+            return 0;
+        }
+        response->data = ptr;
+        response->capacity = capacity;
+    }
+
+    memcpy(response->data + response->length, contents, realsize);
+    response->length += realsize;
+    response->data[response->length] = 0;
+    content_hash_update(&response->hash, contents, realsize);
+
+    return realsize;
+}
+
+int DebugCallback(CURL* handle, curl_infotype type, char* data, size_t size, void* userptr) {
+    (void)handle;
+    (void)userptr;
+
+    trace_event((TraceType)type, data, size);
+    return 0;
+}
+
+char* strdup_safe(const char* str) {
+    if (!str) return NULL;
+    size_t len = strlen(str);
+    char* new_str = (char*)malloc(len + 1);
+    if (new_str) {
+        memcpy(new_str, str, len + 1);
+    }
+    return new_str;
+}
+
+ResponseData initResponseData(const char* ip_version) {
+    ResponseData result;
+    result.data = (char*)malloc(1);
+    if (result.data) {
+        result.data[0] = 0;
+    }
+    result.response_code = 0;
+    result.total_time = 0.0;
+    result.connect_time = 0.0;
+    result.tls_time = 0.0;
+    result.ttfb = 0.0;
+    result.ip_version = strdup_safe(ip_version);
+    result.resolved_ip = NULL;
+    result.success = 0;
+    result.length = 0;
+    result.capacity = result.data ? 1 : 0;
+    content_hash_init(&result.hash);
+    return result;
+}
+
+void cleanupResponseData(ResponseData* data) {
+    if (data) {
+        if (data->data) {
+            free(data->data);
+            data->data = NULL;
+        }
+        if (data->ip_version) {
+            free(data->ip_version);
+            data->ip_version = NULL;
+        }
+        if (data->resolved_ip) {
+            free(data->resolved_ip);
+            data->resolved_ip = NULL;
+        }
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef CURL_CALLBACKS_H
+#define CURL_CALLBACKS_H
+
+// libcurl 테스트 공용 콜백과 응답 데이터 (curl_cpp_simple, advanced_curl_cpp, ipv4_ipv6_test, microbench)
+// - 요청마다 여러 번 불리는 경로라서 microbench가 같은 함수를 직접 측정한다.
+
+#include <stddef.h>
+#include <curl/curl.h>
+#include "content_hash.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 응답 데이터 구조체
+typedef struct {
+    char* data;
+    long response_code;
+    double total_time;
+    double connect_time;    // 단계별 누적 시간 (초): TCP 연결, TLS 완료, 첫 바이트
+    double tls_time;
+    double ttfb;
+    char* ip_version;
+    char* resolved_ip;
+    int success;
+    size_t length;          // data에 받은 바이트 수 (HashingWriteCallback이 채움)
+    size_t capacity;
+    ContentHash hash;       // 본문이 도착하는 대로 누적한 CRC32C
+} ResponseData;
+
+// libcurl 콜백 함수 - 응답 데이터를 받아서 저장 (*userp는 NUL로 끝나는 힙 문자열, 뒤에 이어 붙인다)
+size_t WriteCallback(void* contents, size_t size, size_t nmemb, char** userp);
+
+// 본문을 ResponseData에 이어 붙이면서 조각마다 해시를 누적한다
+// (버퍼를 두 배씩 늘리고 길이를 따로 들고 있어 조각마다 strlen을 부르지 않는다)
+size_t HashingWriteCallback(void* contents, size_t size, size_t nmemb, ResponseData* response);
+
+// libcurl 디버그 콜백 함수
+// 출력은 trace_log의 백그라운드 writer가 담당하고, 여기서는 스레드별 링에 기록만 한다
+int DebugCallback(CURL* handle, curl_infotype type, char* data, size_t size, void* userptr);
+
+// 문자열 복사 함수 (NULL이면 NULL)
+char* strdup_safe(const char* str);
+
+// ResponseData 초기화/정리 함수
+ResponseData initResponseData(const char* ip_version);
+void cleanupResponseData(ResponseData* data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
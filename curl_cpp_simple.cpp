@@ -2,84 +2,47 @@
 #include <stdlib.h>
 #include <string.h>
 #include <curl/curl.h>
+#include "trace_log.h"
+#include "curl_result.h"
+#include "curl_callbacks.h"
+#include "curl_harness.h"
+#include "curl_altsvc.h"
 
-// libcurl 콜백 함수 - 응답 데이터를 받아서 저장
-size_t WriteCallback(void* contents, size_t size, size_t nmemb, char** userp) {
-    size_t realsize = size * nmemb;
-    char* ptr = (char*)realloc(*userp, realsize + 1);
-    
-    if (ptr == NULL) {
-        return 0;
-    }
-    
-    *userp = ptr;
-    memcpy(*userp + strlen(*userp), contents, realsize);
-    (*userp)[strlen(*userp) + realsize] = 0;
-    
-    return realsize;
-}
-
-// libcurl 디버그 콜백 함수
-int DebugCallback(CURL* handle, curl_infotype type, char* data, size_t size, void* userptr) {
-    const char* type_str = "";
-    
-    switch (type) {
-        case CURLINFO_TEXT:
-            type_str = "TEXT";
-            break;
-        case CURLINFO_HEADER_IN:
-            type_str = "HEADER_IN";
-            break;
-        case CURLINFO_HEADER_OUT:
-            type_str = "HEADER_OUT";
-            break;
-        case CURLINFO_DATA_IN:
-            type_str = "DATA_IN";
-            break;
-        case CURLINFO_DATA_OUT:
-            type_str = "DATA_OUT";
-            break;
-        case CURLINFO_SSL_DATA_IN:
-            type_str = "SSL_DATA_IN";
-            break;
-        case CURLINFO_SSL_DATA_OUT:
-            type_str = "SSL_DATA_OUT";
-            break;
-        default:
-            type_str = "UNKNOWN";
-            break;
-    }
+int main() {
+    // 구조화 결과 출력 초기화 (RESULT_FORMAT=jsonl|csv이면 사람용 출력은 stderr로 이동)
+    ResultWriter* results = result_writer_from_env();
     
-    // 데이터를 문자열로 변환 (null 종료)
-    char* str_data = (char*)malloc(size + 1);
-    memcpy(str_data, data, size);
-    str_data[size] = '\0';
+    printf("=== libcurl 디버그 테스트 시작 ===\n\n");
     
-    // 개행 문자 제거
-    if (str_data[size-1] == '\n') {
-        str_data[size-1] = '\0';
+    // 디버그 트레이스 초기화 (TRACE_TYPES, TRACE_MAX_PAYLOAD 환경 변수로 조정 가능)
+    TraceConfig trace_config;
+    trace_default_config(&trace_config);
+    if (trace_init(&trace_config) != 0) {
+        fprintf(stderr, "트레이스 초기화 실패!\n");
+        result_writer_close(results);
+        return 1;
     }
     
-    printf("[DEBUG][%s] %s\n", type_str, str_data);
-    
-    free(str_data);
-    return 0;
-}
-
-int main() {
-    printf("=== libcurl 디버그 테스트 시작 ===\n\n");
-    
     // libcurl 초기화
     CURL* curl = curl_easy_init();
     
     if (!curl) {
         fprintf(stderr, "libcurl 초기화 실패!\n");
+        trace_shutdown();
+        result_writer_close(results);
         return 1;
     }
     
+    // 프로세스 간 Alt-Svc/HSTS 캐시 (CURL_CACHE_DIR, HTTP3_POLICY)
+    altsvc_init("curl_cpp_simple");
+    
     // 테스트할 URL (예: JSONPlaceholder API)
     const char* url = "https://jsonplaceholder.typicode.com/posts/1";
-    printf("요청 URL: %s\n\n", url);
+    printf("요청 URL: %s\n", url);
+    if (harness_target()) {
+        printf("연결 대상: 로컬 하네스 (%s)\n", harness_target());
+    }
+    printf("\n");
     
     // 응답 데이터를 저장할 문자열
     char* response = (char*)malloc(1);
@@ -100,13 +63,22 @@ int main() {
     curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 10L);
     curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
     
+    // HARNESS가 있으면 로컬 하네스로 연결 (URL은 그대로)
+    struct curl_slist* harness = harness_apply(curl);
+    
+    // 캐시에 h3 항목이 있으면 HTTP/3 직접, 없으면 경합
+    AltSvcChoice altsvc;
+    altsvc_apply(curl, url, &altsvc);
+    
     printf("=== libcurl 디버그 로그 시작 ===\n");
     printf("(아래에 libcurl의 상세한 디버그 정보가 출력됩니다)\n");
     printf("=====================================\n\n");
     
     // HTTP 요청 실행
-    CURLcode res = curl_easy_perform(curl);
+    CURLcode res = altsvc_perform(curl, &altsvc);
     
+    // 링에 남은 디버그 레코드를 모두 출력한 뒤 결과를 출력
+    trace_flush();
     printf("\n=== libcurl 디버그 로그 종료 ===\n\n");
     
     if (res != CURLE_OK) {
@@ -118,15 +90,36 @@ int main() {
         
         printf("=== 최종 결과 ===\n");
         printf("HTTP 응답 코드: %ld\n", response_code);
+        printf("연결 정책: %s\n", altsvc_choice_text(&altsvc));
         printf("응답 데이터:\n%s\n", response);
         printf("================\n");
     }
     
+    // 구조화 결과 출력
+    if (result_writer_structured(results)) {
+        TestResult record;
+        result_init(&record, "curl_cpp_simple", "request");
+        record.target = url;
+        record.method = "GET";
+        result_fill_from_curl(&record, curl);
+        record.success = res == CURLE_OK;
+        if (res != CURLE_OK) {
+            record.error = curl_easy_strerror(res);
+        }
+        result_emit(results, &record);
+    }
+    result_writer_close(results);
+    
     // 메모리 정리
     free(response);
     
     // libcurl 정리
     curl_easy_cleanup(curl);
+    curl_slist_free_all(harness);
+    altsvc_cleanup();
+    
+    // 트레이스 정리
+    trace_shutdown();
     
     return 0;
 } 
\ No newline at end of file
@@ -0,0 +1,29 @@
+#include "curl_harness.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+const char* harness_target(void) {
+    const char* target = getenv("HARNESS");
+    return target && target[0] ? target : NULL;
+}
+
+struct curl_slist* harness_apply(CURL* curl) {
+    const char* target = harness_target();
+    if (!target) {
+        return NULL;
+    }
+
+    // 호스트와 포트를 비워 두면 모든 연결에 적용된다 ("::host:port")
+    char entry[512];
+    snprintf(entry, sizeof(entry), "::%s", target);
+    struct curl_slist* connect_to = curl_slist_append(NULL, entry);
+    curl_easy_setopt(curl, CURLOPT_CONNECT_TO, connect_to);
+
+    const char* ca = getenv("HARNESS_CA");
+    if (ca && ca[0]) {
+        curl_easy_setopt(curl, CURLOPT_CAINFO, ca);
+        curl_easy_setopt(curl, CURLOPT_CAPATH, NULL);
+    }
+    return connect_to;
+}
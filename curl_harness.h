@@ -0,0 +1,27 @@
+#ifndef CURL_HARNESS_H
+#define CURL_HARNESS_H
+
+// curl 요청을 로컬 하네스(local_harness)로 돌리기
+// - HARNESS=host:port 이면 모든 요청의 연결 대상을 그 주소로 바꾼다 (CURLOPT_CONNECT_TO)
+//   URL, Host 헤더, SNI, 인증서 검증 호스트는 그대로라서 하네스가 원래 호스트의 라우트로 응답한다.
+//   host가 localhost이면 CURLOPT_IPRESOLVE에 따라 127.0.0.1 또는 ::1로 연결한다.
+// - HARNESS_CA=파일 이면 그 인증서만 신뢰한다 (하네스가 시작할 때 쓴 자체 서명 인증서)
+
+#include <curl/curl.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 하네스 주소 (HARNESS가 없거나 비어 있으면 NULL)
+const char* harness_target(void);
+
+// 핸들에 하네스 설정을 적용한다 (HARNESS가 없으면 아무것도 하지 않고 NULL)
+// 반환한 목록은 curl_easy_cleanup 뒤에 curl_slist_free_all로 해제한다
+struct curl_slist* harness_apply(CURL* curl);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -2,15 +2,40 @@
 #include <stdlib.h>
 #include <string.h>
 #include <curl/curl.h>
+#include "trace_log.h"
+#include "curl_result.h"
+#include "curl_harness.h"
+#include "curl_altsvc.h"
 
-// 디버그 콜백 함수 (SSL, ALPN, protocol 관련 로그만 출력)
+// 길이가 주어진 (null 종료되지 않은) 버퍼에서 키워드 검색
+static int contains_keyword(const char *data, size_t size, const char *keyword) {
+    size_t keyword_len = strlen(keyword);
+    if (keyword_len == 0 || keyword_len > size) {
+        return 0;
+    }
+    for (size_t i = 0; i + keyword_len <= size; i++) {
+        if (data[i] == keyword[0] && memcmp(data + i, keyword, keyword_len) == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// 디버그 콜백 함수 (SSL, ALPN, protocol 관련 로그만 기록)
+// curl이 넘겨주는 data는 null 종료가 보장되지 않으므로 size 범위 안에서만 검색한다
 int debug_callback(CURL *handle, curl_infotype type, char *data, size_t size, void *userptr) {
     (void)handle; (void)userptr;
-    if (type == CURLINFO_TEXT || type == CURLINFO_SSL_DATA_IN || type == CURLINFO_SSL_DATA_OUT) {
+    if (!trace_enabled((TraceType)type)) {
+        return 0;
+    }
+    if (type == CURLINFO_TEXT) {
         // SSL 핸드셰이크, ALPN, protocol 협상 관련 로그만 필터링
-        if (strstr(data, "SSL") || strstr(data, "ALPN") || strstr(data, "protocol") || strstr(data, "QUIC")) {
-            fprintf(stderr, "[CURL-DEBUG] %.*s", (int)size, data);
+        if (contains_keyword(data, size, "SSL") || contains_keyword(data, size, "ALPN") ||
+            contains_keyword(data, size, "protocol") || contains_keyword(data, size, "QUIC")) {
+            trace_event(TRACE_TEXT, data, size);
         }
+    } else {
+        trace_event((TraceType)type, data, size);
     }
     return 0;
 }
@@ -18,6 +43,7 @@ int debug_callback(CURL *handle, curl_infotype type, char *data, size_t size, vo
 // 응답 데이터를 출력하는 콜백 함수
 size_t write_callback(void *ptr, size_t size, size_t nmemb, void *userdata) {
     // 본문은 무시
+    (void)ptr; (void)userdata;
     return size * nmemb;
 }
 
@@ -28,9 +54,13 @@ int main(void) {
     char errbuf[CURL_ERROR_SIZE] = {0};
     long http_version = 0;
 
+    // 구조화 결과 출력 초기화 (RESULT_FORMAT=jsonl|csv이면 사람용 출력은 stderr로 이동)
+    ResultWriter *results = result_writer_from_env();
+
     // libcurl 전역 초기화
     if (curl_global_init(CURL_GLOBAL_DEFAULT) != 0) {
         fprintf(stderr, "curl_global_init() 실패\n");
+        result_writer_close(results);
         return 1;
     }
 
@@ -38,6 +68,27 @@ int main(void) {
     if (!curl) {
         fprintf(stderr, "curl_easy_init() 실패\n");
         curl_global_cleanup();
+        result_writer_close(results);
+        return 1;
+    }
+
+    // 프로세스 간 Alt-Svc/HSTS 캐시 (CURL_CACHE_DIR, HTTP3_POLICY)
+    altsvc_init("curl_http3_test");
+
+    // 디버그 트레이스 초기화 (기본: 텍스트 로그만, stderr 출력)
+    TraceConfig trace_config;
+    trace_default_config(&trace_config);
+    trace_config.out = stderr;
+    trace_config.label = "CURL-DEBUG";
+    if (!getenv("TRACE_TYPES")) {
+        trace_config.type_mask = TRACE_MASK(TRACE_TEXT);
+    }
+    if (trace_init(&trace_config) != 0) {
+        fprintf(stderr, "트레이스 초기화 실패!\n");
+        altsvc_cleanup();
+        curl_easy_cleanup(curl);
+        curl_global_cleanup();
+        result_writer_close(results);
         return 1;
     }
 
@@ -45,12 +96,16 @@ int main(void) {
     const char *url = "https://cloudflare.com";
     curl_easy_setopt(curl, CURLOPT_URL, url);
 
-    // HTTP/3 사용 옵션
-    curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_3);
+    // HTTP/3 연결 정책: Alt-Svc 캐시에 h3 항목이 있으면 HTTP/3 직접, 없으면 QUIC과 TCP 경합
+    AltSvcChoice altsvc;
+    altsvc_apply(curl, url, &altsvc);
 
     // 리다이렉트 자동 추적
     curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
 
+    // HARNESS가 있으면 로컬 하네스로 연결 (하네스는 TCP만 받으므로 HTTP/3 대신 TCP로 폴백한 비용을 잰다)
+    struct curl_slist *harness = harness_apply(curl);
+
     // 에러 메시지 버퍼 설정
     curl_easy_setopt(curl, CURLOPT_ERRORBUFFER, errbuf);
 
@@ -62,7 +117,12 @@ int main(void) {
     curl_easy_setopt(curl, CURLOPT_DEBUGFUNCTION, debug_callback);
 
     printf("🚀 libcurl로 HTTP/3 요청: %s\n", url);
-    res = curl_easy_perform(curl);
+    if (harness_target()) {
+        printf("연결 대상: 로컬 하네스 (%s)\n", harness_target());
+    }
+    res = altsvc_perform(curl, &altsvc);
+    printf("연결 정책: %s\n", altsvc_choice_text(&altsvc));
+    trace_flush();
 
     if (res != CURLE_OK) {
         fprintf(stderr, "\n❌ 요청 실패: %s\n", errbuf[0] ? errbuf : curl_easy_strerror(res));
@@ -71,16 +131,39 @@ int main(void) {
         curl_easy_getinfo(curl, CURLINFO_HTTP_VERSION, &http_version);
         printf("\n✅ HTTP 응답 코드: %ld\n", response_code);
         // 연결된 실제 프로토콜 출력
-        switch (http_version) {
-            case CURL_HTTP_VERSION_1_0: printf("실제 연결 프로토콜: HTTP/1.0\n"); break;
-            case CURL_HTTP_VERSION_1_1: printf("실제 연결 프로토콜: HTTP/1.1\n"); break;
-            case CURL_HTTP_VERSION_2:   printf("실제 연결 프로토콜: HTTP/2\n"); break;
-            case CURL_HTTP_VERSION_3:   printf("실제 연결 프로토콜: HTTP/3\n"); break;
-            default:                    printf("실제 연결 프로토콜: 알 수 없음\n"); break;
+        const char *protocol = curl_http_version_name(http_version);
+        printf("실제 연결 프로토콜: %s\n", protocol ? protocol : "알 수 없음");
+
+        // 단계별 시간 (장애 프록시를 거치면 RTT와 손실이 연결/TLS(QUIC)/첫 바이트에 나뉘어 보인다)
+        double connect_time = 0, tls_time = 0, ttfb = 0, total_time = 0;
+        curl_easy_getinfo(curl, CURLINFO_CONNECT_TIME, &connect_time);
+        curl_easy_getinfo(curl, CURLINFO_APPCONNECT_TIME, &tls_time);
+        curl_easy_getinfo(curl, CURLINFO_STARTTRANSFER_TIME, &ttfb);
+        curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME, &total_time);
+        printf("단계별 시간: 연결 %.1fms, TLS %.1fms, 첫 바이트 %.1fms, 전체 %.1fms\n",
+               connect_time * 1000.0, tls_time * 1000.0, ttfb * 1000.0, total_time * 1000.0);
+    }
+
+    // 구조화 결과 출력
+    if (result_writer_structured(results)) {
+        TestResult record;
+        result_init(&record, "curl_http3_test", "request");
+        record.target = url;
+        record.method = "GET";
+        result_fill_from_curl(&record, curl);
+        record.success = res == CURLE_OK;
+        if (res != CURLE_OK) {
+            record.error = errbuf[0] ? errbuf : curl_easy_strerror(res);
         }
+        result_emit(results, &record);
     }
+    result_writer_close(results);
 
     curl_easy_cleanup(curl);
+    curl_slist_free_all(harness);
+    altsvc_print_summary(stdout);
+    altsvc_cleanup();
+    trace_shutdown();
     curl_global_cleanup();
     return 0;
 } 
\ No newline at end of file
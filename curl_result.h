@@ -0,0 +1,61 @@
+#ifndef CURL_RESULT_H
+#define CURL_RESULT_H
+
+// libcurl 핸들의 측정값을 TestResult로 옮기는 도우미 (curl 테스트 공용)
+
+#include <curl/curl.h>
+#include "result_output.h"
+
+// CURLINFO_HTTP_VERSION 값을 문자열로 변환
+static inline const char* curl_http_version_name(long version) {
+    switch (version) {
+        case CURL_HTTP_VERSION_1_0: return "HTTP/1.0";
+        case CURL_HTTP_VERSION_1_1: return "HTTP/1.1";
+        case CURL_HTTP_VERSION_2_0: return "HTTP/2";
+        case CURL_HTTP_VERSION_3:   return "HTTP/3";
+        default:                    return NULL;
+    }
+}
+
+// 응답 코드, 프로토콜, 해결된 IP, 단계별 시간, 송수신 바이트를 채운다
+// resolved_ip는 curl 핸들이 소유하므로 curl_easy_cleanup 전에 result_emit 해야 한다
+static inline void result_fill_from_curl(TestResult* result, CURL* curl) {
+    long response_code = 0;
+    long http_version = 0;
+    long header_size = 0;
+    long request_size = 0;
+    char* primary_ip = NULL;
+    long primary_port = 0;
+    double namelookup = 0, connect = 0, appconnect = 0, starttransfer = 0, total = 0;
+    curl_off_t downloaded = 0, uploaded = 0;
+
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response_code);
+    curl_easy_getinfo(curl, CURLINFO_HTTP_VERSION, &http_version);
+    curl_easy_getinfo(curl, CURLINFO_PRIMARY_IP, &primary_ip);
+    curl_easy_getinfo(curl, CURLINFO_PRIMARY_PORT, &primary_port);
+    curl_easy_getinfo(curl, CURLINFO_NAMELOOKUP_TIME, &namelookup);
+    curl_easy_getinfo(curl, CURLINFO_CONNECT_TIME, &connect);
+    curl_easy_getinfo(curl, CURLINFO_APPCONNECT_TIME, &appconnect);
+    curl_easy_getinfo(curl, CURLINFO_STARTTRANSFER_TIME, &starttransfer);
+    curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME, &total);
+    curl_easy_getinfo(curl, CURLINFO_SIZE_DOWNLOAD_T, &downloaded);
+    curl_easy_getinfo(curl, CURLINFO_SIZE_UPLOAD_T, &uploaded);
+    curl_easy_getinfo(curl, CURLINFO_HEADER_SIZE, &header_size);
+    curl_easy_getinfo(curl, CURLINFO_REQUEST_SIZE, &request_size);
+
+    result->status = response_code;
+    result->protocol = curl_http_version_name(http_version);
+    result->resolved_ip = (primary_ip && *primary_ip) ? primary_ip : NULL;
+    if (primary_port > 0) {
+        result->port = (int)primary_port;
+    }
+    result->dns_time = namelookup;
+    result->connect_time = connect > namelookup ? connect - namelookup : 0.0;
+    result->tls_time = appconnect > 0 ? appconnect - connect : -1.0;
+    result->ttfb = starttransfer;
+    result->total_time = total;
+    result->bytes_in = (uint64_t)downloaded + (uint64_t)header_size;
+    result->bytes_out = (uint64_t)uploaded + (uint64_t)request_size;
+}
+
+#endif
@@ -0,0 +1,221 @@
+#include "handshake_pool.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <openssl/err.h>
+
+#define HANDSHAKE_POOL_MAX_THREADS 64
+
+struct HandshakePool {
+    pthread_mutex_t lock;
+    pthread_cond_t ready;
+    HandshakeTask* head;
+    HandshakeTask* tail;
+    int pending;
+    int stop;
+    int thread_count;
+    pthread_t threads[HANDSHAKE_POOL_MAX_THREADS];
+};
+
+static double monotonic_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// early data 단계: ClientHello를 처리하고 뒤따라온 0-RTT 평문을 버퍼에 쌓는다.
+// 클라이언트가 early data를 끝냈거나(EndOfEarlyData) 보내지 않았거나 서버가 거절하면 일반 핸드셰이크로 넘어간다
+static int handshake_read_early(HandshakeTask* task) {
+    task->early_len = 0;
+    while (task->early_len < task->early_cap) {
+        size_t bytes = 0;
+        int ret = SSL_read_early_data(task->ssl, task->early_buffer + task->early_len,
+                                      task->early_cap - task->early_len, &bytes);
+        if (ret == SSL_READ_EARLY_DATA_SUCCESS) {
+            task->early_len += bytes;
+            continue;
+        }
+        if (ret == SSL_READ_EARLY_DATA_FINISH) {
+            task->early = 0;
+            return SSL_do_handshake(task->ssl);
+        }
+        return -1;              // 입력 대기 또는 오류 (SSL_get_error로 구분)
+    }
+    return -1;                  // 버퍼가 찼다 (early data 최대 크기가 버퍼보다 크지 않으면 생기지 않는다)
+}
+
+void handshake_step(HandshakeTask* task) {
+    task->started_at = monotonic_seconds();
+    task->result = task->early ? handshake_read_early(task) : SSL_do_handshake(task->ssl);
+    task->ssl_error = task->result > 0 ? SSL_ERROR_NONE : SSL_get_error(task->ssl, task->result);
+    task->error_code = 0;
+
+    // OpenSSL 오류 큐는 스레드별이므로 실패 원인은 여기서 꺼내 작업에 담는다
+    if (task->ssl_error != SSL_ERROR_NONE &&
+        task->ssl_error != SSL_ERROR_WANT_READ && task->ssl_error != SSL_ERROR_WANT_WRITE) {
+        task->error_code = ERR_peek_error();
+    }
+    ERR_clear_error();
+    task->finished_at = monotonic_seconds();
+}
+
+static void queue_push(HandshakeQueue* queue, HandshakeTask* task) {
+    task->next = NULL;
+    pthread_mutex_lock(&queue->lock);
+    if (queue->tail) {
+        queue->tail->next = task;
+    } else {
+        queue->head = task;
+    }
+    queue->tail = task;
+    pthread_mutex_unlock(&queue->lock);
+    handshake_queue_wake(queue);
+}
+
+static void* pool_main(void* arg) {
+    HandshakePool* pool = (HandshakePool*)arg;
+
+    for (;;) {
+        pthread_mutex_lock(&pool->lock);
+        while (!pool->head && !pool->stop) {
+            pthread_cond_wait(&pool->ready, &pool->lock);
+        }
+        if (!pool->head) {
+            pthread_mutex_unlock(&pool->lock);
+            break;
+        }
+        HandshakeTask* task = pool->head;
+        pool->head = task->next;
+        if (!pool->head) {
+            pool->tail = NULL;
+        }
+        pool->pending--;
+        pthread_mutex_unlock(&pool->lock);
+
+        handshake_step(task);
+        queue_push(task->reply, task);
+    }
+
+    return NULL;
+}
+
+HandshakePool* handshake_pool_start(int threads) {
+    if (threads <= 0) {
+        return NULL;
+    }
+    if (threads > HANDSHAKE_POOL_MAX_THREADS) {
+        threads = HANDSHAKE_POOL_MAX_THREADS;
+    }
+
+    HandshakePool* pool = (HandshakePool*)calloc(1, sizeof(HandshakePool));
+    if (!pool) {
+        return NULL;
+    }
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->ready, NULL);
+
+    for (int i = 0; i < threads; i++) {
+        if (pthread_create(&pool->threads[i], NULL, pool_main, pool) != 0) {
+            perror("핸드셰이크 스레드 생성 실패");
+            break;
+        }
+        pool->thread_count++;
+    }
+    if (pool->thread_count == 0) {
+        pthread_cond_destroy(&pool->ready);
+        pthread_mutex_destroy(&pool->lock);
+        free(pool);
+        return NULL;
+    }
+
+    return pool;
+}
+
+void handshake_pool_stop(HandshakePool* pool) {
+    if (!pool) {
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = 1;
+    pthread_cond_broadcast(&pool->ready);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int i = 0; i < pool->thread_count; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+    pthread_cond_destroy(&pool->ready);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool);
+}
+
+void handshake_pool_submit(HandshakePool* pool, HandshakeTask* task) {
+    task->next = NULL;
+    task->queued_at = monotonic_seconds();
+
+    pthread_mutex_lock(&pool->lock);
+    if (pool->tail) {
+        pool->tail->next = task;
+    } else {
+        pool->head = task;
+    }
+    pool->tail = task;
+    pool->pending++;
+    pthread_cond_signal(&pool->ready);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+int handshake_pool_pending(HandshakePool* pool) {
+    if (!pool) {
+        return 0;
+    }
+    pthread_mutex_lock(&pool->lock);
+    int pending = pool->pending;
+    pthread_mutex_unlock(&pool->lock);
+    return pending;
+}
+
+int handshake_queue_init(HandshakeQueue* queue) {
+    memset(queue, 0, sizeof(*queue));
+    queue->event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (queue->event_fd < 0) {
+        perror("eventfd 생성 실패");
+        return -1;
+    }
+    pthread_mutex_init(&queue->lock, NULL);
+    return 0;
+}
+
+void handshake_queue_destroy(HandshakeQueue* queue) {
+    if (queue->event_fd >= 0) {
+        close(queue->event_fd);
+        queue->event_fd = -1;
+    }
+    pthread_mutex_destroy(&queue->lock);
+}
+
+void handshake_queue_wake(HandshakeQueue* queue) {
+    uint64_t one = 1;
+    if (write(queue->event_fd, &one, sizeof(one)) < 0) {
+        // 카운터 포화(EAGAIN)는 이미 깨울 신호가 남아 있다는 뜻이므로 무시한다
+    }
+}
+
+HandshakeTask* handshake_queue_take_all(HandshakeQueue* queue) {
+    uint64_t count;
+    if (read(queue->event_fd, &count, sizeof(count)) < 0) {
+        // EAGAIN: 다른 호출에서 이미 비웠음
+    }
+
+    pthread_mutex_lock(&queue->lock);
+    HandshakeTask* head = queue->head;
+    queue->head = NULL;
+    queue->tail = NULL;
+    pthread_mutex_unlock(&queue->lock);
+    return head;
+}
@@ -0,0 +1,64 @@
+#ifndef HANDSHAKE_POOL_H
+#define HANDSHAKE_POOL_H
+
+// TLS 핸드셰이크 오프로드 풀
+// - I/O 스레드는 핸드셰이크가 진행 가능한 연결(소켓이 읽기/쓰기 가능)을 풀에 넘기고 다른 연결을 계속 처리한다.
+// - 풀 스레드는 비블로킹 SSL_do_handshake를 한 번 진행(RSA 서명 등 암호 연산 포함)한 뒤
+//   결과를 워커의 완료 큐에 넣고 eventfd로 I/O 스레드를 깨운다.
+// - TLS 1.3 early data를 받는 연결은 SSL_read_early_data로 진행하고, 받은 평문은 I/O 스레드가 빌려 준 버퍼에 쌓는다.
+// - 한 연결은 항상 한 스레드만 만진다 (I/O 스레드 -> 풀 -> I/O 스레드 순으로 소유권이 넘어감).
+
+#include <pthread.h>
+#include <openssl/ssl.h>
+
+typedef struct HandshakeQueue HandshakeQueue;
+
+typedef struct HandshakeTask {
+    SSL* ssl;
+    int result;                 // SSL_do_handshake 반환값 (1이면 완료)
+    int ssl_error;              // SSL_get_error 값 (result <= 0일 때)
+    unsigned long error_code;   // 실패 시 풀 스레드의 ERR_peek_error() 값
+    double queued_at;           // 단조 시계 (초)
+    double started_at;
+    double finished_at;
+    int early;                  // 1: 아직 early data(0-RTT) 단계 (끝나면 풀 스레드가 0으로 바꾼다)
+    char* early_buffer;         // early data 평문을 쌓을 곳 (I/O 스레드가 단계마다 지정)
+    size_t early_cap;
+    size_t early_len;           // 이번 단계에서 받은 바이트 수
+    HandshakeQueue* reply;      // 완료 통지를 받을 큐
+    struct HandshakeTask* next;
+} HandshakeTask;
+
+// 완료 큐 (워커마다 하나, eventfd를 epoll에 등록해 사용)
+struct HandshakeQueue {
+    pthread_mutex_t lock;
+    HandshakeTask* head;
+    HandshakeTask* tail;
+    int event_fd;
+};
+
+typedef struct HandshakePool HandshakePool;
+
+// 풀 스레드 시작 (threads가 0이면 NULL을 반환하고 호출자가 직접 처리)
+HandshakePool* handshake_pool_start(int threads);
+void handshake_pool_stop(HandshakePool* pool);
+
+// 핸드셰이크를 한 단계 진행한다 (풀 스레드 또는 인라인 모드의 I/O 스레드에서 호출)
+void handshake_step(HandshakeTask* task);
+
+// 작업 제출 (task->reply 큐로 결과가 돌아온다)
+void handshake_pool_submit(HandshakePool* pool, HandshakeTask* task);
+
+// 대기 중인 작업 수 (관측용)
+int handshake_pool_pending(HandshakePool* pool);
+
+int handshake_queue_init(HandshakeQueue* queue);
+void handshake_queue_destroy(HandshakeQueue* queue);
+
+// 작업 없이 큐 소유 스레드를 깨운다 (종료/드레인 요청 전달용, 어느 스레드에서나 호출 가능)
+void handshake_queue_wake(HandshakeQueue* queue);
+
+// 완료된 작업을 모두 꺼낸다 (제출 순서, 없으면 NULL). eventfd 카운터도 비운다
+HandshakeTask* handshake_queue_take_all(HandshakeQueue* queue);
+
+#endif
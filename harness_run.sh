@@ -0,0 +1,165 @@
+#!/bin/bash
+
+# 로컬 하네스로 모든 클라이언트 도구 실행 스크립트
+# 1. local_harness를 127.0.0.1/::1에 띄우고 자체 서명 인증서를 저장
+# 2. 경로 프로파일(--v4, --v6, --all)이 있으면 하네스 앞에 impair_proxy를 띄움 (포트 + 1)
+# 3. HARNESS/HARNESS_CA를 설정해 curl 도구(URL 그대로)와 tls_client_test를 하네스로 실행
+# 4. 프록시 통계 출력 후 종료
+# 사용법: ./harness_run.sh [--port N] [--size BYTES] [--delay MS] [--alt-svc VALUE] [--hsts SEC] [--v4 SPEC] [--v6 SPEC] [--all SPEC] [--seed N] [--bin-dir DIR] [도구...]
+# 예시:   RESULT_FORMAT=jsonl ./harness_run.sh --size 65536 ipv4_ipv6_test > results.jsonl
+#         ./harness_run.sh --v4 delay=20ms --v6 delay=35ms,loss=1% --seed 7 ipv4_ipv6_test
+#         ./harness_run.sh --bin-dir build/release   # CMake 빌드 결과로 실행
+#         ./harness_run.sh --alt-svc 'h3=":443"; ma=3600' curl_http3_test   # Alt-Svc 캐시 학습 확인
+
+set -e
+
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+BLUE='\033[0;34m'
+NC='\033[0m' # No Color
+
+# 사람용 출력은 stderr (RESULT_FORMAT을 쓰면 stdout에는 결과 레코드만 남는다)
+print_error() {
+    echo -e "${RED}❌ $1${NC}" >&2
+}
+
+print_success() {
+    echo -e "${GREEN}✅ $1${NC}" >&2
+}
+
+print_info() {
+    echo -e "${BLUE}ℹ️  $1${NC}" >&2
+}
+
+PORT=18443
+BIN_DIR=.
+HARNESS_ARGS=()
+PROXY_ARGS=()
+TOOLS=()
+while [[ $# -gt 0 ]]; do
+    case $1 in
+        --port)
+            PORT=$2
+            shift 2
+            ;;
+        --bin-dir)
+            BIN_DIR=$2
+            shift 2
+            ;;
+        --size|--delay|--alt-svc|--hsts)
+            HARNESS_ARGS+=("$1" "$2")
+            shift 2
+            ;;
+        --v4|--v6|--all|--seed)
+            PROXY_ARGS+=("$1" "$2")
+            shift 2
+            ;;
+        -h|--help)
+            sed -n '3,12p' "$0" | sed 's/^# \{0,1\}//'
+            exit 0
+            ;;
+        *)
+            TOOLS+=("$1")
+            shift
+            ;;
+    esac
+done
+if [[ ${#TOOLS[@]} -eq 0 ]]; then
+    TOOLS=(curl_cpp_simple advanced_curl_cpp ipv4_ipv6_test curl_http3_test tls_client_test)
+fi
+
+cd "$(dirname "$0")"
+
+if [[ ! -x "$BIN_DIR/local_harness" ]]; then
+    print_error "$BIN_DIR/local_harness가 없습니다 (먼저 ./build.sh 또는 CMake로 빌드)"
+    exit 1
+fi
+
+WORK_DIR=$(mktemp -d)
+CA_FILE="$WORK_DIR/harness_ca.pem"
+SERVER_PID=""
+PROXY_PID=""
+
+stop_server() {
+    if [[ -n "$PROXY_PID" ]]; then
+        # 종료하면서 주소 계열별 손실/순서 바뀜 통계를 출력한다
+        kill -TERM "$PROXY_PID" 2>/dev/null || true
+        wait "$PROXY_PID" 2>/dev/null || true
+        PROXY_PID=""
+        sed -n '/===/,$p' "$WORK_DIR/proxy.log" >&2
+    fi
+    if [[ -n "$SERVER_PID" ]]; then
+        kill -TERM "$SERVER_PID" 2>/dev/null || true
+        wait "$SERVER_PID" 2>/dev/null || true
+        SERVER_PID=""
+    fi
+    rm -rf "$WORK_DIR"
+}
+trap stop_server EXIT
+
+# 함수: 포트가 열릴 때까지 대기 (최대 5초)
+wait_for_port() {
+    for _ in $(seq 50); do
+        if (exec 3<>"/dev/tcp/127.0.0.1/$1") 2>/dev/null; then
+            return 0
+        fi
+        sleep 0.1
+    done
+    return 1
+}
+
+"$BIN_DIR/local_harness" --port "$PORT" --ca-out "$CA_FILE" "${HARNESS_ARGS[@]}" > "$WORK_DIR/harness.log" 2>&1 &
+SERVER_PID=$!
+if ! wait_for_port "$PORT"; then
+    print_error "하네스가 시작되지 않았습니다:"
+    cat "$WORK_DIR/harness.log" >&2
+    exit 1
+fi
+head -2 "$WORK_DIR/harness.log" >&2
+
+# 경로 프로파일이 있으면 도구는 프록시로 연결
+TARGET_PORT=$PORT
+if [[ ${#PROXY_ARGS[@]} -gt 0 ]]; then
+    if [[ ! -x "$BIN_DIR/impair_proxy" ]]; then
+        print_error "$BIN_DIR/impair_proxy가 없습니다 (먼저 ./build.sh 또는 CMake로 빌드)"
+        exit 1
+    fi
+    TARGET_PORT=$((PORT + 1))
+    "$BIN_DIR/impair_proxy" --port "$TARGET_PORT" --to "$PORT" "${PROXY_ARGS[@]}" > "$WORK_DIR/proxy.log" 2>&1 &
+    PROXY_PID=$!
+    if ! wait_for_port "$TARGET_PORT"; then
+        print_error "장애 프록시가 시작되지 않았습니다:"
+        cat "$WORK_DIR/proxy.log" >&2
+        exit 1
+    fi
+    head -3 "$WORK_DIR/proxy.log" >&2
+fi
+
+export HARNESS="localhost:$TARGET_PORT"
+export HARNESS_CA="$CA_FILE"
+# 하네스가 알려 준 Alt-Svc/HSTS가 실제 사용자 캐시에 섞이지 않도록 임시 캐시를 쓴다
+export CURL_CACHE_DIR="${CURL_CACHE_DIR:-$WORK_DIR/cache}"
+
+FAILED=0
+for tool in "${TOOLS[@]}"; do
+    if [[ ! -x "$BIN_DIR/$tool" ]]; then
+        print_info "건너뜀: $tool (빌드되지 않음)"
+        continue
+    fi
+    print_info "실행: $tool"
+    echo "----------------------------------------" >&2
+    if [[ "$tool" == "tls_client_test" ]]; then
+        # curl을 거치지 않는 OpenSSL 클라이언트는 하네스 주소로 직접 연결
+        "$BIN_DIR/tls_client_test" localhost "$TARGET_PORT" /get --verify --ca-file "$CA_FILE" || FAILED=1
+    else
+        "$BIN_DIR/$tool" || FAILED=1
+    fi
+    echo "----------------------------------------" >&2
+done
+
+stop_server
+if [[ $FAILED -ne 0 ]]; then
+    print_error "실패한 도구가 있습니다"
+    exit 1
+fi
+print_success "하네스 실행 완료"
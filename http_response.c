@@ -0,0 +1,418 @@
+#include "http_response.h"
+
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+
+enum {
+    STATE_HEAD = 0,
+    STATE_BODY_LENGTH,
+    STATE_BODY_CLOSE,
+    STATE_CHUNK_SIZE,
+    STATE_CHUNK_DATA,
+    STATE_CHUNK_END,            // 청크 데이터 뒤의 CRLF
+    STATE_TRAILER,
+    STATE_DONE,
+    STATE_ERROR
+};
+
+#define CHUNK_LINE_MAX 1024     // 청크 크기 줄(확장 포함)과 트레일러 줄의 최대 길이
+
+static HttpParseResult parse_fail(HttpResponse* response, const char* error) {
+    response->state = STATE_ERROR;
+    response->error = error;
+    return HTTP_PARSE_ERROR;
+}
+
+void http_response_init(HttpResponse* response, HttpBodySink sink, int head_request) {
+    response->sink = sink;
+    response->start = 0;
+    response->end = 0;
+    http_response_reset(response, head_request);
+}
+
+void http_response_reset(HttpResponse* response, int head_request) {
+    // 앞 응답 뒤에 이미 받은 바이트(파이프라이닝)는 버퍼 앞으로 옮긴다
+    size_t leftover = response->end - response->start;
+    if (leftover > 0 && response->start > 0) {
+        memmove(response->buffer, response->buffer + response->start, leftover);
+    }
+    response->start = 0;
+    response->end = leftover;
+    response->scanned = 0;
+    response->head_end = 0;
+    response->head_request = head_request;
+    response->state = STATE_HEAD;
+    response->version_minor = 0;
+    response->status = 0;
+    response->reason.data = NULL;
+    response->reason.len = 0;
+    response->header_count = 0;
+    response->head.data = NULL;
+    response->head.len = 0;
+    response->framing = HTTP_BODY_NONE;
+    response->content_length = -1;
+    response->keep_alive = 0;
+    response->body_bytes = 0;
+    response->remaining = 0;
+    response->error = NULL;
+}
+
+char* http_response_read_buffer(HttpResponse* response, size_t* space) {
+    *space = sizeof(response->buffer) - response->end;
+    return response->buffer + response->end;
+}
+
+static int slice_equals(const HttpSlice* slice, const char* text) {
+    size_t len = strlen(text);
+    return slice->len == len && strncasecmp(slice->data, text, len) == 0;
+}
+
+static HttpSlice slice_trim(const char* data, size_t len) {
+    while (len > 0 && (*data == ' ' || *data == '\t')) {
+        data++;
+        len--;
+    }
+    while (len > 0 && (data[len - 1] == ' ' || data[len - 1] == '\t')) {
+        len--;
+    }
+    HttpSlice slice = { data, len };
+    return slice;
+}
+
+const HttpSlice* http_response_header(const HttpResponse* response, const char* name) {
+    for (int i = 0; i < response->header_count; i++) {
+        if (slice_equals(&response->headers[i].name, name)) {
+            return &response->headers[i].value;
+        }
+    }
+    return NULL;
+}
+
+int http_slice_has_token(const HttpSlice* slice, const char* token) {
+    const char* p = slice->data;
+    const char* end = slice->data + slice->len;
+    while (p < end) {
+        const char* comma = memchr(p, ',', (size_t)(end - p));
+        const char* item_end = comma ? comma : end;
+        HttpSlice item = slice_trim(p, (size_t)(item_end - p));
+        if (slice_equals(&item, token)) {
+            return 1;
+        }
+        p = item_end + 1;
+    }
+    return 0;
+}
+
+const char* http_body_framing_name(HttpBodyFraming framing) {
+    switch (framing) {
+        case HTTP_BODY_NONE: return "없음";
+        case HTTP_BODY_LENGTH: return "Content-Length";
+        case HTTP_BODY_CHUNKED: return "chunked";
+        case HTTP_BODY_UNTIL_CLOSE: return "연결 종료까지";
+    }
+    return "?";
+}
+
+// 10진수 (넘치면 -1)
+static int64_t parse_decimal(const HttpSlice* slice) {
+    int64_t value = 0;
+    if (slice->len == 0) {
+        return -1;
+    }
+    for (size_t i = 0; i < slice->len; i++) {
+        if (!isdigit((unsigned char)slice->data[i]) || value > (INT64_MAX - 9) / 10) {
+            return -1;
+        }
+        value = value * 10 + (slice->data[i] - '0');
+    }
+    return value;
+}
+
+// 모든 Content-Length 헤더(쉼표 목록 포함)의 값. 값이 모두 같아야 한다 (RFC 9110 8.6)
+// 반환값: 헤더 없으면 -1, 잘못되었거나 서로 다르면 -2
+static int64_t parse_content_length(const HttpResponse* response) {
+    int64_t result = -1;
+    for (int i = 0; i < response->header_count; i++) {
+        if (!slice_equals(&response->headers[i].name, "Content-Length")) {
+            continue;
+        }
+        const HttpSlice* value = &response->headers[i].value;
+        const char* p = value->data;
+        const char* end = value->data + value->len;
+        do {
+            const char* comma = memchr(p, ',', (size_t)(end - p));
+            const char* item_end = comma ? comma : end;
+            HttpSlice item = slice_trim(p, (size_t)(item_end - p));
+            int64_t length = parse_decimal(&item);
+            if (length < 0 || (result >= 0 && length != result)) {
+                return -2;
+            }
+            result = length;
+            p = item_end + 1;
+        } while (p <= end);
+    }
+    return result;
+}
+
+// 상태 줄과 헤더를 제자리에서 파싱하고 본문 구분 방식을 정한다
+static HttpParseResult parse_head(HttpResponse* response, size_t head_len) {
+    const char* p = response->buffer;
+    const char* end = response->buffer + head_len - 2;     // 마지막 빈 줄의 CRLF 제외
+
+    // 상태 줄: HTTP/1.x SP 3DIGIT [SP reason]
+    const char* line_end = memchr(p, '\r', (size_t)(end - p));
+    if (!line_end || line_end - p < 12 || strncmp(p, "HTTP/1.", 7) != 0 || !isdigit((unsigned char)p[7]) ||
+        p[8] != ' ' || !isdigit((unsigned char)p[9]) || !isdigit((unsigned char)p[10]) ||
+        !isdigit((unsigned char)p[11])) {
+        return parse_fail(response, "잘못된 상태 줄");
+    }
+    response->version_minor = p[7] - '0';
+    response->status = (p[9] - '0') * 100 + (p[10] - '0') * 10 + (p[11] - '0');
+    response->reason = slice_trim(p + 12, (size_t)(line_end - (p + 12)));
+    p = line_end + 2;
+
+    // 헤더: name ":" OWS value OWS (줄 접기는 지원하지 않음)
+    response->header_count = 0;
+    while (p < end) {
+        line_end = memchr(p, '\r', (size_t)(end - p));
+        if (!line_end) {
+            line_end = end;
+        }
+        const char* colon = memchr(p, ':', (size_t)(line_end - p));
+        if (!colon || colon == p || line_end[0] != '\r') {
+            return parse_fail(response, "잘못된 헤더 줄");
+        }
+        if (response->header_count == HTTP_RESPONSE_MAX_HEADERS) {
+            return parse_fail(response, "헤더가 너무 많음");
+        }
+        HttpHeaderView* header = &response->headers[response->header_count++];
+        header->name.data = p;
+        header->name.len = (size_t)(colon - p);
+        header->value = slice_trim(colon + 1, (size_t)(line_end - colon - 1));
+        p = line_end + 2;
+    }
+    response->head.data = response->buffer;
+    response->head.len = head_len;
+
+    // 연결 재사용: HTTP/1.1은 기본 유지, 1.0은 keep-alive를 명시해야 한다
+    const HttpSlice* connection = http_response_header(response, "Connection");
+    response->keep_alive = response->version_minor >= 1 ? !(connection && http_slice_has_token(connection, "close"))
+                                                         : (connection && http_slice_has_token(connection, "keep-alive"));
+
+    // 본문 구분 (RFC 9112 6.3): 본문 없는 응답 > chunked > Content-Length > 연결 종료
+    const HttpSlice* encoding = http_response_header(response, "Transfer-Encoding");
+    int64_t length = parse_content_length(response);
+    if (length == -2) {
+        return parse_fail(response, "잘못되었거나 서로 다른 Content-Length");
+    }
+    // Transfer-Encoding과 Content-Length가 함께 오면 어느 쪽으로 끝을 정했는지 중간 장치와 어긋날 수 있으므로
+    // 이 응답 뒤에 연결을 다시 쓰지 않는다 (RFC 9112 6.3)
+    if (encoding && length >= 0) {
+        response->keep_alive = 0;
+    }
+    if (response->head_request || response->status / 100 == 1 || response->status == 204 || response->status == 304) {
+        response->framing = HTTP_BODY_NONE;
+    } else if (encoding && http_slice_has_token(encoding, "chunked")) {
+        response->framing = HTTP_BODY_CHUNKED;
+    } else if (length >= 0) {
+        response->content_length = length;
+        response->framing = HTTP_BODY_LENGTH;
+        response->remaining = (uint64_t)response->content_length;
+    } else {
+        response->framing = HTTP_BODY_UNTIL_CLOSE;
+        response->keep_alive = 0;
+    }
+    return HTTP_PARSE_MORE;
+}
+
+// 본문 조각을 싱크로 넘긴다
+static int deliver(HttpResponse* response, size_t len) {
+    const char* data = response->buffer + response->start;
+    response->start += len;
+    response->body_bytes += len;
+    if (response->sink.body && len > 0 && response->sink.body(response->sink.ctx, data, len) != 0) {
+        parse_fail(response, "싱크가 본문을 거부함");
+        return -1;
+    }
+    return 0;
+}
+
+// 처리하지 않은 데이터에서 CRLF로 끝나는 줄 하나. 없으면 NULL (줄이 너무 길면 오류)
+static const char* take_line(HttpResponse* response, size_t* line_len, int* too_long) {
+    const char* p = response->buffer + response->start;
+    size_t available = response->end - response->start;
+    const char* lf = memchr(p, '\n', available);
+    *too_long = 0;
+    if (!lf) {
+        *too_long = available > CHUNK_LINE_MAX;
+        return NULL;
+    }
+    size_t len = (size_t)(lf - p);
+    if (len > 0 && p[len - 1] == '\r') {
+        len--;
+    }
+    *line_len = len;
+    response->start += (size_t)(lf - p) + 1;
+    return p;
+}
+
+// 청크 크기 줄: 16진수 [; 확장]
+static HttpParseResult parse_chunk_size(HttpResponse* response, const char* line, size_t len) {
+    uint64_t size = 0;
+    size_t digits = 0;
+    for (; digits < len; digits++) {
+        int c = (unsigned char)line[digits];
+        int value = isdigit(c) ? c - '0' : (c >= 'a' && c <= 'f') ? c - 'a' + 10 : (c >= 'A' && c <= 'F') ? c - 'A' + 10 : -1;
+        if (value < 0) {
+            break;
+        }
+        if (size > (UINT64_MAX >> 4)) {
+            return parse_fail(response, "청크 크기가 너무 큼");
+        }
+        size = (size << 4) | (uint64_t)value;
+    }
+    if (digits == 0 || (digits < len && line[digits] != ';' && line[digits] != ' ' && line[digits] != '\t')) {
+        return parse_fail(response, "잘못된 청크 크기");
+    }
+    response->remaining = size;
+    response->state = size == 0 ? STATE_TRAILER : STATE_CHUNK_DATA;
+    return HTTP_PARSE_MORE;
+}
+
+HttpParseResult http_response_process(HttpResponse* response) {
+    for (;;) {
+        size_t available = response->end - response->start;
+        switch (response->state) {
+            case STATE_HEAD: {
+                // 빈 줄(CRLF CRLF)을 찾을 때까지 모은다. 앞에서 본 곳은 다시 보지 않는다
+                size_t from = response->scanned > 3 ? response->scanned - 3 : 0;
+                const char* found = NULL;
+                for (size_t i = from; i + 3 < response->end; i++) {
+                    if (response->buffer[i] == '\r' && memcmp(response->buffer + i, "\r\n\r\n", 4) == 0) {
+                        found = response->buffer + i;
+                        break;
+                    }
+                }
+                response->scanned = response->end;
+                if (!found) {
+                    if (response->end == sizeof(response->buffer)) {
+                        return parse_fail(response, "헤더가 너무 큼");
+                    }
+                    return HTTP_PARSE_MORE;
+                }
+                // 헤더 뒤에는 청크 크기 줄을 이어 붙일 자리가 남아야 한다
+                size_t head_len = (size_t)(found - response->buffer) + 4;
+                if (head_len > sizeof(response->buffer) - 2 * CHUNK_LINE_MAX) {
+                    return parse_fail(response, "헤더가 너무 큼");
+                }
+                if (parse_head(response, head_len) != HTTP_PARSE_MORE) {
+                    return HTTP_PARSE_ERROR;
+                }
+                // 1xx 중간 응답은 버리고 최종 응답을 기다린다
+                if (response->status / 100 == 1 && response->status != 101) {
+                    response->start = head_len;
+                    http_response_reset(response, response->head_request);
+                    continue;
+                }
+                response->head_end = head_len;
+                response->start = head_len;
+                if (response->sink.headers) {
+                    response->sink.headers(response->sink.ctx, response);
+                }
+                response->state = response->framing == HTTP_BODY_LENGTH ? STATE_BODY_LENGTH
+                                : response->framing == HTTP_BODY_CHUNKED ? STATE_CHUNK_SIZE
+                                : response->framing == HTTP_BODY_UNTIL_CLOSE ? STATE_BODY_CLOSE
+                                : STATE_DONE;
+                if (response->state == STATE_BODY_LENGTH && response->remaining == 0) {
+                    response->state = STATE_DONE;
+                }
+                continue;
+            }
+
+            case STATE_BODY_LENGTH:
+            case STATE_CHUNK_DATA: {
+                size_t len = available < response->remaining ? available : (size_t)response->remaining;
+                if (deliver(response, len) != 0) {
+                    return HTTP_PARSE_ERROR;
+                }
+                response->remaining -= len;
+                if (response->remaining > 0) {
+                    break;
+                }
+                response->state = response->state == STATE_BODY_LENGTH ? STATE_DONE : STATE_CHUNK_END;
+                continue;
+            }
+
+            case STATE_BODY_CLOSE:
+                if (deliver(response, available) != 0) {
+                    return HTTP_PARSE_ERROR;
+                }
+                break;
+
+            case STATE_CHUNK_END:
+            case STATE_CHUNK_SIZE:
+            case STATE_TRAILER: {
+                size_t line_len;
+                int too_long;
+                const char* line = take_line(response, &line_len, &too_long);
+                if (!line) {
+                    if (too_long) {
+                        return parse_fail(response, "청크 줄이 너무 김");
+                    }
+                    break;
+                }
+                if (response->state == STATE_CHUNK_END) {
+                    if (line_len != 0) {
+                        return parse_fail(response, "청크 데이터 뒤에 CRLF가 없음");
+                    }
+                    response->state = STATE_CHUNK_SIZE;
+                } else if (response->state == STATE_CHUNK_SIZE) {
+                    if (parse_chunk_size(response, line, line_len) != HTTP_PARSE_MORE) {
+                        return HTTP_PARSE_ERROR;
+                    }
+                } else if (line_len == 0) {
+                    response->state = STATE_DONE;       // 트레일러 헤더는 건너뛴다
+                }
+                continue;
+            }
+
+            case STATE_DONE:
+                return HTTP_PARSE_DONE;
+
+            default:
+                return HTTP_PARSE_ERROR;
+        }
+        break;
+    }
+
+    // 본문 영역을 비웠으면 헤더 바로 뒤부터 다시 채우고, 덜 받은 청크 줄은 그 자리로 당긴다
+    if (response->start == response->end) {
+        response->start = response->end = response->head_end;
+    } else if (response->end == sizeof(response->buffer) && response->start > response->head_end) {
+        size_t pending = response->end - response->start;
+        memmove(response->buffer + response->head_end, response->buffer + response->start, pending);
+        response->start = response->head_end;
+        response->end = response->head_end + pending;
+    }
+    return HTTP_PARSE_MORE;
+}
+
+HttpParseResult http_response_commit(HttpResponse* response, size_t len) {
+    response->end += len;
+    return http_response_process(response);
+}
+
+HttpParseResult http_response_eof(HttpResponse* response) {
+    if (response->state == STATE_BODY_CLOSE) {
+        response->state = STATE_DONE;
+        return HTTP_PARSE_DONE;
+    }
+    if (response->state == STATE_DONE) {
+        return HTTP_PARSE_DONE;
+    }
+    if (response->state == STATE_ERROR) {
+        return HTTP_PARSE_ERROR;
+    }
+    return parse_fail(response, response->state == STATE_HEAD ? "헤더를 받기 전에 연결이 닫힘" : "본문 도중 연결이 닫힘");
+}
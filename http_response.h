@@ -0,0 +1,112 @@
+#ifndef HTTP_RESPONSE_H
+#define HTTP_RESPONSE_H
+
+// HTTP/1.x 응답 점진 파서 (클라이언트용)
+// - 호출자는 http_response_read_buffer()가 돌려준 자리에 바로 읽어 넣고(SSL_read 등) 읽은 길이를 commit 한다.
+//   상태 줄과 헤더는 그 버퍼 안에서 제자리로 파싱하므로 헤더 값은 복사 없는 뷰(포인터 + 길이)로 제공된다.
+// - 본문은 Content-Length, chunked, 연결 종료까지 세 가지 구분 방식을 모두 처리하고, 디코딩한 조각을
+//   버퍼에서 바로 싱크(HttpBodySink)로 넘긴다. 응답의 끝을 알 수 있으므로 연결을 재사용할 수 있다.
+// - 헤더 뷰는 http_response_reset()을 부르기 전까지 유효하다.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HTTP_RESPONSE_BUFFER_SIZE 16384     // 헤더 블록 최대 크기이자 한 번에 읽는 최대 크기
+#define HTTP_RESPONSE_MAX_HEADERS 64
+
+// 버퍼 안의 문자열 뷰 (NUL로 끝나지 않는다)
+typedef struct {
+    const char* data;
+    size_t len;
+} HttpSlice;
+
+typedef struct {
+    HttpSlice name;
+    HttpSlice value;
+} HttpHeaderView;
+
+// 본문 구분 방식
+typedef enum {
+    HTTP_BODY_NONE = 0,         // 본문 없음 (HEAD, 1xx/204/304)
+    HTTP_BODY_LENGTH,           // Content-Length
+    HTTP_BODY_CHUNKED,          // Transfer-Encoding: chunked
+    HTTP_BODY_UNTIL_CLOSE       // 서버가 연결을 닫을 때까지
+} HttpBodyFraming;
+
+typedef enum {
+    HTTP_PARSE_ERROR = -1,
+    HTTP_PARSE_MORE = 0,        // 더 읽어야 한다
+    HTTP_PARSE_DONE = 1         // 응답 하나가 끝났다 (남은 바이트는 다음 응답의 것)
+} HttpParseResult;
+
+typedef struct HttpResponse HttpResponse;
+
+// 본문 싱크: 헤더를 다 받았을 때 한 번 headers, 디코딩한 본문 조각마다 body (0이 아니면 파싱 중단).
+// 콜백은 NULL이어도 된다 (body가 NULL이면 본문은 세기만 하고 버린다)
+typedef struct {
+    void (*headers)(void* ctx, const HttpResponse* response);
+    int (*body)(void* ctx, const char* data, size_t len);
+    void* ctx;
+} HttpBodySink;
+
+struct HttpResponse {
+    // 파싱 결과 (헤더를 다 받은 뒤 유효)
+    int version_minor;          // HTTP/1.x의 x
+    int status;
+    HttpSlice reason;
+    HttpHeaderView headers[HTTP_RESPONSE_MAX_HEADERS];
+    int header_count;
+    HttpSlice head;             // 상태 줄부터 빈 줄까지의 원문
+    HttpBodyFraming framing;
+    int64_t content_length;     // Content-Length가 없으면 -1
+    int keep_alive;             // 응답 뒤 연결을 다시 쓸 수 있는지
+    uint64_t body_bytes;        // 디코딩한 본문 크기 (chunked 크기 줄 제외)
+    const char* error;          // HTTP_PARSE_ERROR일 때 이유
+
+    // 내부 상태
+    HttpBodySink sink;
+    int head_request;
+    int state;
+    uint64_t remaining;         // 현재 본문/청크에 남은 바이트
+    size_t head_end;            // 헤더 블록 끝 (본문 영역 시작)
+    size_t start;               // 아직 처리하지 않은 데이터
+    size_t end;                 // 받은 데이터 끝
+    size_t scanned;             // 헤더 끝 탐색 위치
+    char buffer[HTTP_RESPONSE_BUFFER_SIZE];
+};
+
+// 새 응답을 받을 준비 (head_request: HEAD 요청의 응답이면 본문이 없다). 처음 한 번만 부른다
+void http_response_init(HttpResponse* response, HttpBodySink sink, int head_request);
+
+// 같은 연결의 다음 응답 준비 (앞 응답 뒤에 받아 둔 바이트는 유지, 이전 헤더 뷰는 무효가 된다)
+void http_response_reset(HttpResponse* response, int head_request);
+
+// 다음에 읽어 넣을 자리와 크기
+char* http_response_read_buffer(HttpResponse* response, size_t* space);
+
+// read_buffer에 len바이트를 읽었다. 처리한 뒤의 상태를 돌려준다
+HttpParseResult http_response_commit(HttpResponse* response, size_t len);
+
+// 이미 받아 둔 바이트만으로 다시 처리 (reset 뒤, 다음 응답이 버퍼에 이미 있을 수 있다)
+HttpParseResult http_response_process(HttpResponse* response);
+
+// 서버가 연결을 닫았다. 연결 종료로 끝나는 본문이면 DONE, 응답 도중이면 ERROR
+HttpParseResult http_response_eof(HttpResponse* response);
+
+// 대소문자 구분 없이 헤더 찾기 (없으면 NULL)
+const HttpSlice* http_response_header(const HttpResponse* response, const char* name);
+
+// 뷰가 대소문자 구분 없이 token을 쉼표 목록 항목으로 포함하는지 (예: "Connection: keep-alive, Upgrade")
+int http_slice_has_token(const HttpSlice* slice, const char* token);
+
+const char* http_body_framing_name(HttpBodyFraming framing);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
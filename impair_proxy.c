@@ -0,0 +1,1038 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <errno.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+// 결정적 네트워크 장애 프록시 (TCP/UDP)
+// 127.0.0.1과 ::1에서 받아 같은 주소 계열의 upstream으로 전달하면서, 주소 계열별 프로파일에 따라
+// 지연, 지터, 대역폭 제한, 손실, 순서 바뀜을 넣는다. 루프백만으로 RTT와 손실이 있는 경로를 재현한다.
+//
+// - 무작위 결정은 (시드, 주소 계열, 연결 순번, 방향, 세그먼트 번호)로 정해지는 카운터 기반 난수라서
+//   read() 조각 크기나 다른 연결의 타이밍과 무관하게 같은 시드면 같은 패킷이 손실/지연된다.
+// - TCP는 바이트 스트림이라 실제로 버릴 수 없으므로, 손실은 재전송 한 번(1 RTT = 단방향 지연 x 2)만큼,
+//   순서 바뀜은 단방향 지연만큼 그 세그먼트를 늦추고 뒤 세그먼트도 기다리게 한다 (HOL 대기).
+// - UDP(QUIC)는 데이터그램을 실제로 버리고, 순서가 바뀐 데이터그램은 뒤 데이터그램이 앞지른다.
+// - 대역폭은 주소 계열마다 방향별 병목 링크 하나를 모든 연결이 나눠 쓴다.
+// - 클라이언트의 TCP 연결은 프록시가 바로 받으므로, 핸드셰이크 1 RTT는 첫 업로드 세그먼트에 더한다.
+
+#define DEFAULT_PORT 18444
+#define DEFAULT_UPSTREAM_PORT 18443
+#define DEFAULT_MSS 1448
+#define READ_CHUNK 16384
+#define BACKLOG_MAX (4 << 20)       // 방향별 지연 큐 + 쓰기 대기 최대 바이트 (넘으면 읽기 중단)
+#define UDP_DATAGRAM_MAX 65536
+#define UDP_IDLE_SEC 30.0
+#define MAX_EVENTS 64
+
+enum { FAMILY_V4 = 0, FAMILY_V6 = 1 };
+enum { DIR_UP = 0, DIR_DOWN = 1 };          // 클라이언트 -> upstream, upstream -> 클라이언트
+enum { REF_TCP_LISTEN, REF_UDP_LISTEN, REF_TCP_CONN, REF_UDP_UP };
+enum { EV_TCP_DATA, EV_TCP_EOF, EV_UDP };
+
+static const char* const FAMILY_NAMES[2] = { "IPv4", "IPv6" };
+
+typedef struct {
+    double delay_ms;            // 단방향 지연
+    double jitter_ms;           // ± 지터 (삼각 분포)
+    double rate_bps;            // 방향별 대역폭 (0이면 제한 없음)
+    double loss;                // 손실 확률 (0~1)
+    double reorder;             // 순서 바뀜 확률 (0~1)
+} ImpairProfile;
+
+typedef struct {
+    unsigned long tcp_connections;
+    unsigned long udp_sessions;
+    unsigned long long bytes[2];
+    unsigned long segments[2];
+    unsigned long lost[2];          // TCP: 재전송 지연, UDP: 버림
+    unsigned long reordered[2];
+} PathStats;
+
+// 주소 계열별 경로 (프로파일, 병목 링크, 통계)
+typedef struct {
+    ImpairProfile profile;
+    double free_at[2];              // 방향별 링크가 비는 시각 (초)
+    uint64_t next_ordinal;          // 연결/세션 순번
+    struct sockaddr_storage upstream;
+    socklen_t upstream_len;
+    PathStats stats;
+} FamilyPath;
+
+// epoll 등록 대상
+typedef struct {
+    int type;
+    int side;                       // TCP 연결: 0 = 클라이언트, 1 = upstream
+    void* owner;
+    int fd;
+    int family;
+} FdRef;
+
+typedef struct TcpConn TcpConn;
+
+// TCP 한 방향 (src에서 읽어 dst에 쓴다)
+typedef struct {
+    int src, dst;                   // FdRef side
+    uint64_t offset;                // 읽은 바이트 수 (세그먼트 번호 계산)
+    double last_due;                // 스트림 순서 보존
+    char* out;                      // 도착해서 쓰기를 기다리는 데이터
+    size_t out_len, out_cap;
+    size_t queued;                  // 지연 큐에 있는 바이트
+    int read_eof;
+    int eof_arrived;                // EOF 이벤트 도착 (out을 다 쓰면 shutdown)
+    int shut;
+} TcpDir;
+
+struct TcpConn {
+    FdRef refs[2];
+    uint32_t interest[2];
+    int hup[2];                     // 상대가 양방향을 닫아 epoll에서 뺀 fd
+    TcpDir dir[2];
+    FamilyPath* path;
+    uint64_t ordinal;
+    int connecting;
+    int dead;
+    int pending;                    // 힙에 남은 이벤트 수 (0이 되어야 해제)
+    TcpConn* next_dead;             // 닫힌 연결 목록 (이벤트 루프 한 바퀴가 끝난 뒤 해제)
+};
+
+typedef struct UdpSession {
+    FdRef up_ref;
+    struct sockaddr_storage client;
+    socklen_t client_len;
+    int listen_fd;
+    FamilyPath* path;
+    uint64_t ordinal;
+    uint64_t count[2];
+    double last_seen;
+    int pending;
+    struct UdpSession* next;
+} UdpSession;
+
+typedef struct {
+    double due;
+    uint64_t seq;
+    int kind;
+    int dir;
+    void* owner;
+    size_t len;
+    char data[];
+} Event;
+
+static FamilyPath g_paths[2];
+static uint64_t g_seed = 1;
+static size_t g_mss = DEFAULT_MSS;
+static int g_epoll = -1;
+static volatile sig_atomic_t g_stop = 0;
+
+static Event** g_heap = NULL;
+static size_t g_heap_len = 0, g_heap_cap = 0;
+static uint64_t g_event_seq = 0;
+static UdpSession* g_sessions = NULL;
+static TcpConn* g_dead_conns = NULL;
+
+static void handle_signal(int sig) {
+    (void)sig;
+    g_stop = 1;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// 카운터 기반 난수 (splitmix64): 같은 키면 언제 불러도 같은 값
+static uint64_t mix64(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+static double draw(uint64_t key, int slot) {
+    return (mix64(key ^ mix64((uint64_t)slot)) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static uint64_t packet_key(int family, uint64_t ordinal, int dir, uint64_t index) {
+    uint64_t key = mix64(g_seed);
+    key = mix64(key ^ ((uint64_t)family << 1 | (uint64_t)dir));
+    key = mix64(key ^ ordinal);
+    return mix64(key ^ index);
+}
+
+// 패킷(세그먼트/데이터그램) 하나의 도착 시각을 정한다
+// 반환값: 0 정상, 1 손실, 2 순서 바뀜 (*due에 도착 시각, UDP 손실이면 의미 없음)
+static int schedule_packet(FamilyPath* path, int family, uint64_t ordinal, int dir, uint64_t index,
+                           size_t len, int first_piece, double now, double* due) {
+    const ImpairProfile* p = &path->profile;
+    uint64_t key = packet_key(family, ordinal, dir, index);
+    double ready = now;
+
+    // 병목 링크 직렬화 (모든 연결이 공유)
+    if (p->rate_bps > 0) {
+        double start = path->free_at[dir] > now ? path->free_at[dir] : now;
+        path->free_at[dir] = start + (double)len * 8.0 / p->rate_bps;
+        ready = path->free_at[dir];
+    }
+
+    double jitter = p->jitter_ms > 0 ? (draw(key, 2) + draw(key, 3) - 1.0) * p->jitter_ms : 0.0;
+    double delay = p->delay_ms + jitter;
+    *due = ready + (delay > 0 ? delay : 0) / 1000.0;
+
+    // 세그먼트가 두 번의 read()에 나뉘면 첫 조각에서만 손실/순서 바뀜을 센다
+    if (!first_piece) {
+        return 0;
+    }
+    if (p->loss > 0 && draw(key, 0) < p->loss) {
+        return 1;
+    }
+    if (p->reorder > 0 && draw(key, 1) < p->reorder) {
+        return 2;
+    }
+    return 0;
+}
+
+// 이벤트를 힙에 넣는다 (실패하면 이벤트를 해제하고 -1)
+static int heap_push(Event* ev) {
+    if (g_heap_len == g_heap_cap) {
+        size_t cap = g_heap_cap ? g_heap_cap * 2 : 256;
+        Event** heap = realloc(g_heap, cap * sizeof(*heap));
+        if (!heap) {
+            free(ev);
+            return -1;
+        }
+        g_heap = heap;
+        g_heap_cap = cap;
+    }
+    ev->seq = g_event_seq++;
+    size_t i = g_heap_len++;
+    while (i > 0) {
+        size_t parent = (i - 1) / 2;
+        Event* p = g_heap[parent];
+        if (p->due < ev->due || (p->due == ev->due && p->seq < ev->seq)) {
+            break;
+        }
+        g_heap[i] = p;
+        i = parent;
+    }
+    g_heap[i] = ev;
+    return 0;
+}
+
+static Event* heap_pop(void) {
+    Event* top = g_heap[0];
+    Event* last = g_heap[--g_heap_len];
+    size_t i = 0;
+    for (;;) {
+        size_t child = i * 2 + 1;
+        if (child >= g_heap_len) {
+            break;
+        }
+        if (child + 1 < g_heap_len) {
+            Event* a = g_heap[child];
+            Event* b = g_heap[child + 1];
+            if (b->due < a->due || (b->due == a->due && b->seq < a->seq)) {
+                child++;
+            }
+        }
+        Event* c = g_heap[child];
+        if (last->due < c->due || (last->due == c->due && last->seq < c->seq)) {
+            break;
+        }
+        g_heap[i] = c;
+        i = child;
+    }
+    if (g_heap_len > 0) {
+        g_heap[i] = last;
+    }
+    return top;
+}
+
+static Event* new_event(int kind, void* owner, int dir, double due, const char* data, size_t len) {
+    Event* ev = malloc(sizeof(Event) + len);
+    if (!ev) {
+        return NULL;
+    }
+    ev->kind = kind;
+    ev->owner = owner;
+    ev->dir = dir;
+    ev->due = due;
+    ev->len = len;
+    if (len > 0) {
+        memcpy(ev->data, data, len);
+    }
+    return ev;
+}
+
+// ---- TCP ----
+
+// 닫힌 연결은 바로 해제하지 않고 목록에 모은다. 같은 epoll_wait 묶음의 뒤 이벤트가
+// 이 연결의 FdRef를 가리킬 수 있으므로, 이벤트 처리와 힙 전달이 모두 끝난 뒤 tcp_reap()에서 해제한다
+static void tcp_kill(TcpConn* conn) {
+    if (conn->dead) {
+        return;
+    }
+    conn->dead = 1;
+    for (int side = 0; side < 2; side++) {
+        if (conn->refs[side].fd >= 0) {
+            epoll_ctl(g_epoll, EPOLL_CTL_DEL, conn->refs[side].fd, NULL);
+            close(conn->refs[side].fd);
+            conn->refs[side].fd = -1;
+        }
+    }
+    conn->next_dead = g_dead_conns;
+    g_dead_conns = conn;
+}
+
+// 힙에 이벤트가 남지 않은 닫힌 연결 해제 (남았으면 다음 바퀴에)
+static void tcp_reap(void) {
+    TcpConn** link = &g_dead_conns;
+    while (*link) {
+        TcpConn* conn = *link;
+        if (conn->pending == 0) {
+            *link = conn->next_dead;
+            free(conn->dir[0].out);
+            free(conn->dir[1].out);
+            free(conn);
+        } else {
+            link = &conn->next_dead;
+        }
+    }
+}
+
+// 두 fd의 epoll 관심 이벤트를 현재 상태에 맞춘다
+static void tcp_update_interest(TcpConn* conn) {
+    for (int side = 0; side < 2; side++) {
+        if (conn->hup[side]) {
+            continue;
+        }
+        uint32_t want = 0;
+        if (conn->connecting) {
+            want = side == 1 ? EPOLLOUT : 0;
+        } else {
+            // side에서 읽는 방향과 side에 쓰는 방향
+            const TcpDir* reader = &conn->dir[side == 0 ? DIR_UP : DIR_DOWN];
+            const TcpDir* writer = &conn->dir[side == 0 ? DIR_DOWN : DIR_UP];
+            if (!reader->read_eof && reader->queued + reader->out_len < BACKLOG_MAX) {
+                want |= EPOLLIN;
+            }
+            if (writer->out_len > 0) {
+                want |= EPOLLOUT;
+            }
+        }
+        if (want != conn->interest[side]) {
+            struct epoll_event ev = { .events = want, .data.ptr = &conn->refs[side] };
+            epoll_ctl(g_epoll, EPOLL_CTL_MOD, conn->refs[side].fd, &ev);
+            conn->interest[side] = want;
+        }
+    }
+}
+
+// 도착한 데이터를 dst에 쓴다 (다 쓰고 EOF가 도착했으면 shutdown)
+static int tcp_flush(TcpConn* conn, TcpDir* d) {
+    int fd = conn->refs[d->dst].fd;
+    size_t written = 0;
+    while (written < d->out_len) {
+        ssize_t n = send(fd, d->out + written, d->out_len - written, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        written += (size_t)n;
+    }
+    memmove(d->out, d->out + written, d->out_len - written);
+    d->out_len -= written;
+    if (d->out_len == 0 && d->eof_arrived && !d->shut) {
+        shutdown(fd, SHUT_WR);
+        d->shut = 1;
+    }
+    return 0;
+}
+
+// 양방향을 모두 닫았으면 연결을 닫는다 (닫았으면 1)
+static int tcp_check_closed(TcpConn* conn) {
+    if (conn->dir[DIR_UP].shut && conn->dir[DIR_DOWN].shut) {
+        tcp_kill(conn);
+        return 1;
+    }
+    return 0;
+}
+
+// src에서 읽은 데이터를 세그먼트로 나눠 지연 큐에 넣는다
+static void tcp_enqueue(TcpConn* conn, int dir, const char* data, size_t len, double now) {
+    TcpDir* d = &conn->dir[dir];
+    FamilyPath* path = conn->path;
+    int family = (int)(path - g_paths);
+    const ImpairProfile* p = &path->profile;
+
+    while (len > 0) {
+        uint64_t index = d->offset / g_mss;
+        size_t in_segment = (size_t)(d->offset % g_mss);
+        size_t piece = g_mss - in_segment < len ? g_mss - in_segment : len;
+        double due;
+        int fate = schedule_packet(path, family, conn->ordinal, dir, index, piece, in_segment == 0, now, &due);
+        if (in_segment == 0) {
+            path->stats.segments[dir]++;
+        }
+        double rtt = 2.0 * p->delay_ms;
+        if (dir == DIR_UP && d->offset == 0) {
+            // 프록시가 대신 받은 TCP 핸드셰이크
+            due += rtt / 1000.0;
+        }
+        if (fate == 1) {
+            // 빠른 재전송 한 번 (1 RTT)
+            due += (rtt > 1.0 ? rtt : 1.0) / 1000.0;
+            path->stats.lost[dir]++;
+        } else if (fate == 2) {
+            due += (p->delay_ms > 1.0 ? p->delay_ms : 1.0) / 1000.0;
+            path->stats.reordered[dir]++;
+        }
+        // 바이트 스트림이므로 앞 세그먼트보다 먼저 도착하지 않는다
+        if (due < d->last_due) {
+            due = d->last_due;
+        }
+        d->last_due = due;
+
+        Event* ev = new_event(EV_TCP_DATA, conn, dir, due, data, piece);
+        if (ev && heap_push(ev) == 0) {
+            conn->pending++;
+            d->queued += piece;
+        }
+        path->stats.bytes[dir] += piece;
+        d->offset += piece;
+        data += piece;
+        len -= piece;
+    }
+}
+
+static void tcp_read(TcpConn* conn, int side) {
+    int dir = side == 0 ? DIR_UP : DIR_DOWN;
+    TcpDir* d = &conn->dir[dir];
+    char buf[READ_CHUNK];
+    ssize_t n = recv(conn->refs[side].fd, buf, sizeof(buf), 0);
+    if (n < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            tcp_kill(conn);
+        }
+        return;
+    }
+    double now = now_seconds();
+    if (n == 0) {
+        // EOF도 마지막 데이터 뒤에 도착하게 한다
+        d->read_eof = 1;
+        Event* ev = new_event(EV_TCP_EOF, conn, dir, d->last_due > now ? d->last_due : now, NULL, 0);
+        if (ev && heap_push(ev) == 0) {
+            conn->pending++;
+        }
+        return;
+    }
+    tcp_enqueue(conn, dir, buf, (size_t)n, now);
+}
+
+static void tcp_event(Event* ev) {
+    TcpConn* conn = ev->owner;
+    conn->pending--;
+    if (conn->dead) {
+        return;
+    }
+    TcpDir* d = &conn->dir[ev->dir];
+    if (ev->kind == EV_TCP_DATA) {
+        d->queued -= ev->len;
+        if (d->out_len + ev->len > d->out_cap) {
+            size_t cap = d->out_cap ? d->out_cap : READ_CHUNK;
+            while (cap < d->out_len + ev->len) {
+                cap *= 2;
+            }
+            char* out = realloc(d->out, cap);
+            if (!out) {
+                tcp_kill(conn);
+                return;
+            }
+            d->out = out;
+            d->out_cap = cap;
+        }
+        memcpy(d->out + d->out_len, ev->data, ev->len);
+        d->out_len += ev->len;
+    } else {
+        d->eof_arrived = 1;
+    }
+    if (tcp_flush(conn, d) != 0) {
+        tcp_kill(conn);
+        return;
+    }
+    if (tcp_check_closed(conn)) {
+        return;
+    }
+    tcp_update_interest(conn);
+}
+
+static void tcp_accept(int listen_fd, int family) {
+    FamilyPath* path = &g_paths[family];
+    int client = accept4(listen_fd, NULL, NULL, SOCK_NONBLOCK);
+    if (client < 0) {
+        return;
+    }
+    int upstream = socket(path->upstream.ss_family, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    if (upstream < 0) {
+        close(client);
+        return;
+    }
+    int one = 1;
+    setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    setsockopt(upstream, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    if (connect(upstream, (struct sockaddr*)&path->upstream, path->upstream_len) != 0 && errno != EINPROGRESS) {
+        perror("upstream 연결 실패");
+        close(client);
+        close(upstream);
+        return;
+    }
+
+    TcpConn* conn = calloc(1, sizeof(*conn));
+    if (!conn) {
+        close(client);
+        close(upstream);
+        return;
+    }
+    conn->path = path;
+    conn->ordinal = path->next_ordinal++;
+    conn->connecting = 1;
+    conn->dir[DIR_UP].src = 0;
+    conn->dir[DIR_UP].dst = 1;
+    conn->dir[DIR_DOWN].src = 1;
+    conn->dir[DIR_DOWN].dst = 0;
+    int fds[2] = { client, upstream };
+    for (int side = 0; side < 2; side++) {
+        conn->refs[side] = (FdRef){ REF_TCP_CONN, side, conn, fds[side], family };
+        conn->interest[side] = side == 1 ? EPOLLOUT : 0;
+        struct epoll_event ev = { .events = conn->interest[side], .data.ptr = &conn->refs[side] };
+        epoll_ctl(g_epoll, EPOLL_CTL_ADD, fds[side], &ev);
+    }
+    path->stats.tcp_connections++;
+}
+
+static void tcp_ready(FdRef* ref, uint32_t events) {
+    TcpConn* conn = ref->owner;
+    if (conn->dead) {
+        return;
+    }
+    if (events & EPOLLERR) {
+        tcp_kill(conn);
+        return;
+    }
+    if (conn->connecting) {
+        if (ref->side == 0) {
+            // 연결 중에 클라이언트가 끊음
+            if (events & EPOLLHUP) {
+                tcp_kill(conn);
+            }
+            return;
+        }
+        int err = 0;
+        socklen_t len = sizeof(err);
+        getsockopt(ref->fd, SOL_SOCKET, SO_ERROR, &err, &len);
+        if (err != 0) {
+            fprintf(stderr, "upstream 연결 실패: %s\n", strerror(err));
+            tcp_kill(conn);
+            return;
+        }
+        conn->connecting = 0;
+        tcp_update_interest(conn);
+        return;
+    }
+    TcpDir* reader = &conn->dir[ref->side == 0 ? DIR_UP : DIR_DOWN];
+    if ((events & (EPOLLIN | EPOLLHUP)) && !reader->read_eof) {
+        tcp_read(conn, ref->side);
+    } else if (events & EPOLLHUP) {
+        // 이미 EOF를 읽었고 상대가 완전히 닫았으므로 이 fd로는 더 보낼 수 없다
+        TcpDir* writer = &conn->dir[ref->side == 0 ? DIR_DOWN : DIR_UP];
+        writer->out_len = 0;
+        writer->shut = 1;
+        conn->hup[ref->side] = 1;
+        epoll_ctl(g_epoll, EPOLL_CTL_DEL, ref->fd, NULL);
+        tcp_check_closed(conn);
+        return;
+    }
+    if (!conn->dead && (events & EPOLLOUT)) {
+        TcpDir* d = &conn->dir[ref->side == 0 ? DIR_DOWN : DIR_UP];
+        if (tcp_flush(conn, d) != 0) {
+            tcp_kill(conn);
+            return;
+        }
+        if (tcp_check_closed(conn)) {
+            return;
+        }
+    }
+    if (!conn->dead) {
+        tcp_update_interest(conn);
+    }
+}
+
+// ---- UDP ----
+
+static UdpSession* udp_session(int listen_fd, int family, const struct sockaddr_storage* client, socklen_t client_len) {
+    for (UdpSession* s = g_sessions; s; s = s->next) {
+        if (s->listen_fd == listen_fd && s->client_len == client_len && memcmp(&s->client, client, client_len) == 0) {
+            return s;
+        }
+    }
+
+    FamilyPath* path = &g_paths[family];
+    int up = socket(path->upstream.ss_family, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+    if (up < 0) {
+        return NULL;
+    }
+    if (connect(up, (struct sockaddr*)&path->upstream, path->upstream_len) != 0) {
+        close(up);
+        return NULL;
+    }
+    UdpSession* s = calloc(1, sizeof(*s));
+    if (!s) {
+        close(up);
+        return NULL;
+    }
+    memcpy(&s->client, client, client_len);
+    s->client_len = client_len;
+    s->listen_fd = listen_fd;
+    s->path = path;
+    s->ordinal = path->next_ordinal++;
+    s->up_ref = (FdRef){ REF_UDP_UP, 1, s, up, family };
+    struct epoll_event ev = { .events = EPOLLIN, .data.ptr = &s->up_ref };
+    epoll_ctl(g_epoll, EPOLL_CTL_ADD, up, &ev);
+    s->next = g_sessions;
+    g_sessions = s;
+    path->stats.udp_sessions++;
+    return s;
+}
+
+static void udp_enqueue(UdpSession* s, int dir, const char* data, size_t len, double now) {
+    FamilyPath* path = s->path;
+    int family = (int)(path - g_paths);
+    double due;
+    int fate = schedule_packet(path, family, s->ordinal, dir, s->count[dir]++, len, 1, now, &due);
+
+    s->last_seen = now;
+    path->stats.segments[dir]++;
+    path->stats.bytes[dir] += len;
+    if (fate == 1) {
+        path->stats.lost[dir]++;
+        return;
+    }
+    if (fate == 2) {
+        // 뒤 데이터그램이 앞지르도록 단방향 지연만큼 더 늦춘다
+        double extra = path->profile.delay_ms > 1.0 ? path->profile.delay_ms : 1.0;
+        due += extra / 1000.0;
+        path->stats.reordered[dir]++;
+    }
+    Event* ev = new_event(EV_UDP, s, dir, due, data, len);
+    if (ev && heap_push(ev) == 0) {
+        s->pending++;
+    }
+}
+
+static void udp_listen_ready(FdRef* ref) {
+    char buf[UDP_DATAGRAM_MAX];
+    for (;;) {
+        struct sockaddr_storage client;
+        socklen_t client_len = sizeof(client);
+        ssize_t n = recvfrom(ref->fd, buf, sizeof(buf), 0, (struct sockaddr*)&client, &client_len);
+        if (n < 0) {
+            return;
+        }
+        UdpSession* s = udp_session(ref->fd, ref->family, &client, client_len);
+        if (s) {
+            udp_enqueue(s, DIR_UP, buf, (size_t)n, now_seconds());
+        }
+    }
+}
+
+static void udp_upstream_ready(FdRef* ref) {
+    UdpSession* s = ref->owner;
+    char buf[UDP_DATAGRAM_MAX];
+    for (;;) {
+        ssize_t n = recv(ref->fd, buf, sizeof(buf), 0);
+        if (n < 0) {
+            return;
+        }
+        udp_enqueue(s, DIR_DOWN, buf, (size_t)n, now_seconds());
+    }
+}
+
+static void udp_event(Event* ev) {
+    UdpSession* s = ev->owner;
+    s->pending--;
+    if (ev->dir == DIR_UP) {
+        send(s->up_ref.fd, ev->data, ev->len, 0);
+    } else {
+        sendto(s->listen_fd, ev->data, ev->len, 0, (struct sockaddr*)&s->client, s->client_len);
+    }
+}
+
+// 오래 쓰지 않은 UDP 세션 정리 (힙에 이벤트가 남아 있으면 다음에)
+static void udp_expire(double now) {
+    UdpSession** link = &g_sessions;
+    while (*link) {
+        UdpSession* s = *link;
+        if (s->pending == 0 && now - s->last_seen > UDP_IDLE_SEC) {
+            *link = s->next;
+            epoll_ctl(g_epoll, EPOLL_CTL_DEL, s->up_ref.fd, NULL);
+            close(s->up_ref.fd);
+            free(s);
+        } else {
+            link = &s->next;
+        }
+    }
+}
+
+// ---- 설정 ----
+
+// 시간 값 (ms, 단위 ms/s/us 허용)
+static int parse_ms(const char* value, double* out) {
+    char* end;
+    double v = strtod(value, &end);
+    if (end == value || v < 0) {
+        return -1;
+    }
+    if (*end == 0 || strcmp(end, "ms") == 0) {
+        *out = v;
+    } else if (strcmp(end, "s") == 0) {
+        *out = v * 1000.0;
+    } else if (strcmp(end, "us") == 0) {
+        *out = v / 1000.0;
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+// 대역폭 (bit/s, k/m/g 접두어와 bit/bps 허용: 10mbit, 512kbit, 1g)
+static int parse_rate(const char* value, double* out) {
+    char* end;
+    double v = strtod(value, &end);
+    if (end == value || v < 0) {
+        return -1;
+    }
+    double scale = 1.0;
+    if (*end == 'k' || *end == 'K') {
+        scale = 1e3;
+        end++;
+    } else if (*end == 'm' || *end == 'M') {
+        scale = 1e6;
+        end++;
+    } else if (*end == 'g' || *end == 'G') {
+        scale = 1e9;
+        end++;
+    }
+    if (*end != 0 && strcmp(end, "bit") != 0 && strcmp(end, "bps") != 0) {
+        return -1;
+    }
+    *out = v * scale;
+    return 0;
+}
+
+// 확률 (1%, 0.01)
+static int parse_probability(const char* value, double* out) {
+    char* end;
+    double v = strtod(value, &end);
+    if (end == value || v < 0) {
+        return -1;
+    }
+    if (*end == '%' && end[1] == 0) {
+        v /= 100.0;
+    } else if (*end != 0) {
+        return -1;
+    }
+    if (v > 1.0) {
+        return -1;
+    }
+    *out = v;
+    return 0;
+}
+
+// 프로파일 문자열: delay=25ms,jitter=5ms,rate=20mbit,loss=1%,reorder=0.5%
+static int parse_profile(const char* spec, ImpairProfile* profile) {
+    char copy[512];
+    snprintf(copy, sizeof(copy), "%s", spec);
+    char* save = NULL;
+    for (char* token = strtok_r(copy, ",", &save); token; token = strtok_r(NULL, ",", &save)) {
+        char* eq = strchr(token, '=');
+        if (!eq) {
+            fprintf(stderr, "잘못된 프로파일 항목: %s\n", token);
+            return -1;
+        }
+        *eq = 0;
+        const char* value = eq + 1;
+        int rc;
+        if (strcmp(token, "delay") == 0) {
+            rc = parse_ms(value, &profile->delay_ms);
+        } else if (strcmp(token, "jitter") == 0) {
+            rc = parse_ms(value, &profile->jitter_ms);
+        } else if (strcmp(token, "rate") == 0) {
+            rc = parse_rate(value, &profile->rate_bps);
+        } else if (strcmp(token, "loss") == 0) {
+            rc = parse_probability(value, &profile->loss);
+        } else if (strcmp(token, "reorder") == 0) {
+            rc = parse_probability(value, &profile->reorder);
+        } else {
+            fprintf(stderr, "알 수 없는 프로파일 항목: %s\n", token);
+            return -1;
+        }
+        if (rc != 0) {
+            fprintf(stderr, "잘못된 값: %s=%s\n", token, value);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static void print_profile(const char* label, const ImpairProfile* p) {
+    printf("  %s: 지연 %.1fms ± %.1fms, 대역폭 ", label, p->delay_ms, p->jitter_ms);
+    if (p->rate_bps > 0) {
+        printf("%.3gMbit/s", p->rate_bps / 1e6);
+    } else {
+        printf("제한 없음");
+    }
+    printf(", 손실 %.2f%%, 순서 바뀜 %.2f%%\n", p->loss * 100.0, p->reorder * 100.0);
+}
+
+static int set_upstream(FamilyPath* path, int family, const char* addr, int port) {
+    memset(&path->upstream, 0, sizeof(path->upstream));
+    if (family == FAMILY_V4) {
+        struct sockaddr_in* sin = (struct sockaddr_in*)&path->upstream;
+        sin->sin_family = AF_INET;
+        sin->sin_port = htons(port);
+        path->upstream_len = sizeof(*sin);
+        return inet_pton(AF_INET, addr, &sin->sin_addr) == 1 ? 0 : -1;
+    }
+    struct sockaddr_in6* sin6 = (struct sockaddr_in6*)&path->upstream;
+    sin6->sin6_family = AF_INET6;
+    sin6->sin6_port = htons(port);
+    path->upstream_len = sizeof(*sin6);
+    return inet_pton(AF_INET6, addr, &sin6->sin6_addr) == 1 ? 0 : -1;
+}
+
+// 루프백 리스닝 소켓 (TCP 또는 UDP, 실패하면 -1)
+static int open_listener(int family, int type, int port) {
+    int fd = socket(family == FAMILY_V4 ? AF_INET : AF_INET6, type | SOCK_NONBLOCK, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    int rc;
+    if (family == FAMILY_V6) {
+        setsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, &one, sizeof(one));
+        struct sockaddr_in6 addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin6_family = AF_INET6;
+        addr.sin6_addr = in6addr_loopback;
+        addr.sin6_port = htons(port);
+        rc = bind(fd, (struct sockaddr*)&addr, sizeof(addr));
+    } else {
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(port);
+        rc = bind(fd, (struct sockaddr*)&addr, sizeof(addr));
+    }
+    if (rc != 0 || (type == SOCK_STREAM && listen(fd, 128) != 0)) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void print_stats(void) {
+    printf("\n=== 장애 프록시 통계 (시드 %llu) ===\n", (unsigned long long)g_seed);
+    for (int f = 0; f < 2; f++) {
+        const PathStats* st = &g_paths[f].stats;
+        if (st->tcp_connections == 0 && st->udp_sessions == 0) {
+            continue;
+        }
+        printf("%s: TCP 연결 %lu개, UDP 세션 %lu개\n", FAMILY_NAMES[f], st->tcp_connections, st->udp_sessions);
+        for (int dir = 0; dir < 2; dir++) {
+            printf("  %s: %llu바이트, 패킷 %lu개, 손실 %lu, 순서 바뀜 %lu\n",
+                   dir == DIR_UP ? "업로드" : "다운로드", st->bytes[dir], st->segments[dir],
+                   st->lost[dir], st->reordered[dir]);
+        }
+    }
+}
+
+static void print_usage(const char* program) {
+    printf("사용법: %s [--port N] [--to PORT] [--v4 SPEC] [--v6 SPEC] [--all SPEC] [--seed N] [옵션]\n", program);
+    printf("  --port N          수신 포트 (127.0.0.1, ::1의 TCP/UDP, 기본값 %d)\n", DEFAULT_PORT);
+    printf("  --to PORT         upstream 포트 (같은 주소 계열의 루프백, 기본값 %d)\n", DEFAULT_UPSTREAM_PORT);
+    printf("  --upstream4 ADDR  IPv4 upstream 주소 (기본값 127.0.0.1)\n");
+    printf("  --upstream6 ADDR  IPv6 upstream 주소 (기본값 ::1)\n");
+    printf("  --v4 SPEC         IPv4 경로 프로파일\n");
+    printf("  --v6 SPEC         IPv6 경로 프로파일\n");
+    printf("  --all SPEC        두 경로 공통 프로파일 (--v4/--v6가 덮어씀)\n");
+    printf("  --seed N          난수 시드 (기본값 1, 같은 시드면 같은 패킷이 손실/지연)\n");
+    printf("  --mss N           TCP 세그먼트 크기 (기본값 %d)\n", DEFAULT_MSS);
+    printf("  --no-udp          UDP 전달 끔\n");
+    printf("\n");
+    printf("SPEC: delay=25ms,jitter=5ms,rate=20mbit,loss=1%%,reorder=0.5%%\n");
+    printf("  delay   단방향 지연 (방향마다 적용, RTT는 두 배)\n");
+    printf("  jitter  ± 지터\n");
+    printf("  rate    방향별 대역폭 (주소 계열마다 모든 연결이 공유)\n");
+    printf("  loss    손실 확률 (TCP는 1 RTT 재전송 지연, UDP는 버림)\n");
+    printf("  reorder 순서 바뀜 확률 (단방향 지연만큼 추가 지연)\n");
+}
+
+int main(int argc, char* argv[]) {
+    int port = DEFAULT_PORT;
+    int upstream_port = DEFAULT_UPSTREAM_PORT;
+    const char* upstream_addr[2] = { "127.0.0.1", "::1" };
+    const char* spec_all = NULL;
+    const char* spec[2] = { NULL, NULL };
+    int udp = 1;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--port") == 0 && i + 1 < argc) {
+            port = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--to") == 0 && i + 1 < argc) {
+            upstream_port = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--upstream4") == 0 && i + 1 < argc) {
+            upstream_addr[FAMILY_V4] = argv[++i];
+        } else if (strcmp(argv[i], "--upstream6") == 0 && i + 1 < argc) {
+            upstream_addr[FAMILY_V6] = argv[++i];
+        } else if (strcmp(argv[i], "--v4") == 0 && i + 1 < argc) {
+            spec[FAMILY_V4] = argv[++i];
+        } else if (strcmp(argv[i], "--v6") == 0 && i + 1 < argc) {
+            spec[FAMILY_V6] = argv[++i];
+        } else if (strcmp(argv[i], "--all") == 0 && i + 1 < argc) {
+            spec_all = argv[++i];
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            g_seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--mss") == 0 && i + 1 < argc) {
+            g_mss = (size_t)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--no-udp") == 0) {
+            udp = 0;
+        } else {
+            print_usage(argv[0]);
+            return strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+    if (port < 1 || port > 65535 || upstream_port < 1 || upstream_port > 65535) {
+        fprintf(stderr, "포트는 1~65535이어야 합니다.\n");
+        return 1;
+    }
+    if (g_mss < 64 || g_mss > 65535) {
+        fprintf(stderr, "MSS는 64~65535이어야 합니다.\n");
+        return 1;
+    }
+    for (int f = 0; f < 2; f++) {
+        if ((spec_all && parse_profile(spec_all, &g_paths[f].profile) != 0) ||
+            (spec[f] && parse_profile(spec[f], &g_paths[f].profile) != 0)) {
+            return 1;
+        }
+        if (set_upstream(&g_paths[f], f, upstream_addr[f], upstream_port) != 0) {
+            fprintf(stderr, "잘못된 upstream 주소: %s\n", upstream_addr[f]);
+            return 1;
+        }
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = handle_signal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    g_epoll = epoll_create1(0);
+    if (g_epoll < 0) {
+        perror("epoll_create1");
+        return 1;
+    }
+
+    // 리스너: [계열][TCP, UDP]
+    static FdRef listeners[2][2];
+    for (int f = 0; f < 2; f++) {
+        for (int t = 0; t < (udp ? 2 : 1); t++) {
+            int fd = open_listener(f, t == 0 ? SOCK_STREAM : SOCK_DGRAM, port);
+            if (fd < 0) {
+                fprintf(stderr, "%s %s 바인드 실패: %s\n", FAMILY_NAMES[f], t == 0 ? "TCP" : "UDP", strerror(errno));
+                if (f == FAMILY_V4) {
+                    return 1;
+                }
+                continue;
+            }
+            listeners[f][t] = (FdRef){ t == 0 ? REF_TCP_LISTEN : REF_UDP_LISTEN, 0, NULL, fd, f };
+            struct epoll_event ev = { .events = EPOLLIN, .data.ptr = &listeners[f][t] };
+            epoll_ctl(g_epoll, EPOLL_CTL_ADD, fd, &ev);
+        }
+    }
+
+    printf("장애 프록시 시작: 127.0.0.1:%d, [::1]:%d (%s) -> upstream 포트 %d, 시드 %llu\n",
+           port, port, udp ? "TCP/UDP" : "TCP", upstream_port, (unsigned long long)g_seed);
+    print_profile("IPv4", &g_paths[FAMILY_V4].profile);
+    print_profile("IPv6", &g_paths[FAMILY_V6].profile);
+    fflush(stdout);
+
+    struct epoll_event events[MAX_EVENTS];
+    double last_expire = now_seconds();
+    while (!g_stop) {
+        // 가장 이른 전달 시각까지 대기 (ms 단위로 올림)
+        int timeout = 1000;
+        if (g_heap_len > 0) {
+            double wait = g_heap[0]->due - now_seconds();
+            timeout = wait <= 0 ? 0 : (int)(wait * 1000.0 + 0.999);
+            if (timeout > 1000) {
+                timeout = 1000;
+            }
+        }
+        int n = epoll_wait(g_epoll, events, MAX_EVENTS, timeout);
+        for (int i = 0; i < n; i++) {
+            FdRef* ref = events[i].data.ptr;
+            switch (ref->type) {
+                case REF_TCP_LISTEN:
+                    tcp_accept(ref->fd, ref->family);
+                    break;
+                case REF_UDP_LISTEN:
+                    udp_listen_ready(ref);
+                    break;
+                case REF_TCP_CONN:
+                    tcp_ready(ref, events[i].events);
+                    break;
+                case REF_UDP_UP:
+                    udp_upstream_ready(ref);
+                    break;
+            }
+        }
+
+        // 도착 시각이 된 패킷 전달
+        double now = now_seconds();
+        while (g_heap_len > 0 && g_heap[0]->due <= now) {
+            Event* ev = heap_pop();
+            if (ev->kind == EV_UDP) {
+                udp_event(ev);
+            } else {
+                tcp_event(ev);
+            }
+            free(ev);
+        }
+        tcp_reap();
+        if (now - last_expire > 1.0) {
+            udp_expire(now);
+            last_expire = now;
+        }
+    }
+
+    print_stats();
+    return 0;
+}
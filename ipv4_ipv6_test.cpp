@@ -2,248 +2,69 @@
 #include <stdlib.h>
 #include <string.h>
 #include <curl/curl.h>
-#include <time.h>
-#include <unistd.h>
+#include "trace_log.h"
+#include "curl_result.h"
+#include "curl_callbacks.h"
+#include "curl_harness.h"
+#include "curl_altsvc.h"
+#include "probe_monitor.h"
+#include "curl_async.h"
+#include <sys/resource.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
 
-// 응답 데이터 구조체
-typedef struct {
-    char* data;
-    long response_code;
-    double total_time;
-    char* ip_version;
-    char* resolved_ip;
-    int success;
-} ResponseData;
+// 구조화 결과 출력 (RESULT_FORMAT 환경 변수로 활성화)
+static ResultWriter* g_result_writer = NULL;
 
-// libcurl 콜백 함수 - 응답 데이터를 받아서 저장
-size_t WriteCallback(void* contents, size_t size, size_t nmemb, char** userp) {
-    size_t realsize = size * nmemb;
-    char* ptr = (char*)realloc(*userp, realsize + 1);
-    
-    if (ptr == NULL) {
-        return 0;
-    }
-    
-    *userp = ptr;
-    memcpy(*userp + strlen(*userp), contents, realsize);
-    (*userp)[strlen(*userp) + realsize] = 0;
-    
-    return realsize;
-}
+// 정규화 JSON 비교에서 기본으로 뺄 키 (요청마다, 주소 계열마다 달라지는 값)
+static const char* const DEFAULT_COMPARE_IGNORE = "origin,ip,X-Amzn-Trace-Id";
 
-// libcurl 디버그 콜백 함수
-int DebugCallback(CURL* handle, curl_infotype type, char* data, size_t size, void* userptr) {
-    const char* type_str = "";
-    
-    switch (type) {
-        case CURLINFO_TEXT:
-            type_str = "TEXT";
-            break;
-        case CURLINFO_HEADER_IN:
-            type_str = "HEADER_IN";
-            break;
-        case CURLINFO_HEADER_OUT:
-            type_str = "HEADER_OUT";
-            break;
-        case CURLINFO_DATA_IN:
-            type_str = "DATA_IN";
-            break;
-        case CURLINFO_DATA_OUT:
-            type_str = "DATA_OUT";
-            break;
-        case CURLINFO_SSL_DATA_IN:
-            type_str = "SSL_DATA_IN";
-            break;
-        case CURLINFO_SSL_DATA_OUT:
-            type_str = "SSL_DATA_OUT";
-            break;
-        default:
-            type_str = "UNKNOWN";
-            break;
-    }
-    
-    // 데이터를 문자열로 변환 (null 종료)
-    char* str_data = (char*)malloc(size + 1);
-    memcpy(str_data, data, size);
-    str_data[size] = '\0';
-    
-    // 개행 문자 제거
-    if (str_data[size-1] == '\n') {
-        str_data[size-1] = '\0';
+// 요청 한 건의 결과를 구조화 레코드로 출력 (curl 핸들 정리 전에 호출)
+void emitRequestResult(CURL* curl, const char* url, const char* ip_version, CURLcode res, const ResponseData* response) {
+    if (!result_writer_structured(g_result_writer)) {
+        return;
     }
     
-    printf("[DEBUG][%s] %s\n", type_str, str_data);
-    
-    free(str_data);
-    return 0;
-}
-
-// 문자열 복사 함수
-char* strdup_safe(const char* str) {
-    if (!str) return NULL;
-    size_t len = strlen(str);
-    char* new_str = (char*)malloc(len + 1);
-    if (new_str) {
-        strcpy(new_str, str);
-    }
-    return new_str;
-}
-
-// ResponseData 초기화 함수
-ResponseData initResponseData(const char* ip_version) {
-    ResponseData result;
-    result.data = (char*)malloc(1);
-    if (result.data) {
-        result.data[0] = 0;
-    }
-    result.response_code = 0;
-    result.total_time = 0.0;
-    result.ip_version = strdup_safe(ip_version);
-    result.resolved_ip = NULL;
-    result.success = 0;
-    return result;
-}
-
-// ResponseData 정리 함수
-void cleanupResponseData(ResponseData* data) {
-    if (data) {
-        if (data->data) {
-            free(data->data);
-            data->data = NULL;
-        }
-        if (data->ip_version) {
-            free(data->ip_version);
-            data->ip_version = NULL;
-        }
-        if (data->resolved_ip) {
-            free(data->resolved_ip);
-            data->resolved_ip = NULL;
-        }
+    char body_hash[32];
+    content_hash_format(&response->hash, body_hash, sizeof(body_hash));
+    TestResult record;
+    result_init(&record, "ipv4_ipv6_test", "request");
+    record.target = url;
+    record.method = "GET";
+    record.ip_version = ip_version;
+    record.body_hash = res == CURLE_OK ? body_hash : NULL;
+    result_fill_from_curl(&record, curl);
+    record.success = res == CURLE_OK;
+    if (res != CURLE_OK) {
+        record.error = curl_easy_strerror(res);
     }
+    result_emit(g_result_writer, &record);
 }
 
-// HTTP 요청을 수행하는 함수
-ResponseData performRequest(const char* url, const char* ip_version, int verbose) {
-    ResponseData result = initResponseData(ip_version);
-    
-    CURL* curl = curl_easy_init();
-    if (!curl) {
-        fprintf(stderr, "libcurl 초기화 실패!\n");
-        return result;
-    }
-    
-    // libcurl 옵션 설정
-    curl_easy_setopt(curl, CURLOPT_URL, url);
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &result.data);
-    curl_easy_setopt(curl, CURLOPT_USERAGENT, "ipv4-ipv6-test/1.0");
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 30L);
-    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 10L);
-    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
-    
-    // IP 버전에 따른 설정
+// 경로 하나의 요청 (ip_version: "default", "IPv4", "IPv6")
+// 멀티 핸들은 연결을 재사용하므로 요청마다 새 연결을 열어 연결/TLS 시간을 매번 잰다
+curl_async::Task<curl_async::Response> fetch(curl_async::Client& client, const char* url, const char* ip_version) {
+    curl_async::RequestOptions options;
+    options.fresh_connection = true;
     if (strcmp(ip_version, "IPv4") == 0) {
-        curl_easy_setopt(curl, CURLOPT_IPRESOLVE, CURL_IPRESOLVE_V4);
+        options.ip_resolve = CURL_IPRESOLVE_V4;
+        options.label = "IPv4";
     } else if (strcmp(ip_version, "IPv6") == 0) {
-        curl_easy_setopt(curl, CURLOPT_IPRESOLVE, CURL_IPRESOLVE_V6);
-    }
-    
-    // 디버그 모드 설정
-    if (verbose) {
-        curl_easy_setopt(curl, CURLOPT_DEBUGFUNCTION, DebugCallback);
-        curl_easy_setopt(curl, CURLOPT_VERBOSE, 1L);
-    }
-    
-    // 요청 시작 시간 기록
-    clock_t start_time = clock();
-    
-    // HTTP 요청 실행
-    CURLcode res = curl_easy_perform(curl);
-    
-    // 요청 종료 시간 기록
-    clock_t end_time = clock();
-    result.total_time = ((double)(end_time - start_time)) / CLOCKS_PER_SEC;
-    
-    if (res != CURLE_OK) {
-        fprintf(stderr, "%s 요청 실패: %s\n", ip_version, curl_easy_strerror(res));
+        options.ip_resolve = CURL_IPRESOLVE_V6;
+        options.label = "IPv6";
     } else {
-        // HTTP 응답 코드 확인
-        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &result.response_code);
-        
-        // 해결된 IP 주소 가져오기
-        char* resolved_ip = nullptr;
-        curl_easy_getinfo(curl, CURLINFO_PRIMARY_IP, &resolved_ip);
-        if (resolved_ip) {
-            result.resolved_ip = strdup_safe(resolved_ip);
-        }
-        
-        result.success = 1;
-    }
-    
-    // libcurl 정리
-    curl_easy_cleanup(curl);
-    
-    return result;
-}
-
-// 기본 IP 해결 동작을 테스트하는 함수
-ResponseData performDefaultRequest(const char* url, int verbose) {
-    ResponseData result = initResponseData("기본 (WHATEVER)");
-    
-    CURL* curl = curl_easy_init();
-    if (!curl) {
-        fprintf(stderr, "libcurl 초기화 실패!\n");
-        return result;
+        options.label = "기본 (WHATEVER)";
     }
     
-    // libcurl 옵션 설정 (IP 버전 지정하지 않음)
-    curl_easy_setopt(curl, CURLOPT_URL, url);
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &result.data);
-    curl_easy_setopt(curl, CURLOPT_USERAGENT, "ipv4-ipv6-test/1.0");
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 30L);
-    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 10L);
-    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
-    
-    // IP 버전을 명시적으로 설정하지 않음 (기본값: CURL_IPRESOLVE_WHATEVER)
-    // curl_easy_setopt(curl, CURLOPT_IPRESOLVE, CURL_IPRESOLVE_WHATEVER); // 이것이 기본값
-    
-    // 디버그 모드 설정
-    if (verbose) {
-        curl_easy_setopt(curl, CURLOPT_DEBUGFUNCTION, DebugCallback);
-        curl_easy_setopt(curl, CURLOPT_VERBOSE, 1L);
-    }
-    
-    // 요청 시작 시간 기록
-    clock_t start_time = clock();
-    
-    // HTTP 요청 실행
-    CURLcode res = curl_easy_perform(curl);
-    
-    // 요청 종료 시간 기록
-    clock_t end_time = clock();
-    result.total_time = ((double)(end_time - start_time)) / CLOCKS_PER_SEC;
-    
-    if (res != CURLE_OK) {
-        fprintf(stderr, "기본 요청 실패: %s\n", curl_easy_strerror(res));
-    } else {
-        // HTTP 응답 코드 확인
-        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &result.response_code);
-        
-        // 해결된 IP 주소 가져오기
-        char* resolved_ip = nullptr;
-        curl_easy_getinfo(curl, CURLINFO_PRIMARY_IP, &resolved_ip);
-        if (resolved_ip) {
-            result.resolved_ip = strdup_safe(resolved_ip);
+    // 구조화 결과 출력 (easy 핸들을 정리하기 전에 불린다)
+    options.on_complete = [url, ip_version](CURL* curl, const curl_async::Response& response) {
+        if (!response.ok()) {
+            fprintf(stderr, "%s 요청 실패: %s\n", response.data().ip_version, response.error());
         }
-        
-        result.success = 1;
-    }
-    
-    // libcurl 정리
-    curl_easy_cleanup(curl);
-    
-    return result;
+        emitRequestResult(curl, url, ip_version, response.code(), &response.data());
+    };
+    return client.get(url, std::move(options));
 }
 
 // 결과를 출력하는 함수
@@ -255,10 +76,14 @@ void printResult(const ResponseData* result, const char* url) {
     if (result->success) {
         printf("HTTP 응답 코드: %ld\n", result->response_code);
         printf("응답 시간: %.3f초\n", result->total_time);
+        printf("단계별 시간: 연결 %.1fms, TLS %.1fms, 첫 바이트 %.1fms\n",
+               result->connect_time * 1000.0, result->tls_time * 1000.0, result->ttfb * 1000.0);
         printf("해결된 IP: %s\n", result->resolved_ip ? result->resolved_ip : "알 수 없음");
-        printf("응답 데이터 길이: %zu 바이트\n", strlen(result->data));
+        char body_hash[32];
+        content_hash_format(&result->hash, body_hash, sizeof(body_hash));
+        printf("응답 데이터 길이: %zu 바이트 (%s)\n", result->length, body_hash);
         printf("응답 데이터 (처음 500자):\n%.500s", result->data);
-        if (strlen(result->data) > 500) {
+        if (result->length > 500) {
             printf("\n... (더 많은 데이터가 있습니다)");
         }
         printf("\n");
@@ -266,6 +91,42 @@ void printResult(const ResponseData* result, const char* url) {
     printf("================================\n");
 }
 
+// 본문 비교: 받는 동안 누적한 CRC32C와 길이가 같으면 동일하고, 다르면 둘 다 JSON일 때
+// 공백/멤버 순서/COMPARE_IGNORE 키(기본값 origin, ip, X-Amzn-Trace-Id)를 뺀 정규화 해시로 다시 비교한다.
+// COMPARE_JSON=off이면 정규화 비교를 하지 않는다. 1이면 같은 본문
+int compareContent(const ResponseData* a, const ResponseData* b, const char* label) {
+    char hash_a[32], hash_b[32];
+    content_hash_format(&a->hash, hash_a, sizeof(hash_a));
+    content_hash_format(&b->hash, hash_b, sizeof(hash_b));
+    
+    if (content_hash_equal(&a->hash, &b->hash)) {
+        printf("  %s: 동일 (%zu 바이트, %s)\n", label, a->length, hash_a);
+        return 1;
+    }
+    printf("  %s: 원문이 다름 (%zu 바이트 %s / %zu 바이트 %s)\n", label, a->length, hash_a, b->length, hash_b);
+    
+    const char* json_mode = getenv("COMPARE_JSON");
+    if (json_mode && strcmp(json_mode, "off") == 0) {
+        return 0;
+    }
+    const char* ignore = getenv("COMPARE_IGNORE");
+    if (!ignore) {
+        ignore = DEFAULT_COMPARE_IGNORE;
+    }
+    uint64_t json_a = 0, json_b = 0;
+    if (content_json_hash(a->data, a->length, ignore, &json_a) != 0 ||
+        content_json_hash(b->data, b->length, ignore, &json_b) != 0) {
+        printf("    JSON이 아니어서 정규화 비교는 건너뜁니다\n");
+        return 0;
+    }
+    if (json_a == json_b) {
+        printf("    정규화 JSON은 동일 (무시한 키: %s)\n", ignore[0] ? ignore : "없음");
+        return 1;
+    }
+    printf("    정규화 JSON도 다름 (무시한 키: %s)\n", ignore[0] ? ignore : "없음");
+    return 0;
+}
+
 // 결과를 비교하는 함수
 void compareResults(const ResponseData* ipv4_result, const ResponseData* ipv6_result) {
     printf("\n=== IPv4 vs IPv6 비교 결과 ===\n");
@@ -300,15 +161,8 @@ void compareResults(const ResponseData* ipv4_result, const ResponseData* ipv6_re
             printf("  응답 코드가 다릅니다.\n");
         }
         
-        printf("데이터 길이 비교:\n");
-        printf("  IPv4: %zu 바이트\n", strlen(ipv4_result->data));
-        printf("  IPv6: %zu 바이트\n", strlen(ipv6_result->data));
-        
-        if (strlen(ipv4_result->data) == strlen(ipv6_result->data)) {
-            printf("  데이터 길이가 동일합니다.\n");
-        } else {
-            printf("  데이터 길이가 다릅니다.\n");
-        }
+        printf("본문 비교:\n");
+        compareContent(ipv4_result, ipv6_result, "IPv4 vs IPv6");
         
         printf("해결된 IP 비교:\n");
         printf("  IPv4: %s\n", ipv4_result->resolved_ip ? ipv4_result->resolved_ip : "알 수 없음");
@@ -325,11 +179,228 @@ void compareResults(const ResponseData* ipv4_result, const ResponseData* ipv6_re
     printf("=================================\n");
 }
 
-int main() {
+// URL 하나의 세 경로(기본, IPv4, IPv6)를 동시에 보내고, 모두 끝나면 출력하고 비교한다
+// (세 요청이 같은 시점의 네트워크 상태를 보므로 차례로 보낼 때보다 비교가 공정하다)
+curl_async::Task<void> compareUrl(curl_async::Client& client, const char* url) {
+    printf("\n\n=== 테스트 URL: %s ===\n", url);
+    printf("\n--- 기본 동작, IPv4, IPv6 요청을 동시에 시작 ---\n");
+    auto [default_response, ipv4_response, ipv6_response] = co_await curl_async::when_all(
+        fetch(client, url, "default"), fetch(client, url, "IPv4"), fetch(client, url, "IPv6"));
+    const ResponseData& default_result = default_response.data();
+    const ResponseData& ipv4_result = ipv4_response.data();
+    const ResponseData& ipv6_result = ipv6_response.data();
+    
+    printResult(&default_result, url);
+    printResult(&ipv4_result, url);
+    printResult(&ipv6_result, url);
+    
+    // 결과 비교 (기본 동작 포함)
+    printf("\n=== 기본 동작 vs IPv4 vs IPv6 비교 결과 ===\n");
+    
+    if (default_result.success) {
+        printf("기본 동작 결과:\n");
+        printf("  응답 시간: %.3f초\n", default_result.total_time);
+        printf("  해결된 IP: %s\n", default_result.resolved_ip ? default_result.resolved_ip : "알 수 없음");
+        printf("  응답 코드: %ld\n", default_result.response_code);
+        
+        // 어떤 IP 버전이 선택되었는지 추측
+        if (default_result.resolved_ip && strchr(default_result.resolved_ip, ':')) {
+            printf("  추측: IPv6 주소가 선택됨\n");
+        } else if (default_result.resolved_ip) {
+            printf("  추측: IPv4 주소가 선택됨\n");
+        }
+    }
+    
+    if (ipv4_result.success && ipv6_result.success) {
+        // 단계별로 나눠 보면 RTT(연결, TLS)와 대역폭/손실(첫 바이트 이후)의 차이를 구분할 수 있다
+        printf("\n단계별 시간 (ms):\n");
+        printf("  경로       연결      TLS  첫 바이트     전체\n");
+        const ResponseData* rows[] = { &default_result, &ipv4_result, &ipv6_result };
+        const char* labels[] = { "기본", "IPv4", "IPv6" };
+        for (int r = 0; r < 3; r++) {
+            if (!rows[r]->success) {
+                continue;
+            }
+            printf("  %s %10.1f %8.1f %10.1f %8.1f\n", labels[r],
+                   rows[r]->connect_time * 1000.0, rows[r]->tls_time * 1000.0,
+                   rows[r]->ttfb * 1000.0, rows[r]->total_time * 1000.0);
+        }
+        
+        printf("\nIPv4 vs IPv6 성능 비교:\n");
+        double time_diff = ipv4_result.total_time - ipv6_result.total_time;
+        if (time_diff > 0) {
+            printf("  IPv6이 %.3f초 더 빠릅니다.\n", time_diff);
+        } else if (time_diff < 0) {
+            printf("  IPv4가 %.3f초 더 빠릅니다.\n", -time_diff);
+        } else {
+            printf("  응답 시간이 동일합니다.\n");
+        }
+    }
+    
+    // 본문이 주소 계열과 상관없이 같은지 (받는 동안 계산한 해시로 비교)
+    if ((ipv4_result.success && ipv6_result.success) || (default_result.success && ipv4_result.success)) {
+        printf("\n본문 비교:\n");
+        if (ipv4_result.success && ipv6_result.success) {
+            compareContent(&ipv4_result, &ipv6_result, "IPv4 vs IPv6");
+        }
+        if (default_result.success && ipv4_result.success) {
+            compareContent(&default_result, &ipv4_result, "기본 vs IPv4");
+        }
+    }
+    
+    printf("=========================================\n");
+    
+    // 이번 URL의 결과 레코드를 내보낸다
+    result_writer_flush(g_result_writer);
+}
+
+// 테스트할 URL을 차례로 비교한다 (URL 사이의 대기도 리액터 위에서 기다린다)
+curl_async::Task<void> runComparisons(curl_async::Client& client, const char* const* urls, int num_urls) {
+    for (int i = 0; i < num_urls; i++) {
+        co_await compareUrl(client, urls[i]);
+        
+        // 잠시 대기 (공개 서버 부하 방지, 로컬 하네스에서는 필요 없음)
+        if (!harness_target() && i + 1 < num_urls) {
+            printf("\n3초 대기 중...\n");
+            co_await client.sleep(std::chrono::seconds(3));
+        }
+    }
+}
+
+// 요청 count개를 한꺼번에 보내고 모두 끝날 때까지 기다린다 (응답은 보낸 순서대로)
+static const char* const FANOUT_VERSIONS[] = { "default", "IPv4", "IPv6" };
+
+static std::vector<curl_async::Response> sendFanout(int count, const char* url, size_t* peak, double* elapsed) {
+    curl_async::Client client(curl_async::ClientConfig{"ipv4-ipv6-test/1.0", 0, 0});
+    std::vector<curl_async::Task<curl_async::Response>> tasks;
+    tasks.reserve(count);
+    for (int i = 0; i < count; i++) {
+        curl_async::RequestOptions options;
+        const char* ip_version = FANOUT_VERSIONS[i % 3];
+        options.ip_resolve = i % 3 == 1 ? CURL_IPRESOLVE_V4 : i % 3 == 2 ? CURL_IPRESOLVE_V6 : CURL_IPRESOLVE_WHATEVER;
+        options.on_complete = [url, ip_version](CURL* curl, const curl_async::Response& response) {
+            emitRequestResult(curl, url, ip_version, response.code(), &response.data());
+        };
+        tasks.push_back(client.get(url, std::move(options)));
+    }
+    
+    auto started = std::chrono::steady_clock::now();
+    std::vector<curl_async::Response> responses = client.run(curl_async::when_all(std::move(tasks)));
+    *elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    *peak = client.peak_in_flight();
+    return responses;
+}
+
+// 동시 요청 모드: 한 스레드에서 요청 count개를 한꺼번에 보낸다 (주소 계열을 기본, IPv4, IPv6 순으로 번갈아)
+static int runFanout(int count, const char* url) {
+    // 요청마다 소켓이 하나씩 필요하므로 열린 파일 수 한도를 최대로 올린다
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+    
+    curl_global_init(CURL_GLOBAL_ALL);
+    altsvc_init("ipv4_ipv6_test");
+    
+    printf("=== 동시 요청: %s에 %d개 (스레드 1개, %s) ===\n", url, count, curl_async::Client::backend());
+    if (harness_target()) {
+        printf("연결 대상: 로컬 하네스 (%s)\n", harness_target());
+    }
+    
+    size_t peak = 0;
+    double elapsed = 0;
+    std::vector<curl_async::Response> responses = sendFanout(count, url, &peak, &elapsed);
+    
+    printf("경과 시간: %.3f초, 최대 동시 진행: %zu개, 처리량: %.0f 요청/초\n",
+           elapsed, peak, elapsed > 0 ? count / elapsed : 0.0);
+    printf("  경로   성공   실패   p50(ms)   p99(ms)   최대(ms)\n");
+    int failed_total = 0;
+    for (int v = 0; v < 3; v++) {
+        std::vector<double> times;
+        int failed = 0;
+        const char* first_error = NULL;
+        for (size_t i = v; i < responses.size(); i += 3) {
+            if (responses[i].ok()) {
+                times.push_back(responses[i].data().total_time * 1000.0);
+            } else {
+                failed++;
+                if (!first_error) {
+                    first_error = responses[i].error();
+                }
+            }
+        }
+        failed_total += failed;
+        std::sort(times.begin(), times.end());
+        double p50 = times.empty() ? 0 : times[times.size() / 2];
+        double p99 = times.empty() ? 0 : times[std::min(times.size() - 1, times.size() * 99 / 100)];
+        double max = times.empty() ? 0 : times.back();
+        printf("  %s %6zu %6d %9.1f %9.1f %10.1f\n", v == 0 ? "기본" : FANOUT_VERSIONS[v], times.size(), failed, p50, p99, max);
+        if (first_error) {
+            printf("         첫 실패: %s\n", first_error);
+        }
+    }
+    
+    responses.clear();
+    result_writer_close(g_result_writer);
+    altsvc_cleanup();
+    curl_global_cleanup();
+    return failed_total == count ? 1 : 0;
+}
+
+int main(int argc, char* argv[]) {
+    // 구조화 결과 출력 초기화 (RESULT_FORMAT=jsonl|csv이면 사람용 출력은 stderr로 이동)
+    g_result_writer = result_writer_from_env();
+    
+    // 동시 요청 모드: --fanout N [URL]
+    if (argc > 1 && strcmp(argv[1], "--fanout") == 0) {
+        int count = argc > 2 ? atoi(argv[2]) : 0;
+        if (count <= 0 || argc > 4) {
+            printf("사용법: %s --fanout N [URL]\n", argv[0]);
+            result_writer_close(g_result_writer);
+            return 1;
+        }
+        return runFanout(count, argc > 3 ? argv[3] : "https://httpbin.org/get");
+    }
+    
+    // 연속 모니터링 모드: 대상 파일의 URL을 주기적으로 탐침하고 통계를 엔드포인트로 노출
+    if (argc > 1) {
+        MonitorConfig monitor_config;
+        monitor_default_config(&monitor_config);
+        if (strcmp(argv[1], "--monitor") != 0 || monitor_parse_args(argc, argv, &monitor_config) != 0) {
+            if (strcmp(argv[1], "--monitor") != 0) {
+                printf("사용법: %s [--monitor FILE ... | --fanout N [URL]]\n", argv[0]);
+            }
+            result_writer_close(g_result_writer);
+            return 1;
+        }
+        curl_global_init(CURL_GLOBAL_ALL);
+        int status = monitor_run(&monitor_config, g_result_writer);
+        result_writer_close(g_result_writer);
+        curl_global_cleanup();
+        return status;
+    }
+    
     printf("=== IPv4 vs IPv6 vs 기본 동작 테스트 시작 ===\n");
+    if (harness_target()) {
+        printf("연결 대상: 로컬 하네스 (%s)\n", harness_target());
+    }
+    printf("본문 해시: CRC32C (%s)\n", content_hash_impl());
     
     // libcurl 초기화
     curl_global_init(CURL_GLOBAL_ALL);
+    altsvc_init("ipv4_ipv6_test");
+    
+    // 디버그 트레이스 초기화 (verbose 요청에서만 레코드가 쌓인다)
+    TraceConfig trace_config;
+    trace_default_config(&trace_config);
+    if (trace_init(&trace_config) != 0) {
+        fprintf(stderr, "트레이스 초기화 실패!\n");
+        altsvc_cleanup();
+        curl_global_cleanup();
+        result_writer_close(g_result_writer);
+        return 1;
+    }
     
     // 테스트할 URL들
     const char* test_urls[] = {
@@ -340,67 +411,17 @@ int main() {
     };
     int num_urls = 4;
     
-    for (int i = 0; i < num_urls; i++) {
-        const char* url = test_urls[i];
-        printf("\n\n=== 테스트 URL: %s ===\n", url);
-        
-        // 기본 동작 테스트 (IP 버전 지정하지 않음)
-        printf("\n--- 기본 동작 요청 시작 (IP 버전 미지정) ---\n");
-        ResponseData default_result = performDefaultRequest(url, 0);
-        printResult(&default_result, url);
-        
-        // IPv4 요청
-        printf("\n--- IPv4 요청 시작 ---\n");
-        ResponseData ipv4_result = performRequest(url, "IPv4", 0);
-        printResult(&ipv4_result, url);
-        
-        // IPv6 요청
-        printf("\n--- IPv6 요청 시작 ---\n");
-        ResponseData ipv6_result = performRequest(url, "IPv6", 0);
-        printResult(&ipv6_result, url);
-        
-        // 결과 비교 (기본 동작 포함)
-        printf("\n=== 기본 동작 vs IPv4 vs IPv6 비교 결과 ===\n");
-        
-        if (default_result.success) {
-            printf("기본 동작 결과:\n");
-            printf("  응답 시간: %.3f초\n", default_result.total_time);
-            printf("  해결된 IP: %s\n", default_result.resolved_ip ? default_result.resolved_ip : "알 수 없음");
-            printf("  응답 코드: %ld\n", default_result.response_code);
-            
-            // 어떤 IP 버전이 선택되었는지 추측
-            if (default_result.resolved_ip && strchr(default_result.resolved_ip, ':')) {
-                printf("  추측: IPv6 주소가 선택됨\n");
-            } else if (default_result.resolved_ip) {
-                printf("  추측: IPv4 주소가 선택됨\n");
-            }
-        }
-        
-        if (ipv4_result.success && ipv6_result.success) {
-            printf("\nIPv4 vs IPv6 성능 비교:\n");
-            double time_diff = ipv4_result.total_time - ipv6_result.total_time;
-            if (time_diff > 0) {
-                printf("  IPv6이 %.3f초 더 빠릅니다.\n", time_diff);
-            } else if (time_diff < 0) {
-                printf("  IPv4가 %.3f초 더 빠릅니다.\n", -time_diff);
-            } else {
-                printf("  응답 시간이 동일합니다.\n");
-            }
-        }
-        
-        printf("=========================================\n");
-        
-        // 메모리 정리
-        cleanupResponseData(&default_result);
-        cleanupResponseData(&ipv4_result);
-        cleanupResponseData(&ipv6_result);
-        
-        // 잠시 대기 (서버 부하 방지)
-        printf("\n3초 대기 중...\n");
-        sleep(3);
+    // 모든 요청은 이 스레드의 리액터 하나가 진행한다 (클라이언트가 사라지기 전에 연결 캐시를 닫는다)
+    {
+        curl_async::Client client(curl_async::ClientConfig{"ipv4-ipv6-test/1.0", 0, 0});
+        client.run(runComparisons(client, test_urls, num_urls));
     }
     
-    // libcurl 정리
+    // 결과 출력, 트레이스 및 libcurl 정리
+    result_writer_close(g_result_writer);
+    altsvc_print_summary(stdout);
+    altsvc_cleanup();
+    trace_shutdown();
     curl_global_cleanup();
     
     printf("\n=== IPv4 vs IPv6 vs 기본 동작 테스트 완료 ===\n");
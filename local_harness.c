@@ -0,0 +1,970 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <signal.h>
+#include <strings.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <openssl/ssl.h>
+#include <openssl/err.h>
+#include <openssl/pem.h>
+#include <openssl/x509v3.h>
+
+// 로컬 성능 하네스 서버
+// 공개 테스트 엔드포인트(httpbin.org, api.ipify.org, jsonplaceholder.typicode.com, cloudflare.com)의
+// 라우트와 응답 형식을 흉내 내어 127.0.0.1과 ::1에서 TLS로 응답한다.
+// curl 도구는 HARNESS/HARNESS_CA 환경 변수로 URL을 바꾸지 않고 이 서버에 연결한다 (curl_harness.c).
+// 응답 크기(--size, ?size=)와 서버 지연(--delay, ?delay=)을 고정해 네트워크와 원격 서버 변동 없이
+// 클라이언트 쪽 비용만 반복해서 잴 수 있다.
+
+#define DEFAULT_PORT 18443
+#define DEFAULT_CA_OUT "harness_ca.pem"
+#define REQUEST_HEAD_MAX 16384
+#define REQUEST_BODY_MAX (1 << 20)
+#define RESPONSE_SIZE_MAX (16 << 20)
+#define DELAY_MAX_MS 60000
+#define IDLE_TIMEOUT_SEC 30
+#define POST_COUNT 100
+
+// 인증서 SAN (curl은 URL의 호스트 이름으로 검증하므로 흉내 내는 호스트를 모두 넣는다)
+static const char* const CERT_SAN =
+    "DNS:localhost,DNS:httpbin.org,DNS:api.ipify.org,DNS:jsonplaceholder.typicode.com,"
+    "DNS:cloudflare.com,DNS:www.cloudflare.com,IP:127.0.0.1,IP:::1";
+
+typedef struct {
+    int port;
+    long size;                  // 응답 본문 최소 크기 (0이면 원래 크기)
+    long delay_ms;              // 응답 전 지연
+    const char* ca_out;         // 자체 서명 인증서를 쓸 파일
+    int ipv6;                   // ::1에서도 수신
+    const char* alt_svc;        // 응답에 붙일 Alt-Svc 값 (curl의 Alt-Svc 캐시 학습 확인용)
+    long hsts_max_age;          // 0보다 크면 Strict-Transport-Security 헤더를 붙임
+} HarnessConfig;
+
+// 파싱한 요청 (문자열은 연결 버퍼를 가리킨다)
+typedef struct {
+    char method[16];
+    char target[2048];          // 경로 + 쿼리
+    char path[2048];
+    const char* query;          // target 안의 '?' 다음 (없으면 "")
+    char host[256];             // 포트를 뺀 Host 헤더
+    const char* headers;        // 첫 헤더 줄 시작
+    size_t headers_len;
+    const char* body;
+    size_t body_len;
+    int keep_alive;
+    const char* peer;
+} HarnessRequest;
+
+// 응답 본문 버퍼
+typedef struct {
+    char* data;
+    size_t len;
+    size_t cap;
+} Buffer;
+
+typedef struct {
+    int fd;
+    char peer[INET6_ADDRSTRLEN];
+} ConnectionArgs;
+
+static HarnessConfig g_config;
+static char g_extra_headers[512];   // 모든 응답에 붙는 헤더 (--alt-svc, --hsts)
+static SSL_CTX* g_ctx = NULL;
+static volatile sig_atomic_t g_stop = 0;
+static atomic_ulong g_connections;
+static atomic_ulong g_requests;
+
+// 모든 응답에 붙일 헤더를 한 번 만들어 둔다 (버퍼에 다 들어가지 않으면 -1: 잘린 헤더 줄은 응답을 깨뜨린다)
+static int build_extra_headers(void) {
+    size_t used = 0;
+    int n;
+    g_extra_headers[0] = '\0';
+    if (g_config.alt_svc && g_config.alt_svc[0]) {
+        n = snprintf(g_extra_headers, sizeof(g_extra_headers), "Alt-Svc: %s\r\n", g_config.alt_svc);
+        if (n < 0 || (size_t)n >= sizeof(g_extra_headers)) {
+            return -1;
+        }
+        used = (size_t)n;
+    }
+    if (g_config.hsts_max_age > 0) {
+        n = snprintf(g_extra_headers + used, sizeof(g_extra_headers) - used,
+                     "Strict-Transport-Security: max-age=%ld\r\n", g_config.hsts_max_age);
+        if (n < 0 || (size_t)n >= sizeof(g_extra_headers) - used) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static void handle_signal(int sig) {
+    (void)sig;
+    g_stop = 1;
+}
+
+static int buf_reserve(Buffer* buf, size_t extra) {
+    if (buf->len + extra + 1 <= buf->cap) {
+        return 0;
+    }
+    size_t cap = buf->cap ? buf->cap : 1024;
+    while (cap < buf->len + extra + 1) {
+        cap *= 2;
+    }
+    char* data = realloc(buf->data, cap);
+    if (!data) {
+        return -1;
+    }
+    buf->data = data;
+    buf->cap = cap;
+    return 0;
+}
+
+static void buf_append(Buffer* buf, const char* data, size_t len) {
+    if (buf_reserve(buf, len) != 0) {
+        return;
+    }
+    memcpy(buf->data + buf->len, data, len);
+    buf->len += len;
+    buf->data[buf->len] = 0;
+}
+
+static void buf_puts(Buffer* buf, const char* s) {
+    buf_append(buf, s, strlen(s));
+}
+
+static void buf_printf(Buffer* buf, const char* fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(NULL, 0, fmt, ap);
+    va_end(ap);
+    if (n < 0 || buf_reserve(buf, (size_t)n) != 0) {
+        return;
+    }
+    va_start(ap, fmt);
+    vsnprintf(buf->data + buf->len, (size_t)n + 1, fmt, ap);
+    va_end(ap);
+    buf->len += (size_t)n;
+}
+
+// JSON 문자열 값 (따옴표 포함)
+static void buf_json_string(Buffer* buf, const char* s, size_t len) {
+    buf_puts(buf, "\"");
+    for (size_t i = 0; i < len; i++) {
+        unsigned char c = (unsigned char)s[i];
+        if (c == '"' || c == '\\') {
+            char esc[2] = { '\\', (char)c };
+            buf_append(buf, esc, 2);
+        } else if (c == '\n') {
+            buf_puts(buf, "\\n");
+        } else if (c < 0x20) {
+            buf_printf(buf, "\\u%04x", c);
+        } else {
+            buf_append(buf, (const char*)&c, 1);
+        }
+    }
+    buf_puts(buf, "\"");
+}
+
+// 쿼리 문자열에서 정수 파라미터 (없으면 fallback)
+static long query_long(const char* query, const char* name, long fallback) {
+    size_t name_len = strlen(name);
+    const char* p = query;
+    while (p && *p) {
+        if (strncmp(p, name, name_len) == 0 && p[name_len] == '=') {
+            return strtol(p + name_len + 1, NULL, 10);
+        }
+        p = strchr(p, '&');
+        if (p) {
+            p++;
+        }
+    }
+    return fallback;
+}
+
+static int query_has(const char* query, const char* pair) {
+    size_t len = strlen(pair);
+    const char* p = query;
+    while (p && *p) {
+        if (strncmp(p, pair, len) == 0 && (p[len] == '&' || p[len] == 0)) {
+            return 1;
+        }
+        p = strchr(p, '&');
+        if (p) {
+            p++;
+        }
+    }
+    return 0;
+}
+
+// 응답 본문을 최소 크기까지 채운다 (JSON 객체는 "padding" 필드, HTML은 주석, 나머지는 공백)
+static void pad_body(Buffer* body, const char* content_type, size_t target) {
+    if (target <= body->len) {
+        return;
+    }
+    if (strncmp(content_type, "application/json", 16) == 0 && body->len >= 2 &&
+        body->data[body->len - 2] == '}' && body->data[body->len - 1] == '\n') {
+        const char* prefix = ",\n  \"padding\": \"";
+        const char* suffix = "\"\n}\n";
+        body->len -= 2;
+        while (body->len > 0 && (body->data[body->len - 1] == '\n' || body->data[body->len - 1] == ' ')) {
+            body->len--;
+        }
+        // 빈 객체이면 앞의 쉼표를 뺀다
+        if (body->len > 0 && body->data[body->len - 1] == '{') {
+            prefix++;
+        }
+        size_t overhead = strlen(prefix) + strlen(suffix);
+        size_t fill = target > body->len + overhead ? target - body->len - overhead : 0;
+        buf_puts(body, prefix);
+        if (buf_reserve(body, fill) == 0) {
+            memset(body->data + body->len, 'x', fill);
+            body->len += fill;
+        }
+        buf_puts(body, suffix);
+    } else if (strncmp(content_type, "text/html", 9) == 0) {
+        size_t fill = target > body->len + 8 ? target - body->len - 8 : 0;
+        buf_puts(body, "<!--");
+        if (buf_reserve(body, fill) == 0) {
+            memset(body->data + body->len, 'x', fill);
+            body->len += fill;
+        }
+        buf_puts(body, "-->\n");
+    } else if (buf_reserve(body, target - body->len) == 0) {
+        memset(body->data + body->len, ' ', target - body->len);
+        body->len = target;
+        body->data[body->len] = 0;
+    }
+}
+
+// httpbin /get 형식 (args, headers, origin, url)
+static void route_httpbin_get(const HarnessRequest* req, Buffer* body) {
+    buf_puts(body, "{\n  \"args\": {");
+    const char* p = req->query;
+    int first = 1;
+    while (*p) {
+        const char* end = strchr(p, '&');
+        size_t len = end ? (size_t)(end - p) : strlen(p);
+        const char* eq = memchr(p, '=', len);
+        if (len > 0) {
+            buf_puts(body, first ? "\n    " : ",\n    ");
+            buf_json_string(body, p, eq ? (size_t)(eq - p) : len);
+            buf_puts(body, ": ");
+            buf_json_string(body, eq ? eq + 1 : "", eq ? len - (size_t)(eq - p) - 1 : 0);
+            first = 0;
+        }
+        p = end ? end + 1 : p + len;
+    }
+    buf_puts(body, first ? "}, \n  \"headers\": {" : "\n  }, \n  \"headers\": {");
+
+    first = 1;
+    const char* line = req->headers;
+    const char* headers_end = req->headers + req->headers_len;
+    while (line < headers_end) {
+        const char* eol = memchr(line, '\r', (size_t)(headers_end - line));
+        if (!eol) {
+            eol = headers_end;
+        }
+        const char* colon = memchr(line, ':', (size_t)(eol - line));
+        if (colon) {
+            const char* value = colon + 1;
+            while (value < eol && *value == ' ') {
+                value++;
+            }
+            buf_puts(body, first ? "\n    " : ", \n    ");
+            buf_json_string(body, line, (size_t)(colon - line));
+            buf_puts(body, ": ");
+            buf_json_string(body, value, (size_t)(eol - value));
+            first = 0;
+        }
+        line = eol + 2;
+    }
+    buf_puts(body, "\n  }, \n  \"origin\": ");
+    buf_json_string(body, req->peer, strlen(req->peer));
+    buf_puts(body, ", \n  \"url\": ");
+    char url[2400];
+    int n = snprintf(url, sizeof(url), "https://%s%s", req->host[0] ? req->host : "localhost", req->target);
+    buf_json_string(body, url, n < (int)sizeof(url) ? (size_t)n : sizeof(url) - 1);
+    buf_puts(body, "\n}\n");
+}
+
+// jsonplaceholder 글 한 개 (1번은 실제 서비스와 같은 내용)
+static void append_post(Buffer* body, long id, const char* indent) {
+    if (id == 1) {
+        buf_printf(body,
+            "%s{\n%s  \"userId\": 1,\n%s  \"id\": 1,\n"
+            "%s  \"title\": \"sunt aut facere repellat provident occaecati excepturi optio reprehenderit\",\n"
+            "%s  \"body\": \"quia et suscipit\\nsuscipit recusandae consequuntur expedita et cum\\n"
+            "reprehenderit molestiae ut ut quas totam\\nnostrum rerum est autem sunt rem eveniet architecto\"\n%s}",
+            indent, indent, indent, indent, indent, indent);
+        return;
+    }
+    buf_printf(body,
+        "%s{\n%s  \"userId\": %ld,\n%s  \"id\": %ld,\n%s  \"title\": \"local harness post %ld\",\n"
+        "%s  \"body\": \"deterministic body for post %ld\\nserved from the local harness\"\n%s}",
+        indent, indent, (id - 1) / 10 + 1, indent, id, indent, id, indent, id, indent);
+}
+
+// jsonplaceholder가 POST/PUT 본문에 id를 붙여 돌려주는 동작
+static void echo_with_id(const HarnessRequest* req, Buffer* body, long id) {
+    const char* start = req->body;
+    const char* end = req->body + req->body_len;
+    while (start < end && (*start == ' ' || *start == '\n' || *start == '\r' || *start == '\t')) {
+        start++;
+    }
+    while (end > start && (end[-1] == ' ' || end[-1] == '\n' || end[-1] == '\r' || end[-1] == '\t')) {
+        end--;
+    }
+    if (end - start < 2 || *start != '{' || end[-1] != '}') {
+        buf_printf(body, "{\n  \"id\": %ld\n}\n", id);
+        return;
+    }
+    buf_append(body, start, (size_t)(end - start - 1));
+    if (!memmem(start, (size_t)(end - start), "\"id\"", 4)) {
+        buf_printf(body, "%s\"id\": %ld", end - start > 2 ? ",\n  " : "\n  ", id);
+    }
+    buf_puts(body, "\n}\n");
+}
+
+static const char* const HTML_PAGE =
+    "<!DOCTYPE html>\n"
+    "<html lang=\"en\">\n"
+    "<head>\n"
+    "  <meta charset=\"utf-8\">\n"
+    "  <title>Local Harness</title>\n"
+    "</head>\n"
+    "<body>\n"
+    "  <h1>Local Harness</h1>\n"
+    "  <p>This page stands in for a public HTTPS site so client measurements do not depend on the network.</p>\n"
+    "</body>\n"
+    "</html>\n";
+
+// 요청을 라우트에 맞춰 처리한다 (경로로 고르고, "/"만 Host로 구분)
+// 반환값: HTTP 상태 코드, *content_type과 body를 채운다
+static int route_request(const HarnessRequest* req, const char** content_type, Buffer* body, long* delay_ms) {
+    const char* path = req->path;
+    int is_get = strcmp(req->method, "GET") == 0;
+    long id = 0;
+    char tail = 0;
+
+    *content_type = "application/json";
+
+    // httpbin.org
+    if (strcmp(path, "/ip") == 0 && is_get) {
+        buf_puts(body, "{\n  \"origin\": ");
+        buf_json_string(body, req->peer, strlen(req->peer));
+        buf_puts(body, "\n}\n");
+        return 200;
+    }
+    if (strcmp(path, "/get") == 0 && is_get) {
+        route_httpbin_get(req, body);
+        return 200;
+    }
+    if (sscanf(path, "/delay/%ld%c", &id, &tail) == 1 && is_get) {
+        // httpbin과 같이 초 단위, 최대 10초
+        *delay_ms += (id < 0 ? 0 : id > 10 ? 10 : id) * 1000;
+        route_httpbin_get(req, body);
+        return 200;
+    }
+    if (sscanf(path, "/bytes/%ld%c", &id, &tail) == 1 && is_get) {
+        // 크기마다 같은 바이트열 (xorshift, 시드는 크기)
+        size_t n = id < 0 ? 0 : id > RESPONSE_SIZE_MAX ? RESPONSE_SIZE_MAX : (size_t)id;
+        uint32_t state = (uint32_t)n | 1;
+        *content_type = "application/octet-stream";
+        if (buf_reserve(body, n) == 0) {
+            for (size_t i = 0; i < n; i++) {
+                state ^= state << 13;
+                state ^= state >> 17;
+                state ^= state << 5;
+                body->data[i] = (char)(state & 0xff);
+            }
+            body->len = n;
+        }
+        return 200;
+    }
+    if (sscanf(path, "/status/%ld%c", &id, &tail) == 1) {
+        *content_type = "text/html; charset=utf-8";
+        return id >= 200 && id <= 599 ? (int)id : 400;
+    }
+
+    // jsonplaceholder.typicode.com
+    if (strcmp(path, "/posts") == 0) {
+        if (is_get) {
+            buf_puts(body, "[\n");
+            for (long i = 1; i <= POST_COUNT; i++) {
+                append_post(body, i, "  ");
+                buf_puts(body, i < POST_COUNT ? ",\n" : "\n");
+            }
+            buf_puts(body, "]\n");
+            return 200;
+        }
+        if (strcmp(req->method, "POST") == 0) {
+            echo_with_id(req, body, POST_COUNT + 1);
+            return 201;
+        }
+        buf_puts(body, "{}\n");
+        return 404;
+    }
+    if (sscanf(path, "/posts/%ld%c", &id, &tail) == 1) {
+        if (id < 1 || id > POST_COUNT) {
+            buf_puts(body, "{}\n");
+            return 404;
+        }
+        if (is_get) {
+            append_post(body, id, "");
+            buf_puts(body, "\n");
+        } else if (strcmp(req->method, "PUT") == 0 || strcmp(req->method, "PATCH") == 0) {
+            echo_with_id(req, body, id);
+        } else if (strcmp(req->method, "DELETE") == 0) {
+            buf_puts(body, "{}\n");
+        } else {
+            buf_puts(body, "{}\n");
+            return 404;
+        }
+        return 200;
+    }
+
+    if (strcmp(path, "/") == 0 && is_get) {
+        // api.ipify.org (?format=json이면 JSON, 아니면 주소만)
+        if (strcasecmp(req->host, "api.ipify.org") == 0 || query_has(req->query, "format=json")) {
+            if (query_has(req->query, "format=json")) {
+                buf_puts(body, "{\"ip\":");
+                buf_json_string(body, req->peer, strlen(req->peer));
+                buf_puts(body, "}");
+            } else {
+                *content_type = "text/plain";
+                buf_puts(body, req->peer);
+            }
+            return 200;
+        }
+        // cloudflare.com 등 나머지 사이트의 첫 페이지
+        *content_type = "text/html; charset=utf-8";
+        buf_puts(body, HTML_PAGE);
+        return 200;
+    }
+
+    *content_type = "text/html; charset=utf-8";
+    buf_puts(body, "<h1>Not Found</h1>\n");
+    return 404;
+}
+
+static const char* status_text(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 201: return "Created";
+        case 204: return "No Content";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 413: return "Payload Too Large";
+        case 500: return "Internal Server Error";
+        case 501: return "Not Implemented";
+        default: return "Status";
+    }
+}
+
+// 헤더 목록에서 이름이 같은 헤더의 값 (없으면 NULL, *len에 길이)
+static const char* find_header(const char* headers, size_t headers_len, const char* name, size_t* len) {
+    size_t name_len = strlen(name);
+    const char* line = headers;
+    const char* end = headers + headers_len;
+    while (line < end) {
+        const char* eol = memchr(line, '\r', (size_t)(end - line));
+        if (!eol) {
+            eol = end;
+        }
+        if ((size_t)(eol - line) > name_len && line[name_len] == ':' && strncasecmp(line, name, name_len) == 0) {
+            const char* value = line + name_len + 1;
+            while (value < eol && *value == ' ') {
+                value++;
+            }
+            *len = (size_t)(eol - value);
+            return value;
+        }
+        line = eol + 2;
+    }
+    return NULL;
+}
+
+// 요청 머리를 파싱한다 (성공 0, 잘못된 요청 -1)
+static int parse_request(char* head, size_t head_len, HarnessRequest* req, size_t* content_length) {
+    char* line_end = memmem(head, head_len, "\r\n", 2);
+    char version[16];
+    if (!line_end) {
+        return -1;
+    }
+    *line_end = 0;
+    if (sscanf(head, "%15s %2047s %15s", req->method, req->target, version) != 3) {
+        return -1;
+    }
+    strcpy(req->path, req->target);
+    char* q = strchr(req->path, '?');
+    if (q) {
+        *q = 0;
+        req->query = strchr(req->target, '?') + 1;
+    } else {
+        req->query = "";
+    }
+
+    // 헤더가 없으면 요청 줄 바로 뒤가 빈 줄
+    req->headers = line_end + 2;
+    req->headers_len = (size_t)(req->headers - head) + 4 <= head_len ? head_len - (size_t)(req->headers - head) - 4 : 0;
+
+    size_t len = 0;
+    const char* value = find_header(req->headers, req->headers_len, "Host", &len);
+    req->host[0] = 0;
+    if (value) {
+        // 포트와 IPv6 괄호를 뺀 호스트 이름
+        const char* end = value + len;
+        if (len > 0 && *value == '[') {
+            value++;
+            const char* close = memchr(value, ']', (size_t)(end - value));
+            end = close ? close : end;
+        } else {
+            const char* colon = memchr(value, ':', len);
+            end = colon ? colon : end;
+        }
+        len = (size_t)(end - value) < sizeof(req->host) ? (size_t)(end - value) : sizeof(req->host) - 1;
+        memcpy(req->host, value, len);
+        req->host[len] = 0;
+    }
+
+    // HTTP/1.1은 기본 keep-alive, HTTP/1.0은 기본 close
+    req->keep_alive = strcmp(version, "HTTP/1.0") != 0;
+    value = find_header(req->headers, req->headers_len, "Connection", &len);
+    if (value) {
+        if (len == 5 && strncasecmp(value, "close", 5) == 0) {
+            req->keep_alive = 0;
+        } else if (len == 10 && strncasecmp(value, "keep-alive", 10) == 0) {
+            req->keep_alive = 1;
+        }
+    }
+
+    *content_length = 0;
+    value = find_header(req->headers, req->headers_len, "Content-Length", &len);
+    if (value) {
+        *content_length = strtoul(value, NULL, 10);
+    }
+    if (find_header(req->headers, req->headers_len, "Transfer-Encoding", &len)) {
+        // 청크 요청 본문은 흉내 내는 도구들이 쓰지 않는다
+        return -2;
+    }
+    return 0;
+}
+
+static int write_all(SSL* ssl, const char* data, size_t len) {
+    while (len > 0) {
+        int n = SSL_write(ssl, data, len > INT32_MAX ? INT32_MAX : (int)len);
+        if (n <= 0) {
+            return -1;
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static void sleep_ms(long ms) {
+    struct timespec ts = { ms / 1000, (ms % 1000) * 1000000L };
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR && !g_stop) {
+    }
+}
+
+// 연결 하나를 처리하는 스레드 (keep-alive 요청을 차례로 처리)
+static void* connection_thread(void* arg) {
+    ConnectionArgs* args = arg;
+    char* in = malloc(REQUEST_HEAD_MAX + REQUEST_BODY_MAX);
+    size_t in_len = 0;
+    Buffer body = {0};
+    Buffer out = {0};
+    SSL* ssl = SSL_new(g_ctx);
+
+    if (!in || !ssl) {
+        goto done;
+    }
+    SSL_set_fd(ssl, args->fd);
+    if (SSL_accept(ssl) <= 0) {
+        goto done;
+    }
+
+    for (;;) {
+        // 요청 머리 끝까지 읽기
+        char* head_end;
+        while (!(head_end = memmem(in, in_len, "\r\n\r\n", 4))) {
+            if (in_len >= REQUEST_HEAD_MAX) {
+                goto done;
+            }
+            int n = SSL_read(ssl, in + in_len, (int)(REQUEST_HEAD_MAX - in_len));
+            if (n <= 0) {
+                goto done;
+            }
+            in_len += (size_t)n;
+        }
+        size_t head_len = (size_t)(head_end - in) + 4;
+
+        HarnessRequest req;
+        size_t content_length = 0;
+        memset(&req, 0, sizeof(req));
+        req.peer = args->peer;
+        int parsed = parse_request(in, head_len, &req, &content_length);
+
+        int status;
+        const char* content_type = "text/html; charset=utf-8";
+        long delay_ms = g_config.delay_ms;
+        body.len = 0;
+        if (parsed == -1) {
+            status = 400;
+            req.keep_alive = 0;
+        } else if (parsed == -2) {
+            status = 501;
+            req.keep_alive = 0;
+        } else if (content_length > REQUEST_BODY_MAX) {
+            status = 413;
+            req.keep_alive = 0;
+        } else {
+            // 요청 본문 읽기
+            while (in_len < head_len + content_length) {
+                int n = SSL_read(ssl, in + in_len, (int)(head_len + content_length - in_len));
+                if (n <= 0) {
+                    goto done;
+                }
+                in_len += (size_t)n;
+            }
+            req.body = in + head_len;
+            req.body_len = content_length;
+
+            delay_ms = query_long(req.query, "delay", delay_ms);
+            status = route_request(&req, &content_type, &body, &delay_ms);
+            long size = query_long(req.query, "size", g_config.size);
+            if (status < 300 && size > 0 && strcmp(content_type, "application/octet-stream") != 0) {
+                pad_body(&body, content_type, size > RESPONSE_SIZE_MAX ? RESPONSE_SIZE_MAX : (size_t)size);
+            }
+        }
+
+        // 서버 지연 (응답 헤더를 보내기 전)
+        if (delay_ms > 0) {
+            sleep_ms(delay_ms > DELAY_MAX_MS ? DELAY_MAX_MS : delay_ms);
+        }
+
+        out.len = 0;
+        buf_printf(&out,
+            "HTTP/1.1 %d %s\r\n"
+            "Server: local-harness\r\n"
+            "Content-Type: %s\r\n"
+            "Content-Length: %zu\r\n"
+            "Connection: %s\r\n"
+            "%s"
+            "\r\n",
+            status, status_text(status), content_type, body.len, req.keep_alive ? "keep-alive" : "close",
+            g_extra_headers);
+        if (strcmp(req.method, "HEAD") != 0 && body.len > 0) {
+            buf_append(&out, body.data, body.len);
+        }
+        if (!out.data || write_all(ssl, out.data, out.len) != 0) {
+            goto done;
+        }
+        atomic_fetch_add(&g_requests, 1);
+
+        if (!req.keep_alive || g_stop) {
+            SSL_shutdown(ssl);
+            goto done;
+        }
+
+        // 파이프라인으로 이미 받은 다음 요청은 앞으로 당긴다
+        size_t consumed = head_len + (parsed == 0 ? content_length : 0);
+        memmove(in, in + consumed, in_len - consumed);
+        in_len -= consumed;
+    }
+
+done:
+    if (ssl) {
+        SSL_free(ssl);
+    }
+    close(args->fd);
+    free(in);
+    free(body.data);
+    free(out.data);
+    free(args);
+    return NULL;
+}
+
+// 자체 서명 인증서 생성 (P-256, SAN에 흉내 내는 호스트 전부) 후 PEM으로 저장
+static int setup_certificate(SSL_CTX* ctx, const char* ca_out) {
+    EVP_PKEY* pkey = EVP_EC_gen("P-256");
+    X509* x509 = X509_new();
+    int ok = 0;
+
+    if (!pkey || !x509) {
+        fprintf(stderr, "인증서 생성 실패: 키 생성 오류\n");
+        goto out;
+    }
+
+    X509_set_version(x509, 2);
+    ASN1_INTEGER_set(X509_get_serialNumber(x509), (long)time(NULL));
+    X509_gmtime_adj(X509_get_notBefore(x509), -3600);
+    X509_gmtime_adj(X509_get_notAfter(x509), 30L * 24 * 60 * 60); // 30일
+    X509_NAME* name = X509_get_subject_name(x509);
+    X509_NAME_add_entry_by_txt(name, "O", MBSTRING_ASC, (const unsigned char*)"Local Harness", -1, -1, 0);
+    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, (const unsigned char*)"localhost", -1, -1, 0);
+    X509_set_issuer_name(x509, name);
+    X509_set_pubkey(x509, pkey);
+
+    // 자기 자신이 신뢰 앵커가 되도록 CA:TRUE (openssl req -x509와 같음)
+    X509V3_CTX v3;
+    X509V3_set_ctx_nodb(&v3);
+    X509V3_set_ctx(&v3, x509, x509, NULL, NULL, 0);
+    const struct { int nid; const char* value; } exts[] = {
+        { NID_basic_constraints, "critical,CA:TRUE" },
+        { NID_subject_key_identifier, "hash" },
+        { NID_subject_alt_name, CERT_SAN },
+    };
+    for (size_t i = 0; i < sizeof(exts) / sizeof(exts[0]); i++) {
+        X509_EXTENSION* ext = X509V3_EXT_conf_nid(NULL, &v3, exts[i].nid, exts[i].value);
+        if (!ext || !X509_add_ext(x509, ext, -1)) {
+            X509_EXTENSION_free(ext);
+            fprintf(stderr, "인증서 확장 설정 실패\n");
+            goto out;
+        }
+        X509_EXTENSION_free(ext);
+    }
+
+    if (!X509_sign(x509, pkey, EVP_sha256()) ||
+        SSL_CTX_use_certificate(ctx, x509) != 1 || SSL_CTX_use_PrivateKey(ctx, pkey) != 1) {
+        fprintf(stderr, "인증서 설정 실패\n");
+        ERR_print_errors_fp(stderr);
+        goto out;
+    }
+
+    FILE* fp = fopen(ca_out, "w");
+    if (!fp) {
+        perror(ca_out);
+        goto out;
+    }
+    ok = PEM_write_X509(fp, x509) == 1;
+    fclose(fp);
+    if (!ok) {
+        fprintf(stderr, "인증서 저장 실패: %s\n", ca_out);
+    }
+
+out:
+    X509_free(x509);
+    EVP_PKEY_free(pkey);
+    return ok;
+}
+
+// 루프백 주소 하나에 리스닝 소켓 (실패하면 -1)
+static int open_listener(int family, int port) {
+    int fd = socket(family, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    int rc;
+    if (family == AF_INET6) {
+        // ::1만 받는다 (127.0.0.1은 IPv4 소켓이 받는다)
+        setsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, &one, sizeof(one));
+        struct sockaddr_in6 addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin6_family = AF_INET6;
+        addr.sin6_addr = in6addr_loopback;
+        addr.sin6_port = htons(port);
+        rc = bind(fd, (struct sockaddr*)&addr, sizeof(addr));
+    } else {
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(port);
+        rc = bind(fd, (struct sockaddr*)&addr, sizeof(addr));
+    }
+    if (rc != 0 || listen(fd, 128) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void accept_connection(int listen_fd) {
+    struct sockaddr_storage peer;
+    socklen_t peer_len = sizeof(peer);
+    int fd = accept(listen_fd, (struct sockaddr*)&peer, &peer_len);
+    if (fd < 0) {
+        return;
+    }
+
+    ConnectionArgs* args = calloc(1, sizeof(*args));
+    if (!args) {
+        close(fd);
+        return;
+    }
+    args->fd = fd;
+    if (peer.ss_family == AF_INET6) {
+        inet_ntop(AF_INET6, &((struct sockaddr_in6*)&peer)->sin6_addr, args->peer, sizeof(args->peer));
+    } else {
+        inet_ntop(AF_INET, &((struct sockaddr_in*)&peer)->sin_addr, args->peer, sizeof(args->peer));
+    }
+
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    struct timeval timeout = { IDLE_TIMEOUT_SEC, 0 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    pthread_t thread;
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    if (pthread_create(&thread, &attr, connection_thread, args) != 0) {
+        close(fd);
+        free(args);
+    } else {
+        atomic_fetch_add(&g_connections, 1);
+    }
+    pthread_attr_destroy(&attr);
+}
+
+static void print_usage(const char* program) {
+    printf("사용법: %s [--port N] [--size BYTES] [--delay MS] [--ca-out FILE] [--no-ipv6] [--alt-svc VALUE] [--hsts SEC]\n", program);
+    printf("  --port N         수신 포트 (127.0.0.1, ::1, 기본값 %d)\n", DEFAULT_PORT);
+    printf("  --size BYTES     응답 본문 최소 크기 (요청마다 ?size=로 바꿀 수 있음, 기본값 원래 크기)\n");
+    printf("  --delay MS       응답 전 서버 지연 (요청마다 ?delay=로 바꿀 수 있음, 기본값 0)\n");
+    printf("  --ca-out FILE    자체 서명 인증서를 쓸 파일 (기본값 %s)\n", DEFAULT_CA_OUT);
+    printf("  --no-ipv6        ::1에서 받지 않음\n");
+    printf("  --alt-svc VALUE  응답마다 Alt-Svc 헤더를 붙임 (예: 'h3=\":443\"; ma=86400')\n");
+    printf("  --hsts SEC       응답마다 Strict-Transport-Security: max-age=SEC를 붙임\n");
+    printf("\n");
+    printf("라우트:\n");
+    printf("  httpbin.org                  GET /ip, /get, /delay/N, /bytes/N, /status/N\n");
+    printf("  jsonplaceholder.typicode.com GET /posts, GET|PUT|PATCH|DELETE /posts/N, POST /posts\n");
+    printf("  api.ipify.org                GET /, /?format=json\n");
+    printf("  그 밖의 호스트               GET / (HTML 페이지)\n");
+}
+
+int main(int argc, char* argv[]) {
+    g_config.port = DEFAULT_PORT;
+    g_config.ca_out = DEFAULT_CA_OUT;
+    g_config.ipv6 = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--port") == 0 && i + 1 < argc) {
+            g_config.port = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+            g_config.size = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--delay") == 0 && i + 1 < argc) {
+            g_config.delay_ms = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--ca-out") == 0 && i + 1 < argc) {
+            g_config.ca_out = argv[++i];
+        } else if (strcmp(argv[i], "--no-ipv6") == 0) {
+            g_config.ipv6 = 0;
+        } else if (strcmp(argv[i], "--alt-svc") == 0 && i + 1 < argc) {
+            g_config.alt_svc = argv[++i];
+        } else if (strcmp(argv[i], "--hsts") == 0 && i + 1 < argc) {
+            g_config.hsts_max_age = atol(argv[++i]);
+        } else {
+            print_usage(argv[0]);
+            return strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+    if (g_config.port < 1 || g_config.port > 65535) {
+        fprintf(stderr, "포트는 1~65535이어야 합니다.\n");
+        return 1;
+    }
+    if (g_config.size < 0 || g_config.size > RESPONSE_SIZE_MAX) {
+        fprintf(stderr, "응답 크기는 0~%d이어야 합니다.\n", RESPONSE_SIZE_MAX);
+        return 1;
+    }
+    if (g_config.delay_ms < 0 || g_config.delay_ms > DELAY_MAX_MS) {
+        fprintf(stderr, "지연은 0~%dms이어야 합니다.\n", DELAY_MAX_MS);
+        return 1;
+    }
+    if (g_config.alt_svc && strlen(g_config.alt_svc) > 256) {
+        fprintf(stderr, "Alt-Svc 값은 256바이트 이하여야 합니다.\n");
+        return 1;
+    }
+    if (build_extra_headers() != 0) {
+        fprintf(stderr, "--alt-svc와 --hsts로 붙일 헤더가 너무 깁니다 (%zu바이트 이하).\n", sizeof(g_extra_headers) - 1);
+        return 1;
+    }
+
+    // 클라이언트가 먼저 끊은 연결에 쓰면 SIGPIPE 대신 오류로 받는다
+    signal(SIGPIPE, SIG_IGN);
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = handle_signal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    g_ctx = SSL_CTX_new(TLS_server_method());
+    if (!g_ctx) {
+        ERR_print_errors_fp(stderr);
+        return 1;
+    }
+    SSL_CTX_set_min_proto_version(g_ctx, TLS1_2_VERSION);
+    if (!setup_certificate(g_ctx, g_config.ca_out)) {
+        SSL_CTX_free(g_ctx);
+        return 1;
+    }
+
+    struct pollfd fds[2];
+    int nfds = 0;
+    int fd4 = open_listener(AF_INET, g_config.port);
+    if (fd4 < 0) {
+        perror("127.0.0.1 바인드 실패");
+        SSL_CTX_free(g_ctx);
+        return 1;
+    }
+    fds[nfds].fd = fd4;
+    fds[nfds++].events = POLLIN;
+    if (g_config.ipv6) {
+        int fd6 = open_listener(AF_INET6, g_config.port);
+        if (fd6 < 0) {
+            perror("::1 바인드 실패 (IPv4만 사용)");
+        } else {
+            fds[nfds].fd = fd6;
+            fds[nfds++].events = POLLIN;
+        }
+    }
+
+    printf("로컬 하네스 시작: https://127.0.0.1:%d", g_config.port);
+    if (nfds > 1) {
+        printf(", https://[::1]:%d", g_config.port);
+    }
+    printf("\n");
+    if (g_config.size > 0) {
+        printf("응답 크기: 최소 %ld바이트, 서버 지연: %ldms\n", g_config.size, g_config.delay_ms);
+    } else {
+        printf("응답 크기: 원래 크기, 서버 지연: %ldms\n", g_config.delay_ms);
+    }
+    printf("curl 도구를 하네스로 돌리려면:\n");
+    printf("  export HARNESS=localhost:%d HARNESS_CA=%s\n", g_config.port, g_config.ca_out);
+    fflush(stdout);
+
+    while (!g_stop) {
+        int ready = poll(fds, (nfds_t)nfds, 1000);
+        if (ready <= 0) {
+            continue;
+        }
+        for (int i = 0; i < nfds; i++) {
+            if (fds[i].revents & POLLIN) {
+                accept_connection(fds[i].fd);
+            }
+        }
+    }
+
+    for (int i = 0; i < nfds; i++) {
+        close(fds[i].fd);
+    }
+    printf("\n로컬 하네스 종료: 연결 %lu개, 요청 %lu개\n",
+           atomic_load(&g_connections), atomic_load(&g_requests));
+    return 0;
+}
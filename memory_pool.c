@@ -0,0 +1,114 @@
+#include "memory_pool.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define SLAB_ALIGN 64
+#define SLAB_HEADER_SIZE SLAB_ALIGN     // 다음 slab 포인터 (객체는 캐시 라인 경계부터 시작)
+
+void slab_init(SlabAllocator* slab, size_t object_size, size_t objects_per_slab) {
+    memset(slab, 0, sizeof(*slab));
+    if (object_size < sizeof(void*)) {
+        object_size = sizeof(void*);
+    }
+    // 객체끼리 캐시 라인을 나눠 쓰지 않도록 정렬한다
+    slab->object_size = (object_size + SLAB_ALIGN - 1) & ~(size_t)(SLAB_ALIGN - 1);
+    slab->objects_per_slab = objects_per_slab > 0 ? objects_per_slab : 1;
+}
+
+void slab_destroy(SlabAllocator* slab) {
+    void* current = slab->slabs;
+    while (current) {
+        void* next = *(void**)current;
+        free(current);
+        current = next;
+    }
+    memset(slab, 0, sizeof(*slab));
+}
+
+static int slab_grow(SlabAllocator* slab) {
+    size_t size = SLAB_HEADER_SIZE + slab->object_size * slab->objects_per_slab;
+    char* block = (char*)aligned_alloc(SLAB_ALIGN, size);
+    if (!block) {
+        return -1;
+    }
+    *(void**)block = slab->slabs;
+    slab->slabs = block;
+    slab->slab_count++;
+
+    // 뒤에서부터 넣어 낮은 주소부터 꺼내지게 한다
+    for (size_t i = slab->objects_per_slab; i > 0; i--) {
+        void* object = block + SLAB_HEADER_SIZE + (i - 1) * slab->object_size;
+        *(void**)object = slab->free_list;
+        slab->free_list = object;
+    }
+    return 0;
+}
+
+void* slab_alloc(SlabAllocator* slab) {
+    if (!slab->free_list && slab_grow(slab) != 0) {
+        return NULL;
+    }
+    void* object = slab->free_list;
+    slab->free_list = *(void**)object;
+    slab->in_use++;
+    memset(object, 0, slab->object_size);
+    return object;
+}
+
+void slab_free(SlabAllocator* slab, void* object) {
+    *(void**)object = slab->free_list;
+    slab->free_list = object;
+    slab->in_use--;
+}
+
+size_t slab_bytes(const SlabAllocator* slab) {
+    return slab->slab_count * (SLAB_HEADER_SIZE + slab->object_size * slab->objects_per_slab);
+}
+
+void buffer_pool_init(BufferPool* pool, size_t buffer_size, size_t max_free) {
+    memset(pool, 0, sizeof(*pool));
+    pool->buffer_size = buffer_size < sizeof(void*) ? sizeof(void*) : buffer_size;
+    pool->max_free = max_free;
+}
+
+void buffer_pool_destroy(BufferPool* pool) {
+    void* current = pool->free_list;
+    while (current) {
+        void* next = *(void**)current;
+        free(current);
+        current = next;
+    }
+    pool->free_list = NULL;
+    pool->free_count = 0;
+}
+
+void* buffer_pool_get(BufferPool* pool) {
+    void* buffer = pool->free_list;
+    if (buffer) {
+        pool->free_list = *(void**)buffer;
+        pool->free_count--;
+    } else {
+        buffer = malloc(pool->buffer_size);
+        if (!buffer) {
+            return NULL;
+        }
+    }
+    pool->lent++;
+    return buffer;
+}
+
+void buffer_pool_put(BufferPool* pool, void* buffer) {
+    pool->lent--;
+    if (pool->free_count >= pool->max_free) {
+        free(buffer);
+        return;
+    }
+    *(void**)buffer = pool->free_list;
+    pool->free_list = buffer;
+    pool->free_count++;
+}
+
+size_t buffer_pool_bytes(const BufferPool* pool) {
+    return (pool->lent + pool->free_count) * pool->buffer_size;
+}
@@ -0,0 +1,49 @@
+#ifndef MEMORY_POOL_H
+#define MEMORY_POOL_H
+
+// 스레드 전용 메모리 풀 (잠금 없음, 소유 스레드만 호출한다)
+// - SlabAllocator: 같은 크기 객체(연결 상태)를 큰 덩어리(slab) 단위로 받아 자유 목록으로 재사용한다.
+//   slab은 풀을 없앨 때까지 돌려주지 않으므로 연결 수락/종료마다 malloc/free가 일어나지 않는다.
+// - BufferPool: 고정 크기 I/O 버퍼. 대기 중인 I/O가 있을 때만 연결에 빌려주고 끝나면 돌려받는다.
+//   빈 버퍼는 max_free개까지만 보관하고 넘치면 해제해, 부하가 지나간 뒤 메모리가 남지 않게 한다.
+
+#include <stddef.h>
+
+typedef struct {
+    size_t object_size;
+    size_t objects_per_slab;
+    void* free_list;
+    void* slabs;                // slab 목록 (각 slab의 첫 포인터가 다음 slab)
+    size_t slab_count;
+    size_t in_use;
+} SlabAllocator;
+
+typedef struct {
+    size_t buffer_size;
+    size_t max_free;
+    void* free_list;
+    size_t free_count;
+    size_t lent;                // 빌려준 버퍼 수
+} BufferPool;
+
+void slab_init(SlabAllocator* slab, size_t object_size, size_t objects_per_slab);
+void slab_destroy(SlabAllocator* slab);
+
+// 객체 하나를 꺼낸다 (0으로 채워져 있음, 메모리 부족이면 NULL)
+void* slab_alloc(SlabAllocator* slab);
+void slab_free(SlabAllocator* slab, void* object);
+
+// slab으로 확보한 전체 바이트 수 (사용 중 + 자유 목록)
+size_t slab_bytes(const SlabAllocator* slab);
+
+void buffer_pool_init(BufferPool* pool, size_t buffer_size, size_t max_free);
+void buffer_pool_destroy(BufferPool* pool);
+
+// 버퍼 하나를 빌린다 (내용은 초기화하지 않음, 메모리 부족이면 NULL)
+void* buffer_pool_get(BufferPool* pool);
+void buffer_pool_put(BufferPool* pool, void* buffer);
+
+// 풀이 잡고 있는 전체 바이트 수 (빌려준 버퍼 + 보관 중인 빈 버퍼)
+size_t buffer_pool_bytes(const BufferPool* pool);
+
+#endif
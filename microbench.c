@@ -0,0 +1,924 @@
+// 요청 경로 핫 함수 마이크로벤치마크
+// - 네트워크 없이 같은 프로세스 안에서 측정한다: curl 콜백(WriteCallback, DebugCallback, ResponseData),
+//   본문 해시(HashingWriteCallback, CRC32C, 정규화 JSON),
+//   서버 응답 경로(send_http_response, handle_http_request), TLS 레코드 경로(메모리 BIO 엔진 루프백).
+// - 벤치마크마다 반복 한 번이 --min-time 정도 걸리도록 연산 수를 맞춘 뒤 --repetitions번 재서 중앙값을 쓴다.
+// - --json으로 결과를 저장하고 --compare로 이전 결과와 같은 이름/매개변수끼리 비교한다.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <openssl/ssl.h>
+#include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/x509.h>
+#include <curl/curl.h>
+#include "curl_callbacks.h"
+#include "trace_log.h"
+#include "tls_engine.h"
+#include "tls_server_internal.h"
+
+#define BENCH_MAX_RESULTS 128
+#define BENCH_SCRATCH_SIZE 65536
+#define BENCH_MAX_PAYLOAD (1024 * 1024)
+#define BENCH_JSON_SCHEMA "microbench/1"
+
+typedef void (*BenchFunction)(void* state, uint64_t iterations);
+
+typedef struct {
+    char name[48];
+    char params[96];
+    uint64_t iterations;        // 반복 한 번의 연산 수
+    double ns_per_op;           // 반복들의 중앙값
+    double ns_min;
+    double spread;              // (최대 - 최소) / 중앙값
+    size_t bytes_per_op;        // 처리량 계산용 (0이면 처리량 없음)
+} BenchResult;
+
+typedef struct {
+    const char* filter;         // 이름/매개변수에 이 문자열이 있는 벤치마크만
+    double min_time;            // 반복 한 번의 목표 시간 (초)
+    int repetitions;
+    int list_only;
+    FILE* human;                // 표 출력 대상 (--json -이면 stderr)
+    BenchResult results[BENCH_MAX_RESULTS];
+    int count;
+} BenchContext;
+
+static double bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// 벤치마크 함수가 측정에서 빼 달라고 쌓는 시간 (링 비우기 대기처럼 측정 대상이 아닌 대기)
+static double g_excluded_time;
+static volatile uint32_t g_sink;     // 해시 결과를 버리지 않게 해 계산이 최적화로 사라지지 않도록
+
+static double bench_time(BenchFunction function, void* state, uint64_t iterations) {
+    g_excluded_time = 0.0;
+    double start = bench_now();
+    function(state, iterations);
+    return bench_now() - start - g_excluded_time;
+}
+
+static int compare_double(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// 사람이 읽는 시간 단위
+static void format_ns(char* buffer, size_t size, double ns) {
+    if (ns < 1e3) {
+        snprintf(buffer, size, "%.1f ns", ns);
+    } else if (ns < 1e6) {
+        snprintf(buffer, size, "%.2f us", ns / 1e3);
+    } else {
+        snprintf(buffer, size, "%.2f ms", ns / 1e6);
+    }
+}
+
+// 벤치마크 하나 측정: 연산 수를 늘려 가며 반복 한 번이 min_time에 가까워지게 맞춘 뒤 repetitions번 측정
+static void bench_run(BenchContext* bench, const char* name, const char* params, size_t bytes_per_op,
+                      BenchFunction function, void* state) {
+    char full[160];
+    snprintf(full, sizeof(full), "%s/%s", name, params);
+    if (bench->filter && !strstr(full, bench->filter)) {
+        return;
+    }
+    if (bench->list_only) {
+        fprintf(bench->human, "%s\n", full);
+        return;
+    }
+    if (bench->count >= BENCH_MAX_RESULTS) {
+        fprintf(stderr, "결과가 너무 많아 건너뜀: %s\n", full);
+        return;
+    }
+
+    // 예열 후 보정 (목표의 1/5을 넘을 때까지 늘림)
+    function(state, 1);
+    uint64_t iterations = 1;
+    double elapsed;
+    while ((elapsed = bench_time(function, state, iterations)) < bench->min_time / 5 && iterations < (1ULL << 40)) {
+        double scale = elapsed > 0.0 ? bench->min_time / 5 / elapsed * 1.5 : 10.0;
+        iterations = (uint64_t)((double)iterations * (scale < 2.0 ? 2.0 : scale > 10.0 ? 10.0 : scale));
+    }
+    iterations = (uint64_t)((double)iterations * bench->min_time / elapsed);
+    if (iterations < 1) {
+        iterations = 1;
+    }
+
+    double samples[64];
+    int repetitions = bench->repetitions;
+    for (int r = 0; r < repetitions; r++) {
+        samples[r] = bench_time(function, state, iterations) * 1e9 / (double)iterations;
+    }
+    qsort(samples, (size_t)repetitions, sizeof(double), compare_double);
+
+    BenchResult* result = &bench->results[bench->count++];
+    snprintf(result->name, sizeof(result->name), "%s", name);
+    snprintf(result->params, sizeof(result->params), "%s", params);
+    result->iterations = iterations;
+    result->ns_per_op = repetitions % 2 ? samples[repetitions / 2]
+                                        : (samples[repetitions / 2 - 1] + samples[repetitions / 2]) / 2;
+    result->ns_min = samples[0];
+    result->spread = (samples[repetitions - 1] - samples[0]) / result->ns_per_op;
+    result->bytes_per_op = bytes_per_op;
+
+    char time_text[32], rate_text[32] = "-";
+    format_ns(time_text, sizeof(time_text), result->ns_per_op);
+    if (bytes_per_op > 0) {
+        snprintf(rate_text, sizeof(rate_text), "%.1f MB/s", (double)bytes_per_op / result->ns_per_op * 1e3);
+    }
+    fprintf(bench->human, "%-22s %-44s %12s %14s %6.1f%%\n", name, params, time_text, rate_text,
+            result->spread * 100);
+    fflush(bench->human);
+}
+
+// 본문으로 쓸 텍스트 (WriteCallback은 NUL로 끝나는 문자열로 다루므로 NUL이 없어야 한다)
+static char* make_payload(size_t size) {
+    char* payload = (char*)malloc(size + 1);
+    if (!payload) {
+        return NULL;
+    }
+    for (size_t i = 0; i < size; i++) {
+        payload[i] = (char)('a' + i % 26);
+    }
+    payload[size] = '\0';
+    return payload;
+}
+
+// ---------------------------------------------------------------------------
+// curl 콜백
+
+typedef struct {
+    const char* payload;
+    size_t* chunks;             // libcurl이 나눠 넘기는 조각 크기들
+    size_t chunk_count;
+} WriteBenchState;
+
+// 응답 하나를 조각들로 받는 과정 (초기화 -> 조각마다 콜백 -> 해제)
+static void run_write_callback(void* arg, uint64_t iterations) {
+    WriteBenchState* state = (WriteBenchState*)arg;
+    for (uint64_t i = 0; i < iterations; i++) {
+        char* response = (char*)malloc(1);
+        response[0] = 0;
+        const char* data = state->payload;
+        for (size_t c = 0; c < state->chunk_count; c++) {
+            WriteCallback((void*)data, 1, state->chunks[c], &response);
+            data += state->chunks[c];
+        }
+        free(response);
+    }
+}
+
+// 조각 패턴: "16k" (CURL_MAX_WRITE_SIZE), "1460" (TCP 세그먼트 하나), "random" (1~16384, 고정 시드)
+static size_t* make_chunks(size_t payload_size, const char* pattern, size_t* count) {
+    size_t* chunks = (size_t*)malloc((payload_size + 1) * sizeof(size_t));
+    uint32_t seed = 42;
+    size_t remaining = payload_size;
+    *count = 0;
+    while (chunks && remaining > 0) {
+        size_t chunk;
+        if (strcmp(pattern, "random") == 0) {
+            seed = seed * 1103515245u + 12345u;
+            chunk = 1 + (seed >> 8) % CURL_MAX_WRITE_SIZE;
+        } else {
+            chunk = strcmp(pattern, "1460") == 0 ? 1460 : CURL_MAX_WRITE_SIZE;
+        }
+        if (chunk > remaining) {
+            chunk = remaining;
+        }
+        chunks[(*count)++] = chunk;
+        remaining -= chunk;
+    }
+    return chunks;
+}
+
+static void bench_write_callback(BenchContext* bench, const char* payload) {
+    static const size_t sizes[] = {1024, 65536, BENCH_MAX_PAYLOAD};
+    static const char* const patterns[] = {"16k", "1460", "random"};
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        for (size_t p = 0; p < sizeof(patterns) / sizeof(patterns[0]); p++) {
+            WriteBenchState state;
+            state.payload = payload;
+            state.chunks = make_chunks(sizes[s], patterns[p], &state.chunk_count);
+            if (!state.chunks) {
+                continue;
+            }
+
+            // 결과가 원문과 같은지 한 번 확인
+            char* check = (char*)malloc(1);
+            check[0] = 0;
+            const char* data = payload;
+            for (size_t c = 0; c < state.chunk_count; c++) {
+                WriteCallback((void*)data, 1, state.chunks[c], &check);
+                data += state.chunks[c];
+            }
+            if (strlen(check) != sizes[s] || memcmp(check, payload, sizes[s]) != 0) {
+                fprintf(stderr, "WriteCallback 결과가 원문과 다릅니다 (payload=%zu, chunk=%s)\n", sizes[s], patterns[p]);
+                exit(1);
+            }
+            free(check);
+
+            char params[96];
+            snprintf(params, sizeof(params), "payload=%zu,chunk=%s", sizes[s], patterns[p]);
+            bench_run(bench, "write_callback", params, sizes[s], run_write_callback, &state);
+            free(state.chunks);
+        }
+    }
+}
+
+// 같은 조각들을 HashingWriteCallback으로 받는 과정 (write_callback과 비교: strlen 대신 길이, 해시 누적)
+static void run_hashing_write_callback(void* arg, uint64_t iterations) {
+    WriteBenchState* state = (WriteBenchState*)arg;
+    for (uint64_t i = 0; i < iterations; i++) {
+        ResponseData response = initResponseData("IPv4");
+        const char* data = state->payload;
+        for (size_t c = 0; c < state->chunk_count; c++) {
+            HashingWriteCallback((void*)data, 1, state->chunks[c], &response);
+            data += state->chunks[c];
+        }
+        cleanupResponseData(&response);
+    }
+}
+
+typedef struct {
+    const char* data;
+    size_t size;
+} HashBenchState;
+
+static void run_content_hash(void* arg, uint64_t iterations) {
+    HashBenchState* state = (HashBenchState*)arg;
+    for (uint64_t i = 0; i < iterations; i++) {
+        ContentHash hash;
+        content_hash_init(&hash);
+        content_hash_update(&hash, state->data, state->size);
+        g_sink ^= content_hash_value(&hash);
+    }
+}
+
+static void run_json_hash(void* arg, uint64_t iterations) {
+    HashBenchState* state = (HashBenchState*)arg;
+    for (uint64_t i = 0; i < iterations; i++) {
+        uint64_t hash = 0;
+        content_json_hash(state->data, state->size, "origin,ip,X-Amzn-Trace-Id", &hash);
+        g_sink ^= (uint32_t)hash;
+    }
+}
+
+// jsonplaceholder /posts 형식의 JSON 배열 (약 size 바이트)
+static char* make_json_payload(size_t size, size_t* length) {
+    char* json = (char*)malloc(size + 256);
+    size_t used = 0;
+    if (!json) {
+        return NULL;
+    }
+    json[used++] = '[';
+    for (int id = 1; used < size; id++) {
+        used += (size_t)snprintf(json + used, size + 256 - used,
+                                 "%s{\"userId\": %d, \"id\": %d, \"title\": \"sunt aut facere repellat\", "
+                                 "\"body\": \"quia et suscipit suscipit recusandae\", \"origin\": \"192.0.2.%d\"}",
+                                 id > 1 ? ", " : "", id % 10 + 1, id, id % 250);
+    }
+    json[used++] = ']';
+    json[used] = '\0';
+    *length = used;
+    return json;
+}
+
+static void bench_content_hash(BenchContext* bench, const char* payload) {
+    static const size_t sizes[] = {1024, 65536, BENCH_MAX_PAYLOAD};
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        WriteBenchState state;
+        state.payload = payload;
+        state.chunks = make_chunks(sizes[s], "16k", &state.chunk_count);
+        if (!state.chunks) {
+            continue;
+        }
+
+        // 조각으로 누적한 해시가 한 번에 계산한 해시와 같은지 한 번 확인
+        ResponseData check = initResponseData("IPv4");
+        const char* data = payload;
+        for (size_t c = 0; c < state.chunk_count; c++) {
+            HashingWriteCallback((void*)data, 1, state.chunks[c], &check);
+            data += state.chunks[c];
+        }
+        ContentHash whole;
+        content_hash_init(&whole);
+        content_hash_update(&whole, payload, sizes[s]);
+        if (check.length != sizes[s] || memcmp(check.data, payload, sizes[s]) != 0 ||
+            !content_hash_equal(&check.hash, &whole)) {
+            fprintf(stderr, "HashingWriteCallback 결과가 원문과 다릅니다 (payload=%zu)\n", sizes[s]);
+            exit(1);
+        }
+        cleanupResponseData(&check);
+
+        char params[96];
+        snprintf(params, sizeof(params), "payload=%zu,chunk=16k", sizes[s]);
+        bench_run(bench, "hashing_write_callback", params, sizes[s], run_hashing_write_callback, &state);
+        free(state.chunks);
+
+        HashBenchState hash_state = {payload, sizes[s]};
+        snprintf(params, sizeof(params), "payload=%zu,impl=%s", sizes[s], content_hash_impl());
+        bench_run(bench, "content_hash", params, sizes[s], run_content_hash, &hash_state);
+    }
+
+    size_t json_length = 0;
+    char* json = make_json_payload(65536, &json_length);
+    uint64_t json_check = 0;
+    if (!json || content_json_hash(json, json_length, NULL, &json_check) != 0) {
+        fprintf(stderr, "정규화 JSON 해시 초기화 실패\n");
+        exit(1);
+    }
+    HashBenchState json_state = {json, json_length};
+    bench_run(bench, "json_hash", "payload=65536,ignore=3", json_length, run_json_hash, &json_state);
+    free(json);
+}
+
+typedef struct {
+    char* data;
+    size_t size;
+    curl_infotype type;
+    uint64_t flush_mask;        // 이만큼 기록할 때마다 writer가 링을 비우기를 기다린다 (0이면 기다리지 않음)
+} DebugBenchState;
+
+// 콜백 스레드의 기록 비용 (링이 넘쳐 버리는 경로를 재지 않도록 주기적으로 writer를 기다리고, 그 시간은 뺀다)
+static void run_debug_callback(void* arg, uint64_t iterations) {
+    DebugBenchState* state = (DebugBenchState*)arg;
+    for (uint64_t i = 0; i < iterations; i++) {
+        DebugCallback(NULL, state->type, state->data, state->size, NULL);
+        if (state->flush_mask && ((i + 1) & state->flush_mask) == 0) {
+            double start = bench_now();
+            trace_flush();
+            g_excluded_time += bench_now() - start;
+        }
+    }
+}
+
+static void bench_debug_callback(BenchContext* bench, char* payload, FILE* sink) {
+    static const struct {
+        curl_infotype type;
+        const char* name;
+        unsigned mask;          // 기록할 종류 (filtered: 걸러지는 경로)
+    } cases[] = {
+        {CURLINFO_TEXT, "text", TRACE_MASK_ALL},
+        {CURLINFO_HEADER_IN, "header_in", TRACE_MASK_ALL},
+        {CURLINFO_DATA_IN, "data_in", TRACE_MASK_ALL},
+        {CURLINFO_DATA_IN, "data_in_filtered", TRACE_MASK_HEADERS},
+    };
+    static const size_t sizes[] = {32, 4096};
+
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        TraceConfig config;
+        trace_default_config(&config);
+        config.out = sink;
+        config.type_mask = cases[c].mask;
+        config.ring_capacity = 65536;
+        config.flush_interval_ms = 1;
+        if (trace_init(&config) != 0) {
+            fprintf(stderr, "트레이스 초기화 실패\n");
+            exit(1);
+        }
+        // 링의 1/4마다 비운다 (걸러지는 종류는 기록하지 않으므로 기다릴 필요 없음)
+        uint64_t flush_every = config.ring_capacity / 4;
+        if (!(cases[c].mask & TRACE_MASK((TraceType)cases[c].type))) {
+            flush_every = 0;
+        }
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+            DebugBenchState state = {payload, sizes[s], cases[c].type, flush_every ? flush_every - 1 : 0};
+            char params[96];
+            snprintf(params, sizeof(params), "type=%s,size=%zu", cases[c].name, sizes[s]);
+            bench_run(bench, "debug_callback", params, 0, run_debug_callback, &state);
+        }
+        trace_shutdown();
+    }
+}
+
+static void run_response_data(void* arg, uint64_t iterations) {
+    const char* ip_version = (const char*)arg;
+    for (uint64_t i = 0; i < iterations; i++) {
+        ResponseData data = initResponseData(ip_version);
+        cleanupResponseData(&data);
+    }
+}
+
+static void bench_response_data(BenchContext* bench) {
+    bench_run(bench, "response_data", "ip_version=IPv4", 0, run_response_data, (void*)"IPv4");
+    bench_run(bench, "response_data", "ip_version=default", 0, run_response_data, (void*)"기본 (WHATEVER)");
+}
+
+// ---------------------------------------------------------------------------
+// 서버 응답 경로와 TLS 레코드 경로
+
+// 테스트용 자체 서명 인증서 (P-256, 서명/키 교환 비용을 줄이기 위해 RSA 대신)
+static SSL_CTX* create_server_context(void) {
+    SSL_CTX* ctx = SSL_CTX_new(TLS_server_method());
+    EVP_PKEY* pkey = EVP_EC_gen("P-256");
+    X509* x509 = X509_new();
+    int ok = ctx && pkey && x509;
+
+    if (ok) {
+        X509_set_version(x509, 2);
+        ASN1_INTEGER_set(X509_get_serialNumber(x509), 1);
+        X509_gmtime_adj(X509_get_notBefore(x509), 0);
+        X509_gmtime_adj(X509_get_notAfter(x509), 24 * 60 * 60);
+        X509_NAME* name = X509_get_subject_name(x509);
+        X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, (const unsigned char*)"localhost", -1, -1, 0);
+        X509_set_issuer_name(x509, name);
+        X509_set_pubkey(x509, pkey);
+        ok = X509_sign(x509, pkey, EVP_sha256()) > 0 && SSL_CTX_use_certificate(ctx, x509) == 1 &&
+             SSL_CTX_use_PrivateKey(ctx, pkey) == 1;
+    }
+    X509_free(x509);
+    EVP_PKEY_free(pkey);
+    if (!ok) {
+        ERR_print_errors_fp(stderr);
+        SSL_CTX_free(ctx);
+        return NULL;
+    }
+    return ctx;
+}
+
+// 루프백으로 핸드셰이크를 마친 엔진 한 쌍 (suite가 NULL이면 기본 스위트)
+static int open_loopback(SSL_CTX* client_ctx, SSL_CTX* server_ctx, const char* suite,
+                         TlsEngine* client, TlsEngine* server) {
+    if (suite && SSL_CTX_set_ciphersuites(client_ctx, suite) != 1) {
+        return -1;
+    }
+    if (tls_engine_init(client, client_ctx, 0) != 0) {
+        return -1;
+    }
+    if (tls_engine_init(server, server_ctx, 1) != 0) {
+        tls_engine_free(client);
+        return -1;
+    }
+    if (tls_engine_loopback_handshake(client, server) != 0) {
+        ERR_print_errors_fp(stderr);
+        tls_engine_free(client);
+        tls_engine_free(server);
+        return -1;
+    }
+    return 0;
+}
+
+typedef struct {
+    TlsEngine* server;
+    const char* body;
+    size_t size;
+    char* scratch;
+} SendBenchState;
+
+// 응답 한 번 (헤더 작성 + 복사 + 암호화) 뒤 암호문은 버린다
+static void run_send_http_response(void* arg, uint64_t iterations) {
+    SendBenchState* state = (SendBenchState*)arg;
+    for (uint64_t i = 0; i < iterations; i++) {
+        if (send_http_response(state->server->ssl, "200 OK", "text/html; charset=utf-8", state->body,
+                               state->size) <= 0) {
+            fprintf(stderr, "send_http_response 실패\n");
+            exit(1);
+        }
+        while (tls_engine_drain(state->server, state->scratch, BENCH_SCRATCH_SIZE) > 0) {
+        }
+    }
+}
+
+static void bench_send_http_response(BenchContext* bench, SSL_CTX* client_ctx, SSL_CTX* server_ctx,
+                                     const char* payload, char* scratch) {
+    static const size_t sizes[] = {0, 1024, 16384, 262144};
+    TlsEngine client, server;
+
+    if (open_loopback(client_ctx, server_ctx, NULL, &client, &server) != 0) {
+        fprintf(stderr, "루프백 핸드셰이크 실패\n");
+        exit(1);
+    }
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        SendBenchState state = {&server, payload, sizes[s], scratch};
+        char params[96];
+        snprintf(params, sizeof(params), "body=%zu", sizes[s]);
+        bench_run(bench, "send_http_response", params, sizes[s], run_send_http_response, &state);
+    }
+    tls_engine_free(&client);
+    tls_engine_free(&server);
+}
+
+typedef struct {
+    ServerWorker* worker;
+    Connection* conn;
+    const char* request;
+    size_t request_len;
+} RequestBenchState;
+
+// 요청 하나 처리 (파싱 + 응답 작성). 응답 버퍼는 서버처럼 매번 풀에 돌려준다
+static void run_handle_http_request(void* arg, uint64_t iterations) {
+    RequestBenchState* state = (RequestBenchState*)arg;
+    Connection* conn = state->conn;
+    for (uint64_t i = 0; i < iterations; i++) {
+        memcpy(conn->in, state->request, state->request_len);
+        conn->in_len = state->request_len;
+        if (handle_http_request(conn, state->request_len) != 0) {
+            fprintf(stderr, "handle_http_request 실패\n");
+            exit(1);
+        }
+        if (conn->out_cap == state->worker->buffers.buffer_size) {
+            buffer_pool_put(&state->worker->buffers, conn->out);
+        } else {
+            free(conn->out);
+        }
+        conn->out = NULL;
+        conn->out_cap = 0;
+        conn->out_len = 0;
+    }
+}
+
+static void bench_handle_http_request(BenchContext* bench, const char* payload) {
+    static const char minimal[] = "GET / HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    static const char browser[] =
+        "GET /index.html?lang=ko HTTP/1.1\r\n"
+        "Host: localhost:8443\r\n"
+        "User-Agent: Mozilla/5.0 (X11; Linux x86_64; rv:128.0) Gecko/20100101 Firefox/128.0\r\n"
+        "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8\r\n"
+        "Accept-Language: ko-KR,ko;q=0.8,en-US;q=0.5,en;q=0.3\r\n"
+        "Accept-Encoding: gzip, deflate, br, zstd\r\n"
+        "Cookie: session=0123456789abcdef0123456789abcdef; theme=dark\r\n"
+        "Upgrade-Insecure-Requests: 1\r\n"
+        "Sec-Fetch-Dest: document\r\n"
+        "Sec-Fetch-Mode: navigate\r\n"
+        "Sec-Fetch-Site: none\r\n"
+        "Connection: keep-alive\r\n"
+        "\r\n";
+    static const char metrics[] = "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    static const struct {
+        const char* name;
+        const char* request;
+        size_t request_len;
+        size_t body;
+    } cases[] = {
+        {"minimal", minimal, sizeof(minimal) - 1, 1024},
+        {"minimal", minimal, sizeof(minimal) - 1, 65536},
+        {"browser", browser, sizeof(browser) - 1, 1024},
+        {"browser", browser, sizeof(browser) - 1, 65536},
+        {"metrics", metrics, sizeof(metrics) - 1, 0},
+    };
+
+    TlsServerConfig config;
+    tls_server_default_config(&config, "microbench", 0);
+    config.response_body = payload;
+
+    ServerWorker worker;
+    memset(&worker, 0, sizeof(worker));
+    worker.config = &config;
+    worker.metrics = server_metrics_register();
+    buffer_pool_init(&worker.buffers, SERVER_POOL_BUFFER_SIZE, 16);
+
+    Connection conn;
+    memset(&conn, 0, sizeof(conn));
+    conn.worker = &worker;
+    conn.in_cap = SERVER_POOL_BUFFER_SIZE;
+    conn.in = (char*)malloc(conn.in_cap);
+    if (!worker.metrics || !conn.in) {
+        fprintf(stderr, "메모리 할당 실패\n");
+        exit(1);
+    }
+
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        worker.body_len = cases[c].body;
+        RequestBenchState state = {&worker, &conn, cases[c].request, cases[c].request_len};
+        char params[96];
+        if (cases[c].body > 0) {
+            snprintf(params, sizeof(params), "request=%s,body=%zu", cases[c].name, cases[c].body);
+        } else {
+            snprintf(params, sizeof(params), "request=%s", cases[c].name);
+        }
+        bench_run(bench, "handle_http_request", params, cases[c].request_len, run_handle_http_request, &state);
+    }
+
+    free(conn.in);
+    buffer_pool_destroy(&worker.buffers);
+}
+
+typedef struct {
+    TlsEngine* client;
+    TlsEngine* server;
+    const char* payload;
+    size_t size;
+    size_t write_size;          // 한 번에 쓰는 평문 크기 (소켓 send 한 번)
+    char* scratch;
+} RecordBenchState;
+
+// 클라이언트가 평문을 암호화 -> 서버 입력으로 옮김 -> 서버가 복호화해 모두 읽음
+static void run_tls_record(void* arg, uint64_t iterations) {
+    RecordBenchState* state = (RecordBenchState*)arg;
+    for (uint64_t i = 0; i < iterations; i++) {
+        for (size_t offset = 0; offset < state->size; offset += state->write_size) {
+            size_t length = state->size - offset < state->write_size ? state->size - offset : state->write_size;
+            if (tls_engine_write(state->client, state->payload + offset, length) != TLS_ENGINE_OK) {
+                fprintf(stderr, "tls_engine_write 실패\n");
+                exit(1);
+            }
+            tls_engine_transfer(state->client, state->server);
+        }
+        size_t received = 0;
+        while (received < state->size) {
+            size_t bytes = 0;
+            if (tls_engine_read(state->server, state->scratch, BENCH_SCRATCH_SIZE, &bytes) != TLS_ENGINE_OK) {
+                fprintf(stderr, "tls_engine_read 실패 (%zu/%zu바이트)\n", received, state->size);
+                exit(1);
+            }
+            received += bytes;
+        }
+    }
+}
+
+static void bench_tls_record(BenchContext* bench, SSL_CTX* client_ctx, SSL_CTX* server_ctx,
+                             const char* payload, char* scratch) {
+    static const char* const suites[] = {"TLS_AES_128_GCM_SHA256", "TLS_CHACHA20_POLY1305_SHA256"};
+    static const size_t sizes[] = {64, 1024, 16384, 262144};
+    static const size_t write_sizes[] = {0, 1460};     // 0: 한 번에 전부
+
+    for (size_t c = 0; c < sizeof(suites) / sizeof(suites[0]); c++) {
+        TlsEngine client, server;
+        if (open_loopback(client_ctx, server_ctx, suites[c], &client, &server) != 0) {
+            fprintf(stderr, "루프백 핸드셰이크 실패: %s\n", suites[c]);
+            continue;
+        }
+        // 핸드셰이크 뒤 서버가 보낸 세션 티켓을 먼저 처리해 둔다
+        size_t ignored;
+        tls_engine_read(&client, scratch, BENCH_SCRATCH_SIZE, &ignored);
+
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+            for (size_t w = 0; w < sizeof(write_sizes) / sizeof(write_sizes[0]); w++) {
+                if (write_sizes[w] >= sizes[s]) {
+                    continue;
+                }
+                RecordBenchState state = {&client, &server, payload, sizes[s],
+                                          write_sizes[w] ? write_sizes[w] : sizes[s], scratch};
+                char params[96];
+                char write_name[24] = "whole";
+                if (write_sizes[w]) {
+                    snprintf(write_name, sizeof(write_name), "%zu", write_sizes[w]);
+                }
+                snprintf(params, sizeof(params), "suite=%s,payload=%zu,write=%s", SSL_get_cipher(client.ssl),
+                         sizes[s], write_name);
+                bench_run(bench, "tls_record", params, sizes[s], run_tls_record, &state);
+            }
+        }
+        tls_engine_free(&client);
+        tls_engine_free(&server);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// JSON 출력과 비교
+
+static void json_string(FILE* out, const char* text) {
+    fputc('"', out);
+    for (const char* p = text; *p; p++) {
+        if (*p == '"' || *p == '\\') {
+            fputc('\\', out);
+            fputc(*p, out);
+        } else if ((unsigned char)*p < 0x20) {
+            fprintf(out, "\\u%04x", (unsigned char)*p);
+        } else {
+            fputc(*p, out);
+        }
+    }
+    fputc('"', out);
+}
+
+// 결과는 한 줄에 하나씩 쓴다 (--compare가 줄 단위로 읽는다)
+static void bench_write_json(const BenchContext* bench, FILE* out) {
+    char timestamp[32];
+    time_t now = time(NULL);
+    struct tm tm;
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", gmtime_r(&now, &tm));
+
+    fprintf(out, "{\n  \"schema\": \"%s\",\n  \"timestamp\": \"%s\",\n  \"openssl\": ", BENCH_JSON_SCHEMA, timestamp);
+    json_string(out, OpenSSL_version(OPENSSL_VERSION));
+    fprintf(out, ",\n  \"curl\": ");
+    json_string(out, curl_version());
+    fprintf(out, ",\n  \"compiler\": ");
+#ifdef __VERSION__
+    json_string(out, __VERSION__);
+#else
+    json_string(out, "unknown");
+#endif
+    fprintf(out, ",\n  \"min_time\": %.3f,\n  \"repetitions\": %d,\n  \"results\": [\n", bench->min_time,
+            bench->repetitions);
+    for (int i = 0; i < bench->count; i++) {
+        const BenchResult* r = &bench->results[i];
+        fprintf(out, "    {\"name\": \"%s\", \"params\": \"%s\", \"iterations\": %llu, \"ns_per_op\": %.3f, "
+                     "\"ns_min\": %.3f, \"spread\": %.4f, \"bytes_per_op\": %zu, \"mb_per_s\": %.3f}%s\n",
+                r->name, r->params, (unsigned long long)r->iterations, r->ns_per_op, r->ns_min, r->spread,
+                r->bytes_per_op, r->bytes_per_op ? (double)r->bytes_per_op / r->ns_per_op * 1e3 : 0.0,
+                i + 1 < bench->count ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+}
+
+// 한 줄에서 "key": "값" 문자열 필드 추출 (우리가 쓴 형식만 읽는다)
+static int json_line_string(const char* line, const char* key, char* value, size_t size) {
+    char pattern[40];
+    snprintf(pattern, sizeof(pattern), "\"%s\": \"", key);
+    const char* start = strstr(line, pattern);
+    if (!start) {
+        return -1;
+    }
+    start += strlen(pattern);
+    const char* end = strchr(start, '"');
+    if (!end || (size_t)(end - start) >= size) {
+        return -1;
+    }
+    memcpy(value, start, (size_t)(end - start));
+    value[end - start] = '\0';
+    return 0;
+}
+
+static int json_line_number(const char* line, const char* key, double* value) {
+    char pattern[40];
+    snprintf(pattern, sizeof(pattern), "\"%s\": ", key);
+    const char* start = strstr(line, pattern);
+    if (!start) {
+        return -1;
+    }
+    char* end;
+    *value = strtod(start + strlen(pattern), &end);
+    return end == start + strlen(pattern) ? -1 : 0;
+}
+
+// 이전 결과와 비교. threshold(%)보다 느려진 항목 수를 돌려준다 (threshold가 0이면 세지 않음)
+static int bench_compare(const BenchContext* bench, const char* path, double threshold) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        perror(path);
+        return -1;
+    }
+
+    typedef struct {
+        char key[160];
+        double ns_per_op;
+    } Baseline;
+    Baseline* baseline = (Baseline*)calloc(BENCH_MAX_RESULTS, sizeof(Baseline));
+    int baseline_count = 0;
+    char line[1024];
+    while (baseline && baseline_count < BENCH_MAX_RESULTS && fgets(line, sizeof(line), file)) {
+        char name[48], params[96];
+        double ns;
+        if (json_line_string(line, "name", name, sizeof(name)) == 0 &&
+            json_line_string(line, "params", params, sizeof(params)) == 0 &&
+            json_line_number(line, "ns_per_op", &ns) == 0) {
+            snprintf(baseline[baseline_count].key, sizeof(baseline[0].key), "%s/%s", name, params);
+            baseline[baseline_count++].ns_per_op = ns;
+        }
+    }
+    fclose(file);
+
+    int regressions = 0;
+    fprintf(bench->human, "\n=== 비교: %s (+는 느려짐) ===\n", path);
+    fprintf(bench->human, "%-67s %12s %12s %9s\n", "벤치마크", "이전", "현재", "변화");
+    for (int i = 0; i < bench->count; i++) {
+        const BenchResult* r = &bench->results[i];
+        char key[160], now_text[32], before_text[32];
+        snprintf(key, sizeof(key), "%s/%s", r->name, r->params);
+        format_ns(now_text, sizeof(now_text), r->ns_per_op);
+
+        const Baseline* match = NULL;
+        for (int b = 0; b < baseline_count && !match; b++) {
+            if (strcmp(baseline[b].key, key) == 0) {
+                match = &baseline[b];
+            }
+        }
+        if (!match) {
+            fprintf(bench->human, "%-67s %12s %12s %9s\n", key, "-", now_text, "새 항목");
+            continue;
+        }
+        double change = (r->ns_per_op - match->ns_per_op) / match->ns_per_op * 100;
+        int regressed = threshold > 0 && change > threshold;
+        regressions += regressed;
+        format_ns(before_text, sizeof(before_text), match->ns_per_op);
+        fprintf(bench->human, "%-67s %12s %12s %+8.1f%%%s\n", key, before_text, now_text, change,
+                regressed ? "  <- 느려짐" : "");
+    }
+    if (threshold > 0) {
+        fprintf(bench->human, "기준 %.1f%%보다 느려진 항목: %d개\n", threshold, regressions);
+    }
+    free(baseline);
+    return regressions;
+}
+
+static void print_usage(const char* program) {
+    printf("사용법: %s [--filter TEXT] [--min-time SEC] [--repetitions N] [--json FILE|-] [--compare FILE]\n"
+           "          [--threshold PCT] [--list]\n", program);
+    printf("  --filter TEXT      이름/매개변수에 TEXT가 들어 있는 벤치마크만 (예: tls_record, body=65536)\n");
+    printf("  --min-time SEC     반복 한 번의 목표 시간 (기본값 0.1)\n");
+    printf("  --repetitions N    반복 횟수, 중앙값 사용 (기본값 5, 최대 64)\n");
+    printf("  --json FILE|-      결과를 JSON으로 저장 (-이면 stdout, 표는 stderr)\n");
+    printf("  --compare FILE     이전 --json 결과와 비교\n");
+    printf("  --threshold PCT    비교에서 PCT%%보다 느려진 항목이 있으면 종료 코드 2\n");
+    printf("  --list             측정하지 않고 벤치마크 이름만 출력\n");
+}
+
+int main(int argc, char* argv[]) {
+    BenchContext* bench = (BenchContext*)calloc(1, sizeof(BenchContext));
+    const char* json_path = NULL;
+    const char* compare_path = NULL;
+    double threshold = 0.0;
+
+    if (!bench) {
+        return 1;
+    }
+    bench->min_time = 0.1;
+    bench->repetitions = 5;
+    bench->human = stdout;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            bench->filter = argv[++i];
+        } else if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+            bench->min_time = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--repetitions") == 0 && i + 1 < argc) {
+            bench->repetitions = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json_path = argv[++i];
+        } else if (strcmp(argv[i], "--compare") == 0 && i + 1 < argc) {
+            compare_path = argv[++i];
+        } else if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) {
+            threshold = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--list") == 0) {
+            bench->list_only = 1;
+        } else {
+            print_usage(argv[0]);
+            free(bench);
+            return strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0 ? 0 : 1;
+        }
+    }
+    if (bench->min_time <= 0.0 || bench->repetitions < 1 || bench->repetitions > 64) {
+        fprintf(stderr, "--min-time은 0보다 크고, --repetitions는 1~64이어야 합니다.\n");
+        free(bench);
+        return 1;
+    }
+    if (json_path && strcmp(json_path, "-") == 0) {
+        bench->human = stderr;
+    }
+
+    char* payload = make_payload(BENCH_MAX_PAYLOAD);
+    char* scratch = (char*)malloc(BENCH_SCRATCH_SIZE);
+    FILE* trace_sink = fopen("/dev/null", "w");
+    SSL_CTX* server_ctx = create_server_context();
+    SSL_CTX* client_ctx = SSL_CTX_new(TLS_client_method());
+    if (!payload || !scratch || !trace_sink || !server_ctx || !client_ctx) {
+        fprintf(stderr, "벤치마크 초기화 실패\n");
+        return 1;
+    }
+    SSL_CTX_set_verify(client_ctx, SSL_VERIFY_NONE, NULL);
+
+    if (!bench->list_only) {
+        fprintf(bench->human, "%s, %s\n", OpenSSL_version(OPENSSL_VERSION), curl_version());
+        fprintf(bench->human, "반복 %d회 (각 약 %.2f초), 중앙값\n\n", bench->repetitions, bench->min_time);
+        fprintf(bench->human, "%-22s %-44s %12s %14s %7s\n", "벤치마크", "매개변수", "시간/연산", "처리량", "편차");
+    }
+    bench_write_callback(bench, payload);
+    bench_debug_callback(bench, payload, trace_sink);
+    bench_response_data(bench);
+    bench_content_hash(bench, payload);
+    bench_send_http_response(bench, client_ctx, server_ctx, payload, scratch);
+    bench_handle_http_request(bench, payload);
+    bench_tls_record(bench, client_ctx, server_ctx, payload, scratch);
+
+    int status = 0;
+    if (!bench->list_only) {
+        if (json_path) {
+            FILE* out = strcmp(json_path, "-") == 0 ? stdout : fopen(json_path, "w");
+            if (!out) {
+                perror(json_path);
+                status = 1;
+            } else {
+                bench_write_json(bench, out);
+                if (out != stdout) {
+                    fclose(out);
+                    fprintf(bench->human, "\nJSON 결과: %s\n", json_path);
+                }
+            }
+        }
+        if (compare_path) {
+            int regressions = bench_compare(bench, compare_path, threshold);
+            if (regressions < 0) {
+                status = 1;
+            } else if (regressions > 0 && status == 0) {
+                status = 2;
+            }
+        }
+    }
+
+    SSL_CTX_free(client_ctx);
+    SSL_CTX_free(server_ctx);
+    fclose(trace_sink);
+    free(scratch);
+    free(payload);
+    free(bench);
+    return status;
+}
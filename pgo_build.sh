@@ -0,0 +1,93 @@
+#!/bin/bash
+
+# TLS 서버 프로파일 기반 최적화(PGO) 빌드 스크립트
+# 1. pgo-generate 프리셋으로 계측한 서버를 빌드
+# 2. 로컬 부하 생성기(tls_load_test)와 핸드셰이크 벤치마크(tls_client_test --bench)로 epoll/io_uring 백엔드를 학습
+# 3. pgo-use 프리셋으로 같은 빌드 디렉토리에서 서버를 다시 빌드 (결과: build/pgo/)
+# 사용법: ./pgo_build.sh [포트]
+
+set -e
+
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+BLUE='\033[0;34m'
+NC='\033[0m' # No Color
+
+print_error() {
+    echo -e "${RED}❌ $1${NC}"
+}
+
+print_success() {
+    echo -e "${GREEN}✅ $1${NC}"
+}
+
+print_info() {
+    echo -e "${BLUE}ℹ️  $1${NC}"
+}
+
+PORT=${1:-18443}
+BUILD_DIR="build/pgo"
+PGO_DIR="$BUILD_DIR/pgo-data"
+JOBS=$(nproc 2>/dev/null || echo 2)
+SERVER_PID=""
+
+cd "$(dirname "$0")"
+
+stop_server() {
+    if [[ -n "$SERVER_PID" ]]; then
+        # SIGTERM이면 드레인 후 main에서 정상 종료하므로 프로파일이 기록된다
+        kill -TERM "$SERVER_PID" 2>/dev/null || true
+        wait "$SERVER_PID" 2>/dev/null || true
+        SERVER_PID=""
+    fi
+}
+trap stop_server EXIT
+
+# 함수: 서버가 포트를 열 때까지 대기 (최대 5초)
+wait_for_port() {
+    for _ in $(seq 50); do
+        if (exec 3<>"/dev/tcp/127.0.0.1/$PORT") 2>/dev/null; then
+            return 0
+        fi
+        sleep 0.1
+    done
+    return 1
+}
+
+# 함수: 백엔드 하나로 학습 부하 실행
+train_backend() {
+    local backend=$1
+    print_info "학습: --backend $backend (포트 $PORT)"
+    "$BUILD_DIR/tls_server_test" "$PORT" --backend "$backend" --early-data 4096 > "$PGO_DIR/server-$backend.log" 2>&1 &
+    SERVER_PID=$!
+    if ! wait_for_port; then
+        print_error "서버가 시작되지 않았습니다 (로그: $PGO_DIR/server-$backend.log)"
+        exit 1
+    fi
+    # keep-alive 요청 처리 경로
+    "$BUILD_DIR/tls_load_test" 127.0.0.1 "$PORT" --connections 16 --requests 2000 > /dev/null
+    # 핸드셰이크 경로 (전체, 재개, 0-RTT)
+    "$BUILD_DIR/tls_client_test" 127.0.0.1 "$PORT" / --bench --count 100 --request > /dev/null
+    stop_server
+}
+
+print_info "1단계: 계측 빌드"
+cmake --preset pgo-generate > /dev/null
+rm -rf "$PGO_DIR"
+mkdir -p "$PGO_DIR"
+cmake --build --preset pgo-generate -j "$JOBS"
+
+print_info "2단계: 학습 부하 실행"
+train_backend epoll
+train_backend uring
+
+# clang은 원시 프로파일을 합쳐야 한다 (gcc는 .gcda를 그대로 쓴다)
+if compgen -G "$PGO_DIR/*.profraw" > /dev/null; then
+    llvm-profdata merge -output="$PGO_DIR/default.profdata" "$PGO_DIR"/*.profraw
+fi
+
+print_info "3단계: 프로파일 적용 빌드"
+cmake --preset pgo-use > /dev/null
+cmake --build --preset pgo-use -j "$JOBS"
+
+print_success "PGO 빌드 완료: $BUILD_DIR/tls_server_test, $BUILD_DIR/tls_server_file_test"
@@ -0,0 +1,962 @@
+#define _GNU_SOURCE
+#include "probe_monitor.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <curl/curl.h>
+#include "timer_wheel.h"
+#include "curl_harness.h"
+#include "curl_result.h"
+
+#define MONITOR_FAMILIES 2
+#define MONITOR_BUCKETS 32              // 지연 히스토그램: 0.5ms부터 √2배씩 (마지막은 약 23초 이상 전부)
+#define MONITOR_TICK_MS 10
+#define MONITOR_MAX_WAIT_MS 1000        // 유휴 시에도 이만큼마다 깨어나 중지/종료 시각을 확인
+#define MONITOR_EWMA_WEIGHT 0.2f
+#define MONITOR_REQUEST_MAX 2048
+#define MONITOR_IO_TIMEOUT_MS 500       // 엔드포인트 클라이언트 읽기/쓰기 제한
+#define MONITOR_TOP_TARGETS 10          // 요약에 나열할 한쪽 주소 계열만 실패한 대상 수
+
+#define target_from_timer(entry) ((MonitorTarget*)((char*)(entry) - offsetof(MonitorTarget, timer)))
+
+static const char* const FAMILY_NAMES[MONITOR_FAMILIES] = {"IPv4", "IPv6"};
+static const char* const FAMILY_LABELS[MONITOR_FAMILIES] = {"ipv4", "ipv6"};
+
+// 대상/주소 계열 하나의 통계 (고정 크기)
+typedef struct {
+    uint32_t probes;
+    uint32_t failures;
+    uint16_t histogram[2][MONITOR_BUCKETS];     // 현재/이전 창의 성공한 탐침 전체 시간 분포
+    uint16_t window_probes[2];
+    uint16_t window_failures[2];
+    float ewma_connect_ms;                      // 단계별 소요 시간의 지수 이동 평균 (성공한 탐침)
+    float ewma_tls_ms;
+    float ewma_ttfb_ms;
+    float ewma_total_ms;
+    uint32_t last_success_sec;                  // 시작 후 초 + 1 (0이면 아직 성공 없음)
+    int16_t last_error;                         // 마지막 CURLcode
+    uint16_t last_status;
+    uint8_t last_ok;
+    uint8_t probed;                             // 한 번이라도 끝난 탐침이 있는지
+    uint8_t consecutive_failures;               // 255에서 멈춤
+} FamilyStats;
+
+typedef struct MonitorTarget {
+    TimerEntry timer;
+    char* url;
+    uint64_t next_due_ms;                       // 지터를 빼고 계산한 다음 탐침 시각 (지터가 누적되지 않게)
+    uint32_t interval_ms;
+    uint32_t window_start_sec;
+    uint32_t skipped;                           // 앞 탐침이 끝나지 않아 건너뛴 주기 수
+    uint8_t window;                             // 현재 창 (0/1)
+    uint8_t inflight;
+    uint8_t queued;
+    struct MonitorTarget* next_ready;
+    FamilyStats family[MONITOR_FAMILIES];
+} MonitorTarget;
+
+typedef struct Probe {
+    CURL* easy;                                 // 끝나면 풀에 돌려 다음 탐침이 다시 쓴다
+    MonitorTarget* target;
+    int family;
+    struct curl_slist* harness;
+    struct Probe* next_free;
+} Probe;
+
+typedef struct {
+    char* data;
+    size_t len;
+    size_t cap;
+} MonitorBuffer;
+
+typedef struct {
+    const MonitorConfig* config;
+    ResultWriter* results;
+    MonitorTarget* targets;
+    size_t target_count;
+    TimerWheel wheel;
+    CURLM* multi;
+    Probe* probes;
+    Probe* free_probes;
+    unsigned inflight;
+    MonitorTarget* ready_head;
+    MonitorTarget* ready_tail;
+    size_t queued;
+    uint64_t start_ms;
+    uint64_t probes_done;
+    uint64_t endpoint_requests;
+    uint32_t rng;
+    int listen_fd;
+} Monitor;
+
+static volatile sig_atomic_t g_monitor_stop = 0;
+static double g_bucket_upper[MONITOR_BUCKETS];
+
+static void monitor_signal(int sig) {
+    (void)sig;
+    g_monitor_stop = 1;
+}
+
+static uint64_t monitor_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+}
+
+static uint32_t monitor_elapsed_sec(const Monitor* m) {
+    return (uint32_t)((monitor_now_ms() - m->start_ms) / 1000);
+}
+
+static uint32_t monitor_random(Monitor* m) {
+    uint32_t x = m->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    m->rng = x;
+    return x;
+}
+
+static void init_buckets(void) {
+    g_bucket_upper[0] = 0.5;
+    for (int i = 1; i < MONITOR_BUCKETS; i++) {
+        g_bucket_upper[i] = g_bucket_upper[i - 1] * 1.41421356237;
+    }
+}
+
+static int bucket_for(double ms) {
+    int i = 0;
+    while (i < MONITOR_BUCKETS - 1 && ms > g_bucket_upper[i]) {
+        i++;
+    }
+    return i;
+}
+
+// 히스토그램 백분위 (버킷 상한이므로 실제보다 최대 √2배 크게 나올 수 있다). 표본이 없으면 -1
+static double histogram_percentile(const uint64_t* histogram, double quantile) {
+    uint64_t total = 0;
+    for (int i = 0; i < MONITOR_BUCKETS; i++) {
+        total += histogram[i];
+    }
+    if (total == 0) {
+        return -1.0;
+    }
+    uint64_t rank = (uint64_t)(quantile * (double)total + 0.999999);
+    uint64_t seen = 0;
+    for (int i = 0; i < MONITOR_BUCKETS; i++) {
+        seen += histogram[i];
+        if (seen >= rank) {
+            return g_bucket_upper[i];
+        }
+    }
+    return g_bucket_upper[MONITOR_BUCKETS - 1];
+}
+
+static void family_histogram(const FamilyStats* stats, uint64_t* out) {
+    for (int i = 0; i < MONITOR_BUCKETS; i++) {
+        out[i] = (uint64_t)stats->histogram[0][i] + stats->histogram[1][i];
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 출력 버퍼
+
+static void buffer_printf(MonitorBuffer* buffer, const char* format, ...) {
+    for (;;) {
+        va_list args;
+        va_start(args, format);
+        size_t room = buffer->cap - buffer->len;
+        int written = vsnprintf(buffer->data ? buffer->data + buffer->len : NULL, room, format, args);
+        va_end(args);
+        if (written < 0) {
+            return;
+        }
+        if ((size_t)written < room) {
+            buffer->len += (size_t)written;
+            return;
+        }
+        size_t cap = buffer->cap ? buffer->cap * 2 : 65536;
+        while (cap < buffer->len + (size_t)written + 1) {
+            cap *= 2;
+        }
+        char* data = (char*)realloc(buffer->data, cap);
+        if (!data) {
+            return;
+        }
+        buffer->data = data;
+        buffer->cap = cap;
+    }
+}
+
+// Prometheus 레이블 값 (역슬래시, 따옴표, 줄바꿈 이스케이프)
+static void buffer_label(MonitorBuffer* buffer, const char* value) {
+    for (const char* p = value; *p; p++) {
+        if (*p == '\\' || *p == '"') {
+            buffer_printf(buffer, "\\%c", *p);
+        } else if (*p == '\n') {
+            buffer_printf(buffer, "\\n");
+        } else {
+            buffer_printf(buffer, "%c", *p);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 대상 파일
+
+static int load_targets(Monitor* m) {
+    FILE* file = fopen(m->config->targets_file, "r");
+    if (!file) {
+        fprintf(stderr, "대상 파일을 열 수 없습니다: %s (%s)\n", m->config->targets_file, strerror(errno));
+        return -1;
+    }
+
+    size_t cap = 0;
+    char* line = NULL;
+    size_t line_cap = 0;
+    unsigned line_no = 0;
+    while (getline(&line, &line_cap, file) > 0) {
+        line_no++;
+        char* saveptr = NULL;
+        char* url = strtok_r(line, " \t\r\n", &saveptr);
+        if (!url || url[0] == '#') {
+            continue;
+        }
+        char* interval_text = strtok_r(NULL, " \t\r\n", &saveptr);
+        long interval = m->config->interval_sec;
+        if (interval_text && interval_text[0] != '#') {
+            char* end = NULL;
+            interval = strtol(interval_text, &end, 10);
+            if (*end != '\0' || interval < 1 || interval > 86400) {
+                fprintf(stderr, "%s:%u: 주기는 1~86400초여야 합니다: %s\n", m->config->targets_file, line_no, interval_text);
+                fclose(file);
+                free(line);
+                return -1;
+            }
+        }
+
+        if (m->target_count == cap) {
+            size_t new_cap = cap ? cap * 2 : 256;
+            MonitorTarget* grown = (MonitorTarget*)realloc(m->targets, new_cap * sizeof(MonitorTarget));
+            if (!grown) {
+                fclose(file);
+                free(line);
+                return -1;
+            }
+            m->targets = grown;
+            cap = new_cap;
+        }
+        MonitorTarget* target = &m->targets[m->target_count++];
+        memset(target, 0, sizeof(*target));
+        timer_init(&target->timer);
+        target->url = strdup(url);
+        target->interval_ms = (uint32_t)interval * 1000;
+    }
+    fclose(file);
+    free(line);
+
+    if (m->target_count == 0) {
+        fprintf(stderr, "대상 파일에 URL이 없습니다: %s\n", m->config->targets_file);
+        return -1;
+    }
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// 스케줄링
+
+static void enqueue_ready(Monitor* m, MonitorTarget* target) {
+    target->queued = 1;
+    target->next_ready = NULL;
+    if (m->ready_tail) {
+        m->ready_tail->next_ready = target;
+    } else {
+        m->ready_head = target;
+    }
+    m->ready_tail = target;
+    m->queued++;
+}
+
+static void schedule_next(Monitor* m, MonitorTarget* target, uint64_t now) {
+    target->next_due_ms += target->interval_ms;
+    if (target->next_due_ms < now) {
+        target->next_due_ms = now + target->interval_ms;   // 밀렸으면 따라잡으려 몰아 보내지 않는다
+    }
+    uint64_t jitter = (uint64_t)target->interval_ms * m->config->jitter_pct / 100;
+    uint64_t due = target->next_due_ms;
+    if (jitter > 0) {
+        due = due - jitter + monitor_random(m) % (2 * jitter + 1);
+    }
+    timer_schedule(&m->wheel, &target->timer, due);
+}
+
+static void on_timer(TimerEntry* timer, void* arg) {
+    Monitor* m = (Monitor*)arg;
+    MonitorTarget* target = target_from_timer(timer);
+
+    schedule_next(m, target, monitor_now_ms());
+    if (target->inflight || target->queued) {
+        target->skipped++;
+        return;
+    }
+    enqueue_ready(m, target);
+}
+
+// 첫 탐침 시각을 주기 안에 고르게 펼친다 (i번째 대상은 주기의 i/N 지점)
+static void schedule_initial(Monitor* m) {
+    for (size_t i = 0; i < m->target_count; i++) {
+        MonitorTarget* target = &m->targets[i];
+        target->next_due_ms = m->start_ms + (uint64_t)target->interval_ms * i / m->target_count;
+        timer_schedule(&m->wheel, &target->timer, target->next_due_ms);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 탐침
+
+static size_t discard_body(void* ptr, size_t size, size_t nmemb, void* userdata) {
+    (void)ptr;
+    (void)userdata;
+    return size * nmemb;
+}
+
+static void start_probe(Monitor* m, MonitorTarget* target, int family) {
+    Probe* probe = m->free_probes;
+    m->free_probes = probe->next_free;
+
+    if (probe->easy) {
+        curl_easy_reset(probe->easy);
+    } else {
+        probe->easy = curl_easy_init();
+    }
+    probe->target = target;
+    probe->family = family;
+
+    CURL* curl = probe->easy;
+    curl_easy_setopt(curl, CURLOPT_URL, target->url);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, discard_body);
+    curl_easy_setopt(curl, CURLOPT_USERAGENT, "ipv4-ipv6-test/1.0 (monitor)");
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, (long)m->config->timeout_ms);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(curl, CURLOPT_PRIVATE, probe);
+    curl_easy_setopt(curl, CURLOPT_IPRESOLVE, family == 0 ? CURL_IPRESOLVE_V4 : CURL_IPRESOLVE_V6);
+    // 탐침마다 연결과 TLS를 새로 맺어 연결/TLS 시간을 잰다
+    curl_easy_setopt(curl, CURLOPT_FRESH_CONNECT, 1L);
+    curl_easy_setopt(curl, CURLOPT_FORBID_REUSE, 1L);
+    probe->harness = harness_apply(curl);
+
+    curl_multi_add_handle(m->multi, curl);
+    target->inflight++;
+    m->inflight++;
+}
+
+// 두 주소 계열을 같은 순간에 보내야 비교가 공정하므로 탐침 두 개가 비어 있을 때만 꺼낸다
+static void start_ready(Monitor* m) {
+    while (m->ready_head && m->config->max_inflight - m->inflight >= MONITOR_FAMILIES) {
+        MonitorTarget* target = m->ready_head;
+        m->ready_head = target->next_ready;
+        if (!m->ready_head) {
+            m->ready_tail = NULL;
+        }
+        target->queued = 0;
+        m->queued--;
+        for (int family = 0; family < MONITOR_FAMILIES; family++) {
+            start_probe(m, target, family);
+        }
+    }
+}
+
+static void rotate_window(MonitorTarget* target, uint32_t now_sec, unsigned window_sec) {
+    uint32_t age = now_sec - target->window_start_sec;
+    if (age < window_sec) {
+        return;
+    }
+    // 두 창 넘게 지났으면 이전 창도 오래된 값이므로 함께 비운다
+    int clear_both = age >= 2 * window_sec;
+    target->window ^= 1;
+    target->window_start_sec = now_sec;
+    for (int f = 0; f < MONITOR_FAMILIES; f++) {
+        FamilyStats* stats = &target->family[f];
+        for (int w = 0; w < 2; w++) {
+            if (w == target->window || clear_both) {
+                memset(stats->histogram[w], 0, sizeof(stats->histogram[w]));
+                stats->window_probes[w] = 0;
+                stats->window_failures[w] = 0;
+            }
+        }
+    }
+}
+
+static void ewma(float* average, double sample, int first) {
+    *average = first ? (float)sample : *average + MONITOR_EWMA_WEIGHT * ((float)sample - *average);
+}
+
+static void complete_probe(Monitor* m, CURL* curl, CURLcode res) {
+    Probe* probe = NULL;
+    curl_easy_getinfo(curl, CURLINFO_PRIVATE, (char**)&probe);
+    MonitorTarget* target = probe->target;
+    FamilyStats* stats = &target->family[probe->family];
+    uint32_t now_sec = monitor_elapsed_sec(m);
+
+    long status = 0;
+    double namelookup = 0, connect = 0, appconnect = 0, starttransfer = 0, total = 0;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
+    curl_easy_getinfo(curl, CURLINFO_NAMELOOKUP_TIME, &namelookup);
+    curl_easy_getinfo(curl, CURLINFO_CONNECT_TIME, &connect);
+    curl_easy_getinfo(curl, CURLINFO_APPCONNECT_TIME, &appconnect);
+    curl_easy_getinfo(curl, CURLINFO_STARTTRANSFER_TIME, &starttransfer);
+    curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME, &total);
+    // 응답이 오면 도달 가능 (5xx는 서버 쪽 장애로 본다)
+    int ok = res == CURLE_OK && status > 0 && status < 500;
+
+    rotate_window(target, now_sec, m->config->window_sec);
+    stats->probes++;
+    stats->window_probes[target->window]++;
+    stats->last_error = (int16_t)res;
+    stats->last_status = (uint16_t)status;
+    stats->last_ok = (uint8_t)ok;
+    stats->probed = 1;
+    if (ok) {
+        int first = stats->probes - stats->failures == 1;
+        ewma(&stats->ewma_connect_ms, (connect - namelookup) * 1000.0, first);
+        ewma(&stats->ewma_tls_ms, appconnect > 0 ? (appconnect - connect) * 1000.0 : 0.0, first);
+        ewma(&stats->ewma_ttfb_ms, starttransfer * 1000.0, first);
+        ewma(&stats->ewma_total_ms, total * 1000.0, first);
+        stats->histogram[target->window][bucket_for(total * 1000.0)]++;
+        stats->last_success_sec = now_sec + 1;
+        stats->consecutive_failures = 0;
+    } else {
+        stats->failures++;
+        stats->window_failures[target->window]++;
+        if (stats->consecutive_failures < 255) {
+            stats->consecutive_failures++;
+        }
+    }
+
+    if (result_writer_structured(m->results)) {
+        TestResult record;
+        result_init(&record, "ipv4_ipv6_test", "probe");
+        record.target = target->url;
+        record.method = "GET";
+        record.ip_version = FAMILY_NAMES[probe->family];
+        result_fill_from_curl(&record, curl);
+        record.success = ok;
+        if (res != CURLE_OK) {
+            record.error = curl_easy_strerror(res);
+        }
+        result_emit(m->results, &record);
+    }
+
+    curl_multi_remove_handle(m->multi, curl);
+    curl_slist_free_all(probe->harness);
+    probe->harness = NULL;
+    probe->target = NULL;
+    probe->next_free = m->free_probes;
+    m->free_probes = probe;
+    target->inflight--;
+    m->inflight--;
+    m->probes_done++;
+}
+
+static int drain_messages(Monitor* m) {
+    int pending = 0;
+    int completed = 0;
+    CURLMsg* msg;
+    while ((msg = curl_multi_info_read(m->multi, &pending)) != NULL) {
+        if (msg->msg == CURLMSG_DONE) {
+            complete_probe(m, msg->easy_handle, msg->data.result);
+            completed++;
+        }
+    }
+    return completed;
+}
+
+// ---------------------------------------------------------------------------
+// 보고
+
+static void render_metrics(const Monitor* m, MonitorBuffer* out) {
+    buffer_printf(out, "# HELP dualstack_targets Number of monitored targets\n# TYPE dualstack_targets gauge\n");
+    buffer_printf(out, "dualstack_targets %zu\n", m->target_count);
+    buffer_printf(out, "# TYPE dualstack_probes_inflight gauge\ndualstack_probes_inflight %u\n", m->inflight);
+    buffer_printf(out, "# TYPE dualstack_probes_queued gauge\ndualstack_probes_queued %zu\n", m->queued);
+    buffer_printf(out, "# TYPE dualstack_probes_completed_total counter\ndualstack_probes_completed_total %llu\n",
+                  (unsigned long long)m->probes_done);
+
+    static const char* const SERIES[] = {
+        "# HELP dualstack_up Whether the last probe got an HTTP response below 500\n# TYPE dualstack_up gauge\n",
+        "# TYPE dualstack_probes_total counter\n",
+        "# TYPE dualstack_probe_failures_total counter\n",
+        "# HELP dualstack_success_ratio Success ratio over the last two windows\n# TYPE dualstack_success_ratio gauge\n",
+        "# HELP dualstack_latency_ms Total probe time quantiles over the last two windows (bucket upper bound)\n"
+        "# TYPE dualstack_latency_ms gauge\n",
+        "# HELP dualstack_phase_ms Exponential moving average of phase durations\n# TYPE dualstack_phase_ms gauge\n",
+        "# TYPE dualstack_last_success_age_seconds gauge\n",
+    };
+    uint32_t now_sec = monitor_elapsed_sec(m);
+    for (size_t s = 0; s < sizeof(SERIES) / sizeof(SERIES[0]); s++) {
+        buffer_printf(out, "%s", SERIES[s]);
+        for (size_t i = 0; i < m->target_count; i++) {
+            const MonitorTarget* target = &m->targets[i];
+            for (int f = 0; f < MONITOR_FAMILIES; f++) {
+                const FamilyStats* stats = &target->family[f];
+                if (!stats->probed) {
+                    continue;
+                }
+                MonitorBuffer labels = {NULL, 0, 0};
+                buffer_printf(&labels, "target=\"");
+                buffer_label(&labels, target->url);
+                buffer_printf(&labels, "\",family=\"%s\"", FAMILY_LABELS[f]);
+                const char* l = labels.data ? labels.data : "";
+                unsigned window_probes = (unsigned)stats->window_probes[0] + stats->window_probes[1];
+                unsigned window_failures = (unsigned)stats->window_failures[0] + stats->window_failures[1];
+                uint64_t histogram[MONITOR_BUCKETS];
+
+                switch (s) {
+                    case 0:
+                        buffer_printf(out, "dualstack_up{%s} %d\n", l, stats->last_ok);
+                        break;
+                    case 1:
+                        buffer_printf(out, "dualstack_probes_total{%s} %u\n", l, stats->probes);
+                        break;
+                    case 2:
+                        buffer_printf(out, "dualstack_probe_failures_total{%s} %u\n", l, stats->failures);
+                        break;
+                    case 3:
+                        if (window_probes > 0) {
+                            buffer_printf(out, "dualstack_success_ratio{%s} %.4f\n", l,
+                                          1.0 - (double)window_failures / window_probes);
+                        }
+                        break;
+                    case 4:
+                        family_histogram(stats, histogram);
+                        if (histogram_percentile(histogram, 0.5) >= 0) {
+                            buffer_printf(out, "dualstack_latency_ms{%s,quantile=\"0.5\"} %.1f\n", l,
+                                          histogram_percentile(histogram, 0.5));
+                            buffer_printf(out, "dualstack_latency_ms{%s,quantile=\"0.95\"} %.1f\n", l,
+                                          histogram_percentile(histogram, 0.95));
+                        }
+                        break;
+                    case 5:
+                        if (stats->last_success_sec) {
+                            buffer_printf(out, "dualstack_phase_ms{%s,phase=\"connect\"} %.2f\n", l, stats->ewma_connect_ms);
+                            buffer_printf(out, "dualstack_phase_ms{%s,phase=\"tls\"} %.2f\n", l, stats->ewma_tls_ms);
+                            buffer_printf(out, "dualstack_phase_ms{%s,phase=\"ttfb\"} %.2f\n", l, stats->ewma_ttfb_ms);
+                            buffer_printf(out, "dualstack_phase_ms{%s,phase=\"total\"} %.2f\n", l, stats->ewma_total_ms);
+                        }
+                        break;
+                    default:
+                        if (stats->last_success_sec) {
+                            buffer_printf(out, "dualstack_last_success_age_seconds{%s} %u\n", l,
+                                          now_sec - (stats->last_success_sec - 1));
+                        }
+                        break;
+                }
+                free(labels.data);
+            }
+        }
+    }
+}
+
+static void render_summary(const Monitor* m, MonitorBuffer* out) {
+    uint32_t elapsed = monitor_elapsed_sec(m);
+    size_t both = 0, v4_only = 0, v6_only = 0, none = 0, waiting = 0;
+    uint64_t histogram[MONITOR_FAMILIES][MONITOR_BUCKETS];
+    uint64_t window_probes[MONITOR_FAMILIES] = {0}, window_failures[MONITOR_FAMILIES] = {0};
+    double phase_sum[MONITOR_FAMILIES][3] = {{0}};
+    size_t phase_count[MONITOR_FAMILIES] = {0};
+    uint64_t skipped = 0;
+    memset(histogram, 0, sizeof(histogram));
+
+    for (size_t i = 0; i < m->target_count; i++) {
+        const MonitorTarget* target = &m->targets[i];
+        const FamilyStats* v4 = &target->family[0];
+        const FamilyStats* v6 = &target->family[1];
+        skipped += target->skipped;
+        if (!v4->probed || !v6->probed) {
+            waiting++;
+        } else if (v4->last_ok && v6->last_ok) {
+            both++;
+        } else if (v4->last_ok) {
+            v4_only++;
+        } else if (v6->last_ok) {
+            v6_only++;
+        } else {
+            none++;
+        }
+        for (int f = 0; f < MONITOR_FAMILIES; f++) {
+            const FamilyStats* stats = &target->family[f];
+            for (int b = 0; b < MONITOR_BUCKETS; b++) {
+                histogram[f][b] += (uint64_t)stats->histogram[0][b] + stats->histogram[1][b];
+            }
+            window_probes[f] += (uint64_t)stats->window_probes[0] + stats->window_probes[1];
+            window_failures[f] += (uint64_t)stats->window_failures[0] + stats->window_failures[1];
+            if (stats->last_success_sec) {
+                phase_sum[f][0] += stats->ewma_connect_ms;
+                phase_sum[f][1] += stats->ewma_tls_ms;
+                phase_sum[f][2] += stats->ewma_ttfb_ms;
+                phase_count[f]++;
+            }
+        }
+    }
+
+    buffer_printf(out, "=== 이중 스택 모니터 (대상 %zu개, 실행 %u:%02u:%02u) ===\n", m->target_count, elapsed / 3600,
+                  elapsed / 60 % 60, elapsed % 60);
+    buffer_printf(out, "탐침 %llu회 완료 (진행 중 %u, 대기 %zu, 앞 탐침이 끝나지 않아 건너뜀 %llu)\n",
+                  (unsigned long long)m->probes_done, m->inflight, m->queued, (unsigned long long)skipped);
+    buffer_printf(out, "마지막 탐침: 둘 다 성공 %zu, IPv4만 %zu, IPv6만 %zu, 둘 다 실패 %zu, 아직 없음 %zu\n", both, v4_only,
+                  v6_only, none, waiting);
+    for (int f = 0; f < MONITOR_FAMILIES; f++) {
+        buffer_printf(out, "%s: ", FAMILY_NAMES[f]);
+        if (window_probes[f] == 0) {
+            buffer_printf(out, "최근 창에 탐침 없음\n");
+            continue;
+        }
+        buffer_printf(out, "성공률 %.2f%% (최근 창 %llu회)", 100.0 * (1.0 - (double)window_failures[f] / window_probes[f]),
+                      (unsigned long long)window_probes[f]);
+        double p50 = histogram_percentile(histogram[f], 0.5);
+        if (p50 >= 0) {
+            buffer_printf(out, ", 전체 시간 p50 %.1fms p95 %.1fms p99 %.1fms", p50, histogram_percentile(histogram[f], 0.95),
+                          histogram_percentile(histogram[f], 0.99));
+        }
+        if (phase_count[f] > 0) {
+            buffer_printf(out, ", 평균 연결 %.1fms TLS %.1fms 첫 바이트 %.1fms", phase_sum[f][0] / phase_count[f],
+                          phase_sum[f][1] / phase_count[f], phase_sum[f][2] / phase_count[f]);
+        }
+        buffer_printf(out, "\n");
+    }
+
+    // 한쪽 주소 계열만 실패한 대상 (이중 스택 문제를 먼저 보도록)
+    size_t listed = 0;
+    for (size_t i = 0; i < m->target_count && listed < MONITOR_TOP_TARGETS; i++) {
+        const MonitorTarget* target = &m->targets[i];
+        const FamilyStats* v4 = &target->family[0];
+        const FamilyStats* v6 = &target->family[1];
+        if (!v4->probed || !v6->probed || v4->last_ok == v6->last_ok) {
+            continue;
+        }
+        const FamilyStats* failed = v4->last_ok ? v6 : v4;
+        if (listed++ == 0) {
+            buffer_printf(out, "한쪽만 실패한 대상:\n");
+        }
+        buffer_printf(out, "  %-4s 실패 %3u회 연속 (%s, HTTP %u): %s\n", v4->last_ok ? "IPv6" : "IPv4",
+                      failed->consecutive_failures, curl_easy_strerror((CURLcode)failed->last_error),
+                      failed->last_status, target->url);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 로컬 HTTP 엔드포인트
+
+static int open_listener(const char* spec) {
+    char host[256] = "127.0.0.1";
+    const char* port = spec;
+    const char* colon = strrchr(spec, ':');
+    if (colon) {
+        size_t len = (size_t)(colon - spec);
+        if (spec[0] == '[' && len >= 2 && spec[len - 1] == ']') {
+            spec++;
+            len -= 2;
+        }
+        if (len == 0 || len >= sizeof(host)) {
+            return -1;
+        }
+        memcpy(host, spec, len);
+        host[len] = '\0';
+        port = colon + 1;
+    }
+
+    struct addrinfo hints, *res = NULL;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+    if (getaddrinfo(host, port, &hints, &res) != 0 || !res) {
+        return -1;
+    }
+    int fd = socket(res->ai_family, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    int one = 1;
+    if (fd >= 0 && (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)) != 0 ||
+                    bind(fd, res->ai_addr, res->ai_addrlen) != 0 || listen(fd, 16) != 0)) {
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(res);
+    return fd;
+}
+
+static int write_all(int fd, const char* data, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, data, len);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return -1;
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+// 요청 하나를 받아 응답하고 닫는다 (보고서 조회용이라 연결 유지나 동시 처리는 하지 않는다)
+static void serve_client(Monitor* m) {
+    int fd = accept4(m->listen_fd, NULL, NULL, SOCK_CLOEXEC);
+    if (fd < 0) {
+        return;
+    }
+    struct timeval timeout = {0, MONITOR_IO_TIMEOUT_MS * 1000};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    char request[MONITOR_REQUEST_MAX];
+    size_t len = 0;
+    while (len < sizeof(request) - 1) {
+        ssize_t n = read(fd, request + len, sizeof(request) - 1 - len);
+        if (n <= 0) {
+            break;
+        }
+        len += (size_t)n;
+        request[len] = '\0';
+        if (strstr(request, "\r\n\r\n")) {
+            break;
+        }
+    }
+    request[len] = '\0';
+    m->endpoint_requests++;
+
+    MonitorBuffer body = {NULL, 0, 0};
+    int status = 200;
+    const char* content_type = "text/plain; version=0.0.4; charset=utf-8";
+    if (strncmp(request, "GET /metrics ", 13) == 0 || strncmp(request, "GET /metrics?", 13) == 0) {
+        render_metrics(m, &body);
+    } else if (strncmp(request, "GET / ", 6) == 0) {
+        content_type = "text/plain; charset=utf-8";
+        render_summary(m, &body);
+    } else {
+        status = 404;
+        content_type = "text/plain; charset=utf-8";
+        buffer_printf(&body, "/metrics 또는 /\n");
+    }
+
+    char header[256];
+    int header_len = snprintf(header, sizeof(header),
+                              "HTTP/1.1 %d %s\r\nContent-Type: %s\r\nContent-Length: %zu\r\nConnection: close\r\n\r\n",
+                              status, status == 200 ? "OK" : "Not Found", content_type, body.len);
+    if (write_all(fd, header, (size_t)header_len) == 0 && body.len > 0) {
+        write_all(fd, body.data, body.len);
+    }
+    free(body.data);
+    close(fd);
+}
+
+// ---------------------------------------------------------------------------
+// 설정
+
+void monitor_default_config(MonitorConfig* config) {
+    memset(config, 0, sizeof(*config));
+    config->interval_sec = 60;
+    config->jitter_pct = 10;
+    config->timeout_ms = 10000;
+    config->max_inflight = 64;
+    config->window_sec = 300;
+    config->listen = "127.0.0.1:9465";
+}
+
+static void print_monitor_usage(const char* program) {
+    printf("사용법: %s --monitor FILE [--interval SEC] [--jitter PCT] [--timeout MS] [--concurrency N]\n", program);
+    printf("        [--window SEC] [--listen [ADDR:]PORT|off] [--duration SEC] [--seed N]\n");
+    printf("  FILE              한 줄에 \"URL [주기초]\" ('#' 주석). 대상마다 IPv4와 IPv6 탐침을 동시에 보냄\n");
+    printf("  --interval SEC    기본 탐침 주기 (기본값 60)\n");
+    printf("  --jitter PCT      주기 대비 ± 지터 (기본값 10)\n");
+    printf("  --timeout MS      탐침 하나의 제한 시간 (기본값 10000)\n");
+    printf("  --concurrency N   동시 탐침 수 (기본값 64, 2 이상)\n");
+    printf("  --window SEC      성공률/지연 분포 창 (최근 두 창 사용, 기본값 300)\n");
+    printf("  --listen ADDR     /metrics, / 엔드포인트 (기본값 127.0.0.1:9465, off면 끔)\n");
+    printf("  --duration SEC    이 시간 뒤 요약을 출력하고 종료 (기본값 0: SIGINT/SIGTERM까지)\n");
+    printf("  --seed N          지터 난수 시드 (기본값: 시각)\n");
+}
+
+static int parse_unsigned(const char* text, unsigned min, unsigned max, unsigned* out) {
+    char* end = NULL;
+    unsigned long value = strtoul(text, &end, 10);
+    if (end == text || *end != '\0' || value < min || value > max) {
+        return -1;
+    }
+    *out = (unsigned)value;
+    return 0;
+}
+
+int monitor_parse_args(int argc, char** argv, MonitorConfig* config) {
+    int ok = 1;
+    for (int i = 1; i < argc && ok; i++) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+        unsigned seed = 0;
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            ok = 0;
+            break;
+        }
+        if (!value) {
+            ok = 0;
+            break;
+        }
+        i++;
+        if (strcmp(arg, "--monitor") == 0) {
+            config->targets_file = value;
+        } else if (strcmp(arg, "--interval") == 0) {
+            ok = parse_unsigned(value, 1, 86400, &config->interval_sec) == 0;
+        } else if (strcmp(arg, "--jitter") == 0) {
+            ok = parse_unsigned(value, 0, 50, &config->jitter_pct) == 0;
+        } else if (strcmp(arg, "--timeout") == 0) {
+            ok = parse_unsigned(value, 100, 600000, &config->timeout_ms) == 0;
+        } else if (strcmp(arg, "--concurrency") == 0) {
+            ok = parse_unsigned(value, MONITOR_FAMILIES, 65536, &config->max_inflight) == 0;
+        } else if (strcmp(arg, "--window") == 0) {
+            // 창 하나의 탐침 수가 uint16 카운터를 넘지 않도록 (주기는 1초 이상)
+            ok = parse_unsigned(value, 10, 65535, &config->window_sec) == 0;
+        } else if (strcmp(arg, "--listen") == 0) {
+            config->listen = strcmp(value, "off") == 0 ? NULL : value;
+        } else if (strcmp(arg, "--duration") == 0) {
+            ok = parse_unsigned(value, 0, 0xFFFFFFFFu / 1000, &config->duration_sec) == 0;
+        } else if (strcmp(arg, "--seed") == 0) {
+            ok = parse_unsigned(value, 0, 0xFFFFFFFFu, &seed) == 0;
+            config->seed = seed;
+        } else {
+            fprintf(stderr, "알 수 없는 옵션: %s\n", arg);
+            ok = 0;
+        }
+        if (!ok) {
+            fprintf(stderr, "잘못된 값: %s %s\n", arg, value);
+        }
+    }
+    if (!ok || !config->targets_file) {
+        print_monitor_usage(argv[0]);
+        return -1;
+    }
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// 실행
+
+int monitor_run(const MonitorConfig* config, ResultWriter* results) {
+    Monitor* m = (Monitor*)calloc(1, sizeof(Monitor));
+    if (!m) {
+        return 1;
+    }
+    m->config = config;
+    m->results = results;
+    m->listen_fd = -1;
+    init_buckets();
+
+    if (load_targets(m) != 0) {
+        free(m);
+        return 1;
+    }
+    if (config->listen) {
+        m->listen_fd = open_listener(config->listen);
+        if (m->listen_fd < 0) {
+            fprintf(stderr, "엔드포인트를 열 수 없습니다: %s (%s)\n", config->listen, strerror(errno));
+        }
+    }
+
+    m->multi = curl_multi_init();
+    m->probes = (Probe*)calloc(config->max_inflight, sizeof(Probe));
+    for (unsigned i = 0; m->probes && i < config->max_inflight; i++) {
+        m->probes[i].next_free = m->free_probes;
+        m->free_probes = &m->probes[i];
+    }
+    m->start_ms = monitor_now_ms();
+    m->rng = config->seed ? config->seed : (uint32_t)time(NULL) | 1u;
+    timer_wheel_init(&m->wheel, m->start_ms, MONITOR_TICK_MS);
+    schedule_initial(m);
+
+    signal(SIGINT, monitor_signal);
+    signal(SIGTERM, monitor_signal);
+    signal(SIGPIPE, SIG_IGN);
+
+    printf("이중 스택 모니터 시작: 대상 %zu개, 기본 주기 %u초 ±%u%%, 동시 탐침 %u, 창 %u초\n", m->target_count,
+           config->interval_sec, config->jitter_pct, config->max_inflight, config->window_sec);
+    if (m->listen_fd >= 0) {
+        printf("엔드포인트: http://%s/metrics, http://%s/\n", config->listen, config->listen);
+    }
+    if (harness_target()) {
+        printf("연결 대상: 로컬 하네스 (%s)\n", harness_target());
+    }
+    fflush(stdout);
+
+    uint64_t stop_at = config->duration_sec ? m->start_ms + (uint64_t)config->duration_sec * 1000 : 0;
+    while (!g_monitor_stop && m->multi && m->probes) {
+        uint64_t now = monitor_now_ms();
+        if (stop_at && now >= stop_at) {
+            break;
+        }
+        timer_wheel_advance(&m->wheel, now, on_timer, m);
+        start_ready(m);
+
+        int running = 0;
+        curl_multi_perform(m->multi, &running);
+        if (drain_messages(m) > 0) {
+            start_ready(m);
+            result_writer_flush(results);
+        }
+
+        // 다음 타이머, curl 내부 타이머, 종료 시각 중 가장 이른 때까지 잔다
+        long wait = MONITOR_MAX_WAIT_MS;
+        int wheel_wait = timer_wheel_timeout_ms(&m->wheel, now);
+        long curl_wait = -1;
+        curl_multi_timeout(m->multi, &curl_wait);
+        if (wheel_wait >= 0 && wheel_wait < wait) {
+            wait = wheel_wait;
+        }
+        if (curl_wait >= 0 && curl_wait < wait) {
+            wait = curl_wait;
+        }
+        if (stop_at && (long)(stop_at - now) < wait) {
+            wait = (long)(stop_at - now);
+        }
+
+        struct curl_waitfd extra = {m->listen_fd, CURL_WAIT_POLLIN, 0};
+        curl_multi_poll(m->multi, m->listen_fd >= 0 ? &extra : NULL, m->listen_fd >= 0 ? 1 : 0, (int)wait, NULL);
+        if (extra.revents & CURL_WAIT_POLLIN) {
+            serve_client(m);
+        }
+    }
+
+    MonitorBuffer summary = {NULL, 0, 0};
+    render_summary(m, &summary);
+    printf("\n%s", summary.data ? summary.data : "");
+    free(summary.data);
+
+    for (unsigned i = 0; m->probes && i < config->max_inflight; i++) {
+        if (m->probes[i].easy) {
+            if (m->probes[i].target) {
+                curl_multi_remove_handle(m->multi, m->probes[i].easy);
+            }
+            curl_easy_cleanup(m->probes[i].easy);
+            curl_slist_free_all(m->probes[i].harness);
+        }
+    }
+    curl_multi_cleanup(m->multi);
+    if (m->listen_fd >= 0) {
+        close(m->listen_fd);
+    }
+    for (size_t i = 0; i < m->target_count; i++) {
+        free(m->targets[i].url);
+    }
+    free(m->targets);
+    free(m->probes);
+    free(m);
+    return 0;
+}
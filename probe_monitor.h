@@ -0,0 +1,43 @@
+#ifndef PROBE_MONITOR_H
+#define PROBE_MONITOR_H
+
+// 이중 스택 연속 모니터링 (ipv4_ipv6_test --monitor)
+// - 대상 파일의 URL마다 주기적으로 IPv4와 IPv6 탐침을 동시에 보낸다. 스레드 하나가 curl multi와
+//   타이머 휠(timer_wheel.h)로 수천 개 대상을 돌리며, 유휴 시에는 타이머나 소켓 이벤트가 있을 때만 깨어난다.
+// - 첫 탐침 시각을 주기 안에 고르게 펼치고 매번 지터를 더해 부하가 한 순간에 몰리지 않게 한다.
+// - 대상/주소 계열마다 고정 크기 통계(누적 수, 지수 이동 평균, 최근 두 창의 지연 히스토그램)만 들고 있으므로
+//   메모리는 대상 수에만 비례하고 실행 시간과 무관하다.
+// - 통계는 로컬 HTTP 엔드포인트로 노출한다: /metrics (Prometheus 텍스트 형식), / (사람용 요약)
+
+#include <stdint.h>
+#include "result_output.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    const char* targets_file;   // 한 줄에 "URL [주기초]" ('#' 주석, 빈 줄 무시)
+    unsigned interval_sec;      // 기본 탐침 주기 (대상 줄에 주기가 없을 때)
+    unsigned jitter_pct;        // 주기 대비 ± 지터 비율
+    unsigned timeout_ms;        // 탐침 하나의 전체 제한 시간
+    unsigned max_inflight;      // 동시에 진행하는 탐침 수 (넘치면 대기열에서 기다림)
+    unsigned window_sec;        // 지연 분포 창 길이 (최근 두 창으로 백분위 계산)
+    const char* listen;         // 엔드포인트 "주소:포트" 또는 "포트" (NULL이면 끔)
+    unsigned duration_sec;      // 0이면 SIGINT/SIGTERM까지
+    uint32_t seed;              // 지터 난수 시드 (0이면 시각)
+} MonitorConfig;
+
+void monitor_default_config(MonitorConfig* config);
+
+// "--monitor FILE" 뒤의 옵션을 파싱한다 (argv[0]은 프로그램 이름). 잘못된 옵션이면 사용법을 출력하고 -1
+int monitor_parse_args(int argc, char** argv, MonitorConfig* config);
+
+// 중지 신호까지 탐침을 돌리고 마지막 요약을 출력한다. results가 구조화 출력이면 탐침마다 레코드를 남긴다
+int monitor_run(const MonitorConfig* config, ResultWriter* results);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
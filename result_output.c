@@ -0,0 +1,409 @@
+#include "result_output.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+#define RESULT_BUFFER_SIZE (256 * 1024)
+#define RESULT_RECORD_MAX 8192
+
+struct ResultWriter {
+    pthread_mutex_t lock;   // 여러 워커가 같은 writer를 공유하는 서버용 (경합 없을 때는 비용이 작다)
+    ResultFormat format;
+    int fd;
+    int owns_fd;
+    char* buffer;
+    size_t length;
+    int header_written;
+    time_t cached_second;   // 타임스탬프 앞부분 캐시 (초 단위가 바뀔 때만 다시 포맷)
+    char cached_prefix[32];
+};
+
+static const char* const CSV_HEADER =
+    "timestamp,tool,phase,target,host,port,method,ip_version,resolved_ip,protocol,"
+    "tls_version,cipher,socket_profile,body_hash,status,success,bytes_in,bytes_out,dns_ms,connect_ms,tls_ms,ttfb_ms,total_ms,error\n";
+
+void result_init(TestResult* result, const char* tool, const char* phase) {
+    memset(result, 0, sizeof(*result));
+    result->tool = tool;
+    result->phase = phase;
+    result->dns_time = -1.0;
+    result->connect_time = -1.0;
+    result->tls_time = -1.0;
+    result->ttfb = -1.0;
+    result->total_time = -1.0;
+}
+
+int result_parse_format(const char* name, ResultFormat* format) {
+    if (!name || !*name || strcasecmp(name, "text") == 0) {
+        *format = RESULT_FORMAT_TEXT;
+    } else if (strcasecmp(name, "jsonl") == 0 || strcasecmp(name, "json") == 0) {
+        *format = RESULT_FORMAT_JSONL;
+    } else if (strcasecmp(name, "csv") == 0) {
+        *format = RESULT_FORMAT_CSV;
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+// 버퍼 내용을 fd로 모두 내보낸다
+static void result_write_all(ResultWriter* writer) {
+    size_t offset = 0;
+    while (offset < writer->length) {
+        ssize_t n = write(writer->fd, writer->buffer + offset, writer->length - offset);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        offset += (size_t)n;
+    }
+    writer->length = 0;
+}
+
+ResultWriter* result_writer_open(ResultFormat format, const char* path) {
+    ResultWriter* writer = (ResultWriter*)calloc(1, sizeof(ResultWriter));
+    if (!writer) {
+        return NULL;
+    }
+    pthread_mutex_init(&writer->lock, NULL);
+    writer->format = format;
+    writer->cached_second = -1;
+
+    if (format == RESULT_FORMAT_TEXT) {
+        writer->fd = -1;
+        return writer;
+    }
+
+    writer->buffer = (char*)malloc(RESULT_BUFFER_SIZE);
+    if (!writer->buffer) {
+        free(writer);
+        return NULL;
+    }
+
+    if (path && *path) {
+        writer->fd = open(path, O_WRONLY | O_CREAT | O_APPEND, 0644);
+        if (writer->fd < 0) {
+            perror("결과 파일 열기 실패");
+            free(writer->buffer);
+            free(writer);
+            return NULL;
+        }
+        writer->owns_fd = 1;
+
+        // 이미 내용이 있는 파일에 이어 쓰는 경우 CSV 헤더를 다시 쓰지 않는다
+        struct stat st;
+        if (fstat(writer->fd, &st) == 0 && st.st_size > 0) {
+            writer->header_written = 1;
+        }
+    } else {
+        // 기존 stdout을 결과 전용으로 가져가고, 사람용 printf 출력은 stderr로 보낸다
+        fflush(stdout);
+        writer->fd = dup(STDOUT_FILENO);
+        if (writer->fd < 0) {
+            free(writer->buffer);
+            free(writer);
+            return NULL;
+        }
+        writer->owns_fd = 1;
+        dup2(STDERR_FILENO, STDOUT_FILENO);
+    }
+
+    return writer;
+}
+
+ResultWriter* result_writer_from_env(void) {
+    ResultFormat format = RESULT_FORMAT_TEXT;
+    const char* name = getenv("RESULT_FORMAT");
+
+    if (result_parse_format(name, &format) != 0) {
+        fprintf(stderr, "알 수 없는 RESULT_FORMAT: %s (text, jsonl, csv 중 하나)\n", name);
+        format = RESULT_FORMAT_TEXT;
+    }
+
+    return result_writer_open(format, getenv("RESULT_FILE"));
+}
+
+ResultFormat result_writer_format(const ResultWriter* writer) {
+    return writer ? writer->format : RESULT_FORMAT_TEXT;
+}
+
+int result_writer_structured(const ResultWriter* writer) {
+    return writer && writer->format != RESULT_FORMAT_TEXT;
+}
+
+// 출력용 작은 문자열 빌더 (레코드 하나 단위)
+typedef struct {
+    char* data;
+    size_t length;
+    size_t capacity;
+} RecordBuffer;
+
+static void rb_append(RecordBuffer* rb, const char* text, size_t length) {
+    if (rb->length + length >= rb->capacity) {
+        length = rb->capacity - rb->length - 1;
+    }
+    memcpy(rb->data + rb->length, text, length);
+    rb->length += length;
+}
+
+static void rb_puts(RecordBuffer* rb, const char* text) {
+    rb_append(rb, text, strlen(text));
+}
+
+static void rb_printf(RecordBuffer* rb, const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+static void rb_printf(RecordBuffer* rb, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(rb->data + rb->length, rb->capacity - rb->length, format, args);
+    va_end(args);
+    if (n > 0) {
+        size_t added = (size_t)n;
+        if (rb->length + added >= rb->capacity) {
+            added = rb->capacity - rb->length - 1;
+        }
+        rb->length += added;
+    }
+}
+
+// ISO 8601 UTC 타임스탬프 (마이크로초 포함)
+static void format_timestamp(ResultWriter* writer, int64_t timestamp_us, char* out, size_t size) {
+    time_t seconds = (time_t)(timestamp_us / 1000000);
+    long micros = (long)(timestamp_us % 1000000);
+
+    if (seconds != writer->cached_second) {
+        struct tm tm_utc;
+        gmtime_r(&seconds, &tm_utc);
+        strftime(writer->cached_prefix, sizeof(writer->cached_prefix), "%Y-%m-%dT%H:%M:%S", &tm_utc);
+        writer->cached_second = seconds;
+    }
+    snprintf(out, size, "%s.%06ldZ", writer->cached_prefix, micros);
+}
+
+static void json_string(RecordBuffer* rb, const char* value) {
+    static const char hex[] = "0123456789abcdef";
+
+    if (!value) {
+        rb_puts(rb, "null");
+        return;
+    }
+
+    rb_append(rb, "\"", 1);
+    for (const unsigned char* p = (const unsigned char*)value; *p; p++) {
+        switch (*p) {
+            case '"':  rb_append(rb, "\\\"", 2); break;
+            case '\\': rb_append(rb, "\\\\", 2); break;
+            case '\n': rb_append(rb, "\\n", 2); break;
+            case '\r': rb_append(rb, "\\r", 2); break;
+            case '\t': rb_append(rb, "\\t", 2); break;
+            default:
+                if (*p < 0x20) {
+                    char escaped[6] = { '\\', 'u', '0', '0', hex[*p >> 4], hex[*p & 0x0f] };
+                    rb_append(rb, escaped, sizeof(escaped));
+                } else {
+                    rb_append(rb, (const char*)p, 1);
+                }
+                break;
+        }
+    }
+    rb_append(rb, "\"", 1);
+}
+
+static void json_millis(RecordBuffer* rb, double seconds) {
+    if (seconds < 0) {
+        rb_puts(rb, "null");
+    } else {
+        rb_printf(rb, "%.3f", seconds * 1000.0);
+    }
+}
+
+static void csv_string(RecordBuffer* rb, const char* value) {
+    if (!value) {
+        return;
+    }
+    if (!strpbrk(value, ",\"\r\n")) {
+        rb_puts(rb, value);
+        return;
+    }
+
+    rb_append(rb, "\"", 1);
+    for (const char* p = value; *p; p++) {
+        if (*p == '"') {
+            rb_append(rb, "\"\"", 2);
+        } else {
+            rb_append(rb, p, 1);
+        }
+    }
+    rb_append(rb, "\"", 1);
+}
+
+static void csv_millis(RecordBuffer* rb, double seconds) {
+    if (seconds >= 0) {
+        rb_printf(rb, "%.3f", seconds * 1000.0);
+    }
+}
+
+static void format_jsonl(RecordBuffer* rb, const char* timestamp, const TestResult* r) {
+    rb_puts(rb, "{\"timestamp\":");
+    json_string(rb, timestamp);
+    rb_puts(rb, ",\"tool\":");
+    json_string(rb, r->tool);
+    rb_puts(rb, ",\"phase\":");
+    json_string(rb, r->phase);
+    rb_puts(rb, ",\"target\":");
+    json_string(rb, r->target);
+    rb_puts(rb, ",\"host\":");
+    json_string(rb, r->host);
+    rb_printf(rb, ",\"port\":%d", r->port);
+    rb_puts(rb, ",\"method\":");
+    json_string(rb, r->method);
+    rb_puts(rb, ",\"ip_version\":");
+    json_string(rb, r->ip_version);
+    rb_puts(rb, ",\"resolved_ip\":");
+    json_string(rb, r->resolved_ip);
+    rb_puts(rb, ",\"protocol\":");
+    json_string(rb, r->protocol);
+    rb_puts(rb, ",\"tls_version\":");
+    json_string(rb, r->tls_version);
+    rb_puts(rb, ",\"cipher\":");
+    json_string(rb, r->cipher);
+    rb_puts(rb, ",\"socket_profile\":");
+    json_string(rb, r->socket_profile);
+    rb_puts(rb, ",\"body_hash\":");
+    json_string(rb, r->body_hash);
+    rb_printf(rb, ",\"status\":%ld,\"success\":%s,\"bytes_in\":%llu,\"bytes_out\":%llu",
+              r->status, r->success ? "true" : "false",
+              (unsigned long long)r->bytes_in, (unsigned long long)r->bytes_out);
+    rb_puts(rb, ",\"dns_ms\":");
+    json_millis(rb, r->dns_time);
+    rb_puts(rb, ",\"connect_ms\":");
+    json_millis(rb, r->connect_time);
+    rb_puts(rb, ",\"tls_ms\":");
+    json_millis(rb, r->tls_time);
+    rb_puts(rb, ",\"ttfb_ms\":");
+    json_millis(rb, r->ttfb);
+    rb_puts(rb, ",\"total_ms\":");
+    json_millis(rb, r->total_time);
+    rb_puts(rb, ",\"error\":");
+    json_string(rb, r->error);
+    rb_puts(rb, "}\n");
+}
+
+static void format_csv(RecordBuffer* rb, const char* timestamp, const TestResult* r) {
+    csv_string(rb, timestamp);
+    rb_puts(rb, ",");
+    csv_string(rb, r->tool);
+    rb_puts(rb, ",");
+    csv_string(rb, r->phase);
+    rb_puts(rb, ",");
+    csv_string(rb, r->target);
+    rb_puts(rb, ",");
+    csv_string(rb, r->host);
+    rb_printf(rb, ",%d,", r->port);
+    csv_string(rb, r->method);
+    rb_puts(rb, ",");
+    csv_string(rb, r->ip_version);
+    rb_puts(rb, ",");
+    csv_string(rb, r->resolved_ip);
+    rb_puts(rb, ",");
+    csv_string(rb, r->protocol);
+    rb_puts(rb, ",");
+    csv_string(rb, r->tls_version);
+    rb_puts(rb, ",");
+    csv_string(rb, r->cipher);
+    rb_puts(rb, ",");
+    csv_string(rb, r->socket_profile);
+    rb_puts(rb, ",");
+    csv_string(rb, r->body_hash);
+    rb_printf(rb, ",%ld,%d,%llu,%llu,", r->status, r->success ? 1 : 0,
+              (unsigned long long)r->bytes_in, (unsigned long long)r->bytes_out);
+    csv_millis(rb, r->dns_time);
+    rb_puts(rb, ",");
+    csv_millis(rb, r->connect_time);
+    rb_puts(rb, ",");
+    csv_millis(rb, r->tls_time);
+    rb_puts(rb, ",");
+    csv_millis(rb, r->ttfb);
+    rb_puts(rb, ",");
+    csv_millis(rb, r->total_time);
+    rb_puts(rb, ",");
+    csv_string(rb, r->error);
+    rb_puts(rb, "\n");
+}
+
+int result_emit(ResultWriter* writer, const TestResult* result) {
+    if (!writer || writer->format == RESULT_FORMAT_TEXT) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&writer->lock);
+
+    if (writer->format == RESULT_FORMAT_CSV && !writer->header_written) {
+        size_t header_len = strlen(CSV_HEADER);
+        memcpy(writer->buffer + writer->length, CSV_HEADER, header_len);
+        writer->length += header_len;
+        writer->header_written = 1;
+    }
+
+    int64_t timestamp_us = result->timestamp_us;
+    if (timestamp_us == 0) {
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        timestamp_us = (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+    }
+    char timestamp[48];
+    format_timestamp(writer, timestamp_us, timestamp, sizeof(timestamp));
+
+    // 버퍼 끝에 레코드 하나가 들어갈 공간을 확보한 뒤 제자리에서 포맷
+    if (RESULT_BUFFER_SIZE - writer->length < RESULT_RECORD_MAX) {
+        result_write_all(writer);
+    }
+    RecordBuffer rb = { writer->buffer + writer->length, 0, RESULT_RECORD_MAX };
+
+    if (writer->format == RESULT_FORMAT_JSONL) {
+        format_jsonl(&rb, timestamp, result);
+    } else {
+        format_csv(&rb, timestamp, result);
+    }
+
+    // 잘린 레코드도 한 줄로 끝나도록 보장
+    if (rb.length > 0 && rb.data[rb.length - 1] != '\n') {
+        rb.data[rb.length - 1] = '\n';
+    }
+    writer->length += rb.length;
+
+    pthread_mutex_unlock(&writer->lock);
+    return 0;
+}
+
+void result_writer_flush(ResultWriter* writer) {
+    if (writer && writer->fd >= 0) {
+        pthread_mutex_lock(&writer->lock);
+        result_write_all(writer);
+        pthread_mutex_unlock(&writer->lock);
+    }
+}
+
+void result_writer_close(ResultWriter* writer) {
+    if (!writer) {
+        return;
+    }
+    result_writer_flush(writer);
+    if (writer->owns_fd) {
+        close(writer->fd);
+    }
+    pthread_mutex_destroy(&writer->lock);
+    free(writer->buffer);
+    free(writer);
+}
@@ -0,0 +1,83 @@
+#ifndef RESULT_OUTPUT_H
+#define RESULT_OUTPUT_H
+
+// 테스트 결과 공용 모델과 기계 판독용 출력 (JSON Lines / CSV)
+// - 결과는 ResultWriter 내부 버퍼에 모았다가 write(2)로 한 번에 내보낸다.
+// - RESULT_FORMAT=jsonl|csv 로 구조화 출력을 켜면, 기존 한국어 텍스트 출력은 stderr로 옮겨지고
+//   stdout(또는 RESULT_FILE)에는 결과 레코드만 남는다.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    RESULT_FORMAT_TEXT = 0, // 기존 사람용 출력만 사용 (레코드는 출력하지 않음)
+    RESULT_FORMAT_JSONL,
+    RESULT_FORMAT_CSV
+} ResultFormat;
+
+// 측정 결과 한 건 (문자열은 모두 호출자 소유, NULL이면 빈 값)
+// 시간 필드는 초 단위이며 음수이면 측정되지 않은 값으로 출력된다.
+// dns/connect/tls는 각 단계의 소요 시간, ttfb/total은 요청 시작부터의 누적 시간이다
+typedef struct {
+    int64_t timestamp_us;   // 벽시계 기준 마이크로초 (0이면 출력 시각 사용)
+    const char* tool;       // 실행 파일 이름
+    const char* phase;      // "request", "handshake", "connection" 등
+    const char* target;     // URL 또는 host:port/path
+    const char* host;
+    int port;
+    const char* method;
+    const char* ip_version; // "IPv4", "IPv6", "default"
+    const char* resolved_ip;
+    const char* protocol;   // HTTP 버전 ("HTTP/1.1", "HTTP/3")
+    const char* tls_version;
+    const char* cipher;
+    const char* socket_profile; // 소켓 튜닝 프로파일 (socket_tuning.h, 설정하지 않는 도구는 NULL)
+    const char* body_hash;  // 응답 본문 해시 ("crc32c:...", content_hash.h, 주소 계열/프로토콜 사이 본문 비교용)
+    long status;            // HTTP 응답 코드 (없으면 0)
+    int success;
+    uint64_t bytes_in;
+    uint64_t bytes_out;
+    double dns_time;
+    double connect_time;
+    double tls_time;
+    double ttfb;
+    double total_time;
+    const char* error;
+} TestResult;
+
+typedef struct ResultWriter ResultWriter;
+
+// 결과 구조체를 기본값으로 초기화 (시간 필드는 -1)
+void result_init(TestResult* result, const char* tool, const char* phase);
+
+// "text", "jsonl"(또는 "json"), "csv" 를 파싱. 성공 시 0
+int result_parse_format(const char* name, ResultFormat* format);
+
+// path가 NULL이면 stdout으로 출력한다. 실패 시 NULL
+ResultWriter* result_writer_open(ResultFormat format, const char* path);
+
+// RESULT_FORMAT, RESULT_FILE 환경 변수로 writer 생성 (설정이 없으면 텍스트 모드)
+ResultWriter* result_writer_from_env(void);
+
+ResultFormat result_writer_format(const ResultWriter* writer);
+
+// 구조화 출력이 켜져 있는지 (writer가 NULL이면 0)
+int result_writer_structured(const ResultWriter* writer);
+
+// 레코드 하나를 버퍼에 추가한다. 버퍼가 차면 내부적으로 write 한다
+int result_emit(ResultWriter* writer, const TestResult* result);
+
+void result_writer_flush(ResultWriter* writer);
+
+// 남은 버퍼를 내보내고 writer를 해제한다
+void result_writer_close(ResultWriter* writer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,220 @@
+#include "server_admission.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#define ADMISSION_WINDOW_MS 100         // 적응형 차단 판단 구간
+#define ADMISSION_RATE_SLOTS 4096       // IP 버킷 수 (넘치면 가장 오래 안 쓴 버킷을 재사용)
+#define ADMISSION_RATE_WAYS 4           // 주소 하나가 들어갈 수 있는 슬롯 수 (같은 구역 안)
+#define ADMISSION_RATE_STRIPES 64
+#define ADMISSION_NO_SAMPLE UINT64_MAX
+
+typedef struct {
+    uint32_t addr;
+    double tokens;
+    uint64_t last_ms;                   // 0이면 빈 슬롯
+} RateBucket;
+
+struct AdmissionControl {
+    AdmissionConfig config;
+    double burst;
+    uint64_t shed_delay_us;
+
+    _Alignas(64) _Atomic int connections;
+    _Alignas(64) _Atomic int handshakes;
+
+    // 적응형 차단 (구간의 최소 대기 시간)
+    _Alignas(64) _Atomic uint64_t window_start_ms;
+    _Atomic uint64_t window_min_us;
+    _Atomic int overloaded;
+
+    RateBucket* buckets;
+    pthread_mutex_t stripes[ADMISSION_RATE_STRIPES];
+};
+
+void admission_default_config(AdmissionConfig* config) {
+    memset(config, 0, sizeof(*config));
+    config->reject = ADMISSION_REJECT_CLOSE;
+}
+
+int admission_enabled(const AdmissionConfig* config) {
+    return config->max_connections > 0 || config->max_handshakes > 0 || config->rate > 0.0 ||
+           config->shed_delay > 0.0;
+}
+
+AdmissionControl* admission_create(const AdmissionConfig* config) {
+    AdmissionControl* admission = (AdmissionControl*)aligned_alloc(64, sizeof(AdmissionControl));
+    if (!admission) {
+        return NULL;
+    }
+    memset(admission, 0, sizeof(*admission));
+    admission->config = *config;
+    admission->burst = config->burst > 0.0 ? config->burst : (config->rate > 1.0 ? config->rate : 1.0);
+    admission->shed_delay_us = (uint64_t)(config->shed_delay * 1e6);
+    atomic_init(&admission->window_min_us, ADMISSION_NO_SAMPLE);
+
+    if (config->rate > 0.0) {
+        admission->buckets = (RateBucket*)calloc(ADMISSION_RATE_SLOTS, sizeof(RateBucket));
+        if (!admission->buckets) {
+            free(admission);
+            return NULL;
+        }
+        for (int i = 0; i < ADMISSION_RATE_STRIPES; i++) {
+            pthread_mutex_init(&admission->stripes[i], NULL);
+        }
+    }
+    return admission;
+}
+
+void admission_destroy(AdmissionControl* admission) {
+    if (!admission) {
+        return;
+    }
+    if (admission->buckets) {
+        for (int i = 0; i < ADMISSION_RATE_STRIPES; i++) {
+            pthread_mutex_destroy(&admission->stripes[i]);
+        }
+        free(admission->buckets);
+    }
+    free(admission);
+}
+
+int admission_needs_peer(const AdmissionControl* admission) {
+    return admission->buckets != NULL;
+}
+
+// 구간이 끝났으면 그 구간의 최소 대기 시간으로 차단 여부를 정한다 (한 스레드만 판단)
+static void admission_tick(AdmissionControl* admission, uint64_t now_ms) {
+    uint64_t start = atomic_load_explicit(&admission->window_start_ms, memory_order_relaxed);
+    if (now_ms - start < ADMISSION_WINDOW_MS ||
+        !atomic_compare_exchange_strong_explicit(&admission->window_start_ms, &start, now_ms,
+                                                 memory_order_relaxed, memory_order_relaxed)) {
+        return;
+    }
+    // 표본이 없으면 대기열이 빈 것이다 (차단하는 동안 새 핸드셰이크가 없어도 풀린다)
+    uint64_t min_us = atomic_exchange_explicit(&admission->window_min_us, ADMISSION_NO_SAMPLE, memory_order_relaxed);
+    atomic_store_explicit(&admission->overloaded,
+                          min_us != ADMISSION_NO_SAMPLE && min_us > admission->shed_delay_us, memory_order_relaxed);
+}
+
+void admission_observe_delay(AdmissionControl* admission, double seconds, uint64_t now_ms) {
+    if (admission->shed_delay_us == 0) {
+        return;
+    }
+    uint64_t us = seconds > 0.0 ? (uint64_t)(seconds * 1e6) : 0;
+    uint64_t current = atomic_load_explicit(&admission->window_min_us, memory_order_relaxed);
+    while (us < current &&
+           !atomic_compare_exchange_weak_explicit(&admission->window_min_us, &current, us,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+    admission_tick(admission, now_ms);
+}
+
+int admission_overloaded(const AdmissionControl* admission) {
+    return atomic_load_explicit(&admission->overloaded, memory_order_relaxed);
+}
+
+// 출발지 IP의 토큰 하나를 쓴다. 남은 토큰이 없으면 0
+static int rate_take(AdmissionControl* admission, uint32_t addr, uint64_t now_ms) {
+    uint32_t hash = addr * 2654435761u;
+    unsigned base = (hash >> 20) & (ADMISSION_RATE_SLOTS - 1) & ~(unsigned)(ADMISSION_RATE_WAYS - 1);
+    pthread_mutex_t* lock = &admission->stripes[(base / ADMISSION_RATE_WAYS) % ADMISSION_RATE_STRIPES];
+
+    pthread_mutex_lock(lock);
+    RateBucket* bucket = NULL;
+    RateBucket* oldest = &admission->buckets[base];
+    for (unsigned i = 0; i < ADMISSION_RATE_WAYS; i++) {
+        RateBucket* slot = &admission->buckets[base + i];
+        if (slot->last_ms != 0 && slot->addr == addr) {
+            bucket = slot;
+            break;
+        }
+        if (slot->last_ms < oldest->last_ms) {
+            oldest = slot;
+        }
+    }
+    if (!bucket) {
+        bucket = oldest;
+        bucket->addr = addr;
+        bucket->tokens = admission->burst;
+    } else {
+        bucket->tokens += (double)(now_ms - bucket->last_ms) * admission->config.rate / 1000.0;
+        if (bucket->tokens > admission->burst) {
+            bucket->tokens = admission->burst;
+        }
+    }
+    bucket->last_ms = now_ms > 0 ? now_ms : 1;
+
+    int allowed = bucket->tokens >= 1.0;
+    if (allowed) {
+        bucket->tokens -= 1.0;
+    }
+    pthread_mutex_unlock(lock);
+    return allowed;
+}
+
+// 제한 안에서 카운터를 하나 올린다. 제한을 넘으면 0
+static int slot_take(_Atomic int* counter, int limit) {
+    if (limit <= 0) {
+        return 1;
+    }
+    if (atomic_fetch_add_explicit(counter, 1, memory_order_relaxed) >= limit) {
+        atomic_fetch_sub_explicit(counter, 1, memory_order_relaxed);
+        return 0;
+    }
+    return 1;
+}
+
+AdmissionResult admission_check(AdmissionControl* admission, uint32_t addr, uint64_t now_ms, AdmissionTicket* ticket) {
+    const AdmissionConfig* config = &admission->config;
+    AdmissionResult result = ADMISSION_ACCEPT;
+
+    ticket->connection = 0;
+    ticket->handshake = 0;
+    if (admission->shed_delay_us > 0) {
+        admission_tick(admission, now_ms);
+        if (admission_overloaded(admission)) {
+            return ADMISSION_REJECT_OVERLOAD;       // 503도 핸드셰이크가 필요하므로 항상 바로 닫는다
+        }
+    }
+
+    if (admission->buckets && addr != 0 && !rate_take(admission, addr, now_ms)) {
+        result = ADMISSION_REJECT_RATE;
+    } else if (!slot_take(&admission->connections, config->max_connections)) {
+        result = ADMISSION_REJECT_CONNECTIONS;
+    } else {
+        ticket->connection = 1;
+    }
+    if (result != ADMISSION_ACCEPT && config->reject != ADMISSION_REJECT_503) {
+        return result;
+    }
+
+    // 503으로 응답할 연결도 핸드셰이크 자리는 있어야 한다
+    if (!slot_take(&admission->handshakes, config->max_handshakes)) {
+        admission_release(admission, ticket);
+        return ADMISSION_REJECT_HANDSHAKES;
+    }
+    ticket->handshake = 1;
+    return result;
+}
+
+void admission_handshake_done(AdmissionControl* admission, AdmissionTicket* ticket) {
+    if (ticket->handshake) {
+        ticket->handshake = 0;
+        if (admission->config.max_handshakes > 0) {
+            atomic_fetch_sub_explicit(&admission->handshakes, 1, memory_order_relaxed);
+        }
+    }
+}
+
+void admission_release(AdmissionControl* admission, AdmissionTicket* ticket) {
+    admission_handshake_done(admission, ticket);
+    if (ticket->connection) {
+        ticket->connection = 0;
+        if (admission->config.max_connections > 0) {
+            atomic_fetch_sub_explicit(&admission->connections, 1, memory_order_relaxed);
+        }
+    }
+}
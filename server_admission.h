@@ -0,0 +1,73 @@
+#ifndef SERVER_ADMISSION_H
+#define SERVER_ADMISSION_H
+
+// 연결 수락 제어 (과부하 시 조기 거절)
+// - 수락 직후, TLS 핸드셰이크를 시작하기 전에 판단하므로 거절한 연결에는 암호 연산 비용이 들지 않는다.
+// - 동시 연결 수, 동시 핸드셰이크 수, 출발지 IP별 새 연결 속도(토큰 버킷)를 제한한다.
+// - 적응형 부하 차단: 대기 시간(핸드셰이크 풀 대기, 인라인 모드는 이벤트 루프 한 바퀴)을 100ms 구간마다 모아
+//   구간의 최솟값이 목표를 넘으면 다음 구간 동안 새 연결을 받지 않는다 (CoDel처럼 최솟값을 보므로 순간 급증은 무시).
+//   거절하는 동안 대기열이 비면 다음 구간에 자동으로 다시 받는다.
+// - 모든 워커가 하나의 상태를 공유한다 (카운터는 원자적 연산, IP 테이블은 구역별 잠금).
+
+#include <stdint.h>
+
+// 제한에 걸린 연결을 어떻게 거절할지
+typedef enum {
+    ADMISSION_REJECT_CLOSE = 0,     // 바로 RST로 닫는다 (클라이언트는 SYN 타임아웃 대신 즉시 실패)
+    ADMISSION_REJECT_503            // 핸드셰이크 후 503 + Retry-After로 응답하고 닫는다 (연결/속도 제한만)
+} AdmissionRejectMode;
+
+typedef struct {
+    int max_connections;            // 동시 연결 수 (0이면 제한 없음)
+    int max_handshakes;             // 동시 핸드셰이크 수 (0이면 제한 없음)
+    double rate;                    // 출발지 IP별 초당 새 연결 수 (0이면 제한 없음)
+    double burst;                   // 출발지 IP별 순간 허용량 (0이면 max(rate, 1))
+    double shed_delay;              // 적응형 차단 목표 대기 시간 (초, 0이면 사용하지 않음)
+    AdmissionRejectMode reject;
+} AdmissionConfig;
+
+typedef enum {
+    ADMISSION_ACCEPT = 0,
+    ADMISSION_REJECT_CONNECTIONS,   // 동시 연결 수 초과
+    ADMISSION_REJECT_HANDSHAKES,    // 동시 핸드셰이크 수 초과
+    ADMISSION_REJECT_RATE,          // 출발지 IP 속도 초과
+    ADMISSION_REJECT_OVERLOAD,      // 적응형 차단 중
+    ADMISSION_RESULT_COUNT
+} AdmissionResult;
+
+// 연결이 잡고 있는 자리 (연결 구조체에 넣어 두고, 해제 함수가 잡은 것만 돌려준다)
+typedef struct {
+    uint8_t connection;
+    uint8_t handshake;
+} AdmissionTicket;
+
+typedef struct AdmissionControl AdmissionControl;
+
+void admission_default_config(AdmissionConfig* config);
+
+// 제한이 하나라도 설정되어 있는지 (없으면 수락 경로에서 아무것도 하지 않는다)
+int admission_enabled(const AdmissionConfig* config);
+
+AdmissionControl* admission_create(const AdmissionConfig* config);
+void admission_destroy(AdmissionControl* admission);
+
+// 출발지 주소가 필요한지 (IP별 속도 제한)
+int admission_needs_peer(const AdmissionControl* admission);
+
+// 새 연결을 받을지 판단하고 자리를 잡는다 (addr는 네트워크 바이트 순서 IPv4, 모르면 0).
+// ADMISSION_ACCEPT가 아니어도 ticket->handshake가 잡혀 있으면 503 모드로 응답할 연결이다
+AdmissionResult admission_check(AdmissionControl* admission, uint32_t addr, uint64_t now_ms, AdmissionTicket* ticket);
+
+// 핸드셰이크가 끝나면 핸드셰이크 자리만 돌려준다
+void admission_handshake_done(AdmissionControl* admission, AdmissionTicket* ticket);
+
+// 연결을 닫을 때 남은 자리를 모두 돌려준다
+void admission_release(AdmissionControl* admission, AdmissionTicket* ticket);
+
+// 대기 시간 표본 (어느 워커에서나 호출 가능)
+void admission_observe_delay(AdmissionControl* admission, double seconds, uint64_t now_ms);
+
+// 적응형 차단 중인지
+int admission_overloaded(const AdmissionControl* admission);
+
+#endif
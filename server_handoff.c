@@ -0,0 +1,197 @@
+#define _GNU_SOURCE
+#include "server_handoff.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+
+#define HANDOFF_MAGIC "TLSH"
+#define HANDOFF_VERSION 1
+#define HANDOFF_READY 'R'
+#define HANDOFF_RECEIVE_TIMEOUT_SEC 10
+
+// 이전 프로세스 -> 새 프로세스 메시지 (리스닝 소켓은 SCM_RIGHTS로 함께 간다)
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint32_t keys_len;          // 0이면 티켓 키 없음
+    unsigned char keys[HANDOFF_TICKET_KEYS_SIZE];
+} HandoffMessage;
+
+static int handoff_address(const char* path, struct sockaddr_un* addr) {
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr->sun_path)) {
+        fprintf(stderr, "업그레이드 소켓 경로가 너무 깁니다: %s\n", path);
+        return -1;
+    }
+    strcpy(addr->sun_path, path);
+    return 0;
+}
+
+// 같은 사용자의 프로세스만 소켓을 주고받는다
+static int handoff_peer(int fd, pid_t* pid) {
+    struct ucred cred;
+    socklen_t len = sizeof(cred);
+    if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &len) != 0 || cred.uid != getuid()) {
+        return -1;
+    }
+    *pid = cred.pid;
+    return 0;
+}
+
+int handoff_acquire(const char* path, HandoffInherited* inherited) {
+    struct sockaddr_un addr;
+    memset(inherited, 0, sizeof(*inherited));
+    inherited->listener = -1;
+    inherited->channel = -1;
+    if (handoff_address(path, &addr) != 0) {
+        return -1;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        perror("업그레이드 소켓 생성 실패");
+        return -1;
+    }
+    if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        int error = errno;
+        close(fd);
+        if (error == ECONNREFUSED) {
+            unlink(path);       // 이전 프로세스가 비정상 종료하고 남긴 파일
+        }
+        return error == ENOENT || error == ECONNREFUSED ? 0 : -1;
+    }
+
+    struct timeval timeout = { HANDOFF_RECEIVE_TIMEOUT_SEC, 0 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    HandoffMessage message;
+    char control[CMSG_SPACE(sizeof(int))];
+    struct iovec iov = { &message, sizeof(message) };
+    struct msghdr msg;
+    memset(&message, 0, sizeof(message));
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    ssize_t received = recvmsg(fd, &msg, MSG_CMSG_CLOEXEC | MSG_WAITALL);
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    if (received == (ssize_t)sizeof(message) && cmsg && cmsg->cmsg_level == SOL_SOCKET &&
+        cmsg->cmsg_type == SCM_RIGHTS && cmsg->cmsg_len == CMSG_LEN(sizeof(int))) {
+        memcpy(&inherited->listener, CMSG_DATA(cmsg), sizeof(int));
+    }
+    if (inherited->listener < 0 || memcmp(message.magic, HANDOFF_MAGIC, 4) != 0 ||
+        message.version != HANDOFF_VERSION || message.keys_len > HANDOFF_TICKET_KEYS_SIZE ||
+        handoff_peer(fd, &inherited->peer_pid) != 0) {
+        fprintf(stderr, "이전 프로세스에서 리스닝 소켓을 받지 못했습니다: %s\n", path);
+        if (inherited->listener >= 0) {
+            close(inherited->listener);
+            inherited->listener = -1;
+        }
+        close(fd);
+        return -1;
+    }
+
+    inherited->channel = fd;
+    inherited->has_ticket_keys = message.keys_len == HANDOFF_TICKET_KEYS_SIZE;
+    memcpy(inherited->ticket_keys, message.keys, sizeof(inherited->ticket_keys));
+    explicit_bzero(message.keys, sizeof(message.keys));
+    return 1;
+}
+
+int handoff_notify_ready(HandoffInherited* inherited) {
+    char ready = HANDOFF_READY;
+    int result = send(inherited->channel, &ready, 1, MSG_NOSIGNAL) == 1 ? 0 : -1;
+    close(inherited->channel);
+    inherited->channel = -1;
+    return result;
+}
+
+void handoff_release(HandoffInherited* inherited) {
+    if (inherited->listener >= 0) {
+        close(inherited->listener);
+        inherited->listener = -1;
+    }
+    if (inherited->channel >= 0) {
+        close(inherited->channel);
+        inherited->channel = -1;
+    }
+}
+
+int handoff_listen(const char* path) {
+    struct sockaddr_un addr;
+    if (handoff_address(path, &addr) != 0) {
+        return -1;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        perror("업그레이드 소켓 생성 실패");
+        return -1;
+    }
+    // 이전 프로세스의 파일을 지워도 그쪽은 이미 인계를 마쳤으므로 영향이 없다
+    unlink(path);
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || chmod(path, S_IRUSR | S_IWUSR) != 0 ||
+        listen(fd, 4) != 0) {
+        perror("업그레이드 소켓 준비 실패");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int handoff_send(int client, int listener, const unsigned char* ticket_keys, size_t keys_len,
+                 int timeout_ms, pid_t* peer_pid) {
+    HandoffMessage message;
+    char control[CMSG_SPACE(sizeof(int))];
+    struct iovec iov = { &message, sizeof(message) };
+    struct msghdr msg;
+
+    if (handoff_peer(client, peer_pid) != 0) {
+        return -1;
+    }
+
+    memset(&message, 0, sizeof(message));
+    memcpy(message.magic, HANDOFF_MAGIC, 4);
+    message.version = HANDOFF_VERSION;
+    if (ticket_keys && keys_len == HANDOFF_TICKET_KEYS_SIZE) {
+        message.keys_len = (uint32_t)keys_len;
+        memcpy(message.keys, ticket_keys, keys_len);
+    }
+
+    memset(&msg, 0, sizeof(msg));
+    memset(control, 0, sizeof(control));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+    memcpy(CMSG_DATA(cmsg), &listener, sizeof(int));
+
+    ssize_t sent = sendmsg(client, &msg, MSG_NOSIGNAL);
+    explicit_bzero(message.keys, sizeof(message.keys));
+    if (sent != (ssize_t)sizeof(message)) {
+        return -1;
+    }
+
+    // 새 프로세스가 워커를 띄울 때까지 기다린다 (그동안에도 이 프로세스의 워커는 계속 수락한다)
+    struct pollfd pfd = { client, POLLIN, 0 };
+    char ready = 0;
+    if (poll(&pfd, 1, timeout_ms) <= 0 || recv(client, &ready, 1, 0) != 1 || ready != HANDOFF_READY) {
+        return -1;
+    }
+    return 0;
+}
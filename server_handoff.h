@@ -0,0 +1,42 @@
+#ifndef SERVER_HANDOFF_H
+#define SERVER_HANDOFF_H
+
+// 리스닝 소켓 인계 (무중단 재시작)
+// - 실행 중인 서버는 유닉스 소켓(--upgrade-socket PATH)에서 새 프로세스의 연결을 기다린다.
+// - 새 프로세스는 시작할 때 같은 경로로 접속해 리스닝 소켓을 SCM_RIGHTS로 받고, 세션 티켓 키도 함께 받는다
+//   (이전 프로세스가 발급한 티켓으로 재개할 수 있어 재시작 직후 전체 핸드셰이크가 몰리지 않는다).
+// - 새 프로세스가 워커를 모두 띄운 뒤 준비 완료를 알리면 이전 프로세스는 수락을 멈추고 드레인한다.
+//   리스닝 소켓은 인계 중에도 닫히지 않으므로 대기열의 연결은 새 프로세스가 받는다.
+
+#include <stddef.h>
+#include <sys/types.h>
+
+#define HANDOFF_TICKET_KEYS_SIZE 80     // 키 이름 16 + HMAC 키 32 + AES 키 32 (SSL_CTRL_GET_TLSEXT_TICKET_KEYS)
+
+typedef struct {
+    int listener;                                       // 인계받은 리스닝 소켓
+    int channel;                                        // 이전 프로세스와의 연결 (준비 완료 통지용)
+    pid_t peer_pid;                                     // 이전 프로세스
+    int has_ticket_keys;
+    unsigned char ticket_keys[HANDOFF_TICKET_KEYS_SIZE];
+} HandoffInherited;
+
+// 새 프로세스: path의 이전 프로세스에서 리스닝 소켓을 받는다.
+// 받았으면 1, 이전 프로세스가 없으면 0 (남은 소켓 파일은 지운다), 실패하면 -1
+int handoff_acquire(const char* path, HandoffInherited* inherited);
+
+// 새 프로세스: 워커를 모두 띄운 뒤 이전 프로세스에 준비 완료를 알리고 채널을 닫는다
+int handoff_notify_ready(HandoffInherited* inherited);
+
+// 새 프로세스: 시작에 실패했을 때 받은 소켓과 채널을 닫는다 (이전 프로세스는 인계 실패로 보고 계속 실행한다)
+void handoff_release(HandoffInherited* inherited);
+
+// 실행 중인 서버: path에 인계 요청을 받을 유닉스 소켓을 만든다 (기존 파일은 바꿔치기한다)
+int handoff_listen(const char* path);
+
+// 실행 중인 서버: 접속한 새 프로세스에 리스닝 소켓과 티켓 키를 보내고 준비 완료를 기다린다.
+// 새 프로세스가 준비되면 0 (peer_pid에 PID), 도중에 실패하거나 timeout_ms 안에 응답이 없으면 -1
+int handoff_send(int client, int listener, const unsigned char* ticket_keys, size_t keys_len,
+                 int timeout_ms, pid_t* peer_pid);
+
+#endif
@@ -0,0 +1,366 @@
+#include "server_metrics.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <pthread.h>
+#include <unistd.h>
+
+// 히스토그램 버킷 상한 (초)
+static const double BUCKET_BOUNDS[METRICS_HISTOGRAM_BUCKETS] = {
+    0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0
+};
+
+static const char* const PROTOCOL_LABELS[METRICS_PROTO_COUNT] = {
+    "TLSv1", "TLSv1.1", "TLSv1.2", "TLSv1.3", "other"
+};
+
+static const char* const SYSCALL_LABELS[METRICS_SYSCALL_COUNT] = {
+    "accept", "read", "write", "wait", "control", "close"
+};
+
+static const char* const TIMEOUT_LABELS[METRICS_TIMEOUT_COUNT] = {
+    "handshake", "header", "idle", "write"
+};
+
+static const char* const REJECT_LABELS[METRICS_REJECT_COUNT] = {
+    "connections", "handshakes", "rate", "overload"
+};
+
+static const char* const EARLY_LABELS[METRICS_EARLY_COUNT] = {
+    "accepted", "rejected"
+};
+
+static const char* const MEMORY_LABELS[METRICS_MEMORY_COUNT] = {
+    "connection_slab", "buffer_pool", "buffers_lent"
+};
+
+// 프로세스 상주 메모리 (바이트, /proc을 읽을 수 없으면 0)
+static uint64_t resident_memory_bytes(void) {
+    unsigned long long size_pages = 0, resident_pages = 0;
+    FILE* file = fopen("/proc/self/statm", "r");
+    if (!file) {
+        return 0;
+    }
+    if (fscanf(file, "%llu %llu", &size_pages, &resident_pages) != 2) {
+        resident_pages = 0;
+    }
+    fclose(file);
+    return (uint64_t)resident_pages * (uint64_t)sysconf(_SC_PAGESIZE);
+}
+
+// 워커 등록은 시작 시 한 번뿐이므로 락을 사용하고, 읽기는 개수만 원자적으로 확인한다
+static ServerMetrics* g_workers[METRICS_MAX_WORKERS];
+static _Atomic int g_worker_count;
+static pthread_mutex_t g_register_lock = PTHREAD_MUTEX_INITIALIZER;
+
+ServerMetrics* server_metrics_register(void) {
+    ServerMetrics* metrics = (ServerMetrics*)aligned_alloc(64, sizeof(ServerMetrics));
+    if (!metrics) {
+        return NULL;
+    }
+    memset(metrics, 0, sizeof(*metrics));
+
+    pthread_mutex_lock(&g_register_lock);
+    int index = atomic_load_explicit(&g_worker_count, memory_order_relaxed);
+    if (index >= METRICS_MAX_WORKERS) {
+        pthread_mutex_unlock(&g_register_lock);
+        free(metrics);
+        return NULL;
+    }
+    g_workers[index] = metrics;
+    atomic_store_explicit(&g_worker_count, index + 1, memory_order_release);
+    pthread_mutex_unlock(&g_register_lock);
+
+    return metrics;
+}
+
+void metrics_observe(MetricsHistogram* histogram, double seconds) {
+    int bucket = METRICS_HISTOGRAM_BUCKETS;
+    for (int i = 0; i < METRICS_HISTOGRAM_BUCKETS; i++) {
+        if (seconds <= BUCKET_BOUNDS[i]) {
+            bucket = i;
+            break;
+        }
+    }
+
+    metrics_add(&histogram->buckets[bucket], 1);
+    metrics_add(&histogram->sum_ns, seconds > 0 ? (uint64_t)(seconds * 1e9) : 0);
+    metrics_add(&histogram->count, 1);
+}
+
+static MetricsProtocol protocol_index(const char* version) {
+    if (!version) {
+        return METRICS_PROTO_OTHER;
+    }
+    if (strcmp(version, "TLSv1.3") == 0) {
+        return METRICS_PROTO_TLS1_3;
+    }
+    if (strcmp(version, "TLSv1.2") == 0) {
+        return METRICS_PROTO_TLS1_2;
+    }
+    if (strcmp(version, "TLSv1.1") == 0) {
+        return METRICS_PROTO_TLS1_1;
+    }
+    if (strcmp(version, "TLSv1") == 0) {
+        return METRICS_PROTO_TLS1_0;
+    }
+    return METRICS_PROTO_OTHER;
+}
+
+void metrics_record_handshake(ServerMetrics* metrics, const char* version, const char* cipher,
+                              int resumed, double seconds) {
+    metrics_add(&metrics->handshakes, 1);
+    metrics_add(&metrics->protocols[protocol_index(version)], 1);
+    if (resumed) {
+        metrics_add(&metrics->resumptions, 1);
+    }
+    metrics_observe(&metrics->handshake_time, seconds);
+
+    if (!cipher) {
+        return;
+    }
+
+    // 소유 워커만 슬롯을 추가하므로 이름을 먼저 쓰고 개수를 release로 공개한다
+    int slots = atomic_load_explicit(&metrics->cipher_slots, memory_order_relaxed);
+    for (int i = 0; i < slots; i++) {
+        if (metrics->cipher_names[i] == cipher || strcmp(metrics->cipher_names[i], cipher) == 0) {
+            metrics_add(&metrics->cipher_counts[i], 1);
+            return;
+        }
+    }
+    if (slots < METRICS_MAX_CIPHERS) {
+        metrics->cipher_names[slots] = cipher;
+        metrics_add(&metrics->cipher_counts[slots], 1);
+        atomic_store_explicit(&metrics->cipher_slots, slots + 1, memory_order_release);
+    } else {
+        metrics_add(&metrics->cipher_overflow, 1);
+    }
+}
+
+// 렌더링용 가변 버퍼
+typedef struct {
+    char* data;
+    size_t length;
+    size_t capacity;
+} TextBuffer;
+
+static void text_printf(TextBuffer* text, const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+static void text_printf(TextBuffer* text, const char* format, ...) {
+    for (;;) {
+        va_list args;
+        va_start(args, format);
+        int n = vsnprintf(text->data + text->length, text->capacity - text->length, format, args);
+        va_end(args);
+
+        if (n < 0) {
+            return;
+        }
+        if ((size_t)n < text->capacity - text->length) {
+            text->length += (size_t)n;
+            return;
+        }
+
+        size_t capacity = text->capacity * 2 + (size_t)n;
+        char* data = (char*)realloc(text->data, capacity);
+        if (!data) {
+            return;
+        }
+        text->data = data;
+        text->capacity = capacity;
+    }
+}
+
+static uint64_t load(const _Atomic uint64_t* value) {
+    return atomic_load_explicit(value, memory_order_relaxed);
+}
+
+static void render_counter(TextBuffer* text, const char* name, const char* help, uint64_t value) {
+    text_printf(text, "# HELP %s %s\n# TYPE %s counter\n%s %llu\n",
+                name, help, name, name, (unsigned long long)value);
+}
+
+static void render_histogram(TextBuffer* text, const char* name, const char* help,
+                             ServerMetrics* const* workers, int count, size_t offset) {
+    uint64_t buckets[METRICS_HISTOGRAM_BUCKETS + 1] = { 0 };
+    uint64_t sum_ns = 0;
+    uint64_t total = 0;
+
+    for (int w = 0; w < count; w++) {
+        const MetricsHistogram* histogram = (const MetricsHistogram*)((const char*)workers[w] + offset);
+        for (int i = 0; i <= METRICS_HISTOGRAM_BUCKETS; i++) {
+            buckets[i] += load(&histogram->buckets[i]);
+        }
+        sum_ns += load(&histogram->sum_ns);
+        total += load(&histogram->count);
+    }
+
+    text_printf(text, "# HELP %s %s\n# TYPE %s histogram\n", name, help, name);
+    uint64_t cumulative = 0;
+    for (int i = 0; i < METRICS_HISTOGRAM_BUCKETS; i++) {
+        cumulative += buckets[i];
+        text_printf(text, "%s_bucket{le=\"%g\"} %llu\n", name, BUCKET_BOUNDS[i], (unsigned long long)cumulative);
+    }
+    cumulative += buckets[METRICS_HISTOGRAM_BUCKETS];
+    text_printf(text, "%s_bucket{le=\"+Inf\"} %llu\n", name, (unsigned long long)cumulative);
+    text_printf(text, "%s_sum %.9f\n%s_count %llu\n", name, (double)sum_ns / 1e9, name, (unsigned long long)total);
+}
+
+char* server_metrics_render(const char* server_name, const char* backend, size_t* length) {
+    TextBuffer text = { (char*)malloc(8192), 0, 8192 };
+    if (!text.data) {
+        return NULL;
+    }
+
+    int count = atomic_load_explicit(&g_worker_count, memory_order_acquire);
+    ServerMetrics* const* workers = g_workers;
+
+    uint64_t accepts = 0, failures = 0, resumptions = 0;
+    uint64_t requests = 0, bytes_in = 0, bytes_out = 0, cipher_overflow = 0;
+    uint64_t protocols[METRICS_PROTO_COUNT] = { 0 };
+    uint64_t syscalls[METRICS_SYSCALL_COUNT] = { 0 };
+    int64_t memory[METRICS_MEMORY_COUNT] = { 0 };
+    uint64_t timeouts[METRICS_TIMEOUT_COUNT] = { 0 };
+    uint64_t rejections[METRICS_REJECT_COUNT] = { 0 };
+    uint64_t early_data[METRICS_EARLY_COUNT] = { 0 };
+    uint64_t early_requests = 0;
+    int64_t active = 0;
+
+    // 암호화 스위트는 워커마다 슬롯 순서가 다르므로 이름 기준으로 합친다
+    const char* cipher_names[METRICS_MAX_WORKERS * METRICS_MAX_CIPHERS];
+    uint64_t cipher_counts[METRICS_MAX_WORKERS * METRICS_MAX_CIPHERS];
+    int cipher_total = 0;
+
+    for (int w = 0; w < count; w++) {
+        ServerMetrics* m = workers[w];
+        accepts += load(&m->accepts);
+        failures += load(&m->handshake_failures);
+        resumptions += load(&m->resumptions);
+        requests += load(&m->requests);
+        bytes_in += load(&m->bytes_in);
+        bytes_out += load(&m->bytes_out);
+        active += atomic_load_explicit(&m->active_connections, memory_order_relaxed);
+        cipher_overflow += load(&m->cipher_overflow);
+        for (int p = 0; p < METRICS_PROTO_COUNT; p++) {
+            protocols[p] += load(&m->protocols[p]);
+        }
+        for (int c = 0; c < METRICS_SYSCALL_COUNT; c++) {
+            syscalls[c] += load(&m->syscalls[c]);
+        }
+        for (int k = 0; k < METRICS_MEMORY_COUNT; k++) {
+            memory[k] += atomic_load_explicit(&m->memory[k], memory_order_relaxed);
+        }
+        for (int t = 0; t < METRICS_TIMEOUT_COUNT; t++) {
+            timeouts[t] += load(&m->timeouts[t]);
+        }
+        for (int r = 0; r < METRICS_REJECT_COUNT; r++) {
+            rejections[r] += load(&m->rejections[r]);
+        }
+        for (int e = 0; e < METRICS_EARLY_COUNT; e++) {
+            early_data[e] += load(&m->early_data[e]);
+        }
+        early_requests += load(&m->early_requests);
+
+        int slots = atomic_load_explicit(&m->cipher_slots, memory_order_acquire);
+        for (int i = 0; i < slots; i++) {
+            int found = -1;
+            for (int j = 0; j < cipher_total; j++) {
+                if (strcmp(cipher_names[j], m->cipher_names[i]) == 0) {
+                    found = j;
+                    break;
+                }
+            }
+            if (found < 0) {
+                found = cipher_total++;
+                cipher_names[found] = m->cipher_names[i];
+                cipher_counts[found] = 0;
+            }
+            cipher_counts[found] += load(&m->cipher_counts[i]);
+        }
+    }
+
+    const char* label = server_name ? server_name : "tls_server";
+    text_printf(&text, "# HELP tls_server_info Server build information.\n"
+                       "# TYPE tls_server_info gauge\n"
+                       "tls_server_info{server=\"%s\",backend=\"%s\"} 1\n", label, backend ? backend : "epoll");
+    text_printf(&text, "# HELP tls_server_workers Number of worker threads.\n"
+                       "# TYPE tls_server_workers gauge\n"
+                       "tls_server_workers %d\n", count);
+    render_counter(&text, "tls_server_accepts_total", "Accepted TCP connections.", accepts);
+    render_counter(&text, "tls_server_handshake_failures_total", "Failed TLS handshakes.", failures);
+    render_counter(&text, "tls_server_resumptions_total", "Handshakes that resumed a previous session.", resumptions);
+    render_counter(&text, "tls_server_requests_total", "HTTP requests served.", requests);
+    render_counter(&text, "tls_server_bytes_in_total", "Plaintext bytes read from clients.", bytes_in);
+    render_counter(&text, "tls_server_bytes_out_total", "Plaintext bytes written to clients.", bytes_out);
+    text_printf(&text, "# HELP tls_server_active_connections Connections currently open.\n"
+                       "# TYPE tls_server_active_connections gauge\n"
+                       "tls_server_active_connections %lld\n", (long long)active);
+    text_printf(&text, "# HELP tls_server_memory_bytes Bytes held by per-worker memory pools.\n"
+                       "# TYPE tls_server_memory_bytes gauge\n");
+    for (int k = 0; k < METRICS_MEMORY_COUNT; k++) {
+        text_printf(&text, "tls_server_memory_bytes{pool=\"%s\"} %lld\n", MEMORY_LABELS[k], (long long)memory[k]);
+    }
+    text_printf(&text, "# HELP process_resident_memory_bytes Resident memory size in bytes.\n"
+                       "# TYPE process_resident_memory_bytes gauge\n"
+                       "process_resident_memory_bytes %llu\n", (unsigned long long)resident_memory_bytes());
+
+    text_printf(&text, "# HELP tls_server_handshakes_total Successful TLS handshakes by protocol version.\n"
+                       "# TYPE tls_server_handshakes_total counter\n");
+    for (int p = 0; p < METRICS_PROTO_COUNT; p++) {
+        text_printf(&text, "tls_server_handshakes_total{protocol=\"%s\"} %llu\n",
+                    PROTOCOL_LABELS[p], (unsigned long long)protocols[p]);
+    }
+
+    text_printf(&text, "# HELP tls_server_cipher_handshakes_total Successful TLS handshakes by cipher suite.\n"
+                       "# TYPE tls_server_cipher_handshakes_total counter\n");
+    for (int i = 0; i < cipher_total; i++) {
+        text_printf(&text, "tls_server_cipher_handshakes_total{cipher=\"%s\"} %llu\n",
+                    cipher_names[i], (unsigned long long)cipher_counts[i]);
+    }
+    if (cipher_overflow > 0) {
+        text_printf(&text, "tls_server_cipher_handshakes_total{cipher=\"other\"} %llu\n",
+                    (unsigned long long)cipher_overflow);
+    }
+
+    text_printf(&text, "# HELP tls_server_syscalls_total System calls issued by the I/O backend.\n"
+                       "# TYPE tls_server_syscalls_total counter\n");
+    for (int c = 0; c < METRICS_SYSCALL_COUNT; c++) {
+        text_printf(&text, "tls_server_syscalls_total{op=\"%s\"} %llu\n",
+                    SYSCALL_LABELS[c], (unsigned long long)syscalls[c]);
+    }
+
+    text_printf(&text, "# HELP tls_server_timeouts_total Connections closed by a timeout.\n"
+                       "# TYPE tls_server_timeouts_total counter\n");
+    for (int t = 0; t < METRICS_TIMEOUT_COUNT; t++) {
+        text_printf(&text, "tls_server_timeouts_total{kind=\"%s\"} %llu\n",
+                    TIMEOUT_LABELS[t], (unsigned long long)timeouts[t]);
+    }
+
+    text_printf(&text, "# HELP tls_server_rejected_total Connections rejected by admission control.\n"
+                       "# TYPE tls_server_rejected_total counter\n");
+    for (int r = 0; r < METRICS_REJECT_COUNT; r++) {
+        text_printf(&text, "tls_server_rejected_total{reason=\"%s\"} %llu\n",
+                    REJECT_LABELS[r], (unsigned long long)rejections[r]);
+    }
+
+    text_printf(&text, "# HELP tls_server_early_data_total TLS 1.3 handshakes that offered early data, by outcome.\n"
+                       "# TYPE tls_server_early_data_total counter\n");
+    for (int e = 0; e < METRICS_EARLY_COUNT; e++) {
+        text_printf(&text, "tls_server_early_data_total{result=\"%s\"} %llu\n",
+                    EARLY_LABELS[e], (unsigned long long)early_data[e]);
+    }
+    render_counter(&text, "tls_server_early_requests_total",
+                   "Requests answered from early data before the handshake completed.", early_requests);
+
+    render_histogram(&text, "tls_server_handshake_duration_seconds", "TLS handshake duration.",
+                     workers, count, offsetof(ServerMetrics, handshake_time));
+    render_histogram(&text, "tls_server_handshake_queue_seconds", "Time handshake steps waited for a handshake thread.",
+                     workers, count, offsetof(ServerMetrics, handshake_queue_time));
+    render_histogram(&text, "tls_server_request_duration_seconds", "HTTP request handling duration.",
+                     workers, count, offsetof(ServerMetrics, request_time));
+
+    *length = text.length;
+    return text.data;
+}
@@ -0,0 +1,134 @@
+#ifndef SERVER_METRICS_H
+#define SERVER_METRICS_H
+
+// TLS 서버 메트릭 (Prometheus 텍스트 노출 형식)
+// - 워커마다 자기 전용 ServerMetrics를 갖고, 값은 소유 워커만 갱신한다 (공유 락 없음).
+// - /metrics 요청이 들어왔을 때만 등록된 워커들의 값을 읽어 합산한다.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+#define METRICS_MAX_WORKERS 64
+#define METRICS_MAX_CIPHERS 16
+#define METRICS_HISTOGRAM_BUCKETS 14
+
+typedef enum {
+    METRICS_PROTO_TLS1_0 = 0,
+    METRICS_PROTO_TLS1_1,
+    METRICS_PROTO_TLS1_2,
+    METRICS_PROTO_TLS1_3,
+    METRICS_PROTO_OTHER,
+    METRICS_PROTO_COUNT
+} MetricsProtocol;
+
+// 백엔드가 직접 호출한 시스템 콜 종류
+typedef enum {
+    METRICS_SYSCALL_ACCEPT = 0,
+    METRICS_SYSCALL_READ,
+    METRICS_SYSCALL_WRITE,
+    METRICS_SYSCALL_WAIT,       // epoll_wait, io_uring_enter
+    METRICS_SYSCALL_CONTROL,    // epoll_ctl, getpeername 등
+    METRICS_SYSCALL_CLOSE,
+    METRICS_SYSCALL_COUNT
+} MetricsSyscall;
+
+// 연결을 끊은 타임아웃 종류
+typedef enum {
+    METRICS_TIMEOUT_HANDSHAKE = 0,  // 수락 후 핸드셰이크 완료까지
+    METRICS_TIMEOUT_HEADER,         // 요청 헤더 수신 완료까지 (slowloris)
+    METRICS_TIMEOUT_IDLE,           // keep-alive 유휴
+    METRICS_TIMEOUT_WRITE,          // 응답 송신 정체
+    METRICS_TIMEOUT_COUNT
+} MetricsTimeout;
+
+// 수락 제어로 거절한 연결 (server_admission.h의 AdmissionResult 순서와 같다)
+typedef enum {
+    METRICS_REJECT_CONNECTIONS = 0, // 동시 연결 수 초과
+    METRICS_REJECT_HANDSHAKES,      // 동시 핸드셰이크 수 초과
+    METRICS_REJECT_RATE,            // 출발지 IP 속도 초과
+    METRICS_REJECT_OVERLOAD,        // 적응형 부하 차단
+    METRICS_REJECT_COUNT
+} MetricsReject;
+
+// TLS 1.3 early data(0-RTT)를 보낸 핸드셰이크의 결과
+typedef enum {
+    METRICS_EARLY_ACCEPTED = 0,     // 받아들임 (요청을 핸드셰이크 첫 비행에서 읽었다)
+    METRICS_EARLY_REJECTED,         // 거절 (이미 쓴 티켓, 티켓 나이 초과 등. 클라이언트가 핸드셰이크 뒤 다시 보낸다)
+    METRICS_EARLY_COUNT
+} MetricsEarlyData;
+
+// 워커 메모리 풀 종류 (바이트 게이지)
+typedef enum {
+    METRICS_MEMORY_CONNECTION_SLAB = 0,     // Connection 객체 slab (사용 중 + 재사용 대기)
+    METRICS_MEMORY_BUFFER_POOL,             // I/O 버퍼 풀 (빌려준 버퍼 + 보관 중인 빈 버퍼)
+    METRICS_MEMORY_BUFFERS_LENT,            // 지금 연결이 빌려 간 버퍼
+    METRICS_MEMORY_COUNT
+} MetricsMemory;
+
+// 고정 버킷 히스토그램 (버킷 값은 누적이 아닌 구간별 개수)
+typedef struct {
+    _Atomic uint64_t buckets[METRICS_HISTOGRAM_BUCKETS + 1]; // 마지막은 +Inf
+    _Atomic uint64_t sum_ns;
+    _Atomic uint64_t count;
+} MetricsHistogram;
+
+// 워커 한 개의 메트릭 (캐시 라인 단위로 정렬해 다른 워커와 공유되지 않게 한다)
+typedef struct {
+    _Alignas(64) _Atomic uint64_t accepts;
+    _Atomic uint64_t handshakes;
+    _Atomic uint64_t handshake_failures;
+    _Atomic uint64_t resumptions;
+    _Atomic uint64_t requests;
+    _Atomic uint64_t bytes_in;
+    _Atomic uint64_t bytes_out;
+    _Atomic int64_t active_connections;
+    _Atomic uint64_t protocols[METRICS_PROTO_COUNT];
+    _Atomic uint64_t syscalls[METRICS_SYSCALL_COUNT];
+    _Atomic int64_t memory[METRICS_MEMORY_COUNT];
+    _Atomic uint64_t timeouts[METRICS_TIMEOUT_COUNT];
+    _Atomic uint64_t rejections[METRICS_REJECT_COUNT];
+    _Atomic uint64_t early_data[METRICS_EARLY_COUNT];
+    _Atomic uint64_t early_requests;        // 핸드셰이크가 끝나기 전에 응답한 요청 (0.5-RTT)
+
+    // 암호화 스위트별 핸드셰이크 수 (이름은 OpenSSL이 소유한 정적 문자열)
+    const char* cipher_names[METRICS_MAX_CIPHERS];
+    _Atomic uint64_t cipher_counts[METRICS_MAX_CIPHERS];
+    _Atomic int cipher_slots;
+    _Atomic uint64_t cipher_overflow;
+
+    MetricsHistogram handshake_time;
+    MetricsHistogram handshake_queue_time;  // 핸드셰이크 풀에서 대기한 시간
+    MetricsHistogram request_time;
+} ServerMetrics;
+
+// 워커용 메트릭을 할당하고 전역 목록에 등록한다 (워커 시작 시 한 번만 호출)
+ServerMetrics* server_metrics_register(void);
+
+// 단일 작성자 카운터 증가 (소유 워커만 호출)
+static inline void metrics_add(_Atomic uint64_t* counter, uint64_t value) {
+    atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + value,
+                          memory_order_relaxed);
+}
+
+static inline void metrics_gauge_add(_Atomic int64_t* gauge, int64_t value) {
+    atomic_store_explicit(gauge, atomic_load_explicit(gauge, memory_order_relaxed) + value,
+                          memory_order_relaxed);
+}
+
+static inline void metrics_gauge_set(_Atomic int64_t* gauge, int64_t value) {
+    atomic_store_explicit(gauge, value, memory_order_relaxed);
+}
+
+// 히스토그램에 소요 시간(초)을 기록
+void metrics_observe(MetricsHistogram* histogram, double seconds);
+
+// 핸드셰이크 성공 기록 (프로토콜 버전, 암호화 스위트, 재개 여부, 소요 시간)
+void metrics_record_handshake(ServerMetrics* metrics, const char* version, const char* cipher,
+                              int resumed, double seconds);
+
+// 모든 워커를 합산해 Prometheus 텍스트 형식으로 출력한다.
+// 반환된 버퍼는 호출자가 free 해야 하며, length에 길이가 저장된다
+char* server_metrics_render(const char* server_name, const char* backend, size_t* length);
+
+#endif
@@ -0,0 +1,292 @@
+#include "server_ocsp.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <openssl/err.h>
+#include <openssl/ocsp.h>
+#include <openssl/x509v3.h>
+
+#define OCSP_DEFAULT_REFRESH 300.0
+#define OCSP_MAX_RESPONSE_SIZE 65536
+#define OCSP_CLOCK_SKEW 300                 // thisUpdate/nextUpdate 허용 시계 오차 (초)
+
+struct OcspStapler {
+    OcspConfig config;
+    X509* cert;                             // 서버 인증서 (ctx 소유)
+    X509* issuer;                           // 발급자 (ctx 소유)
+    X509_STORE* store;                      // 응답자 서명 검증용: 발급자만 신뢰 앵커로 둔다
+    STACK_OF(X509)* chain;                  // 설정된 체인 (ctx 소유, 응답자 인증서 경로 구성용)
+
+    pthread_mutex_t lock;                   // 아래 응답 필드와 stop
+    pthread_cond_t wake;
+    int stop;
+    pthread_t thread;
+    unsigned char* response;                // 지금 붙이는 DER 응답 (없으면 NULL)
+    long response_len;
+    time_t next_update;                     // 이 시각이 지나면 붙이지 않는다 (0이면 제한 없음)
+
+    // 갱신 스레드 전용: 마지막으로 읽은 파일 (바뀌지 않았으면 다시 파싱하지 않는다)
+    struct timespec file_mtime;
+    off_t file_size;
+};
+
+void ocsp_default_config(OcspConfig* config) {
+    memset(config, 0, sizeof(*config));
+    config->refresh = OCSP_DEFAULT_REFRESH;
+}
+
+static const char* ocsp_cert_status_name(int status) {
+    switch (status) {
+        case V_OCSP_CERTSTATUS_GOOD: return "good";
+        case V_OCSP_CERTSTATUS_REVOKED: return "revoked";
+        default: return "unknown";
+    }
+}
+
+// 응답 검사: successful, 응답자 서명(발급자 또는 발급자가 위임한 응답자), 서버 인증서의 단일 응답, 유효 기간.
+// 통과하면 0과 nextUpdate(벽시계), 인증서 상태
+static int ocsp_validate(const OcspStapler* stapler, const unsigned char* data, long len,
+                         time_t* next_update, int* cert_status) {
+    const unsigned char* p = data;
+    OCSP_RESPONSE* response = d2i_OCSP_RESPONSE(NULL, &p, len);
+    OCSP_BASICRESP* basic = NULL;
+    OCSP_CERTID* id = NULL;
+    const char* problem = NULL;
+
+    if (!response || OCSP_response_status(response) != OCSP_RESPONSE_STATUS_SUCCESSFUL ||
+        !(basic = OCSP_response_get1_basic(response))) {
+        problem = "successful 응답이 아님";
+        goto done;
+    }
+    if (OCSP_basic_verify(basic, stapler->chain, stapler->store, 0) <= 0) {
+        problem = "응답자 서명 검증 실패";
+        goto done;
+    }
+    id = OCSP_cert_to_id(NULL, stapler->cert, stapler->issuer);
+    int index = id ? OCSP_resp_find(basic, id, -1) : -1;
+    OCSP_SINGLERESP* single = index >= 0 ? OCSP_resp_get0(basic, index) : NULL;
+    if (!single) {
+        problem = "서버 인증서에 대한 응답이 없음";
+        goto done;
+    }
+    int reason;
+    ASN1_GENERALIZEDTIME *revoked_at, *this_update, *next;
+    *cert_status = OCSP_single_get0_status(single, &reason, &revoked_at, &this_update, &next);
+    if (OCSP_check_validity(this_update, next, OCSP_CLOCK_SKEW, -1) != 1) {
+        problem = "유효 기간이 아님 (thisUpdate/nextUpdate)";
+        goto done;
+    }
+    *next_update = 0;
+    struct tm tm;
+    if (next && ASN1_TIME_to_tm(next, &tm) == 1) {
+        *next_update = timegm(&tm);
+    }
+
+done:
+    if (problem) {
+        fprintf(stderr, "OCSP 응답 무시 (%s): %s\n", stapler->config.response_file, problem);
+    }
+    ERR_clear_error();
+    OCSP_CERTID_free(id);
+    OCSP_BASICRESP_free(basic);
+    OCSP_RESPONSE_free(response);
+    return problem ? -1 : 0;
+}
+
+// 파일이 바뀌었으면 읽고 검사해서 바꿔 끼운다 (검사에 실패하면 이전 응답을 유지)
+static void ocsp_reload(OcspStapler* stapler) {
+    const char* path = stapler->config.response_file;
+    struct stat st;
+    if (stat(path, &st) != 0) {
+        fprintf(stderr, "OCSP 응답 파일을 읽을 수 없습니다: %s (%s)\n", path, strerror(errno));
+        return;
+    }
+    if (st.st_mtim.tv_sec == stapler->file_mtime.tv_sec && st.st_mtim.tv_nsec == stapler->file_mtime.tv_nsec &&
+        st.st_size == stapler->file_size) {
+        return;
+    }
+    if (st.st_size <= 0 || st.st_size > OCSP_MAX_RESPONSE_SIZE) {
+        fprintf(stderr, "OCSP 응답 파일 크기가 잘못되었습니다: %s (%lld바이트)\n", path, (long long)st.st_size);
+        return;
+    }
+
+    FILE* file = fopen(path, "rb");
+    unsigned char* data = (unsigned char*)malloc((size_t)st.st_size);
+    size_t len = file && data ? fread(data, 1, (size_t)st.st_size, file) : 0;
+    if (file) {
+        fclose(file);
+    }
+    time_t next_update;
+    int cert_status;
+    if (len != (size_t)st.st_size || ocsp_validate(stapler, data, (long)len, &next_update, &cert_status) != 0) {
+        free(data);
+        return;
+    }
+    stapler->file_mtime = st.st_mtim;
+    stapler->file_size = st.st_size;
+
+    pthread_mutex_lock(&stapler->lock);
+    unsigned char* old = stapler->response;
+    stapler->response = data;
+    stapler->response_len = (long)len;
+    stapler->next_update = next_update;
+    pthread_mutex_unlock(&stapler->lock);
+    free(old);
+
+    char until[32] = "제한 없음";
+    if (next_update) {
+        struct tm tm;
+        strftime(until, sizeof(until), "%Y-%m-%d %H:%M:%S", localtime_r(&next_update, &tm));
+    }
+    printf("OCSP 응답 적재: %s (%zu바이트, 인증서 상태 %s, nextUpdate %s)\n", path, len,
+           ocsp_cert_status_name(cert_status), until);
+    fflush(stdout);
+}
+
+// 갱신 명령 실행 후 다시 읽기 (명령이 실패해도 파일은 확인한다: 다른 곳에서 바꿨을 수 있다)
+static void ocsp_refresh(OcspStapler* stapler) {
+    if (stapler->config.command) {
+        int status = system(stapler->config.command);
+        if (status == -1 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            fprintf(stderr, "OCSP 갱신 명령 실패 (상태 %d): %s\n", status, stapler->config.command);
+        }
+    }
+    ocsp_reload(stapler);
+}
+
+static void* ocsp_refresh_thread(void* arg) {
+    OcspStapler* stapler = (OcspStapler*)arg;
+    pthread_mutex_lock(&stapler->lock);
+    while (!stapler->stop) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += (time_t)stapler->config.refresh;
+        deadline.tv_nsec += (long)((stapler->config.refresh - (double)(time_t)stapler->config.refresh) * 1e9);
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        while (!stapler->stop && pthread_cond_timedwait(&stapler->wake, &stapler->lock, &deadline) != ETIMEDOUT) {
+        }
+        if (stapler->stop) {
+            break;
+        }
+        pthread_mutex_unlock(&stapler->lock);
+        ocsp_refresh(stapler);
+        pthread_mutex_lock(&stapler->lock);
+    }
+    pthread_mutex_unlock(&stapler->lock);
+    return NULL;
+}
+
+// SSL_CTX_set_tlsext_status_cb (서버): 보관한 응답의 복사본을 붙인다 (OpenSSL이 해제)
+static int ocsp_status_callback(SSL* ssl, void* arg) {
+    OcspStapler* stapler = (OcspStapler*)arg;
+    if (SSL_get_tlsext_status_type(ssl) != TLSEXT_STATUSTYPE_ocsp) {
+        return SSL_TLSEXT_ERR_NOACK;
+    }
+
+    unsigned char* copy = NULL;
+    long len = 0;
+    time_t now = time(NULL);
+    pthread_mutex_lock(&stapler->lock);
+    if (stapler->response && (stapler->next_update == 0 || now <= stapler->next_update)) {
+        copy = (unsigned char*)OPENSSL_malloc((size_t)stapler->response_len);
+        if (copy) {
+            memcpy(copy, stapler->response, (size_t)stapler->response_len);
+            len = stapler->response_len;
+        }
+    }
+    pthread_mutex_unlock(&stapler->lock);
+
+    if (!copy || SSL_set_tlsext_status_ocsp_resp(ssl, copy, len) != 1) {
+        OPENSSL_free(copy);
+        return SSL_TLSEXT_ERR_NOACK;
+    }
+    return SSL_TLSEXT_ERR_OK;
+}
+
+// 서버 인증서의 발급자 (자체 발급이면 자기 자신, 아니면 설정된 체인에서 찾는다)
+static X509* ocsp_find_issuer(SSL_CTX* ctx, X509* cert) {
+    if (X509_NAME_cmp(X509_get_subject_name(cert), X509_get_issuer_name(cert)) == 0) {
+        return cert;
+    }
+    STACK_OF(X509)* chain = NULL;
+    SSL_CTX_get0_chain_certs(ctx, &chain);
+    for (int i = 0; chain && i < sk_X509_num(chain); i++) {
+        if (X509_check_issued(sk_X509_value(chain, i), cert) == X509_V_OK) {
+            return sk_X509_value(chain, i);
+        }
+    }
+    return NULL;
+}
+
+OcspStapler* ocsp_stapler_start(const OcspConfig* config, SSL_CTX* ctx) {
+    X509* cert = SSL_CTX_get0_certificate(ctx);
+    if (!config->response_file || !cert || config->refresh <= 0.0) {
+        return NULL;
+    }
+    // 발급자를 모르면 응답이 이 인증서의 것인지, 누가 서명했는지 확인할 수 없으므로 붙이지 않는다
+    X509* issuer = ocsp_find_issuer(ctx, cert);
+    if (!issuer) {
+        fprintf(stderr, "OCSP: 서버 인증서의 발급자를 찾지 못했습니다 (발급자 인증서를 체인에 넣으세요)\n");
+        return NULL;
+    }
+    OcspStapler* stapler = (OcspStapler*)calloc(1, sizeof(OcspStapler));
+    if (!stapler) {
+        return NULL;
+    }
+    stapler->config = *config;
+    stapler->cert = cert;
+    stapler->issuer = issuer;
+    SSL_CTX_get0_chain_certs(ctx, &stapler->chain);
+    // 발급자가 중간 인증서여도 신뢰 앵커로 쓰도록 부분 체인 허용
+    stapler->store = X509_STORE_new();
+    if (!stapler->store || X509_STORE_add_cert(stapler->store, issuer) != 1 ||
+        X509_STORE_set_flags(stapler->store, X509_V_FLAG_PARTIAL_CHAIN) != 1) {
+        X509_STORE_free(stapler->store);
+        free(stapler);
+        return NULL;
+    }
+    pthread_mutex_init(&stapler->lock, NULL);
+    pthread_cond_init(&stapler->wake, NULL);
+
+    // 첫 응답은 수락을 시작하기 전에 읽는다
+    ocsp_refresh(stapler);
+
+    if (pthread_create(&stapler->thread, NULL, ocsp_refresh_thread, stapler) != 0) {
+        perror("OCSP 갱신 스레드 생성 실패");
+        pthread_cond_destroy(&stapler->wake);
+        pthread_mutex_destroy(&stapler->lock);
+        X509_STORE_free(stapler->store);
+        free(stapler->response);
+        free(stapler);
+        return NULL;
+    }
+    SSL_CTX_set_tlsext_status_cb(ctx, ocsp_status_callback);
+    SSL_CTX_set_tlsext_status_arg(ctx, stapler);
+    return stapler;
+}
+
+void ocsp_stapler_stop(OcspStapler* stapler) {
+    if (!stapler) {
+        return;
+    }
+    pthread_mutex_lock(&stapler->lock);
+    stapler->stop = 1;
+    pthread_cond_signal(&stapler->wake);
+    pthread_mutex_unlock(&stapler->lock);
+    pthread_join(stapler->thread, NULL);
+
+    pthread_cond_destroy(&stapler->wake);
+    pthread_mutex_destroy(&stapler->lock);
+    X509_STORE_free(stapler->store);
+    free(stapler->response);
+    free(stapler);
+}
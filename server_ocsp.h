@@ -0,0 +1,32 @@
+#ifndef SERVER_OCSP_H
+#define SERVER_OCSP_H
+
+// OCSP 스테이플링
+// - 서버 인증서의 OCSP 응답(DER)을 파일에서 읽어 메모리에 두고, 상태 요청을 보낸 클라이언트의 핸드셰이크에 붙인다.
+//   핸드셰이크 경로는 보관한 응답을 복사만 하고, 응답자 조회나 파일 I/O는 하지 않는다.
+// - 백그라운드 스레드가 주기적으로 (설정했으면) 갱신 명령을 실행하고 파일이 바뀌었으면 다시 읽는다.
+//   갱신 명령은 OCSP 응답자 대신이다 (예: openssl ocsp -url ... -respout 파일).
+// - 응답은 상태가 successful이고, 발급자(또는 발급자가 위임한 응답자)가 서명했으며, 서버 인증서의 것이고
+//   thisUpdate/nextUpdate 안일 때만 붙인다. 발급자를 찾지 못하면 시작하지 않는다.
+//   nextUpdate가 지난 응답은 새 응답을 받을 때까지 붙이지 않는다 (오래된 응답을 붙이면 클라이언트가 거절한다).
+
+#include <openssl/ssl.h>
+
+typedef struct {
+    const char* response_file;      // DER OCSP 응답 파일 (NULL이면 스테이플링하지 않음)
+    const char* command;            // 다시 읽기 전에 실행할 갱신 명령 (NULL 가능)
+    double refresh;                 // 갱신 주기 (초)
+} OcspConfig;
+
+typedef struct OcspStapler OcspStapler;
+
+void ocsp_default_config(OcspConfig* config);
+
+// 첫 응답을 읽고 ctx에 상태 요청 콜백을 붙인 뒤 갱신 스레드를 시작한다.
+// 첫 응답이 없거나 잘못되어도 시작은 한다 (유효한 응답을 받기 전까지는 붙이지 않음). 실패하면 NULL
+OcspStapler* ocsp_stapler_start(const OcspConfig* config, SSL_CTX* ctx);
+
+// 갱신 스레드를 멈추고 해제한다 (NULL 허용, 이 SSL_CTX로 새 핸드셰이크가 없을 때 호출)
+void ocsp_stapler_stop(OcspStapler* stapler);
+
+#endif
@@ -0,0 +1,672 @@
+#define _GNU_SOURCE
+#include "tls_server_internal.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+// io_uring 백엔드
+// - 워커마다 링 하나: 공유 리스닝 소켓에 멀티샷 accept, 수신은 제공 버퍼 링(provided buffer ring)에서 커널이 고른다.
+// - 수신한 암호문을 TLS 엔진에 넣고, 엔진이 내놓은 암호문을 send SQE로 보낸다.
+// - 응답 송신 뒤의 다음 작업(recv 또는 close)은 IOSQE_IO_LINK로 묶어 한 번의 io_uring_enter로 제출한다.
+// - 연결당 진행 중인 send는 최대 하나이고, recv는 send가 끝난 뒤에만 걸린다 (버퍼 소유권이 단순해진다).
+
+#define URING_ENTRIES 1024
+#define URING_BUFFER_COUNT 512          // 2의 거듭제곱
+#define URING_BUFFER_SIZE 4096
+#define URING_BUFFER_GROUP 0
+
+// user_data: Connection 포인터 하위 2비트에 작업 종류를 담는다 (포인터가 NULL이면 워커 이벤트)
+#define URING_OP_RECV 0
+#define URING_OP_SEND 1
+#define URING_OP_CLOSE 2
+#define URING_EVENT_ACCEPT 1
+#define URING_EVENT_WAKEUP 2
+#define URING_EVENT_CANCEL 3
+
+typedef enum {
+    URING_NEXT_NONE = 0,
+    URING_NEXT_RECV,
+    URING_NEXT_CLOSE
+} UringNext;
+
+struct UringLoop {
+    int ring_fd;
+    int disabled;               // 워커 스레드에서 활성화해야 하는 링
+    int accept_armed;           // 멀티샷 accept가 걸려 있다 (마지막 CQE 전까지)
+    int accept_cancelled;       // 드레인: 취소 SQE를 넣었다
+
+    // 제출 큐
+    unsigned* sq_head;
+    unsigned* sq_tail;
+    unsigned* sq_array;
+    unsigned sq_mask;
+    unsigned sq_entries;
+    unsigned sq_local_tail;
+    struct io_uring_sqe* sqes;
+
+    // 완료 큐
+    unsigned* cq_head;
+    unsigned* cq_tail;
+    unsigned cq_mask;
+    struct io_uring_cqe* cqes;
+
+    void* sq_ring;
+    size_t sq_ring_size;
+    void* cq_ring;
+    size_t cq_ring_size;
+    size_t sqes_size;
+
+    // 제공 버퍼 링
+    struct io_uring_buf_ring* buf_ring;
+    size_t buf_ring_size;
+    char* buffers;
+    unsigned short buf_tail;
+};
+
+static int sys_uring_setup(unsigned entries, struct io_uring_params* params) {
+    return (int)syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int sys_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags,
+                           void* arg, size_t arg_size) {
+    return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, arg, arg_size);
+}
+
+static int sys_uring_register(int fd, unsigned opcode, void* arg, unsigned nr_args) {
+    return (int)syscall(__NR_io_uring_register, fd, opcode, arg, nr_args);
+}
+
+// 제공 버퍼 링 등록이 되는지까지 확인한다 (멀티샷 accept와 같은 5.19 이상 기능)
+int uring_available(void) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int fd = sys_uring_setup(4, &params);
+    if (fd < 0) {
+        return 0;
+    }
+
+    int supported = 0;
+    size_t size = 4096;
+    void* ring = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    if (ring != MAP_FAILED) {
+        struct io_uring_buf_reg reg;
+        memset(&reg, 0, sizeof(reg));
+        reg.ring_addr = (uint64_t)(uintptr_t)ring;
+        reg.ring_entries = 1;
+        reg.bgid = URING_BUFFER_GROUP;
+        supported = sys_uring_register(fd, IORING_REGISTER_PBUF_RING, &reg, 1) == 0;
+        munmap(ring, size);
+    }
+    close(fd);
+    return supported;
+}
+
+static int uring_map(UringLoop* u, const struct io_uring_params* params) {
+    u->sq_ring_size = params->sq_off.array + params->sq_entries * sizeof(unsigned);
+    u->cq_ring_size = params->cq_off.cqes + params->cq_entries * sizeof(struct io_uring_cqe);
+    int single_mmap = (params->features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+        if (u->cq_ring_size > u->sq_ring_size) {
+            u->sq_ring_size = u->cq_ring_size;
+        }
+        u->cq_ring_size = u->sq_ring_size;
+    }
+
+    u->sq_ring = mmap(NULL, u->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      u->ring_fd, IORING_OFF_SQ_RING);
+    if (u->sq_ring == MAP_FAILED) {
+        u->sq_ring = NULL;
+        return -1;
+    }
+    if (single_mmap) {
+        u->cq_ring = u->sq_ring;
+    } else {
+        u->cq_ring = mmap(NULL, u->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                          u->ring_fd, IORING_OFF_CQ_RING);
+        if (u->cq_ring == MAP_FAILED) {
+            u->cq_ring = NULL;
+            return -1;
+        }
+    }
+
+    u->sqes_size = params->sq_entries * sizeof(struct io_uring_sqe);
+    u->sqes = (struct io_uring_sqe*)mmap(NULL, u->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                         u->ring_fd, IORING_OFF_SQES);
+    if (u->sqes == MAP_FAILED) {
+        u->sqes = NULL;
+        return -1;
+    }
+
+    char* sq = (char*)u->sq_ring;
+    char* cq = (char*)u->cq_ring;
+    u->sq_head = (unsigned*)(sq + params->sq_off.head);
+    u->sq_tail = (unsigned*)(sq + params->sq_off.tail);
+    u->sq_array = (unsigned*)(sq + params->sq_off.array);
+    u->sq_mask = *(unsigned*)(sq + params->sq_off.ring_mask);
+    u->sq_entries = params->sq_entries;
+    u->sq_local_tail = *u->sq_tail;
+    u->cq_head = (unsigned*)(cq + params->cq_off.head);
+    u->cq_tail = (unsigned*)(cq + params->cq_off.tail);
+    u->cq_mask = *(unsigned*)(cq + params->cq_off.ring_mask);
+    u->cqes = (struct io_uring_cqe*)(cq + params->cq_off.cqes);
+    return 0;
+}
+
+static void buffer_ring_add(UringLoop* u, unsigned short bid) {
+    struct io_uring_buf* buf = &u->buf_ring->bufs[u->buf_tail & (URING_BUFFER_COUNT - 1)];
+    buf->addr = (uint64_t)(uintptr_t)(u->buffers + (size_t)bid * URING_BUFFER_SIZE);
+    buf->len = URING_BUFFER_SIZE;
+    buf->bid = bid;
+    u->buf_tail++;
+}
+
+static void buffer_ring_publish(UringLoop* u) {
+    __atomic_store_n(&u->buf_ring->tail, u->buf_tail, __ATOMIC_RELEASE);
+}
+
+static int buffer_ring_init(UringLoop* u) {
+    u->buf_ring_size = URING_BUFFER_COUNT * sizeof(struct io_uring_buf);
+    void* ring = mmap(NULL, u->buf_ring_size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    if (ring == MAP_FAILED) {
+        return -1;
+    }
+    u->buf_ring = (struct io_uring_buf_ring*)ring;
+
+    u->buffers = (char*)aligned_alloc(4096, (size_t)URING_BUFFER_COUNT * URING_BUFFER_SIZE);
+    if (!u->buffers) {
+        return -1;
+    }
+
+    struct io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = (uint64_t)(uintptr_t)u->buf_ring;
+    reg.ring_entries = URING_BUFFER_COUNT;
+    reg.bgid = URING_BUFFER_GROUP;
+    if (sys_uring_register(u->ring_fd, IORING_REGISTER_PBUF_RING, &reg, 1) != 0) {
+        perror("제공 버퍼 링 등록 실패");
+        return -1;
+    }
+
+    for (unsigned i = 0; i < URING_BUFFER_COUNT; i++) {
+        buffer_ring_add(u, (unsigned short)i);
+    }
+    buffer_ring_publish(u);
+    return 0;
+}
+
+// 아직 커널이 가져가지 않은 SQE를 제출하고, min_complete개 이상 완료될 때까지 기다린다
+// (timeout_ms >= 0이면 그 시간까지만 기다린다. 타임아웃 SQE 없이 EXT_ARG로 대기 시간을 넘긴다)
+static int uring_submit(ServerWorker* worker, unsigned min_complete, int timeout_ms) {
+    UringLoop* u = worker->uring;
+    __atomic_store_n(u->sq_tail, u->sq_local_tail, __ATOMIC_RELEASE);
+    unsigned pending = u->sq_local_tail - __atomic_load_n(u->sq_head, __ATOMIC_ACQUIRE);
+    unsigned flags = min_complete ? IORING_ENTER_GETEVENTS : 0;
+
+    metrics_add(&worker->metrics->syscalls[METRICS_SYSCALL_WAIT], 1);
+    if (min_complete == 0 || timeout_ms < 0) {
+        return sys_uring_enter(u->ring_fd, pending, min_complete, flags, NULL, 0);
+    }
+
+    struct __kernel_timespec ts;
+    struct io_uring_getevents_arg arg;
+    ts.tv_sec = timeout_ms / 1000;
+    ts.tv_nsec = (long long)(timeout_ms % 1000) * 1000000;
+    memset(&arg, 0, sizeof(arg));
+    arg.ts = (uint64_t)(uintptr_t)&ts;
+    return sys_uring_enter(u->ring_fd, pending, min_complete, flags | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+}
+
+static struct io_uring_sqe* uring_get_sqe(ServerWorker* worker) {
+    UringLoop* u = worker->uring;
+
+    // 제출 큐가 가득 차면 먼저 제출해 자리를 만든다
+    if (u->sq_local_tail - __atomic_load_n(u->sq_head, __ATOMIC_ACQUIRE) >= u->sq_entries) {
+        uring_submit(worker, 0, -1);
+        if (u->sq_local_tail - __atomic_load_n(u->sq_head, __ATOMIC_ACQUIRE) >= u->sq_entries) {
+            return NULL;
+        }
+    }
+
+    unsigned index = u->sq_local_tail & u->sq_mask;
+    struct io_uring_sqe* sqe = &u->sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    u->sq_array[index] = index;
+    u->sq_local_tail++;
+    return sqe;
+}
+
+static uint64_t conn_tag(Connection* conn, unsigned op) {
+    return (uint64_t)(uintptr_t)conn | op;
+}
+
+static int queue_accept(ServerWorker* worker) {
+    struct io_uring_sqe* sqe = uring_get_sqe(worker);
+    if (!sqe) {
+        return -1;
+    }
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = worker->server_sock;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->accept_flags = SOCK_CLOEXEC;
+    sqe->user_data = URING_EVENT_ACCEPT;
+    worker->uring->accept_armed = 1;
+    return 0;
+}
+
+static int queue_wakeup(ServerWorker* worker) {
+    struct io_uring_sqe* sqe = uring_get_sqe(worker);
+    if (!sqe) {
+        return -1;
+    }
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = worker->completions.event_fd;
+    sqe->len = IORING_POLL_ADD_MULTI;
+    sqe->poll32_events = POLLIN;
+    sqe->user_data = URING_EVENT_WAKEUP;
+    return 0;
+}
+
+static int queue_recv(Connection* conn) {
+    struct io_uring_sqe* sqe = uring_get_sqe(conn->worker);
+    if (!sqe) {
+        return -1;
+    }
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = conn->fd;
+    sqe->len = URING_BUFFER_SIZE;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = URING_BUFFER_GROUP;
+    sqe->user_data = conn_tag(conn, URING_OP_RECV);
+    conn->inflight++;
+    return 0;
+}
+
+static int queue_send(Connection* conn, int link) {
+    struct io_uring_sqe* sqe = uring_get_sqe(conn->worker);
+    if (!sqe) {
+        return -1;
+    }
+    sqe->opcode = IORING_OP_SEND;
+    sqe->fd = conn->fd;
+    sqe->addr = (uint64_t)(uintptr_t)(conn->tx + conn->tx_sent);
+    sqe->len = (unsigned)(conn->tx_len - conn->tx_sent);
+    // MSG_WAITALL: 커널이 짧은 전송을 알아서 이어 보내므로 링크가 중간에 끊기지 않는다
+    sqe->msg_flags = MSG_NOSIGNAL | MSG_WAITALL;
+    sqe->flags = link ? IOSQE_IO_LINK : 0;
+    sqe->user_data = conn_tag(conn, URING_OP_SEND);
+    conn->inflight++;
+    return 0;
+}
+
+static int queue_close(Connection* conn) {
+    struct io_uring_sqe* sqe = uring_get_sqe(conn->worker);
+    if (!sqe) {
+        return -1;
+    }
+    sqe->opcode = IORING_OP_CLOSE;
+    sqe->fd = conn->fd;
+    sqe->user_data = conn_tag(conn, URING_OP_CLOSE);
+    conn->inflight++;
+    conn->state = CONN_CLOSING;
+    return 0;
+}
+
+// 모아 둔 암호문을 보내고 이어서 할 작업을 링크로 묶는다
+static void conn_flush(Connection* conn, UringNext next) {
+    int queued = 0;
+
+    // 진행 중인 send가 없을 때만 호출되므로 tx를 늘려도 커널이 보던 버퍼가 바뀌지 않는다
+    if (conn_collect_output(conn) != 0) {
+        next = URING_NEXT_CLOSE;
+    }
+    if (conn->tx_len > conn->tx_sent) {
+        queued = queue_send(conn, next != URING_NEXT_NONE) == 0;
+        if (!queued) {
+            next = URING_NEXT_CLOSE;
+        }
+    }
+
+    if (next == URING_NEXT_RECV) {
+        if (queue_recv(conn) != 0) {
+            next = URING_NEXT_CLOSE;
+        }
+    }
+    if (next == URING_NEXT_CLOSE && queue_close(conn) != 0) {
+        // SQ를 얻지 못하면 동기 close로 정리한다
+        close(conn->fd);
+        metrics_add(&conn->worker->metrics->syscalls[METRICS_SYSCALL_CLOSE], 1);
+        conn->fd = -1;
+        conn->state = CONN_CLOSING;
+    }
+    if (conn->state != CONN_CLOSING) {
+        conn_update_timer(conn);
+    }
+}
+
+// 평문 요청을 읽고 응답을 암호화해 송신 버퍼에 쌓는다 (파이프라이닝된 요청은 한 번에 처리)
+static void conn_process(Connection* conn) {
+    int result = conn_serve_requests(conn);
+    conn_flush(conn, result == 0 ? URING_NEXT_RECV : URING_NEXT_CLOSE);
+}
+
+static void conn_handshake_done(Connection* conn) {
+    HandshakeTask* task = &conn->task;
+
+    if (conn->in_pool) {
+        worker_observe_delay(conn->worker, task->started_at - task->queued_at);
+    }
+    conn->in_pool = 0;
+    if (conn->close_pending || conn_handshake_early_data(conn) != 0) {
+        conn_flush(conn, URING_NEXT_CLOSE);
+        return;
+    }
+    if (task->result == 1) {
+        conn_record_handshake(conn);
+        conn->state = CONN_READING;
+        conn_process(conn);
+        return;
+    }
+
+    // 메모리 BIO는 쓰기가 막히지 않으므로 WANT_READ만 기다리면 된다
+    if (task->ssl_error == SSL_ERROR_WANT_READ || task->ssl_error == SSL_ERROR_WANT_WRITE) {
+        conn_flush(conn, URING_NEXT_RECV);
+        return;
+    }
+
+    conn_record_handshake_failure(conn, task->error_code);
+    conn_flush(conn, URING_NEXT_CLOSE);     // 경고(alert) 레코드가 있으면 보내고 닫는다
+}
+
+// 수신한 암호문을 SSL에 넣고 진행한다
+static void conn_received(Connection* conn, const char* data, size_t length) {
+    if (tls_engine_feed(&conn->tls, data, length) != 0) {
+        conn_flush(conn, URING_NEXT_CLOSE);
+        return;
+    }
+
+    if (conn->state != CONN_HANDSHAKE) {
+        conn_process(conn);
+    } else if (conn_handshake_prepare(conn) != 0) {
+        conn_flush(conn, URING_NEXT_CLOSE);
+    } else if (conn->worker->pool) {
+        // 진행 중인 SQE가 없으므로 풀 스레드가 SSL을 단독으로 만질 수 있다
+        conn->in_pool = 1;
+        handshake_pool_submit(conn->worker->pool, &conn->task);
+    } else {
+        handshake_step(&conn->task);
+        conn_handshake_done(conn);
+    }
+}
+
+static void accept_connection(ServerWorker* worker, int fd) {
+    Connection* conn = conn_accept(worker, fd, NULL);
+    if (!conn) {
+        return;
+    }
+
+    // 멀티샷 accept는 주소를 돌려주지 않으므로 접근 로그에 남길 연결만 조회한다 (수락 제어가 이미 조회했으면 생략)
+    if (conn->logged && conn->entry.family == 0) {
+        struct sockaddr_in client_addr;
+        socklen_t client_len = sizeof(client_addr);
+        metrics_add(&worker->metrics->syscalls[METRICS_SYSCALL_CONTROL], 1);
+        if (getpeername(fd, (struct sockaddr*)&client_addr, &client_len) == 0 && client_addr.sin_family == AF_INET) {
+            conn_set_peer(conn, &client_addr);
+        }
+    }
+
+    if (queue_recv(conn) != 0) {
+        close(fd);
+        conn_destroy(conn);
+    }
+}
+
+static void handle_connection_cqe(ServerWorker* worker, const struct io_uring_cqe* cqe) {
+    Connection* conn = (Connection*)(uintptr_t)(cqe->user_data & ~(uint64_t)3);
+    unsigned op = (unsigned)(cqe->user_data & 3);
+    int failed = 0;
+
+    conn->inflight--;
+
+    switch (op) {
+        case URING_OP_RECV:
+            if (cqe->flags & IORING_CQE_F_BUFFER) {
+                unsigned short bid = (unsigned short)(cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+                if (cqe->res > 0 && conn->state != CONN_CLOSING) {
+                    conn_received(conn, worker->uring->buffers + (size_t)bid * URING_BUFFER_SIZE, (size_t)cqe->res);
+                }
+                // 데이터는 BIO로 복사했으므로 버퍼는 바로 돌려준다
+                buffer_ring_add(worker->uring, bid);
+                buffer_ring_publish(worker->uring);
+            }
+            if (cqe->res == -ENOBUFS && conn->state != CONN_CLOSING) {
+                failed = queue_recv(conn) != 0;
+            } else if (cqe->res <= 0) {
+                failed = 1;
+            }
+            break;
+        case URING_OP_SEND:
+            if (cqe->res >= 0 && (size_t)cqe->res == conn->tx_len - conn->tx_sent) {
+                conn_release_tx(conn);
+                if (conn->state != CONN_CLOSING) {
+                    conn_update_timer(conn);    // 송신 정체 마감을 다음 요청 대기 마감으로 바꾼다
+                }
+            } else {
+                failed = 1;
+            }
+            break;
+        case URING_OP_CLOSE:
+            if (cqe->res != -ECANCELED) {
+                conn->fd = -1;
+            }
+            break;
+    }
+
+    // 실패했거나 링크가 취소되면 남은 작업이 모두 끝난 뒤 닫는다
+    if (failed && conn->state != CONN_CLOSING) {
+        if (conn->state == CONN_HANDSHAKE) {
+            conn_record_handshake_failure(conn, 0);
+        }
+        conn->state = CONN_CLOSING;
+    }
+    if (conn->inflight == 0 && conn->state == CONN_CLOSING) {
+        if (conn->fd >= 0) {
+            if (queue_close(conn) == 0) {
+                return;
+            }
+            close(conn->fd);
+            metrics_add(&worker->metrics->syscalls[METRICS_SYSCALL_CLOSE], 1);
+        }
+        conn_destroy(conn);
+    }
+}
+
+// 진행 중인 recv/send를 끝내도록 소켓을 shutdown하고, 완료가 돌아오면 평소처럼 닫는다
+// (풀에 가 있으면 진행 중인 SQE가 없으므로 돌아온 뒤 닫는다)
+static void conn_abort(Connection* conn) {
+    if (conn->state == CONN_CLOSING) {
+        return;
+    }
+    if (conn->in_pool) {
+        conn->close_pending = 1;
+        return;
+    }
+    conn->state = CONN_CLOSING;
+    shutdown(conn->fd, SHUT_RDWR);
+    metrics_add(&conn->worker->metrics->syscalls[METRICS_SYSCALL_CONTROL], 1);
+}
+
+static void conn_timeout(TimerEntry* timer, void* arg) {
+    Connection* conn = conn_from_timer(timer);
+    (void)arg;
+
+    if (conn->state != CONN_CLOSING && conn_timer_expired(conn)) {
+        conn_abort(conn);
+    }
+}
+
+// 드레인: accept가 끝난 뒤 대기열에 남은 연결을 직접 수락한다
+// (accept의 poll 대기는 배타적이라, 취소 직전에 이 링이 받은 깨움은 새 프로세스의 링에 가지 않는다)
+static void accept_backlog(ServerWorker* worker) {
+    for (;;) {
+        int fd = accept4(worker->server_sock, NULL, NULL, SOCK_CLOEXEC);
+        metrics_add(&worker->metrics->syscalls[METRICS_SYSCALL_ACCEPT], 1);
+        if (fd < 0) {
+            return;
+        }
+        accept_connection(worker, fd);
+    }
+}
+
+// 드레인: 멀티샷 accept를 취소한다 (취소된 accept는 다시 걸지 않는다)
+static void stop_accepting(ServerWorker* worker) {
+    struct io_uring_sqe* sqe = uring_get_sqe(worker);
+    if (!sqe) {
+        return;         // 다음 루프에서 다시 시도한다
+    }
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->addr = URING_EVENT_ACCEPT;
+    sqe->user_data = URING_EVENT_CANCEL;
+    worker->uring->accept_cancelled = 1;
+}
+
+int uring_worker_init(ServerWorker* worker) {
+    UringLoop* u = (UringLoop*)calloc(1, sizeof(UringLoop));
+    if (!u) {
+        return -1;
+    }
+    u->ring_fd = -1;
+    worker->uring = u;
+
+    // 완료 처리는 이 워커 스레드만 하므로 가능하면 단일 제출자/지연 작업 실행 모드를 쓴다
+    // (제출자는 링을 활성화한 스레드로 정해지므로 비활성 상태로 만들고 워커 스레드에서 활성화한다)
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN | IORING_SETUP_R_DISABLED;
+    u->ring_fd = sys_uring_setup(URING_ENTRIES, &params);
+    u->disabled = u->ring_fd >= 0;
+    if (u->ring_fd < 0 && errno == EINVAL) {
+        memset(&params, 0, sizeof(params));
+        u->ring_fd = sys_uring_setup(URING_ENTRIES, &params);
+    }
+    if (u->ring_fd < 0) {
+        perror("io_uring 생성 실패");
+        return -1;
+    }
+
+    if (uring_map(u, &params) != 0 || buffer_ring_init(u) != 0) {
+        perror("io_uring 초기화 실패");
+        return -1;
+    }
+
+    if (queue_accept(worker) != 0 || queue_wakeup(worker) != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+// 워커 스레드: io_uring 이벤트 루프
+void* uring_worker_main(void* arg) {
+    ServerWorker* worker = (ServerWorker*)arg;
+    UringLoop* u = worker->uring;
+
+    if (u->disabled && sys_uring_register(u->ring_fd, IORING_REGISTER_ENABLE_RINGS, NULL, 0) != 0) {
+        perror("io_uring 활성화 실패");
+        return NULL;
+    }
+
+    for (;;) {
+        if (uring_submit(worker, 1, worker_wait_timeout_ms(worker)) < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY &&
+            errno != ETIME) {
+            perror("io_uring_enter 실패");
+            break;
+        }
+        // 인라인 핸드셰이크는 이벤트 루프 자체가 대기열이므로 한 바퀴 처리 시간을 대기 시간으로 본다
+        double woke_at = worker->admission && !worker->pool ? server_now_seconds() : 0.0;
+
+        unsigned head = *u->cq_head;
+        unsigned tail = __atomic_load_n(u->cq_tail, __ATOMIC_ACQUIRE);
+        for (; head != tail; head++) {
+            struct io_uring_cqe cqe = u->cqes[head & u->cq_mask];
+
+            if (cqe.user_data == URING_EVENT_ACCEPT) {
+                if (cqe.res >= 0) {
+                    accept_connection(worker, cqe.res);
+                }
+                if (cqe.flags & IORING_CQE_F_MORE) {
+                    // 멀티샷 accept가 계속 걸려 있다
+                } else if (worker->draining ||
+                           atomic_load_explicit(&worker->drain_deadline_ms, memory_order_relaxed) != 0) {
+                    u->accept_armed = 0;
+                    accept_backlog(worker);
+                } else {
+                    u->accept_armed = 0;
+                    queue_accept(worker);
+                }
+            } else if (cqe.user_data == URING_EVENT_WAKEUP) {
+                HandshakeTask* task = handshake_queue_take_all(&worker->completions);
+                metrics_add(&worker->metrics->syscalls[METRICS_SYSCALL_READ], 1);
+                while (task) {
+                    HandshakeTask* next = task->next;
+                    conn_handshake_done((Connection*)task);
+                    task = next;
+                }
+                if (!(cqe.flags & IORING_CQE_F_MORE)) {
+                    queue_wakeup(worker);
+                }
+            } else if (cqe.user_data != URING_EVENT_CANCEL) {
+                handle_connection_cqe(worker, &cqe);
+            }
+        }
+        __atomic_store_n(u->cq_head, head, __ATOMIC_RELEASE);
+        if (woke_at > 0.0) {
+            worker_observe_delay(worker, server_now_seconds() - woke_at);
+        }
+        timer_wheel_advance(&worker->timers, server_now_ms(), conn_timeout, NULL);
+        // accept의 poll 대기가 리스닝 소켓에 남아 있는 동안 나가면, 그 대기가 가져간 깨움이
+        // 새 프로세스에 가지 않아 대기열의 연결이 다음 연결이 올 때까지 방치된다.
+        // 취소가 끝나(마지막 CQE) 남은 대기열을 쓸어 담은 뒤에만 루프를 떠난다.
+        int drained = worker_drain(worker, stop_accepting, conn_abort);
+        if (worker->draining && u->accept_armed && !u->accept_cancelled) {
+            stop_accepting(worker);
+        }
+        if (drained && !u->accept_armed) {
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+void uring_worker_destroy(ServerWorker* worker) {
+    UringLoop* u = worker->uring;
+    if (!u) {
+        return;
+    }
+
+    if (u->sqes) {
+        munmap(u->sqes, u->sqes_size);
+    }
+    if (u->cq_ring && u->cq_ring != u->sq_ring) {
+        munmap(u->cq_ring, u->cq_ring_size);
+    }
+    if (u->sq_ring) {
+        munmap(u->sq_ring, u->sq_ring_size);
+    }
+    if (u->buf_ring) {
+        munmap(u->buf_ring, u->buf_ring_size);
+    }
+    if (u->ring_fd >= 0) {
+        close(u->ring_fd);
+    }
+    free(u->buffers);
+    free(u);
+    worker->uring = NULL;
+}
@@ -0,0 +1,219 @@
+#!/bin/bash
+
+# 소켓 튜닝 옵션 매트릭스 벤치마크
+# 1. 구성마다 tls_server_test를 해당 --socket-profile로 다시 띄움 (클라이언트도 같은 프로파일)
+# 2. tls_client_test --bench로 핸드셰이크마다 요청 하나를 보내 연결/핸드셰이크/첫 바이트 지연 시간 분포를 측정
+# 3. tls_load_test로 keep-alive 처리량(req/s, MB/s)을 측정
+# 4. 기준 구성(첫 번째, 기본값 none) 대비 변화율을 표로 출력
+# 사용법: ./socket_matrix.sh [--port N] [--count N] [--connections N] [--requests N] [--bin-dir DIR] [--profile SPEC]...
+# 예시:   ./socket_matrix.sh --count 500
+#         ./socket_matrix.sh --profile none --profile none,fastopen --profile latency
+#         sudo sysctl -w net.ipv4.tcp_fastopen=3   # 서버 쪽 Fast Open 허용 (기본값 1은 클라이언트만)
+
+set -e
+
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+BLUE='\033[0;34m'
+YELLOW='\033[1;33m'
+NC='\033[0m' # No Color
+
+print_error() {
+    echo -e "${RED}❌ $1${NC}" >&2
+}
+
+print_success() {
+    echo -e "${GREEN}✅ $1${NC}" >&2
+}
+
+print_info() {
+    echo -e "${BLUE}ℹ️  $1${NC}" >&2
+}
+
+print_warning() {
+    echo -e "${YELLOW}⚠️  $1${NC}" >&2
+}
+
+PORT=19443
+COUNT=200
+CONNECTIONS=8
+REQUESTS=500
+BIN_DIR=.
+PROFILES=()
+while [[ $# -gt 0 ]]; do
+    case $1 in
+        --port)
+            PORT=$2
+            shift 2
+            ;;
+        --count)
+            COUNT=$2
+            shift 2
+            ;;
+        --connections)
+            CONNECTIONS=$2
+            shift 2
+            ;;
+        --requests)
+            REQUESTS=$2
+            shift 2
+            ;;
+        --bin-dir)
+            BIN_DIR=$2
+            shift 2
+            ;;
+        --profile)
+            PROFILES+=("$2")
+            shift 2
+            ;;
+        -h|--help)
+            sed -n '3,11p' "$0" | sed 's/^# \{0,1\}//'
+            exit 0
+            ;;
+        *)
+            print_error "알 수 없는 옵션: $1"
+            exit 1
+            ;;
+    esac
+done
+# 기본 매트릭스: 아무것도 설정하지 않은 기준, 옵션 하나씩, 이름 있는 프로파일
+if [[ ${#PROFILES[@]} -eq 0 ]]; then
+    PROFILES=(none none,nodelay none,fastopen none,defer_accept none,buffers=4m none,notsent_lowat=16384
+              none,busy_poll=50 default latency throughput)
+fi
+
+cd "$(dirname "$0")"
+
+for tool in tls_server_test tls_client_test tls_load_test; do
+    if [[ ! -x "$BIN_DIR/$tool" ]]; then
+        print_error "$BIN_DIR/$tool이 없습니다 (먼저 ./build.sh -t 또는 CMake로 빌드)"
+        exit 1
+    fi
+done
+
+# 서버 쪽 Fast Open은 sysctl의 2번 비트가 켜져 있어야 한다 (꺼져 있으면 일반 핸드셰이크로 떨어진다)
+TFO_SYSCTL=$(cat /proc/sys/net/ipv4/tcp_fastopen 2>/dev/null || echo 3)
+if (( (TFO_SYSCTL & 3) != 3 )); then
+    print_warning "net.ipv4.tcp_fastopen=$TFO_SYSCTL: fastopen 구성은 일반 핸드셰이크로 측정됩니다 (3으로 설정 필요)"
+fi
+
+WORK_DIR=$(mktemp -d)
+SERVER_PID=""
+
+stop_server() {
+    if [[ -n "$SERVER_PID" ]]; then
+        kill -TERM "$SERVER_PID" 2>/dev/null || true
+        wait "$SERVER_PID" 2>/dev/null || true
+        SERVER_PID=""
+    fi
+}
+
+cleanup() {
+    stop_server
+    rm -rf "$WORK_DIR"
+}
+trap cleanup EXIT
+
+# 함수: 포트가 열릴 때까지 대기 (최대 5초)
+wait_for_port() {
+    for _ in $(seq 50); do
+        if (exec 3<>"/dev/tcp/127.0.0.1/$PORT") 2>/dev/null; then
+            return 0
+        fi
+        sleep 0.1
+    done
+    return 1
+}
+
+# 함수: 핸드셰이크 레코드(JSON Lines)에서 성공한 핸드셰이크의 "연결 연결+TLS TTFB" (ms)를 한 줄씩 뽑는다
+handshake_samples() {
+    awk '
+        function field(name,   start, rest) {
+            start = index($0, "\"" name "\":")
+            if (start == 0) return "null"
+            rest = substr($0, start + length(name) + 3)
+            return substr(rest, 1, match(rest, /[,}]/) - 1)
+        }
+        /"success":true/ {
+            c = field("connect_ms"); t = field("tls_ms"); f = field("ttfb_ms")
+            if (c == "null" || t == "null") next
+            printf "%s %.3f %s\n", c, c + t, f == "null" ? "-" : f
+        }' "$1"
+}
+
+# 함수: 표본 파일의 열 하나에서 백분위 계산 (값이 없으면 "-")
+# 사용법: percentile <파일> <열> <백분위>
+percentile() {
+    awk -v column="$2" '$column != "-" { print $column }' "$1" | sort -n |
+        awk -v p="$3" '{ values[NR] = $1 } END {
+            if (NR == 0) { print "-"; exit }
+            i = int(NR * p / 100) + 1
+            if (i > NR) i = NR
+            printf "%.3f\n", values[i]
+        }'
+}
+
+# 함수: 기준 대비 변화율 ("+12.3%")
+delta() {
+    awk -v value="$1" -v base="$2" 'BEGIN {
+        if (value == "-" || base == "-" || base + 0 == 0) { print "-"; exit }
+        printf "%+.1f%%", (value - base) / base * 100
+    }'
+}
+
+print_info "구성 ${#PROFILES[@]}개, 구성당 핸드셰이크 $COUNT회, 부하 연결 $CONNECTIONS개 x 요청 $REQUESTS회"
+echo "" >&2
+
+ROWS=()
+BASE_TTFB=""
+BASE_RPS=""
+for spec in "${PROFILES[@]}"; do
+    "$BIN_DIR/tls_server_test" "$PORT" --socket-profile "$spec" > "$WORK_DIR/server.log" 2>&1 &
+    SERVER_PID=$!
+    if ! wait_for_port; then
+        print_error "서버가 시작되지 않았습니다 ($spec):"
+        cat "$WORK_DIR/server.log" >&2
+        exit 1
+    fi
+
+    # 첫 연결로 Fast Open 쿠키를 받아 둔다 (측정에서 제외)
+    "$BIN_DIR/tls_client_test" localhost "$PORT" / --socket-profile "$spec" > /dev/null 2>&1 || true
+
+    rm -f "$WORK_DIR/handshake.jsonl"
+    RESULT_FORMAT=jsonl RESULT_FILE="$WORK_DIR/handshake.jsonl" \
+        "$BIN_DIR/tls_client_test" localhost "$PORT" / --bench --count "$COUNT" --tls 1.3 --modes full \
+        --groups X25519 --request --socket-profile "$spec" > "$WORK_DIR/bench.log" 2>&1
+    handshake_samples "$WORK_DIR/handshake.jsonl" > "$WORK_DIR/samples"
+    CONNECT_P50=$(percentile "$WORK_DIR/samples" 1 50)
+    SETUP_P50=$(percentile "$WORK_DIR/samples" 2 50)
+    SETUP_P99=$(percentile "$WORK_DIR/samples" 2 99)
+    TTFB_P50=$(percentile "$WORK_DIR/samples" 3 50)
+    TFO=$(grep -o 'TFO [0-9]*/[0-9]*' "$WORK_DIR/bench.log" | head -1 | cut -d' ' -f2)
+
+    "$BIN_DIR/tls_load_test" localhost "$PORT" --connections "$CONNECTIONS" --requests "$REQUESTS" \
+        --socket-profile "$spec" > "$WORK_DIR/load.log" 2>&1 || true
+    RPS=$(sed -n 's/^처리량: \([0-9.]*\) req\/s, \([0-9.]*\) MB\/s$/\1/p' "$WORK_DIR/load.log")
+    MBPS=$(sed -n 's/^처리량: \([0-9.]*\) req\/s, \([0-9.]*\) MB\/s$/\2/p' "$WORK_DIR/load.log")
+    stop_server
+
+    if [[ -z "$BASE_TTFB" ]]; then
+        BASE_TTFB=$TTFB_P50
+        BASE_RPS=${RPS:--}
+    fi
+    ROWS+=("$(printf "%-26s %9s %10s %9s %9s %9s %9s %8s %9s %6s" "$spec" "$CONNECT_P50" "$SETUP_P50" "$SETUP_P99" \
+        "$TTFB_P50" "$(delta "$TTFB_P50" "$BASE_TTFB")" "${RPS:--}" "$(delta "${RPS:--}" "$BASE_RPS")" "${MBPS:--}" \
+        "${TFO:--}")")
+    print_info "완료: $spec"
+done
+
+echo ""
+echo "=== 소켓 튜닝 매트릭스 (TLS 1.3 X25519 전체 핸드셰이크 + 요청, 기준: ${PROFILES[0]}) ==="
+# 한글 열 이름은 두 칸씩 차지하므로 printf 폭 대신 직접 맞춘다
+echo "프로파일                     연결p50    설정p50   설정p99   TTFBp50  TTFB변화     req/s     변화      MB/s    TFO"
+for row in "${ROWS[@]}"; do
+    echo "$row"
+done
+echo ""
+echo "시간 단위 ms. 설정 = TCP 연결 + TLS 핸드셰이크, TTFB = 연결 시작부터 첫 응답 바이트까지"
+echo "TFO: SYN에 ClientHello를 실어 보낸 핸드셰이크 수 / 성공한 핸드셰이크 수"
+print_success "매트릭스 완료"
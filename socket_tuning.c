@@ -0,0 +1,242 @@
+#include "socket_tuning.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#define SOCKET_TUNING_FASTOPEN_QUEUE 256    // 서버 Fast Open 대기열 길이 (fastopen에 값을 주지 않았을 때)
+
+typedef enum {
+    OPTION_NODELAY = 0,
+    OPTION_FASTOPEN,
+    OPTION_DEFER_ACCEPT,
+    OPTION_SNDBUF,
+    OPTION_RCVBUF,
+    OPTION_NOTSENT_LOWAT,
+    OPTION_BUSY_POLL,
+    OPTION_COUNT
+} TuningOption;
+
+static const char* const OPTION_NAMES[OPTION_COUNT] = {
+    "nodelay", "fastopen", "defer_accept", "sndbuf", "rcvbuf", "notsent_lowat", "busy_poll"
+};
+
+// 이미 경고한 옵션 (벤치마크 스레드마다 같은 경고를 반복하지 않는다)
+static unsigned g_warned = 0;
+
+typedef struct {
+    const char* name;
+    SocketTuning values;
+} TuningProfile;
+
+static const TuningProfile PROFILES[] = {
+    { "none", { "", 0, 0, 0, 0, 0, 0, 0 } },
+    { "default", { "", 1, 0, 0, 0, 0, 0, 0 } },
+    // 연결 설정 왕복과 작은 레코드 지연을 줄인다
+    { "latency", { "", 1, 1, 1, 0, 0, 16384, 50 } },
+    // 큰 응답을 위한 고정 버퍼 (대역폭 지연 곱이 큰 경로)
+    { "throughput", { "", 1, 0, 0, 4 * 1024 * 1024, 4 * 1024 * 1024, 0, 0 } },
+};
+
+#define PROFILE_COUNT (sizeof(PROFILES) / sizeof(PROFILES[0]))
+
+const char* socket_tuning_profile_names(void) {
+    return "none, default, latency, throughput";
+}
+
+void socket_tuning_default(SocketTuning* tuning) {
+    *tuning = PROFILES[1].values;
+    snprintf(tuning->name, sizeof(tuning->name), "%s", PROFILES[1].name);
+}
+
+// "4m", "256k", "65536" -> 바이트. 잘못된 값이면 -1
+static long parse_size(const char* text) {
+    char* end = NULL;
+    long value = strtol(text, &end, 10);
+    if (end == text || value < 0) {
+        return -1;
+    }
+    if (*end == 'k' || *end == 'K') {
+        value *= 1024;
+        end++;
+    } else if (*end == 'm' || *end == 'M') {
+        value *= 1024 * 1024;
+        end++;
+    }
+    if (*end != '\0' || value > 1024L * 1024 * 1024) {
+        return -1;
+    }
+    return value;
+}
+
+static int parse_option(const char* token, SocketTuning* tuning) {
+    char key[32];
+    const char* equals = strchr(token, '=');
+    size_t key_len = equals ? (size_t)(equals - token) : strlen(token);
+    int disable = 0;
+
+    if (strncmp(token, "no-", 3) == 0 && !equals) {
+        token += 3;
+        key_len -= 3;
+        disable = 1;
+    }
+    if (key_len >= sizeof(key)) {
+        return -1;
+    }
+    memcpy(key, token, key_len);
+    key[key_len] = '\0';
+
+    long value = 1;
+    if (equals) {
+        value = parse_size(equals + 1);
+        if (value < 0) {
+            return -1;
+        }
+    } else if (disable) {
+        value = 0;
+    }
+
+    if (strcmp(key, "nodelay") == 0) {
+        tuning->nodelay = value != 0;
+    } else if (strcmp(key, "fastopen") == 0 || strcmp(key, "tfo") == 0) {
+        tuning->fastopen = (int)value;
+    } else if (strcmp(key, "defer_accept") == 0) {
+        tuning->defer_accept = (int)value;
+    } else if (strcmp(key, "sndbuf") == 0 && (equals || disable)) {
+        tuning->sndbuf = (int)value;
+    } else if (strcmp(key, "rcvbuf") == 0 && (equals || disable)) {
+        tuning->rcvbuf = (int)value;
+    } else if (strcmp(key, "buffers") == 0 && (equals || disable)) {
+        tuning->sndbuf = tuning->rcvbuf = (int)value;
+    } else if (strcmp(key, "notsent_lowat") == 0 && (equals || disable)) {
+        tuning->notsent_lowat = (int)value;
+    } else if (strcmp(key, "busy_poll") == 0 && (equals || disable)) {
+        tuning->busy_poll = (int)value;
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+int socket_tuning_parse(const char* spec, SocketTuning* tuning) {
+    char copy[256];
+    SocketTuning parsed = PROFILES[0].values;
+
+    if (!spec || !*spec || strlen(spec) >= sizeof(copy)) {
+        fprintf(stderr, "잘못된 소켓 프로파일: %s\n", spec ? spec : "(없음)");
+        return -1;
+    }
+    snprintf(copy, sizeof(copy), "%s", spec);
+    char* saveptr = NULL;
+    for (char* token = strtok_r(copy, ",", &saveptr); token; token = strtok_r(NULL, ",", &saveptr)) {
+        size_t p = 0;
+        while (p < PROFILE_COUNT && strcmp(token, PROFILES[p].name) != 0) {
+            p++;
+        }
+        if (p < PROFILE_COUNT) {
+            parsed = PROFILES[p].values;
+        } else if (parse_option(token, &parsed) != 0) {
+            fprintf(stderr, "알 수 없는 소켓 옵션: %s (프로파일: %s)\n", token, socket_tuning_profile_names());
+            return -1;
+        }
+    }
+
+    *tuning = parsed;
+    snprintf(tuning->name, sizeof(tuning->name), "%s", spec);
+    return 0;
+}
+
+static int warn_option(TuningOption option, int error) {
+    unsigned bit = 1u << option;
+    if (!(__atomic_fetch_or(&g_warned, bit, __ATOMIC_RELAXED) & bit)) {
+        fprintf(stderr, "소켓 옵션 %s 설정 실패: %s\n", OPTION_NAMES[option], strerror(error));
+    }
+    return 1;
+}
+
+static int set_option(int fd, int level, int name, int value, TuningOption option) {
+    if (setsockopt(fd, level, name, &value, sizeof(value)) == 0) {
+        return 0;
+    }
+    return warn_option(option, errno);
+}
+
+int socket_tuning_apply(int fd, const SocketTuning* tuning, SocketRole role) {
+    int failed = 0;
+
+    // 버퍼와 Fast Open 대기열은 listen/connect 전에 정해져야 한다
+    if (tuning->sndbuf > 0) {
+        failed += set_option(fd, SOL_SOCKET, SO_SNDBUF, tuning->sndbuf, OPTION_SNDBUF);
+    }
+    if (tuning->rcvbuf > 0) {
+        failed += set_option(fd, SOL_SOCKET, SO_RCVBUF, tuning->rcvbuf, OPTION_RCVBUF);
+    }
+    if (tuning->nodelay) {
+        failed += set_option(fd, IPPROTO_TCP, TCP_NODELAY, 1, OPTION_NODELAY);
+    }
+    if (tuning->notsent_lowat > 0) {
+        failed += set_option(fd, IPPROTO_TCP, TCP_NOTSENT_LOWAT, tuning->notsent_lowat, OPTION_NOTSENT_LOWAT);
+    }
+    if (tuning->busy_poll > 0) {
+#ifdef SO_BUSY_POLL
+        failed += set_option(fd, SOL_SOCKET, SO_BUSY_POLL, tuning->busy_poll, OPTION_BUSY_POLL);
+#else
+        failed += warn_option(OPTION_BUSY_POLL, ENOPROTOOPT);
+#endif
+    }
+    if (role == SOCKET_ROLE_LISTEN) {
+        if (tuning->fastopen) {
+            int queue = tuning->fastopen > 1 ? tuning->fastopen : SOCKET_TUNING_FASTOPEN_QUEUE;
+            failed += set_option(fd, IPPROTO_TCP, TCP_FASTOPEN, queue, OPTION_FASTOPEN);
+        }
+        if (tuning->defer_accept > 0) {
+            failed += set_option(fd, IPPROTO_TCP, TCP_DEFER_ACCEPT, tuning->defer_accept, OPTION_DEFER_ACCEPT);
+        }
+    } else if (tuning->fastopen) {
+        // connect는 바로 돌아오고 SYN은 첫 write(ClientHello)와 함께 나간다 (쿠키가 없으면 일반 핸드셰이크)
+#ifdef TCP_FASTOPEN_CONNECT
+        failed += set_option(fd, IPPROTO_TCP, TCP_FASTOPEN_CONNECT, 1, OPTION_FASTOPEN);
+#else
+        failed += warn_option(OPTION_FASTOPEN, ENOPROTOOPT);
+#endif
+    }
+    return failed;
+}
+
+void socket_tuning_describe(const SocketTuning* tuning, char* buffer, size_t size) {
+    size_t used = 0;
+    int values[OPTION_COUNT] = {
+        tuning->nodelay, tuning->fastopen, tuning->defer_accept, tuning->sndbuf,
+        tuning->rcvbuf, tuning->notsent_lowat, tuning->busy_poll
+    };
+
+    buffer[0] = '\0';
+    for (int i = 0; i < OPTION_COUNT && used < size; i++) {
+        if (!values[i]) {
+            continue;
+        }
+        int written = values[i] == 1 && (i == OPTION_NODELAY || i == OPTION_FASTOPEN)
+                          ? snprintf(buffer + used, size - used, "%s%s", used ? " " : "", OPTION_NAMES[i])
+                          : snprintf(buffer + used, size - used, "%s%s=%d", used ? " " : "", OPTION_NAMES[i], values[i]);
+        if (written < 0) {
+            break;
+        }
+        used += (size_t)written;
+    }
+    if (!buffer[0]) {
+        snprintf(buffer, size, "커널 기본값");
+    }
+}
+
+int socket_tuning_fastopen_used(int fd) {
+    struct tcp_info info;
+    socklen_t len = sizeof(info);
+    if (getsockopt(fd, IPPROTO_TCP, TCP_INFO, &info, &len) != 0) {
+        return 0;
+    }
+    return (info.tcpi_options & TCPI_OPT_SYN_DATA) != 0;
+}
@@ -0,0 +1,60 @@
+#ifndef SOCKET_TUNING_H
+#define SOCKET_TUNING_H
+
+// TCP 소켓 튜닝 프로파일 (서버 리스닝 소켓, 클라이언트 소켓 공용)
+// - 이름 있는 프로파일에 옵션을 이어 붙여 지정한다: "latency", "none,nodelay", "throughput,sndbuf=8m"
+// - 서버는 리스닝 소켓에만 옵션을 건다. accept한 소켓이 물려받으므로 연결마다 시스템 콜이 늘지 않는다.
+// - 커널이 거부한 옵션(권한, sysctl)은 한 번만 경고하고 나머지 옵션은 그대로 적용한다.
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SOCKET_TUNING_NAME_SIZE 96
+
+typedef enum {
+    SOCKET_ROLE_LISTEN = 0,     // bind 전의 리스닝 소켓 (또는 인계받은 리스닝 소켓)
+    SOCKET_ROLE_CLIENT          // connect 전의 클라이언트 소켓
+} SocketRole;
+
+// 값이 0이면 설정하지 않는다 (커널 기본값)
+typedef struct {
+    char name[SOCKET_TUNING_NAME_SIZE]; // 지정한 문자열 그대로 (배너, 결과 레코드의 socket_profile)
+    int nodelay;                // TCP_NODELAY: 작은 TLS 레코드를 Nagle 알고리즘으로 묶지 않음
+    int fastopen;               // TCP Fast Open (서버: SYN 데이터 대기열 길이, 클라이언트: TCP_FASTOPEN_CONNECT)
+    int defer_accept;           // TCP_DEFER_ACCEPT 초 (서버 전용, ClientHello가 도착해야 accept가 깨어남)
+    int sndbuf;                 // SO_SNDBUF 바이트 (설정하면 커널 자동 조절이 꺼진다)
+    int rcvbuf;                 // SO_RCVBUF 바이트 (리스닝 소켓은 listen 전에 걸어야 창 배율에 반영)
+    int notsent_lowat;          // TCP_NOTSENT_LOWAT 바이트 (보내지 않은 데이터가 이보다 적을 때만 쓰기 가능)
+    int busy_poll;              // SO_BUSY_POLL 마이크로초 (sysctl 값보다 크게 하려면 CAP_NET_ADMIN 필요)
+} SocketTuning;
+
+// 프로파일 이름과 옵션을 쉼표로 이어 파싱한다. 앞에서부터 적용하며 프로파일 이름은 모든 값을 바꾼다.
+// 프로파일: none(아무것도 설정 안 함), default(nodelay), latency, throughput
+// 옵션: nodelay, fastopen[=N], defer_accept[=SEC], sndbuf=SIZE, rcvbuf=SIZE, buffers=SIZE,
+//       notsent_lowat=SIZE, busy_poll=USEC (SIZE는 k/m 접미사 가능, =0이나 no- 접두사는 끔)
+// 성공 시 0, 잘못된 항목이면 stderr에 출력하고 -1
+int socket_tuning_parse(const char* spec, SocketTuning* tuning);
+
+// "default" 프로파일로 채운다
+void socket_tuning_default(SocketTuning* tuning);
+
+// 소켓에 적용한다. 커널이 거부한 옵션 수를 돌려준다 (0이면 모두 적용)
+int socket_tuning_apply(int fd, const SocketTuning* tuning, SocketRole role);
+
+// 적용된 옵션 요약 ("nodelay fastopen=256 sndbuf=4194304", 없으면 "커널 기본값")
+void socket_tuning_describe(const SocketTuning* tuning, char* buffer, size_t size);
+
+// 연결이 Fast Open으로 SYN에 데이터를 실어 보냈고 서버가 받았는지 (핸드셰이크 뒤 호출)
+int socket_tuning_fastopen_used(int fd);
+
+// 사용법 출력용 프로파일 목록
+const char* socket_tuning_profile_names(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,129 @@
+#include "timer_wheel.h"
+
+#define TIMER_WHEEL_MASK (TIMER_WHEEL_SLOTS - 1)
+#define TIMER_WHEEL_SPAN(level) ((uint64_t)1 << (TIMER_WHEEL_BITS * (level)))
+
+void timer_wheel_init(TimerWheel* wheel, uint64_t now_ms, unsigned tick_ms) {
+    wheel->origin_ms = now_ms;
+    wheel->tick_ms = tick_ms > 0 ? tick_ms : 1;
+    wheel->now = 0;
+    wheel->count = 0;
+    for (int level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        for (unsigned slot = 0; slot < TIMER_WHEEL_SLOTS; slot++) {
+            TimerEntry* head = &wheel->slots[level][slot];
+            head->next = head;
+            head->prev = head;
+        }
+    }
+}
+
+static void timer_unlink(TimerEntry* timer) {
+    timer->prev->next = timer->next;
+    timer->next->prev = timer->prev;
+    timer->next = NULL;
+    timer->prev = NULL;
+}
+
+// 만료 틱까지 남은 거리로 단계를 골라 슬롯 끝에 붙인다 (expires >= now)
+static void timer_place(TimerWheel* wheel, TimerEntry* timer) {
+    uint64_t delta = timer->expires - wheel->now;
+    int level = 0;
+
+    while (level < TIMER_WHEEL_LEVELS - 1 && delta >= TIMER_WHEEL_SPAN(level + 1)) {
+        level++;
+    }
+    if (delta >= TIMER_WHEEL_SPAN(TIMER_WHEEL_LEVELS)) {
+        timer->expires = wheel->now + TIMER_WHEEL_SPAN(TIMER_WHEEL_LEVELS) - 1;   // 휠 범위를 넘으면 끝에 둔다
+    }
+
+    unsigned slot = (unsigned)(timer->expires >> (TIMER_WHEEL_BITS * level)) & TIMER_WHEEL_MASK;
+    TimerEntry* head = &wheel->slots[level][slot];
+    timer->next = head;
+    timer->prev = head->prev;
+    head->prev->next = timer;
+    head->prev = timer;
+}
+
+void timer_schedule(TimerWheel* wheel, TimerEntry* timer, uint64_t expires_ms) {
+    if (timer_pending(timer)) {
+        timer_unlink(timer);
+    } else {
+        wheel->count++;
+    }
+
+    // 올림: 만료 시각보다 일찍 불리지 않게 한다. 이미 지난 시각이면 다음 틱에 만료
+    uint64_t expires = expires_ms > wheel->origin_ms
+                           ? (expires_ms - wheel->origin_ms + wheel->tick_ms - 1) / wheel->tick_ms
+                           : 0;
+    timer->expires = expires > wheel->now ? expires : wheel->now + 1;
+    timer_place(wheel, timer);
+}
+
+void timer_cancel(TimerWheel* wheel, TimerEntry* timer) {
+    if (timer_pending(timer)) {
+        timer_unlink(timer);
+        wheel->count--;
+    }
+}
+
+// 위 단계 슬롯을 아래로 내린다 (높은 단계부터 내려야 같은 틱에 내려갈 타이머가 한 바퀴를 놓치지 않는다)
+static void timer_cascade(TimerWheel* wheel) {
+    int top = 0;
+    while (top < TIMER_WHEEL_LEVELS - 1 && (wheel->now & (TIMER_WHEEL_SPAN(top + 1) - 1)) == 0) {
+        top++;
+    }
+
+    for (int level = top; level >= 1; level--) {
+        unsigned slot = (unsigned)(wheel->now >> (TIMER_WHEEL_BITS * level)) & TIMER_WHEEL_MASK;
+        TimerEntry* head = &wheel->slots[level][slot];
+        while (head->next != head) {
+            TimerEntry* timer = head->next;
+            timer_unlink(timer);
+            timer_place(wheel, timer);
+        }
+    }
+}
+
+size_t timer_wheel_advance(TimerWheel* wheel, uint64_t now_ms, TimerCallback callback, void* arg) {
+    uint64_t target = now_ms > wheel->origin_ms ? (now_ms - wheel->origin_ms) / wheel->tick_ms : 0;
+    size_t expired = 0;
+
+    while (wheel->now < target) {
+        if (wheel->count == 0) {
+            wheel->now = target;    // 비어 있으면 틱을 하나씩 돌 필요가 없다
+            break;
+        }
+        wheel->now++;
+        timer_cascade(wheel);
+
+        TimerEntry* head = &wheel->slots[0][wheel->now & TIMER_WHEEL_MASK];
+        while (head->next != head) {
+            TimerEntry* timer = head->next;
+            timer_unlink(timer);
+            wheel->count--;
+            expired++;
+            callback(timer, arg);   // 다시 등록해도 다음 틱 이후 슬롯으로 간다
+        }
+    }
+    return expired;
+}
+
+int timer_wheel_timeout_ms(const TimerWheel* wheel, uint64_t now_ms) {
+    if (wheel->count == 0) {
+        return -1;
+    }
+
+    // 다음 내림(cascade) 틱 전까지는 0단계에서 비어 있지 않은 첫 슬롯까지만 깨어나면 된다
+    uint64_t next = wheel->now + 1;
+    uint64_t boundary = (wheel->now | TIMER_WHEEL_MASK) + 1;
+    while (next < boundary && wheel->slots[0][next & TIMER_WHEEL_MASK].next == &wheel->slots[0][next & TIMER_WHEEL_MASK]) {
+        next++;
+    }
+
+    uint64_t deadline = wheel->origin_ms + next * wheel->tick_ms;
+    if (deadline <= now_ms) {
+        return 0;
+    }
+    uint64_t wait = deadline - now_ms;
+    return wait > 1000000 ? 1000000 : (int)wait;
+}
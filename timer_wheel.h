@@ -0,0 +1,56 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+// 계층형 타이머 휠 (스레드 전용, 잠금 없음)
+// - 타이머는 호출자 구조체에 들어 있는 TimerEntry(이중 연결 리스트 노드)라서 등록/취소에 할당이 없다.
+// - 등록/취소는 O(1): 만료까지 남은 틱 수로 단계(level)를 고르고 그 단계의 슬롯 리스트에 붙인다.
+// - 시간이 흐르면 0단계 슬롯을 하나씩 만료시키고, 0단계가 한 바퀴 돌 때마다 위 단계 슬롯 하나를 아래로 내린다.
+//   따라서 틱당 비용은 만료되거나 내려오는 타이머 수에만 비례하고 전체 타이머 수와는 무관하다.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define TIMER_WHEEL_BITS 6
+#define TIMER_WHEEL_SLOTS (1u << TIMER_WHEEL_BITS)     // 단계별 슬롯 수
+#define TIMER_WHEEL_LEVELS 4                            // 64^4 틱 (100ms 틱이면 약 19일)
+
+typedef struct TimerEntry {
+    struct TimerEntry* next;
+    struct TimerEntry* prev;    // NULL이면 등록되지 않은 타이머
+    uint64_t expires;           // 만료 틱
+} TimerEntry;
+
+typedef struct {
+    uint64_t origin_ms;         // 0번 틱의 시각
+    unsigned tick_ms;
+    uint64_t now;               // 처리한 마지막 틱
+    size_t count;               // 등록된 타이머 수
+    TimerEntry slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];   // 각 슬롯의 원형 리스트 머리
+} TimerWheel;
+
+// 만료 콜백 (콜백 안에서 타이머를 다시 등록하거나, 타이머를 담은 객체를 해제해도 된다)
+typedef void (*TimerCallback)(TimerEntry* timer, void* arg);
+
+void timer_wheel_init(TimerWheel* wheel, uint64_t now_ms, unsigned tick_ms);
+
+static inline void timer_init(TimerEntry* timer) {
+    timer->next = NULL;
+    timer->prev = NULL;
+    timer->expires = 0;
+}
+
+static inline int timer_pending(const TimerEntry* timer) {
+    return timer->prev != NULL;
+}
+
+// expires_ms(단조 시계, 밀리초)에 만료되도록 등록한다 (이미 등록되어 있으면 옮긴다)
+void timer_schedule(TimerWheel* wheel, TimerEntry* timer, uint64_t expires_ms);
+void timer_cancel(TimerWheel* wheel, TimerEntry* timer);
+
+// now_ms까지 시간을 진행하며 만료된 타이머마다 callback을 부른다 (만료된 개수)
+size_t timer_wheel_advance(TimerWheel* wheel, uint64_t now_ms, TimerCallback callback, void* arg);
+
+// 다음 틱까지 남은 밀리초 (등록된 타이머가 없으면 -1, epoll_wait 대기 시간용)
+int timer_wheel_timeout_ms(const TimerWheel* wheel, uint64_t now_ms);
+
+#endif
@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <unistd.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
@@ -8,9 +9,57 @@
 #include <netdb.h>
 #include <openssl/ssl.h>
 #include <openssl/err.h>
+#include <time.h>
+#include <pthread.h>
+#include <signal.h>
+#include "result_output.h"
+#include "tls_trust.h"
+#include "http_response.h"
+#include "socket_tuning.h"
 
 #define BUFFER_SIZE 4096
 #define DEFAULT_PORT 443
+#define BENCH_DEFAULT_COUNT 200
+#define BENCH_MAX_CONCURRENCY 64
+#define BENCH_MAX_LIST 16                       // --ciphers, --groups 항목 수
+#define BENCH_DEFAULT_GROUPS "X25519,P-256,X25519MLKEM768"
+#define BENCH_MAX_SESSIONS 64                   // 보관할 세션 티켓 수 (0-RTT 티켓은 한 번씩만 쓴다)
+
+// 연결 한 건의 측정값
+typedef struct {
+    char ip_address[INET_ADDRSTRLEN];
+    double start;           // 측정 시작 시각 (단조 시계, 초)
+    double dns_time;
+    double connect_time;
+    double tls_time;
+    double ttfb;            // 요청 시작부터 첫 응답 바이트까지
+    double total_time;
+    uint64_t bytes_in;
+    uint64_t bytes_out;
+    long status;            // 응답 상태 코드
+    int resumed;            // 세션 티켓으로 재개했는지
+    int early_data;         // 1: 요청을 0-RTT로 보내 서버가 받음, -1: 거절됨 (핸드셰이크 뒤 다시 보냄), 0: 보내지 않음
+    int reused;             // 앞 요청의 연결을 다시 쓴 요청 (핸드셰이크 없음)
+} ConnectionStats;
+
+// 구조화 결과 출력 (RESULT_FORMAT 환경 변수로 활성화)
+static ResultWriter* g_result_writer = NULL;
+
+// 재연결에 쓸 가장 최근 세션 티켓 (--reconnect)
+static SSL_SESSION* g_session = NULL;
+
+// 서버 인증서 검증 (신뢰 저장소와 검증 결과 캐시는 모든 연결과 벤치마크 스레드가 공유)
+static TlsTrust* g_trust = NULL;
+
+// 모든 연결에 거는 소켓 튜닝 프로파일 (--socket-profile)
+static SocketTuning g_socket;
+
+// 단조 시계 기준 현재 시각 (초)
+static double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
 
 // OpenSSL 초기화 함수
 void init_openssl() {
@@ -67,17 +116,21 @@ int resolve_hostname(const char* hostname, char* ip_address) {
 }
 
 // SSL 연결 설정 함수
-SSL* connect_to_server(SSL_CTX* ctx, const char* hostname, int port) {
+// session이 있으면 재개를 시도하고, early_request가 있으면 그 요청을 핸드셰이크 첫 비행에 early data(0-RTT)로 싣는다
+SSL* connect_to_server(SSL_CTX* ctx, const char* hostname, int port, ConnectionStats* stats,
+                       SSL_SESSION* session, const char* early_request) {
     int sock;
     struct sockaddr_in addr;
     SSL* ssl;
-    char ip_address[INET_ADDRSTRLEN];
+    char* ip_address = stats->ip_address;
+    double phase_start = now_seconds();
     
     // DNS 해결
     if (resolve_hostname(hostname, ip_address) != 0) {
         fprintf(stderr, "호스트명 해결 실패: %s\n", hostname);
         return NULL;
     }
+    stats->dns_time = now_seconds() - phase_start;
     
     printf("DNS 해결: %s -> %s\n", hostname, ip_address);
     
@@ -87,6 +140,7 @@ SSL* connect_to_server(SSL_CTX* ctx, const char* hostname, int port) {
         perror("소켓 생성 실패");
         return NULL;
     }
+    socket_tuning_apply(sock, &g_socket, SOCKET_ROLE_CLIENT);
     
     // 서버 주소 설정
     memset(&addr, 0, sizeof(addr));
@@ -95,11 +149,13 @@ SSL* connect_to_server(SSL_CTX* ctx, const char* hostname, int port) {
     addr.sin_addr.s_addr = inet_addr(ip_address);
     
     // 연결
+    phase_start = now_seconds();
     if (connect(sock, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
         perror("서버 연결 실패");
         close(sock);
         return NULL;
     }
+    stats->connect_time = now_seconds() - phase_start;
     
     // SSL 생성
     ssl = SSL_new(ctx);
@@ -107,14 +163,46 @@ SSL* connect_to_server(SSL_CTX* ctx, const char* hostname, int port) {
     
     // SNI (Server Name Indication) 설정
     SSL_set_tlsext_host_name(ssl, hostname);
+    if (g_trust) {
+        tls_trust_set_host(ssl, hostname);
+    }
+    if (session) {
+        SSL_set_session(ssl, session);
+    }
     
-    // SSL 핸드셰이크
+    // SSL 핸드셰이크 (0-RTT: 세션이 early data를 허용할 때만. 요청은 재전송되어도 안전한 GET이다)
+    phase_start = now_seconds();
+    int early_sent = 0;
+    if (early_request && session && SSL_SESSION_get_max_early_data(session) > 0) {
+        size_t request_len = strlen(early_request);
+        size_t written = 0;
+        early_sent = SSL_write_early_data(ssl, early_request, request_len, &written) == 1 && written == request_len;
+        if (early_sent) {
+            stats->bytes_out += (uint64_t)request_len;
+        }
+    }
     if (SSL_connect(ssl) != 1) {
         ERR_print_errors_fp(stderr);
+        if (SSL_get_verify_result(ssl) != X509_V_OK) {
+            fprintf(stderr, "인증서 검증 실패: %s\n", X509_verify_cert_error_string(SSL_get_verify_result(ssl)));
+        } else if (tls_trust_ocsp_status(g_trust, ssl) == TLS_OCSP_REVOKED ||
+                   tls_trust_ocsp_status(g_trust, ssl) == TLS_OCSP_INVALID) {
+            fprintf(stderr, "OCSP 확인 실패: %s\n", tls_ocsp_status_name(tls_trust_ocsp_status(g_trust, ssl)));
+        }
         SSL_free(ssl);
         close(sock);
         return NULL;
     }
+    stats->tls_time = now_seconds() - phase_start;
+    stats->resumed = SSL_session_reused(ssl);
+    if (early_sent) {
+        if (SSL_get_early_data_status(ssl) == SSL_EARLY_DATA_ACCEPTED) {
+            stats->early_data = 1;
+        } else {
+            stats->early_data = -1;
+            stats->bytes_out = 0;       // 서버가 버린 요청은 다시 보낸다
+        }
+    }
     
     return ssl;
 }
@@ -125,7 +213,20 @@ void print_ssl_info(SSL* ssl, const char* hostname) {
     printf("호스트: %s\n", hostname);
     printf("프로토콜: %s\n", SSL_get_version(ssl));
     printf("암호화 스위트: %s\n", SSL_get_cipher(ssl));
-    printf("인증서 검증: %s\n", SSL_get_verify_result(ssl) == X509_V_OK ? "성공" : "실패");
+    long verify_result = SSL_get_verify_result(ssl);
+    if (verify_result == X509_V_OK) {
+        printf("인증서 검증: 성공\n");
+    } else {
+        printf("인증서 검증: 실패 (%s)\n", X509_verify_cert_error_string(verify_result));
+    }
+    if (tls_trust_ocsp_status(g_trust, ssl) != TLS_OCSP_NOT_REQUESTED) {
+        printf("OCSP 스테이플링: %s\n", tls_ocsp_status_name(tls_trust_ocsp_status(g_trust, ssl)));
+    }
+    if (g_socket.fastopen) {
+        printf("TCP Fast Open: %s\n", socket_tuning_fastopen_used(SSL_get_fd(ssl))
+                                          ? "SYN에 ClientHello를 실어 보냄 (연결 왕복 생략)"
+                                          : "사용 안 됨 (쿠키 없음 또는 서버 미지원)");
+    }
     
     // 인증서 정보 출력
     X509* cert = SSL_get_peer_certificate(ssl);
@@ -143,119 +244,1110 @@ void print_ssl_info(SSL* ssl, const char* hostname) {
     printf("=====================\n\n");
 }
 
-// HTTP GET 요청 전송 함수
-int send_http_request(SSL* ssl, const char* hostname, const char* path) {
-    char request[BUFFER_SIZE];
-    char response[BUFFER_SIZE];
-    int bytes;
+// 연결 결과를 구조화 레코드로 출력
+static void emit_connection_result(SSL* ssl, const char* hostname, int port, const char* path,
+                                   const ConnectionStats* stats, long status, int success) {
+    if (!result_writer_structured(g_result_writer)) {
+        return;
+    }
     
-    // HTTP GET 요청 생성
-    snprintf(request, sizeof(request),
+    TestResult record;
+    result_init(&record, "tls_client_test",
+                stats->early_data > 0 ? "0rtt" : stats->resumed ? "resumed" : stats->reused ? "reused" : "request");
+    record.target = path;
+    record.host = hostname;
+    record.port = port;
+    record.method = "GET";
+    record.ip_version = "IPv4";
+    record.resolved_ip = stats->ip_address[0] ? stats->ip_address : NULL;
+    record.protocol = "HTTP/1.1";
+    if (ssl) {
+        record.tls_version = SSL_get_version(ssl);
+        record.cipher = SSL_get_cipher(ssl);
+    }
+    record.socket_profile = g_socket.name;
+    record.status = status;
+    record.success = success;
+    record.bytes_in = stats->bytes_in;
+    record.bytes_out = stats->bytes_out;
+    record.dns_time = stats->dns_time;
+    record.connect_time = stats->connect_time;
+    record.tls_time = stats->tls_time;
+    record.ttfb = stats->ttfb;
+    record.total_time = stats->total_time;
+    if (!success) {
+        record.error = ssl ? "HTTP 요청 실패" : "TLS 연결 실패";
+    }
+    result_emit(g_result_writer, &record);
+}
+
+// HTTP GET 요청 생성 (keep_alive이면 응답 뒤에도 연결을 유지해 다음 요청을 보낸다)
+static void format_http_request(char* request, size_t size, const char* hostname, const char* path, int keep_alive) {
+    snprintf(request, size,
         "GET %s HTTP/1.1\r\n"
         "Host: %s\r\n"
         "User-Agent: OpenSSL-TLS-Test/1.0\r\n"
-        "Connection: close\r\n"
+        "Connection: %s\r\n"
         "\r\n",
-        path, hostname);
-    
-    printf("=== HTTP 요청 전송 ===\n");
-    printf("요청:\n%s", request);
-    
-    // 요청 전송
-    if (SSL_write(ssl, request, strlen(request)) <= 0) {
+        path, hostname, keep_alive ? "keep-alive" : "close");
+}
+
+// 사람이 읽을 수 있는 본문인지 (Content-Type이 없으면 텍스트로 본다)
+static int content_type_textual(const HttpSlice* type) {
+    static const char* const TEXTUAL[] = { "text/", "application/json", "application/xml", "application/javascript",
+                                           "application/x-www-form-urlencoded", "+json", "+xml" };
+    if (!type) {
+        return 1;
+    }
+    for (size_t i = 0; i < sizeof(TEXTUAL) / sizeof(TEXTUAL[0]); i++) {
+        size_t len = strlen(TEXTUAL[i]);
+        for (size_t at = 0; at + len <= type->len; at++) {
+            if (strncasecmp(type->data + at, TEXTUAL[i], len) == 0) {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+// 응답 출력 싱크: 헤더는 원문 그대로, 본문은 텍스트면 화면에, --output이면 파일에 (바이너리도 그대로) 쓴다
+typedef struct {
+    FILE* output;           // --output 파일 (NULL이면 화면)
+    int print;              // 헤더와 본문을 화면에 출력할지 (같은 연결의 두 번째 응답부터는 요약만)
+    int textual;
+    double first_byte;      // 첫 응답 바이트 시각 (0이면 아직)
+    double body_start;      // 헤더를 다 받은 시각
+} ResponsePrinter;
+
+static void printer_headers(void* ctx, const HttpResponse* response) {
+    ResponsePrinter* printer = (ResponsePrinter*)ctx;
+    printer->body_start = now_seconds();
+    printer->textual = content_type_textual(http_response_header(response, "Content-Type"));
+    if (printer->print) {
+        fwrite(response->head.data, 1, response->head.len, stdout);
+    }
+}
+
+static int printer_body(void* ctx, const char* data, size_t len) {
+    ResponsePrinter* printer = (ResponsePrinter*)ctx;
+    if (printer->output) {
+        return fwrite(data, 1, len, printer->output) == len ? 0 : -1;
+    }
+    if (printer->print && printer->textual) {
+        fwrite(data, 1, len, stdout);
+    }
+    return 0;
+}
+
+// 응답 하나를 끝까지 읽는다 (구분 방식에 따라 Content-Length/chunked의 끝 또는 연결 종료까지).
+// 성공하면 0, 첫 바이트 시각은 printer->first_byte
+static int read_http_response(SSL* ssl, HttpResponse* response, ResponsePrinter* printer, uint64_t* bytes_in) {
+    HttpParseResult result = http_response_process(response);     // 앞 읽기에서 이미 받은 바이트
+    if (result != HTTP_PARSE_MORE || response->end > response->start) {
+        printer->first_byte = now_seconds();
+    }
+    while (result == HTTP_PARSE_MORE) {
+        size_t space;
+        char* buffer = http_response_read_buffer(response, &space);
+        int bytes = SSL_read(ssl, buffer, space > INT32_MAX ? INT32_MAX : (int)space);
+        if (bytes <= 0) {
+            result = http_response_eof(response);
+            break;
+        }
+        if (printer->first_byte == 0.0) {
+            printer->first_byte = now_seconds();
+        }
+        *bytes_in += (uint64_t)bytes;
+        result = http_response_commit(response, (size_t)bytes);
+    }
+    if (result != HTTP_PARSE_DONE) {
         ERR_print_errors_fp(stderr);
+        fprintf(stderr, "응답 수신 실패: %s\n", response->error ? response->error : "알 수 없는 오류");
         return -1;
     }
+    return 0;
+}
+
+// Connection: close 응답 뒤 서버가 닫을 때까지 마저 읽는다.
+// 0.5-RTT 응답 뒤에는 TLS 1.3 세션 티켓이 올 수 있다 (핸드셰이크가 끝난 뒤 발급)
+static void drain_until_close(SSL* ssl) {
+    char buffer[BUFFER_SIZE];
+    while (SSL_read(ssl, buffer, sizeof(buffer)) > 0) {
+    }
+}
+
+// 응답 한 줄 요약: 상태, 본문 크기와 구분 방식, TTFB, 본문 전송 시간과 처리량
+static void print_response_summary(const HttpResponse* response, const ResponsePrinter* printer,
+                                   double request_start, double finished) {
+    double transfer = finished - printer->body_start;
+    printf("응답: %d %.*s, 본문 %llu바이트 (%s), TTFB %.3fms, 본문 전송 %.3fms", response->status,
+           (int)response->reason.len, response->reason.data, (unsigned long long)response->body_bytes,
+           http_body_framing_name(response->framing), (printer->first_byte - request_start) * 1000, transfer * 1000);
+    if (transfer > 0.0 && response->body_bytes > 0) {
+        printf(" (%.2f MB/s)", response->body_bytes / transfer / 1e6);
+    }
+    printf("%s\n", response->keep_alive ? "" : ", 서버가 연결을 닫음");
+}
+
+// HTTP GET 요청 전송 함수
+// requests개의 요청을 한 연결로 차례로 보내고 (마지막만 Connection: close) 응답을 구분 방식대로 끝까지 읽는다.
+// 첫 요청이 early data로 이미 받아들여졌으면 다시 보내지 않는다. 두 번째 응답부터는 요약만 출력한다
+int send_http_request(SSL* ssl, const char* hostname, int port, const char* path, int requests, FILE* output,
+                      ConnectionStats* stats) {
+    char request[BUFFER_SIZE];
+    ResponsePrinter printer;
+    HttpBodySink sink = { printer_headers, printer_body, &printer };
+    HttpResponse* response = (HttpResponse*)malloc(sizeof(HttpResponse));
+    int completed = 0;
+    double ttfb_sum = 0.0, transfer_sum = 0.0;
+    uint64_t body_sum = 0;
+    double reuse_start = 0.0;
+
+    if (!response) {
+        fprintf(stderr, "메모리 할당 실패\n");
+        return -1;
+    }
+    http_response_init(response, sink, 0);
     
-    // 응답 수신
-    printf("\n=== HTTP 응답 수신 ===\n");
-    while ((bytes = SSL_read(ssl, response, sizeof(response) - 1)) > 0) {
-        response[bytes] = '\0';
-        printf("%s", response);
+    for (int i = 0; i < requests; i++) {
+        int last = i == requests - 1;
+        double request_start = i == 0 ? stats->start : now_seconds();
+        format_http_request(request, sizeof(request), hostname, path, !last);
+        memset(&printer, 0, sizeof(printer));
+        printer.output = output;
+        printer.print = i == 0;
+        if (i == 1) {
+            reuse_start = request_start;
+        }
+
+        if (i == 0) {
+            printf("=== HTTP 요청 전송%s ===\n", stats->early_data > 0 ? " (0-RTT early data)" : "");
+            printf("요청:\n%s", request);
+        }
+        
+        // 요청 전송
+        int request_len = (int)strlen(request);
+        if (i > 0 || stats->early_data <= 0) {
+            if (SSL_write(ssl, request, request_len) <= 0) {
+                ERR_print_errors_fp(stderr);
+                break;
+            }
+            stats->bytes_out += (uint64_t)request_len;
+        }
+        
+        // 응답 수신
+        if (i == 0) {
+            printf("\n=== HTTP 응답 수신 ===\n");
+        }
+        if (i > 0) {
+            http_response_reset(response, 0);
+        }
+        uint64_t bytes_in = 0;
+        int received = read_http_response(ssl, response, &printer, &bytes_in);
+        double finished = now_seconds();
+        if (i == 0) {
+            stats->bytes_in += bytes_in;
+        }
+        if (received != 0) {
+            break;
+        }
+        if (i == 0) {
+            stats->ttfb = printer.first_byte - stats->start;
+            stats->total_time = finished - stats->start;
+            stats->status = response->status;
+            printf("\n========================\n");
+            if (!printer.textual && !output && response->body_bytes > 0) {
+                printf("(바이너리 본문 %llu바이트는 출력하지 않음, --output FILE로 저장)\n",
+                       (unsigned long long)response->body_bytes);
+            }
+        } else {
+            // 같은 연결로 보낸 요청은 각각 레코드 하나 (DNS/연결/핸드셰이크 없음)
+            ConnectionStats reused;
+            memset(&reused, 0, sizeof(reused));
+            memcpy(reused.ip_address, stats->ip_address, sizeof(reused.ip_address));
+            reused.dns_time = reused.connect_time = reused.tls_time = -1.0;
+            reused.ttfb = printer.first_byte - request_start;
+            reused.total_time = finished - request_start;
+            reused.bytes_out = (uint64_t)request_len;
+            reused.bytes_in = bytes_in;
+            reused.reused = 1;
+            emit_connection_result(ssl, hostname, port, path, &reused, response->status, 1);
+        }
+        printf("[%d/%d] ", i + 1, requests);
+        print_response_summary(response, &printer, request_start, finished);
+
+        completed++;
+        ttfb_sum += printer.first_byte - request_start;
+        transfer_sum += finished - printer.body_start;
+        body_sum += response->body_bytes;
+        if (!response->keep_alive) {
+            drain_until_close(ssl);
+            if (!last) {
+                printf("서버가 연결을 닫아 %d/%d번째 요청에서 멈춤\n", i + 1, requests);
+                break;
+            }
+        }
     }
     
-    if (bytes < 0) {
-        ERR_print_errors_fp(stderr);
+    if (requests > 1 && completed > 1) {
+        double elapsed = now_seconds() - reuse_start;
+        printf("\n=== 연결 재사용 요약 ===\n");
+        printf("요청: %d/%d (한 연결), 재사용 구간 초당 요청 %.1f\n", completed, requests, (completed - 1) / elapsed);
+        printf("평균 TTFB: %.3fms, 본문 합계 %llu바이트, 평균 처리량 %.2f MB/s\n", ttfb_sum / completed * 1000,
+               (unsigned long long)body_sum, transfer_sum > 0.0 ? body_sum / transfer_sum / 1e6 : 0.0);
+    }
+    free(response);
+    return completed == requests ? 0 : -1;
+}
+
+// 새 세션 티켓을 보관한다 (TLS 1.3 티켓은 핸드셰이크 뒤 응답과 함께 온다)
+static int keep_session(SSL* ssl, SSL_SESSION* session) {
+    (void)ssl;
+    if (g_session) {
+        SSL_SESSION_free(g_session);
+    }
+    g_session = session;
+    return 1;                   // 참조를 넘겨받았다
+}
+
+// 연결 한 번: 핸드셰이크, 요청, 응답 (session이 있으면 재개, early_data가 0이 아니면 첫 요청을 0-RTT로 보낸다.
+// requests가 1보다 크면 같은 연결로 요청을 더 보낸다)
+static int run_connection(SSL_CTX* ctx, const char* hostname, int port, const char* path,
+                          SSL_SESSION* session, int early_data, int requests, FILE* output, ConnectionStats* stats) {
+    char request[BUFFER_SIZE];
+    SSL* ssl;
+    int result = 0;
+    
+    memset(stats, 0, sizeof(*stats));
+    stats->dns_time = stats->connect_time = stats->tls_time = stats->ttfb = -1.0;
+    stats->start = now_seconds();
+    format_http_request(request, sizeof(request), hostname, path, requests > 1);
+    
+    // 서버에 연결
+    ssl = connect_to_server(ctx, hostname, port, stats, session, early_data ? request : NULL);
+    if (!ssl) {
+        stats->total_time = now_seconds() - stats->start;
+        emit_connection_result(NULL, hostname, port, path, stats, 0, 0);
         return -1;
     }
     
-    printf("\n========================\n");
-    return 0;
+    // SSL 정보 출력
+    print_ssl_info(ssl, hostname);
+    if (session) {
+        printf("세션 재개: %s, early data: %s\n\n", stats->resumed ? "성공" : "실패 (전체 핸드셰이크)",
+               stats->early_data > 0 ? "수락" : stats->early_data < 0 ? "거절 (핸드셰이크 뒤 다시 보냄)" : "보내지 않음");
+    }
+    
+    // HTTP 요청 전송
+    if (send_http_request(ssl, hostname, port, path, requests, output, stats) != 0) {
+        result = -1;
+    }
+    if (stats->total_time <= 0.0) {
+        stats->total_time = now_seconds() - stats->start;       // 첫 응답을 다 받지 못함
+    }
+    emit_connection_result(ssl, hostname, port, path, stats, stats->status, result == 0);
+    
+    // 정리
+    SSL_shutdown(ssl);
+    close(SSL_get_fd(ssl));
+    SSL_free(ssl);
+    
+    return result;
 }
 
 // TLS 연결 테스트 함수
-int test_tls_connection(const char* hostname, int port, const char* path) {
+// reconnects가 있으면 첫 연결에서 받은 세션 티켓으로 다시 연결하고 (티켓은 한 번씩만 쓴다),
+// early_data가 0이 아니면 재연결의 요청을 0-RTT로 보내 첫 응답까지 한 왕복을 줄인다
+int test_tls_connection(const char* hostname, int port, const char* path, int reconnects, int early_data,
+                        int requests, FILE* output) {
     SSL_CTX* ctx;
-    SSL* ssl;
-    int result = 0;
+    ConnectionStats stats;
+    int result;
     
     printf("=== TLS 연결 테스트 시작 ===\n");
     printf("호스트: %s:%d\n", hostname, port);
-    printf("경로: %s\n\n", path);
+    printf("경로: %s\n", path);
+    char socket_options[160];
+    socket_tuning_describe(&g_socket, socket_options, sizeof(socket_options));
+    printf("소켓 프로파일: %s (%s)\n\n", g_socket.name, socket_options);
     
     // SSL 컨텍스트 생성
     ctx = create_context();
     if (!ctx) {
         return -1;
     }
-    
-    // 서버에 연결
-    ssl = connect_to_server(ctx, hostname, port);
-    if (!ssl) {
+    if (tls_trust_attach(g_trust, ctx) != 0) {
+        ERR_print_errors_fp(stderr);
         SSL_CTX_free(ctx);
         return -1;
     }
+    if (reconnects > 0) {
+        SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+        SSL_CTX_sess_set_new_cb(ctx, keep_session);
+    }
     
-    // SSL 정보 출력
-    print_ssl_info(ssl, hostname);
+    result = run_connection(ctx, hostname, port, path, NULL, 0, requests, output, &stats);
+    double first_tls = stats.tls_time;
+    double first_ttfb = stats.ttfb;
     
-    // HTTP 요청 전송
-    if (send_http_request(ssl, hostname, path) != 0) {
-        result = -1;
+    int completed = 0, resumed = 0, early_accepted = 0, early_rejected = 0;
+    double tls_sum = 0.0, ttfb_sum = 0.0;
+    for (int i = 0; i < reconnects && result == 0; i++) {
+        SSL_SESSION* session = g_session;
+        g_session = NULL;
+        printf("=== 재연결 %d/%d ===\n", i + 1, reconnects);
+        result = run_connection(ctx, hostname, port, path, session, early_data, requests, output, &stats);
+        if (session) {
+            SSL_SESSION_free(session);
+        }
+        if (result != 0) {
+            break;
+        }
+        completed++;
+        resumed += stats.resumed;
+        early_accepted += stats.early_data > 0;
+        early_rejected += stats.early_data < 0;
+        tls_sum += stats.tls_time;
+        ttfb_sum += stats.ttfb;
     }
     
-    // 정리
-    SSL_shutdown(ssl);
-    SSL_free(ssl);
+    if (completed > 0) {
+        printf("=== 재연결 요약 ===\n");
+        printf("재연결: %d/%d, 세션 재개: %d\n", completed, reconnects, resumed);
+        if (early_data) {
+            printf("0-RTT early data: 수락 %d, 거절 %d, 보내지 않음 %d\n", early_accepted, early_rejected,
+                   completed - early_accepted - early_rejected);
+        }
+        printf("TLS 핸드셰이크: 첫 연결 %.3fms, 재연결 평균 %.3fms\n", first_tls * 1000, tls_sum / completed * 1000);
+        printf("첫 응답 바이트(TTFB): 첫 연결 %.3fms, 재연결 평균 %.3fms\n\n", first_ttfb * 1000,
+               ttfb_sum / completed * 1000);
+    }
+    if (g_session) {
+        SSL_SESSION_free(g_session);
+        g_session = NULL;
+    }
     SSL_CTX_free(ctx);
     
     return result;
 }
 
-int main(int argc, char* argv[]) {
+// ===== 핸드셰이크 벤치마크 (--bench) =====
+// 프로토콜 버전 × 암호화 스위트 × 키 교환 그룹 × 모드(전체/재개/0-RTT) 조합마다 핸드셰이크를 반복하고
+// 초당 핸드셰이크 수와 지연 시간 분포를 출력한다.
+
+typedef enum {
+    BENCH_MODE_FULL = 0,        // 세션 없이 전체 핸드셰이크
+    BENCH_MODE_RESUMED,         // 미리 받은 세션(티켓)으로 재개
+    BENCH_MODE_EARLY_DATA,      // 재개 + 요청을 0-RTT early data로 전송 (TLS 1.3)
+    BENCH_MODE_COUNT
+} BenchMode;
+
+static const char* const BENCH_MODE_NAMES[BENCH_MODE_COUNT] = { "full", "resumed", "0rtt" };
+
+typedef struct {
+    int count;                  // 구성당 핸드셰이크 수
+    int concurrency;            // 동시에 핸드셰이크하는 스레드 수
+    int versions[2];            // TLS1_2_VERSION, TLS1_3_VERSION (0이면 사용 안 함)
+    const char* ciphers[BENCH_MAX_LIST];
+    int cipher_count;           // 0이면 라이브러리 기본값
+    const char* groups[BENCH_MAX_LIST];
+    int group_count;
+    int modes[BENCH_MODE_COUNT];
+    int send_request;           // 핸드셰이크마다 요청을 보내고 첫 응답 바이트까지 측정
+} BenchOptions;
+
+// 핸드셰이크 한 번의 측정값
+typedef struct {
+    double connect_time;
+    double handshake_time;      // SSL_connect (TCP 연결 제외)
+    double ttfb;                // TCP 연결 시작부터 첫 응답 바이트까지 (요청을 보낼 때만)
+    int success;
+    int resumed;
+    int early_data;             // 1: 0-RTT 수락, -1: 거절, 0: 보내지 않음
+    int fastopen;               // ClientHello를 SYN에 실어 보냄 (TCP Fast Open)
+    const char* cipher;         // 협상된 암호화 스위트 (OpenSSL 정적 문자열)
+} BenchSample;
+
+// 재개용 세션 (받은 티켓을 쌓아 두고 스레드가 공유, 가장 최근 티켓부터 쓴다)
+typedef struct {
+    pthread_mutex_t lock;
+    SSL_SESSION* sessions[BENCH_MAX_SESSIONS];
+    int count;
+} BenchSessionStore;
+
+typedef struct {
     const char* hostname;
+    const char* path;
+    struct sockaddr_in addr;
+    SSL_CTX* ctx;
+    BenchMode mode;
+    BenchSessionStore* sessions;
+    BenchSample* samples;
+    int count;
+    pthread_t thread;
+} BenchWorker;
+
+static int bench_new_session(SSL* ssl, SSL_SESSION* session) {
+    BenchSessionStore* store = (BenchSessionStore*)SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl));
+    pthread_mutex_lock(&store->lock);
+    if (store->count == BENCH_MAX_SESSIONS) {
+        SSL_SESSION_free(store->sessions[0]);
+        memmove(store->sessions, store->sessions + 1, sizeof(store->sessions[0]) * (BENCH_MAX_SESSIONS - 1));
+        store->count--;
+    }
+    store->sessions[store->count++] = session;
+    pthread_mutex_unlock(&store->lock);
+    return 1;                   // 참조를 넘겨받았다
+}
+
+// 다음 연결에 쓸 세션. early data를 허용하는 티켓은 서버가 한 번만 받아 주므로(재전송 방지) 꺼내서 쓰고,
+// 그 밖의 티켓은 복사본을 쓴다 (TLS 1.3 클라이언트는 한 번 쓴 세션을 재개 불가로 표시하므로,
+// 요청을 보내지 않아 새 티켓을 받지 못하는 모드에서도 같은 티켓으로 계속 재개할 수 있게)
+static SSL_SESSION* bench_take_session(BenchSessionStore* store) {
+    SSL_SESSION* session = NULL;
+    pthread_mutex_lock(&store->lock);
+    if (store->count > 0) {
+        SSL_SESSION* latest = store->sessions[store->count - 1];
+        if (SSL_SESSION_get_max_early_data(latest) > 0) {
+            session = latest;
+            store->count--;
+        } else {
+            session = SSL_SESSION_dup(latest);
+        }
+    }
+    pthread_mutex_unlock(&store->lock);
+    return session;
+}
+
+static void bench_clear_sessions(BenchSessionStore* store) {
+    for (int i = 0; i < store->count; i++) {
+        SSL_SESSION_free(store->sessions[i]);
+    }
+    store->count = 0;
+}
+
+// 구성 하나의 SSL 컨텍스트 (버전 고정, 암호화 스위트/그룹 지정). 지원하지 않는 설정이면 NULL
+static SSL_CTX* bench_create_context(int version, const char* cipher, const char* group, BenchSessionStore* store) {
+    SSL_CTX* ctx = SSL_CTX_new(TLS_client_method());
+    if (!ctx) {
+        return NULL;
+    }
+    int ok = SSL_CTX_set_min_proto_version(ctx, version) == 1 && SSL_CTX_set_max_proto_version(ctx, version) == 1;
+    if (ok && cipher) {
+        ok = version == TLS1_3_VERSION ? SSL_CTX_set_ciphersuites(ctx, cipher) == 1
+                                       : SSL_CTX_set_cipher_list(ctx, cipher) == 1;
+    }
+    if (ok && group) {
+        ok = SSL_CTX_set1_groups_list(ctx, group) == 1;
+    }
+    if (!ok) {
+        ERR_clear_error();
+        SSL_CTX_free(ctx);
+        return NULL;
+    }
+
+    // 검증을 켰으면 공유 신뢰 저장소와 검증 결과 캐시를 쓴다
+    if (g_trust && tls_trust_attach(g_trust, ctx) != 0) {
+        ERR_clear_error();
+        SSL_CTX_free(ctx);
+        return NULL;
+    }
+
+    // 티켓은 내부 캐시 대신 콜백으로 받아 다음 연결에 넘긴다
+    SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+    SSL_CTX_sess_set_new_cb(ctx, bench_new_session);
+    SSL_CTX_set_app_data(ctx, store);
+    return ctx;
+}
+
+// 응답을 끝까지 읽는다 (첫 바이트 시각 기록, 본문은 세기만 하고 버림). 완전한 응답을 받았으면 0
+static int bench_read_response(SSL* ssl, double start, BenchSample* sample) {
+    HttpBodySink discard = { NULL, NULL, NULL };
+    HttpResponse* response = (HttpResponse*)malloc(sizeof(HttpResponse));
+    HttpParseResult result = HTTP_PARSE_MORE;
+
+    if (!response) {
+        return -1;
+    }
+    http_response_init(response, discard, 0);
+    while (result == HTTP_PARSE_MORE) {
+        size_t space;
+        char* buffer = http_response_read_buffer(response, &space);
+        int bytes = SSL_read(ssl, buffer, (int)space);
+        if (bytes <= 0) {
+            result = http_response_eof(response);
+            break;
+        }
+        if (sample->ttfb < 0.0) {
+            sample->ttfb = now_seconds() - start;
+        }
+        result = http_response_commit(response, (size_t)bytes);
+    }
+    free(response);
+    drain_until_close(ssl);
+    return result == HTTP_PARSE_DONE ? 0 : -1;
+}
+
+// 핸드셰이크 한 번 (모드에 따라 세션 재개, early data, 요청 전송)
+static void bench_handshake(const BenchWorker* worker, BenchSample* sample) {
+    char request[BUFFER_SIZE];
+    int request_len = snprintf(request, sizeof(request),
+                               "GET %s HTTP/1.1\r\nHost: %s\r\nUser-Agent: OpenSSL-TLS-Test/1.0\r\nConnection: close\r\n\r\n",
+                               worker->path ? worker->path : "/", worker->hostname);
+    int send_request = worker->mode == BENCH_MODE_EARLY_DATA || worker->path != NULL;
+
+    memset(sample, 0, sizeof(*sample));
+    sample->ttfb = -1.0;
+
+    double start = now_seconds();
+    int sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (sock < 0) {
+        return;
+    }
+    socket_tuning_apply(sock, &g_socket, SOCKET_ROLE_CLIENT);
+    if (connect(sock, (const struct sockaddr*)&worker->addr, sizeof(worker->addr)) != 0) {
+        close(sock);
+        return;
+    }
+    double connected = now_seconds();
+    sample->connect_time = connected - start;
+
+    SSL* ssl = SSL_new(worker->ctx);
+    SSL_SESSION* session = worker->mode != BENCH_MODE_FULL ? bench_take_session(worker->sessions) : NULL;
+    SSL_set_fd(ssl, sock);
+    SSL_set_tlsext_host_name(ssl, worker->hostname);
+    if (g_trust) {
+        tls_trust_set_host(ssl, worker->hostname);
+    }
+    if (session) {
+        SSL_set_session(ssl, session);
+    }
+
+    // 한 번만 쓸 수 있는 티켓(early data 허용)으로 재개하거나 남은 티켓이 없으면 요청 없는 재개도 요청을 보낸다.
+    // TLS 1.3 티켓은 핸드셰이크 뒤에 오고, 서버가 응답 뒤 정상 종료해야 마지막으로 발급한 티켓이 서버 캐시에 남는다
+    // (요청 없이 끊으면 서버가 그 세션을 캐시에서 지워 다음 연결이 재개하지 못한다)
+    if (worker->mode == BENCH_MODE_RESUMED && (!session || SSL_SESSION_get_max_early_data(session) > 0)) {
+        send_request = 1;
+    }
+
+    // 0-RTT: 세션이 early data를 허용하면 요청을 핸드셰이크 첫 비행에 싣는다
+    int early_sent = 0;
+    if (worker->mode == BENCH_MODE_EARLY_DATA && session && SSL_SESSION_get_max_early_data(session) > 0) {
+        size_t written = 0;
+        early_sent = SSL_write_early_data(ssl, request, (size_t)request_len, &written) == 1 &&
+                     written == (size_t)request_len;
+    }
+
+    if (SSL_connect(ssl) == 1) {
+        sample->handshake_time = now_seconds() - connected;
+        sample->resumed = SSL_session_reused(ssl);
+        sample->cipher = SSL_get_cipher(ssl);
+        sample->fastopen = g_socket.fastopen && socket_tuning_fastopen_used(sock);
+        sample->success = 1;
+        if (early_sent) {
+            sample->early_data = SSL_get_early_data_status(ssl) == SSL_EARLY_DATA_ACCEPTED ? 1 : -1;
+        }
+        // early data가 거절되었으면 요청을 다시 보낸다
+        if (send_request && sample->early_data != 1 && SSL_write(ssl, request, request_len) != request_len) {
+            sample->success = 0;
+        }
+        if (send_request && sample->success && bench_read_response(ssl, start, sample) != 0) {
+            sample->success = 0;
+        }
+        SSL_shutdown(ssl);
+    }
+    ERR_clear_error();
+    if (session) {
+        SSL_SESSION_free(session);
+    }
+    SSL_free(ssl);
+    close(sock);
+}
+
+static void* bench_worker_main(void* arg) {
+    BenchWorker* worker = (BenchWorker*)arg;
+    for (int i = 0; i < worker->count; i++) {
+        bench_handshake(worker, &worker->samples[i]);
+    }
+    return NULL;
+}
+
+static int compare_double(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static double percentile_ms(const double* sorted, int count, int percent) {
+    int index = count * percent / 100;
+    if (index >= count) {
+        index = count - 1;
+    }
+    return sorted[index] * 1000;
+}
+
+// TLS 1.2로는 협상할 수 없는 그룹 (하이브리드 PQ 키 교환은 TLS 1.3 전용)
+static int bench_group_tls13_only(const char* group) {
+    return strstr(group, "MLKEM") != NULL || strstr(group, "Kyber") != NULL || strstr(group, "kyber") != NULL;
+}
+
+// 암호화 스위트 이름이 TLS 1.3용인지 (TLS_AES_128_GCM_SHA256 등)
+static int bench_cipher_tls13(const char* cipher) {
+    return strncmp(cipher, "TLS_", 4) == 0;
+}
+
+// 구성 하나를 실행하고 결과 한 줄을 출력한다
+static void bench_run_config(const BenchOptions* options, const char* hostname, int port, const char* path,
+                             const struct sockaddr_in* addr, int version, const char* cipher, const char* group,
+                             BenchMode mode) {
+    const char* version_name = version == TLS1_3_VERSION ? "TLSv1.3" : "TLSv1.2";
+    BenchSessionStore store;
+    char label[160];
+
+    snprintf(label, sizeof(label), "%s %s %s %s", version_name, cipher ? cipher : "기본", group,
+             BENCH_MODE_NAMES[mode]);
+    memset(&store, 0, sizeof(store));
+    pthread_mutex_init(&store.lock, NULL);
+
+    SSL_CTX* ctx = bench_create_context(version, cipher, group, &store);
+    if (!ctx) {
+        printf("%-58s 지원하지 않는 구성 (이 OpenSSL 빌드)\n", label);
+        pthread_mutex_destroy(&store.lock);
+        return;
+    }
+
+    BenchWorker workers[BENCH_MAX_CONCURRENCY];
+    BenchSample* samples = (BenchSample*)calloc((size_t)options->count, sizeof(BenchSample));
+    double* latencies = (double*)malloc(sizeof(double) * (size_t)options->count);
+    double* ttfbs = (double*)malloc(sizeof(double) * (size_t)options->count);
+    if (!samples || !latencies || !ttfbs) {
+        fprintf(stderr, "메모리 할당 실패\n");
+        free(samples);
+        free(latencies);
+        free(ttfbs);
+        SSL_CTX_free(ctx);
+        pthread_mutex_destroy(&store.lock);
+        return;
+    }
+
+    // 재개 모드는 먼저 전체 핸드셰이크와 요청 하나로 티켓을 받아 둔다 (TLS 1.3 티켓은 핸드셰이크 뒤에 온다)
+    BenchWorker prime;
+    memset(&prime, 0, sizeof(prime));
+    prime.hostname = hostname;
+    prime.path = path ? path : "/";
+    prime.addr = *addr;
+    prime.ctx = ctx;
+    prime.mode = BENCH_MODE_FULL;
+    prime.sessions = &store;
+    int runnable = mode == BENCH_MODE_FULL;
+    if (mode != BENCH_MODE_FULL) {
+        BenchSample primed;
+        bench_handshake(&prime, &primed);
+        runnable = store.count > 0;
+        if (!runnable) {
+            printf("%-58s 세션을 받지 못해 건너뜀 (서버가 재개를 지원하지 않음)\n", label);
+        }
+    }
+
+    double elapsed = 0.0;
+    int completed = 0, failed = 0, resumed = 0, early_accepted = 0, early_rejected = 0, ttfb_count = 0, fastopen = 0;
+    int latency_count = 0, not_resumed = 0;
+    const char* negotiated_cipher = NULL;
+    if (runnable) {
+        int threads = options->concurrency < options->count ? options->concurrency : options->count;
+        int launched = 0;
+        double started = now_seconds();
+        for (int i = 0; i < threads; i++) {
+            int first = options->count * i / threads;
+            workers[i] = prime;
+            workers[i].path = path;
+            workers[i].mode = mode;
+            workers[i].samples = samples + first;
+            workers[i].count = options->count * (i + 1) / threads - first;
+            if (pthread_create(&workers[i].thread, NULL, bench_worker_main, &workers[i]) != 0) {
+                perror("스레드 생성 실패");
+                break;
+            }
+            launched++;
+        }
+        for (int i = 0; i < launched; i++) {
+            pthread_join(workers[i].thread, NULL);
+        }
+        elapsed = now_seconds() - started;
+
+        int total = launched > 0 ? options->count * launched / threads : 0;
+        for (int i = 0; i < total; i++) {
+            const BenchSample* sample = &samples[i];
+            if (!sample->success) {
+                failed++;
+                continue;
+            }
+            completed++;
+            // 재개 모드에서 재개되지 않은 핸드셰이크는 전체 핸드셰이크이므로 지연 분포에 넣지 않는다
+            if (mode != BENCH_MODE_FULL && !sample->resumed) {
+                not_resumed++;
+            } else {
+                latencies[latency_count++] = sample->handshake_time;
+            }
+            negotiated_cipher = sample->cipher;
+            resumed += sample->resumed;
+            fastopen += sample->fastopen;
+            early_accepted += sample->early_data > 0;
+            early_rejected += sample->early_data < 0;
+            if (sample->ttfb >= 0.0) {
+                ttfbs[ttfb_count++] = sample->ttfb;
+            }
+        }
+        failed += options->count - total;
+    }
+
+    // 스위트를 지정하지 않았으면 실제 협상된 스위트를 보여 준다
+    if (!cipher && negotiated_cipher) {
+        snprintf(label, sizeof(label), "%s %s %s %s", version_name, negotiated_cipher, group, BENCH_MODE_NAMES[mode]);
+    }
+
+    if (runnable) {
+        qsort(latencies, (size_t)latency_count, sizeof(double), compare_double);
+        printf("%-58s %5d %4d %5d", label, completed, failed, resumed);
+        if (mode == BENCH_MODE_EARLY_DATA) {
+            printf(" %3d/%-3d", early_accepted, early_accepted + early_rejected);
+        } else {
+            printf(" %7s", "-");
+        }
+        if (latency_count > 0) {
+            printf(" %9.1f %8.3f %8.3f %8.3f %8.3f", completed / elapsed, percentile_ms(latencies, latency_count, 50),
+                   percentile_ms(latencies, latency_count, 90), percentile_ms(latencies, latency_count, 99),
+                   latencies[latency_count - 1] * 1000);
+        }
+        if (not_resumed > 0) {
+            printf("  재개 안 됨 %d (지연 분포에서 제외)", not_resumed);
+        }
+        if (ttfb_count > 0) {
+            qsort(ttfbs, (size_t)ttfb_count, sizeof(double), compare_double);
+            printf("  TTFB p50 %.3f p99 %.3f", percentile_ms(ttfbs, ttfb_count, 50), percentile_ms(ttfbs, ttfb_count, 99));
+        }
+        if (g_socket.fastopen) {
+            printf("  TFO %d/%d", fastopen, completed);
+        }
+        printf("\n");
+        fflush(stdout);
+
+        // 구조화 출력: 핸드셰이크마다 레코드 하나 (분포는 후처리에서 계산)
+        if (result_writer_structured(g_result_writer)) {
+            for (int i = 0; i < options->count; i++) {
+                const BenchSample* sample = &samples[i];
+                TestResult record;
+                result_init(&record, "tls_client_test", "handshake");
+                record.target = label;
+                record.host = hostname;
+                record.port = port;
+                record.ip_version = "IPv4";
+                record.tls_version = version_name;
+                record.cipher = sample->cipher;
+                record.socket_profile = g_socket.name;
+                record.success = sample->success;
+                record.connect_time = sample->connect_time;
+                record.tls_time = sample->success ? sample->handshake_time : -1.0;
+                record.ttfb = sample->ttfb;
+                if (!sample->success) {
+                    record.error = "핸드셰이크 실패";
+                }
+                result_emit(g_result_writer, &record);
+            }
+        }
+    }
+
+    free(samples);
+    free(latencies);
+    free(ttfbs);
+    bench_clear_sessions(&store);
+    SSL_CTX_free(ctx);
+    pthread_mutex_destroy(&store.lock);
+}
+
+// 쉼표로 구분된 목록을 나눈다 (list 문자열을 직접 고친다)
+static int bench_split_list(char* list, const char** items, int max_items) {
+    int count = 0;
+    for (char* token = strtok(list, ","); token && count < max_items; token = strtok(NULL, ",")) {
+        items[count++] = token;
+    }
+    return count;
+}
+
+static int run_handshake_bench(const BenchOptions* options, const char* hostname, int port, const char* path) {
+    struct sockaddr_in addr;
+    char ip_address[INET_ADDRSTRLEN];
+
+    if (resolve_hostname(hostname, ip_address) != 0) {
+        fprintf(stderr, "호스트명 해결 실패: %s\n", hostname);
+        return -1;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = inet_addr(ip_address);
+
+    // 서버가 먼저 닫은 연결에 close_notify를 보내도 SIGPIPE로 죽지 않게 한다
+    signal(SIGPIPE, SIG_IGN);
+
+    printf("=== TLS 핸드셰이크 벤치마크 ===\n");
+    printf("서버: %s:%d (%s)\n", hostname, port, ip_address);
+    printf("구성당 핸드셰이크: %d, 동시 실행: %d%s\n", options->count, options->concurrency,
+           path ? ", 핸드셰이크마다 요청 전송" : "");
+    char socket_options[160];
+    socket_tuning_describe(&g_socket, socket_options, sizeof(socket_options));
+    printf("소켓 프로파일: %s (%s)\n\n", g_socket.name, socket_options);
+    printf("%-58s %5s %4s %5s %7s %9s %8s %8s %8s %8s\n", "구성 (버전 스위트 그룹 모드)", "성공", "실패", "재개",
+           "0-RTT", "초당", "p50(ms)", "p90", "p99", "최대");
+
+    for (int v = 0; v < 2; v++) {
+        int version = options->versions[v];
+        if (!version) {
+            continue;
+        }
+        // 이 버전에 맞는 스위트만 (지정하지 않았으면 기본값 하나)
+        const char* ciphers[BENCH_MAX_LIST];
+        int cipher_count = 0;
+        for (int c = 0; c < options->cipher_count; c++) {
+            if (bench_cipher_tls13(options->ciphers[c]) == (version == TLS1_3_VERSION)) {
+                ciphers[cipher_count++] = options->ciphers[c];
+            }
+        }
+        if (options->cipher_count > 0 && cipher_count == 0) {
+            continue;
+        }
+        if (cipher_count == 0) {
+            ciphers[cipher_count++] = NULL;
+        }
+
+        for (int c = 0; c < cipher_count; c++) {
+            for (int g = 0; g < options->group_count; g++) {
+                if (version == TLS1_2_VERSION && bench_group_tls13_only(options->groups[g])) {
+                    continue;
+                }
+                for (int m = 0; m < BENCH_MODE_COUNT; m++) {
+                    if (!options->modes[m] || (m == BENCH_MODE_EARLY_DATA && version != TLS1_3_VERSION)) {
+                        continue;
+                    }
+                    bench_run_config(options, hostname, port, path, &addr, version, ciphers[c], options->groups[g],
+                                     (BenchMode)m);
+                }
+            }
+        }
+    }
+    printf("\n재개: 세션 티켓으로 재개된 핸드셰이크 수, 0-RTT: 서버가 받아들인 early data / 보낸 수\n");
+    if (g_trust) {
+        TlsTrustStats trust_stats;
+        tls_trust_stats(g_trust, &trust_stats);
+        printf("인증서 검증: 체인 검증 %llu회 (평균 %.3fms), 검증 캐시 적중 %llu회\n",
+               (unsigned long long)trust_stats.verifications,
+               trust_stats.verifications > 0 ? trust_stats.verify_seconds / trust_stats.verifications * 1000 : 0.0,
+               (unsigned long long)trust_stats.cache_hits);
+    }
+    return 0;
+}
+
+static void print_usage(const char* program) {
+    printf("사용법: %s <hostname> [port] [path] [--reconnect N] [--early-data] [--requests N] [--output FILE]\n", program);
+    printf("        [--verify] [--ca-file PATH] [--ca-path DIR] [--no-verify-cache] [--ocsp] [--socket-profile SPEC]\n");
+    printf("        %s <hostname> [port] [path] --bench [--count N] [--concurrency N] [--tls 1.2|1.3|all]\n", program);
+    printf("        [--ciphers LIST] [--groups LIST] [--modes full,resumed,0rtt] [--request]\n");
+    printf("예시: %s www.google.com 443 /\n", program);
+    printf("예시: %s httpbin.org 443 /get\n", program);
+    printf("예시: %s localhost 8443 / --reconnect 5 --early-data\n", program);
+    printf("예시: %s localhost 8443 / --requests 100\n", program);
+    printf("예시: %s localhost 8443 / --verify --ca-file certs/server.crt --ocsp\n", program);
+    printf("예시: %s localhost 8443 / --bench --groups X25519,P-256 --count 500\n", program);
+    printf("  --reconnect N    첫 연결에서 받은 세션 티켓으로 N번 다시 연결 (세션 재개)\n");
+    printf("  --early-data     재연결의 GET 요청을 TLS 1.3 early data(0-RTT)로 전송\n");
+    printf("  --requests N     연결마다 같은 요청을 keep-alive로 N번 보냄 (기본값 1, 응답 끝은 Content-Length/chunked로 판단)\n");
+    printf("  --output FILE    응답 본문을 화면 대신 파일에 저장 (바이너리 그대로, chunked는 디코딩)\n");
+    printf("  --verify         서버 인증서 검증에 실패하면 연결을 끊음 (기본: 결과만 출력)\n");
+    printf("  --ca-file PATH   신뢰할 CA 인증서 PEM 파일 (기본값: 시스템 신뢰 저장소)\n");
+    printf("  --ca-path DIR    신뢰할 CA 인증서 디렉터리 (c_rehash 형식)\n");
+    printf("  --no-verify-cache 같은 인증서 체인의 검증 결과를 재사용하지 않음\n");
+    printf("  --ocsp           OCSP 스테이플링 요청과 확인 (--verify와 함께면 폐기/잘못된 응답에서 연결을 끊음)\n");
+    printf("  --socket-profile SPEC 소켓 튜닝 프로파일 (%s, 기본값 default).\n", socket_tuning_profile_names());
+    printf("                   옵션을 쉼표로 덧붙임: nodelay, fastopen, sndbuf=SIZE, rcvbuf=SIZE, notsent_lowat=SIZE, busy_poll=USEC\n");
+    printf("  --bench          연결 대신 핸드셰이크 벤치마크 실행 (구성마다 초당 핸드셰이크 수와 지연 시간 분포)\n");
+    printf("  --count N        구성당 핸드셰이크 수 (기본값 %d)\n", BENCH_DEFAULT_COUNT);
+    printf("  --concurrency N  동시에 핸드셰이크하는 스레드 수 (기본값 1)\n");
+    printf("  --tls V          프로토콜 버전 (기본값 all: 1.2와 1.3)\n");
+    printf("  --ciphers LIST   암호화 스위트 목록 (TLS_로 시작하면 1.3, 아니면 1.2용. 기본값은 라이브러리 기본)\n");
+    printf("  --groups LIST    키 교환 그룹 목록 (기본값 %s, 지원하지 않는 그룹은 건너뜀)\n", BENCH_DEFAULT_GROUPS);
+    printf("  --modes LIST     full(전체), resumed(세션 재개), 0rtt(재개 + early data 요청) (기본값 모두)\n");
+    printf("  --request        핸드셰이크마다 요청을 보내고 첫 응답 바이트 시간(TTFB)도 측정\n");
+    printf("벤치마크는 --verify, --ca-file, --ca-path, --ocsp 중 하나를 줄 때만 인증서를 검증한다\n");
+}
+
+int main(int argc, char* argv[]) {
+    const char* hostname = NULL;
     int port = DEFAULT_PORT;
     const char* path = "/";
-    
-    if (argc < 2) {
-        printf("사용법: %s <hostname> [port] [path]\n", argv[0]);
-        printf("예시: %s www.google.com 443 /\n", argv[0]);
-        printf("예시: %s httpbin.org 443 /get\n", argv[0]);
+    int positional = 0;
+    int bench = 0;
+    char* cipher_list = NULL;
+    char group_list[256];
+    char* mode_list = NULL;
+    int reconnects = 0;
+    int early_data = 0;
+    int requests = 1;
+    const char* output_path = NULL;
+    FILE* output = NULL;
+    int trust_requested = 0;
+    TlsTrustConfig trust_config;
+    BenchOptions options;
+
+    memset(&options, 0, sizeof(options));
+    options.count = BENCH_DEFAULT_COUNT;
+    options.concurrency = 1;
+    options.versions[0] = TLS1_2_VERSION;
+    options.versions[1] = TLS1_3_VERSION;
+    snprintf(group_list, sizeof(group_list), "%s", BENCH_DEFAULT_GROUPS);
+    tls_trust_default_config(&trust_config);
+    socket_tuning_default(&g_socket);
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--bench") == 0) {
+            bench = 1;
+        } else if (strcmp(argv[i], "--count") == 0 && i + 1 < argc) {
+            options.count = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--concurrency") == 0 && i + 1 < argc) {
+            options.concurrency = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--tls") == 0 && i + 1 < argc) {
+            i++;
+            options.versions[0] = strcmp(argv[i], "1.3") != 0 ? TLS1_2_VERSION : 0;
+            options.versions[1] = strcmp(argv[i], "1.2") != 0 ? TLS1_3_VERSION : 0;
+            if (strcmp(argv[i], "1.2") != 0 && strcmp(argv[i], "1.3") != 0 && strcmp(argv[i], "all") != 0) {
+                fprintf(stderr, "알 수 없는 TLS 버전: %s (1.2, 1.3, all)\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--ciphers") == 0 && i + 1 < argc) {
+            cipher_list = argv[++i];
+        } else if (strcmp(argv[i], "--groups") == 0 && i + 1 < argc) {
+            snprintf(group_list, sizeof(group_list), "%s", argv[++i]);
+        } else if (strcmp(argv[i], "--modes") == 0 && i + 1 < argc) {
+            mode_list = argv[++i];
+        } else if (strcmp(argv[i], "--request") == 0) {
+            options.send_request = 1;
+        } else if (strcmp(argv[i], "--reconnect") == 0 && i + 1 < argc) {
+            reconnects = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--early-data") == 0) {
+            early_data = 1;
+        } else if (strcmp(argv[i], "--requests") == 0 && i + 1 < argc) {
+            requests = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output_path = argv[++i];
+        } else if (strcmp(argv[i], "--verify") == 0) {
+            trust_config.enforce = trust_requested = 1;
+        } else if (strcmp(argv[i], "--ca-file") == 0 && i + 1 < argc) {
+            trust_config.ca_file = argv[++i];
+            trust_requested = 1;
+        } else if (strcmp(argv[i], "--ca-path") == 0 && i + 1 < argc) {
+            trust_config.ca_path = argv[++i];
+            trust_requested = 1;
+        } else if (strcmp(argv[i], "--no-verify-cache") == 0) {
+            trust_config.cache_entries = 0;
+        } else if (strcmp(argv[i], "--ocsp") == 0) {
+            trust_config.ocsp = trust_requested = 1;
+        } else if (strcmp(argv[i], "--socket-profile") == 0 && i + 1 < argc) {
+            if (socket_tuning_parse(argv[++i], &g_socket) != 0) {
+                return 1;
+            }
+        } else if (argv[i][0] == '-' || positional >= 3) {
+            print_usage(argv[0]);
+            return 1;
+        } else if (positional == 0) {
+            hostname = argv[i];
+            positional++;
+        } else if (positional == 1) {
+            port = atoi(argv[i]);
+            positional++;
+        } else {
+            path = argv[i];
+            positional++;
+        }
+    }
+    if (!hostname || reconnects < 0 || requests < 1) {
+        print_usage(argv[0]);
         return 1;
     }
-    
-    hostname = argv[1];
-    
-    if (argc > 2) {
-        port = atoi(argv[2]);
+    if (early_data && reconnects == 0) {
+        reconnects = 1;         // 0-RTT에는 재개할 세션이 필요하다
     }
-    
-    if (argc > 3) {
-        path = argv[3];
+
+    if (bench) {
+        if (options.count < 1 || options.concurrency < 1 || options.concurrency > BENCH_MAX_CONCURRENCY) {
+            fprintf(stderr, "핸드셰이크 수는 1 이상, 동시 실행 수는 1~%d이어야 합니다.\n", BENCH_MAX_CONCURRENCY);
+            return 1;
+        }
+        if (cipher_list) {
+            options.cipher_count = bench_split_list(cipher_list, options.ciphers, BENCH_MAX_LIST);
+        }
+        options.group_count = bench_split_list(group_list, options.groups, BENCH_MAX_LIST);
+        if (mode_list) {
+            const char* modes[BENCH_MAX_LIST];
+            int mode_count = bench_split_list(mode_list, modes, BENCH_MAX_LIST);
+            for (int i = 0; i < mode_count; i++) {
+                int found = 0;
+                for (int m = 0; m < BENCH_MODE_COUNT; m++) {
+                    if (strcmp(modes[i], BENCH_MODE_NAMES[m]) == 0) {
+                        options.modes[m] = found = 1;
+                    }
+                }
+                if (!found) {
+                    fprintf(stderr, "알 수 없는 모드: %s (full, resumed, 0rtt)\n", modes[i]);
+                    return 1;
+                }
+            }
+        } else {
+            for (int m = 0; m < BENCH_MODE_COUNT; m++) {
+                options.modes[m] = 1;
+            }
+        }
+        if (options.group_count == 0) {
+            fprintf(stderr, "키 교환 그룹을 하나 이상 지정해야 합니다.\n");
+            return 1;
+        }
     }
-    
+
+    // 구조화 결과 출력 초기화 (RESULT_FORMAT=jsonl|csv이면 사람용 출력은 stderr로 이동)
+    g_result_writer = result_writer_from_env();
+
     // OpenSSL 초기화
     init_openssl();
-    
-    // TLS 연결 테스트
-    if (test_tls_connection(hostname, port, path) == 0) {
+
+    // 신뢰 저장소는 한 번만 읽는다 (벤치마크는 검증 옵션을 줬을 때만 검증 비용을 포함한다)
+    if (!bench || trust_requested) {
+        g_trust = tls_trust_create(&trust_config);
+        if (!g_trust) {
+            cleanup_openssl();
+            result_writer_close(g_result_writer);
+            return 1;
+        }
+    }
+
+    int status = 0;
+    if (bench) {
+        status = run_handshake_bench(&options, hostname, port, options.send_request ? path : NULL) == 0 ? 0 : 1;
+    } else if (output_path && !(output = fopen(output_path, "wb"))) {
+        perror("출력 파일 열기 실패");
+        status = 1;
+    } else if (test_tls_connection(hostname, port, path, reconnects, early_data, requests, output) == 0) {
+        // TLS 연결 테스트
         printf("✅ TLS 연결 테스트 성공!\n");
     } else {
         printf("❌ TLS 연결 테스트 실패!\n");
     }
-    
+
+    if (output) {
+        fclose(output);
+    }
+
     // OpenSSL 정리
+    tls_trust_free(g_trust);
     cleanup_openssl();
-    
-    return 0;
-} 
\ No newline at end of file
+    result_writer_close(g_result_writer);
+
+    return status;
+}
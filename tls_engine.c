@@ -0,0 +1,170 @@
+#include "tls_engine.h"
+
+#include <limits.h>
+#include <string.h>
+#include <openssl/err.h>
+
+#define TLS_LOOPBACK_MAX_ROUNDS 16
+
+int tls_engine_init(TlsEngine* engine, SSL_CTX* ctx, int server) {
+    memset(engine, 0, sizeof(*engine));
+
+    engine->ssl = SSL_new(ctx);
+    engine->rbio = BIO_new(BIO_s_mem());
+    engine->wbio = BIO_new(BIO_s_mem());
+    if (!engine->ssl || !engine->rbio || !engine->wbio) {
+        BIO_free(engine->rbio);
+        BIO_free(engine->wbio);
+        SSL_free(engine->ssl);
+        memset(engine, 0, sizeof(*engine));
+        return -1;
+    }
+
+    // 입력이 비어 있으면 EOF가 아니라 재시도(WANT_READ)로 보이게 한다
+    BIO_set_mem_eof_return(engine->rbio, -1);
+    SSL_set_bio(engine->ssl, engine->rbio, engine->wbio);
+    // 레코드 읽기/쓰기 버퍼(약 34KB)는 처리할 레코드가 있을 때만 잡는다 (유휴 연결 메모리 절약)
+    SSL_set_mode(engine->ssl, SSL_MODE_RELEASE_BUFFERS);
+    if (server) {
+        SSL_set_accept_state(engine->ssl);
+    } else {
+        SSL_set_connect_state(engine->ssl);
+    }
+    return 0;
+}
+
+void tls_engine_free(TlsEngine* engine) {
+    // BIO는 SSL_set_bio로 SSL이 소유한다
+    SSL_free(engine->ssl);
+    ERR_clear_error();
+    memset(engine, 0, sizeof(*engine));
+}
+
+int tls_engine_feed(TlsEngine* engine, const void* data, size_t length) {
+    while (length > 0) {
+        int chunk = length > INT_MAX ? INT_MAX : (int)length;
+        int written = BIO_write(engine->rbio, data, chunk);
+        if (written <= 0) {
+            return -1;
+        }
+        data = (const char*)data + written;
+        length -= (size_t)written;
+    }
+    return 0;
+}
+
+size_t tls_engine_output_pending(const TlsEngine* engine) {
+    return BIO_ctrl_pending(engine->wbio);
+}
+
+size_t tls_engine_drain(TlsEngine* engine, void* buffer, size_t size) {
+    int chunk = size > INT_MAX ? INT_MAX : (int)size;
+    int bytes = chunk > 0 ? BIO_read(engine->wbio, buffer, chunk) : 0;
+    return bytes > 0 ? (size_t)bytes : 0;
+}
+
+// SSL 호출 결과를 엔진 상태로 바꾼다 (오류 큐는 스레드별이므로 여기서 비운다)
+static TlsEngineStatus engine_status(TlsEngine* engine, int ret) {
+    TlsEngineStatus status;
+
+    switch (SSL_get_error(engine->ssl, ret)) {
+        case SSL_ERROR_NONE:
+            status = TLS_ENGINE_OK;
+            break;
+        case SSL_ERROR_WANT_READ:
+        case SSL_ERROR_WANT_WRITE:
+            status = TLS_ENGINE_WANT_INPUT;
+            break;
+        case SSL_ERROR_ZERO_RETURN:
+            status = TLS_ENGINE_CLOSED;
+            break;
+        default:
+            engine->error_code = ERR_peek_error();
+            status = TLS_ENGINE_ERROR;
+            break;
+    }
+    ERR_clear_error();
+    return status;
+}
+
+TlsEngineStatus tls_engine_handshake(TlsEngine* engine) {
+    int ret = SSL_do_handshake(engine->ssl);
+    return ret == 1 ? TLS_ENGINE_OK : engine_status(engine, ret);
+}
+
+TlsEngineStatus tls_engine_read(TlsEngine* engine, void* buffer, size_t size, size_t* bytes) {
+    *bytes = 0;
+    if (size == 0) {
+        return TLS_ENGINE_OK;
+    }
+
+    int chunk = size > INT_MAX ? INT_MAX : (int)size;
+    int ret = SSL_read(engine->ssl, buffer, chunk);
+    if (ret > 0) {
+        *bytes = (size_t)ret;
+        return TLS_ENGINE_OK;
+    }
+    return engine_status(engine, ret);
+}
+
+TlsEngineStatus tls_engine_write(TlsEngine* engine, const void* data, size_t length) {
+    // 출력 BIO가 막히지 않으므로 SSL_write는 핸드셰이크가 끝났다면 전체를 한 번에 쓴다
+    while (length > 0) {
+        int chunk = length > INT_MAX ? INT_MAX : (int)length;
+        int ret = SSL_write(engine->ssl, data, chunk);
+        if (ret <= 0) {
+            return engine_status(engine, ret);
+        }
+        data = (const char*)data + ret;
+        length -= (size_t)ret;
+    }
+    return TLS_ENGINE_OK;
+}
+
+TlsEngineStatus tls_engine_write_early(TlsEngine* engine, const void* data, size_t length) {
+    while (length > 0) {
+        size_t written = 0;
+        if (SSL_write_early_data(engine->ssl, data, length, &written) != 1) {
+            return engine_status(engine, 0);
+        }
+        data = (const char*)data + written;
+        length -= written;
+    }
+    return TLS_ENGINE_OK;
+}
+
+void tls_engine_shutdown(TlsEngine* engine) {
+    SSL_shutdown(engine->ssl);
+    ERR_clear_error();
+}
+
+size_t tls_engine_transfer(TlsEngine* from, TlsEngine* to) {
+    char buffer[16384];
+    size_t total = 0;
+
+    for (;;) {
+        size_t bytes = tls_engine_drain(from, buffer, sizeof(buffer));
+        if (bytes == 0 || tls_engine_feed(to, buffer, bytes) != 0) {
+            return total;
+        }
+        total += bytes;
+    }
+}
+
+int tls_engine_loopback_handshake(TlsEngine* client, TlsEngine* server) {
+    for (int round = 0; round < TLS_LOOPBACK_MAX_ROUNDS; round++) {
+        TlsEngineStatus client_status = tls_engine_handshake(client);
+        tls_engine_transfer(client, server);
+        TlsEngineStatus server_status = tls_engine_handshake(server);
+        tls_engine_transfer(server, client);
+
+        if (client_status == TLS_ENGINE_ERROR || server_status == TLS_ENGINE_ERROR) {
+            return -1;
+        }
+        if (client_status == TLS_ENGINE_OK && server_status == TLS_ENGINE_OK) {
+            // TLS 1.3 세션 티켓처럼 핸드셰이크 뒤에 온 레코드는 다음 read에서 처리된다
+            return 0;
+        }
+    }
+    return -1;
+}
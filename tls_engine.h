@@ -0,0 +1,69 @@
+#ifndef TLS_ENGINE_H
+#define TLS_ENGINE_H
+
+// 소켓과 분리된 TLS 연결 엔진
+// - SSL 객체를 소켓 대신 읽기/쓰기 메모리 BIO 두 개에 연결한다.
+// - 호출자는 받은 암호문을 feed로 넣고, 보낼 암호문을 drain으로 꺼내 원하는 방식(epoll, io_uring,
+//   같은 프로세스 안의 루프백)으로 전달한다. 평문은 read/write로 주고받는다.
+// - 메모리 BIO는 쓰기가 막히지 않으므로 handshake/read/write가 기다리는 것은 항상 입력(암호문)뿐이다.
+// - 엔진 하나는 한 번에 한 스레드만 사용한다 (스레드 간 이동은 호출자가 소유권을 넘겨 처리).
+
+#include <stddef.h>
+#include <openssl/ssl.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    TLS_ENGINE_OK = 0,          // 요청한 작업을 마쳤다
+    TLS_ENGINE_WANT_INPUT,      // 암호문이 더 필요하다 (feed 후 다시 호출)
+    TLS_ENGINE_CLOSED,          // 상대가 close_notify를 보냈다
+    TLS_ENGINE_ERROR            // 프로토콜 오류 (error_code 참고)
+} TlsEngineStatus;
+
+typedef struct {
+    SSL* ssl;
+    BIO* rbio;                  // 받은 암호문 (SSL이 읽는다)
+    BIO* wbio;                  // 보낼 암호문 (SSL이 쓴다)
+    unsigned long error_code;   // 마지막 오류의 ERR_peek_error() 값
+} TlsEngine;
+
+// 엔진 생성 (server가 0이 아니면 accept 상태, 아니면 connect 상태). 성공 시 0
+int tls_engine_init(TlsEngine* engine, SSL_CTX* ctx, int server);
+void tls_engine_free(TlsEngine* engine);
+
+// 받은 암호문을 넣는다. 성공 시 0
+int tls_engine_feed(TlsEngine* engine, const void* data, size_t length);
+
+// 보낼 암호문 크기와 꺼내기 (꺼낸 바이트 수)
+size_t tls_engine_output_pending(const TlsEngine* engine);
+size_t tls_engine_drain(TlsEngine* engine, void* buffer, size_t size);
+
+// 핸드셰이크를 진행할 수 있는 만큼 진행한다
+TlsEngineStatus tls_engine_handshake(TlsEngine* engine);
+
+// 평문 읽기 (읽은 바이트 수는 bytes). 평문이 없으면 TLS_ENGINE_WANT_INPUT
+TlsEngineStatus tls_engine_read(TlsEngine* engine, void* buffer, size_t size, size_t* bytes);
+
+// 평문 전체를 암호화해 출력에 쌓는다 (핸드셰이크 전이면 핸드셰이크부터 진행)
+TlsEngineStatus tls_engine_write(TlsEngine* engine, const void* data, size_t length);
+
+// 핸드셰이크가 끝나기 전에 평문을 암호화해 출력에 쌓는다 (서버가 early data를 받은 뒤 보내는 0.5-RTT 응답).
+// 아직 인증되지 않은 클라이언트에게 가므로 재전송되어도 안전한 요청의 응답만 보낸다
+TlsEngineStatus tls_engine_write_early(TlsEngine* engine, const void* data, size_t length);
+
+// close_notify를 출력에 쌓는다 (상대의 응답은 기다리지 않는다)
+void tls_engine_shutdown(TlsEngine* engine);
+
+// 같은 프로세스 안의 루프백: from의 출력을 to의 입력으로 옮긴다 (옮긴 바이트 수)
+size_t tls_engine_transfer(TlsEngine* from, TlsEngine* to);
+
+// 루프백으로 두 엔진의 핸드셰이크를 끝까지 진행한다 (마이크로벤치마크/테스트용). 성공 시 0
+int tls_engine_loopback_handshake(TlsEngine* client, TlsEngine* server);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
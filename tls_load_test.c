@@ -0,0 +1,976 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <strings.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <openssl/ssl.h>
+#include <openssl/err.h>
+#include <time.h>
+#include <sys/resource.h>
+#include <errno.h>
+#include "socket_tuning.h"
+#include "traffic_capture.h"
+#include "http_response.h"
+
+// TLS 서버 부하 테스트 (keep-alive 연결 여러 개로 작은 요청을 반복)
+// 테스트 전후로 서버의 /metrics를 읽어 요청당 시스템 콜 수를 계산한다.
+// --replay는 서버가 기록한 트래픽 캡처를 원래 간격(또는 배속, 최대 속도)으로 재생한다.
+
+#define BUFFER_SIZE 16384
+#define MAX_CONNECTIONS 1024
+#define SYSCALL_KINDS 6
+#define MEMORY_KINDS 3
+#define MAX_IDLE_CONNECTIONS 100000
+#define REPLAY_QUEUE_SIZE 64            // 연결 스레드별 대기 요청 수 (가득 차면 디스패처가 기다린다)
+#define REPLAY_PAD_MAX 8192             // 요청 크기를 캡처에 맞추려고 붙이는 헤더의 최대 길이
+#define REPLAY_REQUEST_MAX (1024 + REPLAY_PAD_MAX)
+#define REPLAY_HISTOGRAM_SUB_BITS 4
+#define REPLAY_HISTOGRAM_SUB (1 << REPLAY_HISTOGRAM_SUB_BITS)     // 2배 구간마다 나누는 칸 수
+#define REPLAY_HISTOGRAM_BUCKETS (REPLAY_HISTOGRAM_SUB * 40)      // 1µs부터 약 2^40µs까지
+
+static const char* const SYSCALL_NAMES[SYSCALL_KINDS] = {
+    "accept", "read", "write", "wait", "control", "close"
+};
+
+static const char* const MEMORY_NAMES[MEMORY_KINDS] = {
+    "connection_slab", "buffer_pool", "buffers_lent"
+};
+
+typedef struct {
+    const char* host;
+    int port;
+    const char* path;
+    int requests;               // 연결당 요청 수
+    SSL_CTX* ctx;
+    struct sockaddr_in addr;
+    SocketTuning socket;        // 연결마다 거는 소켓 튜닝 프로파일
+} LoadConfig;
+
+// 연결 하나를 맡는 스레드의 결과
+typedef struct {
+    const LoadConfig* config;
+    pthread_t thread;
+    double* latencies;          // 요청별 지연 시간 (초)
+    int completed;
+    int failed;
+    int reconnects;             // 서버가 Connection: close로 닫아 다시 연결한 횟수
+    unsigned long long bytes_in;
+} LoadWorker;
+
+// 재생할 요청 하나 (디스패처가 캡처에서 복사해 연결 스레드 대기열에 넣는다)
+typedef struct {
+    uint64_t due_us;            // 재생 시작 기준 예정 시각 (최대 속도면 대기열에 넣은 시각)
+    uint32_t bytes_in;
+    uint32_t bytes_out;
+    uint16_t request_index;
+    uint8_t method;
+    char path[256];
+} ReplayRequest;
+
+// 지연 히스토그램 (요청 수와 무관한 고정 크기라 수억 건 재생에도 메모리가 늘지 않는다)
+typedef struct {
+    uint64_t counts[REPLAY_HISTOGRAM_BUCKETS];
+    uint64_t total;
+    uint64_t max_us;
+} ReplayHistogram;
+
+// 재생 연결 스레드 (연결 하나씩 차례로 사용)
+typedef struct {
+    const LoadConfig* config;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+    ReplayRequest* queue;
+    size_t head;                // 다음에 꺼낼 위치 (단조 증가)
+    size_t tail;                // 다음에 넣을 위치
+    int done;                   // 디스패처가 캡처를 다 읽었다
+    double started;
+    uint64_t stalls;            // 대기열이 가득 차 디스패처가 기다린 횟수
+    uint64_t completed;
+    uint64_t failed;
+    uint64_t connections;
+    uint64_t reconnects;
+    uint64_t bytes_in;
+    uint64_t bytes_expected;    // 캡처한 응답 크기 합
+    ReplayHistogram latency;
+    ReplayHistogram service;
+} ReplayWorker;
+
+// /metrics 스냅샷
+typedef struct {
+    double requests;
+    double syscalls[SYSCALL_KINDS];
+    double memory[MEMORY_KINDS];    // 워커 메모리 풀 (바이트)
+    double resident;                // 서버 프로세스 상주 메모리 (바이트)
+    char backend[32];
+} ServerSnapshot;
+
+// 단조 시계 기준 현재 시각 (초)
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static SSL* open_connection(const LoadConfig* config) {
+    int sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (sock < 0) {
+        return NULL;
+    }
+    socket_tuning_apply(sock, &config->socket, SOCKET_ROLE_CLIENT);
+    if (connect(sock, (const struct sockaddr*)&config->addr, sizeof(config->addr)) != 0) {
+        close(sock);
+        return NULL;
+    }
+
+    SSL* ssl = SSL_new(config->ctx);
+    SSL_set_fd(ssl, sock);
+    SSL_set_tlsext_host_name(ssl, config->host);
+    if (SSL_connect(ssl) <= 0) {
+        SSL_free(ssl);
+        close(sock);
+        return NULL;
+    }
+    return ssl;
+}
+
+static void close_connection(SSL* ssl) {
+    int sock = SSL_get_fd(ssl);
+    SSL_shutdown(ssl);
+    SSL_free(ssl);
+    close(sock);
+}
+
+// 응답 하나를 끝까지 읽는다 (Content-Length 기준). 본문은 body에 담을 수 있으면 담는다
+// 서버가 응답 뒤 연결을 닫겠다고 하면(Connection: close, 드레인 중인 서버 등) closing을 1로 한다
+static long read_response(SSL* ssl, char* buffer, size_t size, size_t* body_offset, size_t* total, int* closing) {
+    size_t used = 0;
+    size_t header_len = 0;
+    long content_length = -1;
+
+    for (;;) {
+        if (used == size) {
+            return -1;
+        }
+        int bytes = SSL_read(ssl, buffer + used, (int)(size - used));
+        if (bytes <= 0) {
+            return -1;
+        }
+        used += (size_t)bytes;
+
+        if (header_len == 0) {
+            char* end = memmem(buffer, used, "\r\n\r\n", 4);
+            if (!end) {
+                continue;
+            }
+            header_len = (size_t)(end - buffer) + 4;
+            char saved = buffer[header_len - 1];
+            buffer[header_len - 1] = '\0';
+            const char* field = strcasestr(buffer, "\r\nContent-Length:");
+            content_length = field ? atol(field + strlen("\r\nContent-Length:")) : 0;
+            *closing = strcasestr(buffer, "\r\nConnection: close") != NULL;
+            buffer[header_len - 1] = saved;
+        }
+        if (used >= header_len + (size_t)content_length) {
+            *body_offset = header_len;
+            *total = used;
+            return content_length;
+        }
+    }
+}
+
+static void* load_worker_main(void* arg) {
+    LoadWorker* worker = (LoadWorker*)arg;
+    const LoadConfig* config = worker->config;
+    char request[512];
+    char* buffer = (char*)malloc(BUFFER_SIZE);
+
+    int request_len = snprintf(request, sizeof(request),
+                               "GET %s HTTP/1.1\r\nHost: %s\r\nUser-Agent: TLS-Load-Test/1.0\r\n\r\n",
+                               config->path, config->host);
+
+    SSL* ssl = buffer ? open_connection(config) : NULL;
+    if (!ssl) {
+        worker->failed = config->requests;
+        free(buffer);
+        return NULL;
+    }
+
+    int reused = 0;             // 현재 연결로 받은 응답 수
+    for (int i = 0; i < config->requests; i++) {
+        size_t body_offset = 0;
+        size_t total = 0;
+        int closing = 0;
+        double started = now_seconds();
+
+        if (SSL_write(ssl, request, request_len) <= 0 ||
+            read_response(ssl, buffer, BUFFER_SIZE, &body_offset, &total, &closing) < 0) {
+            // 재사용한 keep-alive 연결이 요청과 엇갈려 닫혔으면(서버 드레인, 유휴 타임아웃)
+            // 일반 HTTP 클라이언트처럼 GET을 새 연결로 한 번 다시 보낸다
+            if (reused > 0) {
+                close_connection(ssl);
+                worker->reconnects++;
+                reused = 0;
+                ssl = open_connection(config);
+                if (ssl) {
+                    i--;
+                    continue;
+                }
+            }
+            worker->failed += config->requests - i;
+            break;
+        }
+        worker->latencies[worker->completed++] = now_seconds() - started;
+        worker->bytes_in += total;
+        reused++;
+
+        // 닫히는 연결은 버리고 새로 연결한다 (서버 재시작 중에도 요청이 이어진다)
+        if (closing && i + 1 < config->requests) {
+            close_connection(ssl);
+            worker->reconnects++;
+            reused = 0;
+            ssl = open_connection(config);
+            if (!ssl) {
+                worker->failed += config->requests - i - 1;
+                break;
+            }
+        }
+    }
+
+    if (ssl) {
+        close_connection(ssl);
+    }
+    free(buffer);
+    return NULL;
+}
+
+// /metrics에서 요청 수와 시스템 콜 카운터를 읽는다
+static int fetch_snapshot(const LoadConfig* config, ServerSnapshot* snapshot) {
+    char* buffer = (char*)malloc(65536);
+    char request[256];
+    memset(snapshot, 0, sizeof(*snapshot));
+    snprintf(snapshot->backend, sizeof(snapshot->backend), "?");
+
+    SSL* ssl = buffer ? open_connection(config) : NULL;
+    if (!ssl) {
+        free(buffer);
+        return -1;
+    }
+
+    int request_len = snprintf(request, sizeof(request),
+                               "GET /metrics HTTP/1.1\r\nHost: %s\r\nConnection: close\r\n\r\n", config->host);
+    size_t body_offset = 0;
+    size_t total = 0;
+    int closing = 0;
+    long length = -1;
+    if (SSL_write(ssl, request, request_len) > 0) {
+        length = read_response(ssl, buffer, 65535, &body_offset, &total, &closing);
+    }
+    close_connection(ssl);
+    if (length < 0) {
+        free(buffer);
+        return -1;
+    }
+    buffer[total] = '\0';
+
+    for (char* line = buffer + body_offset; line && *line; ) {
+        char* next = strchr(line, '\n');
+        if (next) {
+            *next++ = '\0';
+        }
+        if (strncmp(line, "tls_server_requests_total ", 26) == 0) {
+            snapshot->requests = atof(line + 26);
+        } else if (strncmp(line, "tls_server_syscalls_total{op=\"", 30) == 0) {
+            for (int i = 0; i < SYSCALL_KINDS; i++) {
+                size_t name_len = strlen(SYSCALL_NAMES[i]);
+                if (strncmp(line + 30, SYSCALL_NAMES[i], name_len) == 0 && line[30 + name_len] == '"') {
+                    snapshot->syscalls[i] = atof(strchr(line + 30, ' ') + 1);
+                }
+            }
+        } else if (strncmp(line, "tls_server_memory_bytes{pool=\"", 30) == 0) {
+            for (int i = 0; i < MEMORY_KINDS; i++) {
+                size_t name_len = strlen(MEMORY_NAMES[i]);
+                if (strncmp(line + 30, MEMORY_NAMES[i], name_len) == 0 && line[30 + name_len] == '"') {
+                    snapshot->memory[i] = atof(strchr(line + 30, ' ') + 1);
+                }
+            }
+        } else if (strncmp(line, "process_resident_memory_bytes ", 30) == 0) {
+            snapshot->resident = atof(line + 30);
+        } else if (strncmp(line, "tls_server_info{", 16) == 0) {
+            const char* backend = strstr(line, "backend=\"");
+            if (backend) {
+                backend += 9;
+                size_t len = strcspn(backend, "\"");
+                if (len >= sizeof(snapshot->backend)) {
+                    len = sizeof(snapshot->backend) - 1;
+                }
+                memcpy(snapshot->backend, backend, len);
+                snapshot->backend[len] = '\0';
+            }
+        }
+        line = next;
+    }
+
+    free(buffer);
+    return 0;
+}
+
+// 유휴 연결 메모리 측정: 연결마다 요청 하나를 처리한 뒤 열어 둔 채로 서버 메모리 증가량을 본다
+static int run_idle_test(const LoadConfig* config, int count) {
+    SSL** connections = (SSL**)calloc((size_t)count, sizeof(SSL*));
+    char* buffer = (char*)malloc(BUFFER_SIZE);
+    char request[512];
+    ServerSnapshot before, after;
+    int opened = 0;
+
+    if (!connections || !buffer) {
+        fprintf(stderr, "메모리 할당 실패\n");
+        free(connections);
+        free(buffer);
+        return 1;
+    }
+
+    // 연결 수만큼 파일 디스크립터가 필요하다
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < (rlim_t)count + 64) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    int request_len = snprintf(request, sizeof(request),
+                               "GET %s HTTP/1.1\r\nHost: %s\r\nUser-Agent: TLS-Load-Test/1.0\r\n\r\n",
+                               config->path, config->host);
+
+    if (fetch_snapshot(config, &before) != 0) {
+        fprintf(stderr, "서버 메트릭을 읽지 못했습니다.\n");
+        free(connections);
+        free(buffer);
+        return 1;
+    }
+
+    for (; opened < count; opened++) {
+        size_t body_offset = 0;
+        size_t total = 0;
+        int closing = 0;
+        SSL* ssl = open_connection(config);
+        if (!ssl) {
+            break;
+        }
+        connections[opened] = ssl;
+        if (SSL_write(ssl, request, request_len) <= 0 ||
+            read_response(ssl, buffer, BUFFER_SIZE, &body_offset, &total, &closing) < 0) {
+            opened++;
+            break;
+        }
+    }
+    usleep(200 * 1000);     // 서버가 마지막 응답의 버퍼를 돌려줄 시간
+
+    int measured = fetch_snapshot(config, &after) == 0;
+
+    printf("=== 유휴 연결 메모리 (백엔드: %s) ===\n", measured ? after.backend : before.backend);
+    printf("열린 연결: %d / %d\n", opened, count);
+    if (measured && opened > 0) {
+        double resident = after.resident - before.resident;
+        printf("서버 상주 메모리 증가: %.1f KB (연결당 %.0f 바이트)\n", resident / 1024, resident / opened);
+        for (int i = 0; i < MEMORY_KINDS; i++) {
+            double delta = after.memory[i] - before.memory[i];
+            printf("%-16s %10.0f 바이트 (연결당 %.0f)\n", MEMORY_NAMES[i], delta, delta / opened);
+        }
+    }
+
+    for (int i = 0; i < opened; i++) {
+        close_connection(connections[i]);
+    }
+    free(connections);
+    free(buffer);
+    return opened == count && measured ? 0 : 1;
+}
+
+// ---------------------------------------------------------------------------
+// 캡처 재생 (--replay): 디스패처(메인 스레드)가 mmap한 캡처를 앞에서부터 읽어 예정 시각에 요청을 연결 스레드에 넘긴다.
+// 캡처의 연결 번호로 스레드를 고르므로 같은 연결의 요청은 같은 스레드가 순서대로 보내고,
+// 캡처에서 새 연결로 시작한 요청은 재생에서도 새 연결(새 핸드셰이크)로 보낸다.
+
+// 히스토그램 칸: 16µs까지는 1µs 단위, 그 위로는 2배 구간마다 16칸
+static int histogram_index(uint64_t us) {
+    if (us < REPLAY_HISTOGRAM_SUB) {
+        return (int)us;
+    }
+    int shift = 63 - __builtin_clzll(us) - REPLAY_HISTOGRAM_SUB_BITS;
+    int index = (shift + 1) * REPLAY_HISTOGRAM_SUB + (int)((us >> shift) - REPLAY_HISTOGRAM_SUB);
+    return index < REPLAY_HISTOGRAM_BUCKETS ? index : REPLAY_HISTOGRAM_BUCKETS - 1;
+}
+
+// 칸의 하한 (칸 폭은 값의 1/16 이하)
+static uint64_t histogram_value(int index) {
+    if (index < REPLAY_HISTOGRAM_SUB) {
+        return (uint64_t)index;
+    }
+    int shift = index / REPLAY_HISTOGRAM_SUB - 1;
+    return (uint64_t)(REPLAY_HISTOGRAM_SUB + index % REPLAY_HISTOGRAM_SUB) << shift;
+}
+
+static void histogram_record(ReplayHistogram* histogram, double seconds) {
+    uint64_t us = seconds > 0 ? (uint64_t)(seconds * 1e6) : 0;
+    histogram->counts[histogram_index(us)]++;
+    histogram->total++;
+    if (us > histogram->max_us) {
+        histogram->max_us = us;
+    }
+}
+
+static void histogram_merge(ReplayHistogram* into, const ReplayHistogram* from) {
+    for (int i = 0; i < REPLAY_HISTOGRAM_BUCKETS; i++) {
+        into->counts[i] += from->counts[i];
+    }
+    into->total += from->total;
+    if (from->max_us > into->max_us) {
+        into->max_us = from->max_us;
+    }
+}
+
+static double histogram_percentile_ms(const ReplayHistogram* histogram, double quantile) {
+    uint64_t rank = (uint64_t)(quantile * (double)histogram->total);
+    uint64_t seen = 0;
+    for (int i = 0; i < REPLAY_HISTOGRAM_BUCKETS; i++) {
+        seen += histogram->counts[i];
+        if (seen > rank) {
+            return histogram_value(i) / 1000.0;
+        }
+    }
+    return histogram->max_us / 1000.0;
+}
+
+static void print_histogram(const char* label, const ReplayHistogram* histogram) {
+    if (histogram->total == 0) {
+        return;
+    }
+    printf("%s p50 %.3f ms, p90 %.3f ms, p99 %.3f ms, p99.9 %.3f ms, 최대 %.3f ms\n", label,
+           histogram_percentile_ms(histogram, 0.5), histogram_percentile_ms(histogram, 0.9),
+           histogram_percentile_ms(histogram, 0.99), histogram_percentile_ms(histogram, 0.999),
+           histogram->max_us / 1000.0);
+}
+
+static void replay_push(ReplayWorker* worker, const ReplayRequest* request) {
+    pthread_mutex_lock(&worker->lock);
+    while (worker->tail - worker->head == REPLAY_QUEUE_SIZE) {
+        worker->stalls++;
+        pthread_cond_wait(&worker->not_full, &worker->lock);
+    }
+    worker->queue[worker->tail++ % REPLAY_QUEUE_SIZE] = *request;
+    pthread_cond_signal(&worker->not_empty);
+    pthread_mutex_unlock(&worker->lock);
+}
+
+// 다음 요청을 꺼낸다. 디스패처가 끝났고 남은 요청이 없으면 -1
+static int replay_pop(ReplayWorker* worker, ReplayRequest* request) {
+    pthread_mutex_lock(&worker->lock);
+    while (worker->head == worker->tail && !worker->done) {
+        pthread_cond_wait(&worker->not_empty, &worker->lock);
+    }
+    if (worker->head == worker->tail) {
+        pthread_mutex_unlock(&worker->lock);
+        return -1;
+    }
+    *request = worker->queue[worker->head++ % REPLAY_QUEUE_SIZE];
+    pthread_cond_signal(&worker->not_full);
+    pthread_mutex_unlock(&worker->lock);
+    return 0;
+}
+
+// 캡처한 메서드/경로로 요청을 만든다. 응답 크기는 X-Replay-Size로 서버에 알리고,
+// 요청 크기는 X-Replay-Pad 헤더로 캡처한 크기에 맞춘다 (REPLAY_PAD_MAX까지)
+static int build_replay_request(const LoadConfig* config, const ReplayRequest* item, char* request, size_t size) {
+    static const char pad_name[] = "X-Replay-Pad: ";
+    int len = snprintf(request, size,
+                       "%s %s HTTP/1.1\r\nHost: %s\r\nUser-Agent: TLS-Load-Test/1.0 (replay)\r\nX-Replay-Size: %u\r\n",
+                       traffic_method_name((TrafficMethod)item->method), item->path[0] ? item->path : "/",
+                       config->host, item->bytes_out);
+    if (len < 0 || (size_t)len + 2 >= size) {
+        return -1;
+    }
+    size_t overhead = (size_t)len + sizeof(pad_name) - 1 + 4;
+    if (item->bytes_in > overhead) {
+        size_t pad = item->bytes_in - overhead;
+        if (pad > REPLAY_PAD_MAX) {
+            pad = REPLAY_PAD_MAX;
+        }
+        memcpy(request + len, pad_name, sizeof(pad_name) - 1);
+        len += (int)sizeof(pad_name) - 1;
+        memset(request + len, 'x', pad);
+        len += (int)pad;
+        memcpy(request + len, "\r\n", 2);
+        len += 2;
+    }
+    memcpy(request + len, "\r\n", 2);
+    return len + 2;
+}
+
+// 응답 하나를 끝까지 읽고 받은 바이트 수를 더한다 (본문은 세기만 하고 버린다). 성공하면 0
+static int read_replay_response(SSL* ssl, HttpResponse* response, uint64_t* bytes_in) {
+    HttpParseResult result = http_response_process(response);
+    while (result == HTTP_PARSE_MORE) {
+        size_t space;
+        char* buffer = http_response_read_buffer(response, &space);
+        int bytes = SSL_read(ssl, buffer, space > INT32_MAX ? INT32_MAX : (int)space);
+        if (bytes <= 0) {
+            result = http_response_eof(response);
+            break;
+        }
+        *bytes_in += (uint64_t)bytes;
+        result = http_response_commit(response, (size_t)bytes);
+    }
+    return result == HTTP_PARSE_DONE ? 0 : -1;
+}
+
+static void* replay_worker_main(void* arg) {
+    ReplayWorker* worker = (ReplayWorker*)arg;
+    const LoadConfig* config = worker->config;
+    HttpResponse* response = (HttpResponse*)malloc(sizeof(HttpResponse));
+    char* request = (char*)malloc(REPLAY_REQUEST_MAX);
+    HttpBodySink discard = { NULL, NULL, NULL };
+    SSL* ssl = NULL;
+    unsigned served = 0;            // 현재 연결로 받은 응답 수
+    ReplayRequest item;
+
+    while (replay_pop(worker, &item) == 0) {
+        int request_len = response && request ? build_replay_request(config, &item, request, REPLAY_REQUEST_MAX) : -1;
+        int head = item.method == TRAFFIC_METHOD_HEAD;
+        int ok = 0;
+
+        // 캡처에서 새 연결로 시작한 요청은 재생에서도 새 연결로 보낸다 (핸드셰이크 비율 재현)
+        if (ssl && item.request_index == 0 && served > 0) {
+            close_connection(ssl);
+            ssl = NULL;
+        }
+        for (int attempt = 0; attempt < 2 && request_len > 0; attempt++) {
+            if (!ssl) {
+                ssl = open_connection(config);
+                if (!ssl) {
+                    break;
+                }
+                worker->connections++;
+                served = 0;
+                http_response_init(response, discard, head);
+            } else {
+                http_response_reset(response, head);
+            }
+
+            double sent = now_seconds();
+            uint64_t received = 0;
+            if (SSL_write(ssl, request, request_len) > 0 && read_replay_response(ssl, response, &received) == 0) {
+                double finished = now_seconds();
+                histogram_record(&worker->latency, finished - (worker->started + item.due_us / 1e6));
+                histogram_record(&worker->service, finished - sent);
+                worker->bytes_in += received;
+                worker->bytes_expected += item.bytes_out;
+                served++;
+                ok = 1;
+                if (!response->keep_alive) {
+                    close_connection(ssl);
+                    ssl = NULL;
+                }
+                break;
+            }
+            // 재사용한 keep-alive 연결이 요청과 엇갈려 닫혔으면 새 연결로 한 번 다시 보낸다
+            close_connection(ssl);
+            ssl = NULL;
+            if (served == 0) {
+                break;
+            }
+            worker->reconnects++;
+        }
+        if (ok) {
+            worker->completed++;
+        } else {
+            worker->failed++;
+        }
+    }
+
+    if (ssl) {
+        close_connection(ssl);
+    }
+    free(request);
+    free(response);
+    return NULL;
+}
+
+static uint32_t replay_hash(uint32_t connection) {
+    connection ^= connection >> 16;
+    connection *= 0x7feb352dU;
+    connection ^= connection >> 15;
+    connection *= 0x846ca68bU;
+    return connection ^ (connection >> 16);
+}
+
+// 단조 시계의 started + offset_us까지 잔다
+static void sleep_until(const struct timespec* started, uint64_t offset_us) {
+    struct timespec due = *started;
+    due.tv_sec += (time_t)(offset_us / 1000000);
+    due.tv_nsec += (long)(offset_us % 1000000) * 1000;
+    if (due.tv_nsec >= 1000000000L) {
+        due.tv_sec++;
+        due.tv_nsec -= 1000000000L;
+    }
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &due, NULL) == EINTR) {
+    }
+}
+
+static int run_replay(const LoadConfig* config, const char* path, int connections, double speed, uint64_t limit) {
+    TrafficCaptureReader reader;
+    if (traffic_capture_open(&reader, path) != 0) {
+        return 1;
+    }
+
+    ReplayWorker* workers = (ReplayWorker*)calloc((size_t)connections, sizeof(ReplayWorker));
+    if (!workers) {
+        fprintf(stderr, "메모리 할당 실패\n");
+        traffic_capture_close(&reader);
+        return 1;
+    }
+
+    time_t captured = (time_t)(reader.started_us / 1000000);
+    char captured_text[32] = "?";
+    struct tm tm_local;
+    if (reader.started_us > 0 && localtime_r(&captured, &tm_local)) {
+        strftime(captured_text, sizeof(captured_text), "%Y-%m-%d %H:%M:%S", &tm_local);
+    }
+    printf("=== TLS 캡처 재생 ===\n");
+    printf("대상: %s:%d\n", config->host, config->port);
+    printf("캡처: %s (%.1f MB, 기록 시작 %s)\n", path, reader.size / 1e6, captured_text);
+    if (speed > 0) {
+        printf("속도: 원래 간격의 %.2g배, 연결 스레드: %d\n\n", speed, connections);
+    } else {
+        printf("속도: 최대 (간격 무시), 연결 스레드: %d\n\n", connections);
+    }
+
+    struct timespec started_ts;
+    clock_gettime(CLOCK_MONOTONIC, &started_ts);
+    double started = started_ts.tv_sec + started_ts.tv_nsec / 1e9;
+    int launched = 0;
+    int prepared = 0;
+    for (int i = 0; i < connections; i++) {
+        ReplayWorker* worker = &workers[i];
+        prepared++;
+        worker->config = config;
+        worker->started = started;
+        worker->queue = (ReplayRequest*)malloc(sizeof(ReplayRequest) * REPLAY_QUEUE_SIZE);
+        pthread_mutex_init(&worker->lock, NULL);
+        pthread_cond_init(&worker->not_empty, NULL);
+        pthread_cond_init(&worker->not_full, NULL);
+        if (!worker->queue || pthread_create(&worker->thread, NULL, replay_worker_main, worker) != 0) {
+            perror("스레드 생성 실패");
+            break;
+        }
+        launched++;
+    }
+
+    uint64_t dispatched = 0;
+    uint64_t skipped = 0;
+    uint64_t captured_connections = 0;
+    uint64_t last_time_us = 0;
+    uint64_t method_counts[TRAFFIC_METHOD_COUNT] = { 0 };
+    TrafficEvent event;
+    int status = 0;
+    while (launched > 0 && (limit == 0 || dispatched < limit) && (status = traffic_capture_next(&reader, &event)) == 1) {
+        // 요청 없이 실패한 핸드셰이크는 재생할 요청이 없다
+        if ((event.flags & TRAFFIC_FLAG_HANDSHAKE_FAILED) || event.status == 0) {
+            skipped++;
+            continue;
+        }
+        ReplayRequest item;
+        // 최대 속도는 예정 시각 대신 대기열에 넣은 시각부터 잰다
+        item.due_us = speed > 0 ? (uint64_t)(event.time_us / speed) : (uint64_t)((now_seconds() - started) * 1e6);
+        item.bytes_in = event.bytes_in;
+        item.bytes_out = event.bytes_out;
+        item.request_index = event.request_index;
+        item.method = event.method;
+        memcpy(item.path, event.path, event.path_len);
+        item.path[event.path_len] = '\0';
+        if (speed > 0) {
+            sleep_until(&started_ts, item.due_us);
+        }
+        replay_push(&workers[replay_hash(event.connection) % (uint32_t)launched], &item);
+
+        dispatched++;
+        captured_connections += event.request_index == 0;
+        method_counts[event.method]++;
+        last_time_us = event.time_us;
+    }
+    if (status < 0) {
+        fprintf(stderr, "캡처 파일이 %zu 바이트 위치에서 깨져 있어 재생을 멈춥니다.\n", reader.offset);
+    }
+
+    for (int i = 0; i < launched; i++) {
+        pthread_mutex_lock(&workers[i].lock);
+        workers[i].done = 1;
+        pthread_cond_signal(&workers[i].not_empty);
+        pthread_mutex_unlock(&workers[i].lock);
+    }
+    for (int i = 0; i < launched; i++) {
+        pthread_join(workers[i].thread, NULL);
+    }
+    double elapsed = now_seconds() - started;
+
+    ReplayHistogram* latency = (ReplayHistogram*)calloc(2, sizeof(ReplayHistogram));
+    uint64_t completed = 0, failed = 0, opened = 0, reconnects = 0, stalls = 0, bytes_in = 0, bytes_expected = 0;
+    for (int i = 0; i < launched; i++) {
+        if (latency) {
+            histogram_merge(&latency[0], &workers[i].latency);
+            histogram_merge(&latency[1], &workers[i].service);
+        }
+        completed += workers[i].completed;
+        failed += workers[i].failed;
+        opened += workers[i].connections;
+        reconnects += workers[i].reconnects;
+        stalls += workers[i].stalls;
+        bytes_in += workers[i].bytes_in;
+        bytes_expected += workers[i].bytes_expected;
+    }
+
+    printf("=== 결과 ===\n");
+    printf("요청: 완료 %llu, 실패 %llu (캡처 %llu건, 핸드셰이크 실패 레코드 %llu건 건너뜀)\n",
+           (unsigned long long)completed, (unsigned long long)failed, (unsigned long long)dispatched,
+           (unsigned long long)skipped);
+    printf("메서드:");
+    for (int m = 1; m < TRAFFIC_METHOD_COUNT; m++) {
+        if (method_counts[m] > 0) {
+            printf(" %s %llu", traffic_method_name((TrafficMethod)m), (unsigned long long)method_counts[m]);
+        }
+    }
+    if (method_counts[TRAFFIC_METHOD_OTHER] > 0) {
+        printf(" 기타(GET으로 재생) %llu", (unsigned long long)method_counts[TRAFFIC_METHOD_OTHER]);
+    }
+    printf("\n");
+    printf("연결: 재생 %llu개 (캡처 %llu개, 엇갈려 닫혀 다시 연결 %llu)\n", (unsigned long long)opened,
+           (unsigned long long)captured_connections, (unsigned long long)reconnects);
+    printf("경과 시간: %.3f초 (캡처 구간 %.3f초), 처리량: %.0f req/s\n", elapsed, last_time_us / 1e6,
+           elapsed > 0 ? completed / elapsed : 0.0);
+    printf("응답 바이트: %.2f MB (캡처 %.2f MB)\n", bytes_in / 1e6, bytes_expected / 1e6);
+    if (latency) {
+        print_histogram(speed > 0 ? "지연 (예정 시각부터):" : "지연 (대기열에 넣은 때부터):", &latency[0]);
+        print_histogram("서비스 시간 (보낸 뒤):", &latency[1]);
+    }
+    if (stalls > 0 && speed > 0) {
+        printf("연결 스레드 대기열이 가득 차 디스패처가 기다린 횟수: %llu (--connections를 늘리면 예정 시각에 더 가깝게 보냄)\n",
+               (unsigned long long)stalls);
+    }
+    if (reader.truncated) {
+        printf("캡처 마지막 레코드가 잘려 있어 건너뛰었습니다 (기록 중인 파일).\n");
+    }
+
+    for (int i = 0; i < prepared; i++) {
+        pthread_mutex_destroy(&workers[i].lock);
+        pthread_cond_destroy(&workers[i].not_empty);
+        pthread_cond_destroy(&workers[i].not_full);
+        free(workers[i].queue);
+    }
+    free(latency);
+    free(workers);
+    traffic_capture_close(&reader);
+    return failed > 0 || status < 0 || launched == 0 ? 1 : 0;
+}
+
+static int compare_double(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static void print_usage(const char* program) {
+    printf("사용법: %s <host> <port> [--connections N] [--requests N] [--path PATH] [--idle N]\n", program);
+    printf("        [--socket-profile SPEC] [--replay FILE [--speed X|max] [--limit N]]\n");
+    printf("  --connections N  동시 keep-alive 연결 수 (기본값 16)\n");
+    printf("  --requests N     연결당 요청 수 (기본값 1000)\n");
+    printf("  --path PATH      요청 경로 (기본값 /)\n");
+    printf("  --idle N         부하 대신 유휴 연결 N개를 열어 두고 연결당 서버 메모리를 측정\n");
+    printf("  --socket-profile SPEC 소켓 튜닝 프로파일 (%s, 기본값 default: nodelay)\n",
+           socket_tuning_profile_names());
+    printf("  --replay FILE    서버 캡처(--access-log-format capture)를 재생 (--connections는 연결 스레드 수)\n");
+    printf("  --speed X|max    재생 속도: 원래 간격의 X배 (기본값 1), max면 간격 없이 최대 속도\n");
+    printf("  --limit N        앞에서부터 요청 N개만 재생\n");
+}
+
+int main(int argc, char* argv[]) {
+    LoadConfig config;
+    int connections = 16;
+    int idle = 0;
+    const char* replay = NULL;
+    double speed = 1.0;
+    unsigned long long limit = 0;
+
+    if (argc < 3) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    // 서버가 먼저 닫은 연결에 쓰면 SIGPIPE 대신 오류로 받아 재연결한다
+    signal(SIGPIPE, SIG_IGN);
+
+    memset(&config, 0, sizeof(config));
+    config.host = argv[1];
+    config.port = atoi(argv[2]);
+    config.path = "/";
+    config.requests = 1000;
+    socket_tuning_default(&config.socket);
+    for (int i = 3; i < argc; i++) {
+        if (strcmp(argv[i], "--connections") == 0 && i + 1 < argc) {
+            connections = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--requests") == 0 && i + 1 < argc) {
+            config.requests = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--path") == 0 && i + 1 < argc) {
+            config.path = argv[++i];
+        } else if (strcmp(argv[i], "--idle") == 0 && i + 1 < argc) {
+            idle = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--socket-profile") == 0 && i + 1 < argc) {
+            if (socket_tuning_parse(argv[++i], &config.socket) != 0) {
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replay = argv[++i];
+        } else if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc) {
+            i++;
+            speed = strcmp(argv[i], "max") == 0 ? 0.0 : atof(argv[i]);
+            if (speed <= 0.0 && strcmp(argv[i], "max") != 0) {
+                fprintf(stderr, "재생 속도는 0보다 크거나 max여야 합니다: %s\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--limit") == 0 && i + 1 < argc) {
+            limit = strtoull(argv[++i], NULL, 10);
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (connections < 1 || connections > MAX_CONNECTIONS || config.requests < 1) {
+        fprintf(stderr, "연결 수는 1~%d, 요청 수는 1 이상이어야 합니다.\n", MAX_CONNECTIONS);
+        return 1;
+    }
+    if (idle < 0 || idle > MAX_IDLE_CONNECTIONS) {
+        fprintf(stderr, "유휴 연결 수는 0~%d이어야 합니다.\n", MAX_IDLE_CONNECTIONS);
+        return 1;
+    }
+
+    // 주소 해석
+    struct addrinfo hints, *result;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    int status = getaddrinfo(config.host, NULL, &hints, &result);
+    if (status != 0) {
+        fprintf(stderr, "DNS 해결 실패: %s\n", gai_strerror(status));
+        return 1;
+    }
+    memcpy(&config.addr, result->ai_addr, sizeof(config.addr));
+    config.addr.sin_port = htons(config.port);
+    freeaddrinfo(result);
+
+    config.ctx = SSL_CTX_new(TLS_client_method());
+    if (!config.ctx) {
+        ERR_print_errors_fp(stderr);
+        return 1;
+    }
+    SSL_CTX_set_verify(config.ctx, SSL_VERIFY_NONE, NULL);   // 테스트 서버는 자체 서명 인증서
+
+    if (idle > 0) {
+        int exit_code = run_idle_test(&config, idle);
+        SSL_CTX_free(config.ctx);
+        return exit_code;
+    }
+    if (replay) {
+        int exit_code = run_replay(&config, replay, connections, speed, limit);
+        SSL_CTX_free(config.ctx);
+        return exit_code;
+    }
+
+    printf("=== TLS 부하 테스트 ===\n");
+    printf("대상: %s:%d%s\n", config.host, config.port, config.path);
+    printf("연결 수: %d, 연결당 요청 수: %d\n", connections, config.requests);
+    char socket_options[160];
+    socket_tuning_describe(&config.socket, socket_options, sizeof(socket_options));
+    printf("소켓 프로파일: %s (%s)\n\n", config.socket.name, socket_options);
+
+    ServerSnapshot before, after;
+    int have_metrics = fetch_snapshot(&config, &before) == 0;
+
+    LoadWorker* workers = (LoadWorker*)calloc((size_t)connections, sizeof(LoadWorker));
+    double* latencies = (double*)malloc(sizeof(double) * (size_t)connections * (size_t)config.requests);
+    if (!workers || !latencies) {
+        fprintf(stderr, "메모리 할당 실패\n");
+        return 1;
+    }
+
+    double started = now_seconds();
+    int launched = 0;
+    for (int i = 0; i < connections; i++) {
+        workers[i].config = &config;
+        workers[i].latencies = latencies + (size_t)i * (size_t)config.requests;
+        if (pthread_create(&workers[i].thread, NULL, load_worker_main, &workers[i]) != 0) {
+            perror("스레드 생성 실패");
+            break;
+        }
+        launched++;
+    }
+    for (int i = 0; i < launched; i++) {
+        pthread_join(workers[i].thread, NULL);
+    }
+    double elapsed = now_seconds() - started;
+
+    // 요청별 지연 시간을 한 배열로 모아 정렬
+    size_t completed = 0;
+    int failed = 0;
+    int reconnects = 0;
+    unsigned long long bytes_in = 0;
+    for (int i = 0; i < launched; i++) {
+        memmove(latencies + completed, workers[i].latencies, sizeof(double) * (size_t)workers[i].completed);
+        completed += (size_t)workers[i].completed;
+        failed += workers[i].failed;
+        reconnects += workers[i].reconnects;
+        bytes_in += workers[i].bytes_in;
+    }
+    qsort(latencies, completed, sizeof(double), compare_double);
+
+    printf("=== 결과 ===\n");
+    printf("완료: %zu, 실패: %d, 경과 시간: %.3f초\n", completed, failed, elapsed);
+    if (reconnects > 0) {
+        printf("재연결: %d (서버가 닫은 keep-alive 연결)\n", reconnects);
+    }
+    printf("처리량: %.0f req/s, %.2f MB/s\n", completed / elapsed, bytes_in / elapsed / 1e6);
+    if (completed > 0) {
+        printf("지연 시간: p50 %.3f ms, p90 %.3f ms, p99 %.3f ms, 최대 %.3f ms\n",
+               latencies[completed / 2] * 1000, latencies[completed * 9 / 10] * 1000,
+               latencies[completed * 99 / 100] * 1000, latencies[completed - 1] * 1000);
+    }
+
+    int have_after = have_metrics && fetch_snapshot(&config, &after) == 0;
+    if (have_after && after.requests < before.requests) {
+        // 테스트 중 서버가 재시작(리스닝 소켓 인계)되어 카운터가 처음부터 다시 셌다
+        printf("\n테스트 중 서버 프로세스가 바뀌어 시스템 콜 수는 생략합니다.\n");
+    } else if (have_after) {
+        // 스냅샷용 /metrics 요청 하나가 포함되어 있다
+        double requests = after.requests - before.requests;
+        double total = 0;
+        printf("\n=== 서버 시스템 콜 (백엔드: %s) ===\n", after.backend);
+        for (int i = 0; i < SYSCALL_KINDS; i++) {
+            double delta = after.syscalls[i] - before.syscalls[i];
+            total += delta;
+            printf("%-8s %10.0f  (요청당 %.3f)\n", SYSCALL_NAMES[i], delta, requests > 0 ? delta / requests : 0.0);
+        }
+        printf("%-8s %10.0f  (요청당 %.3f)\n", "합계", total, requests > 0 ? total / requests : 0.0);
+    } else {
+        printf("\n서버 메트릭을 읽지 못해 시스템 콜 수는 생략합니다.\n");
+    }
+
+    free(latencies);
+    free(workers);
+    SSL_CTX_free(config.ctx);
+    return failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,1669 @@
+#define _GNU_SOURCE
+#include "tls_server_internal.h"
+#include "server_handoff.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <openssl/err.h>
+
+#define SERVER_MAX_EVENTS 64
+#define SERVER_ACCEPT_BATCH 32
+#define SERVER_LISTEN_BACKLOG 1024
+#define SERVER_CONN_SLAB_SIZE 64        // slab 하나에 담는 Connection 수
+#define SERVER_POOL_MAX_FREE 256        // 워커가 보관하는 빈 버퍼 수 (넘치면 해제)
+#define SERVER_TIMER_TICK_MS 100        // 타임아웃 해상도
+#define SERVER_HANDOFF_TIMEOUT_MS 30000 // 새 프로세스가 워커를 띄우고 준비 완료를 알릴 때까지 기다리는 시간
+#define SERVER_REPLAY_MAX_BYTES (8 * 1024 * 1024)  // X-Replay-Size로 요청할 수 있는 최대 응답 크기
+
+double server_now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+uint64_t server_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+}
+
+// 벽시계 기준 현재 시각 (마이크로초, 접근 로그 타임스탬프용)
+static int64_t wall_clock_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+void tls_server_default_config(TlsServerConfig* config, const char* name, int port) {
+    memset(config, 0, sizeof(*config));
+    config->name = name;
+    config->port = port;
+    config->workers = 1;
+    config->handshake_threads = 2;
+    config->backend = SERVER_BACKEND_EPOLL;
+    config->timeouts.handshake = 10.0;
+    config->timeouts.header = 10.0;
+    config->timeouts.idle = 60.0;
+    config->timeouts.write = 30.0;
+    config->timeouts.drain = 30.0;
+    admission_default_config(&config->admission);
+    ocsp_default_config(&config->ocsp);
+    access_log_default_config(&config->access_log);
+    config->access_log.server_name = name;
+    socket_tuning_default(&config->socket);
+}
+
+int tls_server_parse_args(TlsServerConfig* config, int argc, char* argv[]) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            config->workers = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--backend") == 0 && i + 1 < argc) {
+            if (tls_server_parse_backend(argv[++i], &config->backend) != 0) {
+                fprintf(stderr, "알 수 없는 I/O 백엔드: %s (epoll, uring)\n", argv[i]);
+                return -1;
+            }
+        } else if (strcmp(argv[i], "--handshake-threads") == 0 && i + 1 < argc) {
+            config->handshake_threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--handshake-timeout") == 0 && i + 1 < argc) {
+            config->timeouts.handshake = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--header-timeout") == 0 && i + 1 < argc) {
+            config->timeouts.header = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--idle-timeout") == 0 && i + 1 < argc) {
+            config->timeouts.idle = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--write-timeout") == 0 && i + 1 < argc) {
+            config->timeouts.write = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--drain-timeout") == 0 && i + 1 < argc) {
+            config->timeouts.drain = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--max-connections") == 0 && i + 1 < argc) {
+            config->admission.max_connections = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--max-handshakes") == 0 && i + 1 < argc) {
+            config->admission.max_handshakes = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--rate-limit") == 0 && i + 1 < argc) {
+            config->admission.rate = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--rate-burst") == 0 && i + 1 < argc) {
+            config->admission.burst = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--shed-delay") == 0 && i + 1 < argc) {
+            config->admission.shed_delay = atof(argv[++i]) / 1000.0;
+        } else if (strcmp(argv[i], "--reject") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "close") == 0) {
+                config->admission.reject = ADMISSION_REJECT_CLOSE;
+            } else if (strcmp(argv[i], "503") == 0) {
+                config->admission.reject = ADMISSION_REJECT_503;
+            } else {
+                fprintf(stderr, "알 수 없는 거절 방식: %s (close, 503)\n", argv[i]);
+                return -1;
+            }
+        } else if (strcmp(argv[i], "--early-data") == 0 && i + 1 < argc) {
+            config->early_data = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--ocsp-file") == 0 && i + 1 < argc) {
+            config->ocsp.response_file = argv[++i];
+        } else if (strcmp(argv[i], "--ocsp-refresh") == 0 && i + 1 < argc) {
+            config->ocsp.refresh = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--ocsp-command") == 0 && i + 1 < argc) {
+            config->ocsp.command = argv[++i];
+        } else if (strcmp(argv[i], "--upgrade-socket") == 0 && i + 1 < argc) {
+            config->upgrade_socket = argv[++i];
+        } else if (strcmp(argv[i], "--socket-profile") == 0 && i + 1 < argc) {
+            if (socket_tuning_parse(argv[++i], &config->socket) != 0) {
+                return -1;
+            }
+        } else if (strcmp(argv[i], "--access-log") == 0 && i + 1 < argc) {
+            config->access_log.path = argv[++i];
+        } else if (strcmp(argv[i], "--access-log-format") == 0 && i + 1 < argc) {
+            if (access_log_parse_format(argv[++i], &config->access_log.format) != 0) {
+                fprintf(stderr, "알 수 없는 접근 로그 형식: %s (common, tls, json, capture)\n", argv[i]);
+                return -1;
+            }
+        } else if (strcmp(argv[i], "--access-log-sample") == 0 && i + 1 < argc) {
+            config->access_log.sample_rate = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--access-log-max-size") == 0 && i + 1 < argc) {
+            config->access_log.max_bytes = (size_t)atol(argv[++i]) * 1024 * 1024;
+        } else if (strcmp(argv[i], "--access-log-keep") == 0 && i + 1 < argc) {
+            config->access_log.max_files = atoi(argv[++i]);
+        } else if (argv[i][0] != '-') {
+            config->port = atoi(argv[i]);
+        } else {
+            fprintf(stderr, "알 수 없는 옵션: %s\n", argv[i]);
+            return -1;
+        }
+    }
+
+    if (config->port <= 0 || config->port > 65535) {
+        fprintf(stderr, "잘못된 포트: %d\n", config->port);
+        return -1;
+    }
+    // 표준 출력에는 배너와 사용법이 섞이므로 바이너리 캡처는 파일로만 쓴다
+    if (config->access_log.format == ACCESS_LOG_CAPTURE && config->access_log.path &&
+        strcmp(config->access_log.path, "-") == 0) {
+        fprintf(stderr, "capture 형식은 표준 출력으로 쓸 수 없습니다 (--access-log에 파일 경로를 지정하세요)\n");
+        return -1;
+    }
+    if (config->workers < 1 || config->workers > SERVER_MAX_WORKERS) {
+        fprintf(stderr, "워커 수는 1~%d 사이여야 합니다: %d\n", SERVER_MAX_WORKERS, config->workers);
+        return -1;
+    }
+    if (config->handshake_threads < 0 || config->handshake_threads > SERVER_MAX_WORKERS) {
+        fprintf(stderr, "핸드셰이크 스레드 수는 0~%d 사이여야 합니다: %d\n", SERVER_MAX_WORKERS, config->handshake_threads);
+        return -1;
+    }
+    if (config->timeouts.handshake < 0.0 || config->timeouts.header < 0.0 ||
+        config->timeouts.idle < 0.0 || config->timeouts.write < 0.0 || config->timeouts.drain < 0.0) {
+        fprintf(stderr, "타임아웃은 0 이상이어야 합니다 (0이면 사용하지 않음)\n");
+        return -1;
+    }
+    if (config->admission.max_connections < 0 || config->admission.max_handshakes < 0 ||
+        config->admission.rate < 0.0 || config->admission.burst < 0.0 || config->admission.shed_delay < 0.0) {
+        fprintf(stderr, "수락 제한은 0 이상이어야 합니다 (0이면 제한 없음)\n");
+        return -1;
+    }
+    // early data는 핸드셰이크가 끝나기 전에 연결의 요청 버퍼 하나에 모두 쌓는다
+    if (config->early_data < 0 || config->early_data > SERVER_POOL_BUFFER_SIZE - 1) {
+        fprintf(stderr, "early data 크기는 0~%d 바이트 사이여야 합니다: %ld\n", SERVER_POOL_BUFFER_SIZE - 1,
+                config->early_data);
+        return -1;
+    }
+    if (config->ocsp.refresh <= 0.0) {
+        fprintf(stderr, "OCSP 갱신 주기는 0보다 커야 합니다: %g\n", config->ocsp.refresh);
+        return -1;
+    }
+    if (config->ocsp.command && !config->ocsp.response_file) {
+        fprintf(stderr, "--ocsp-command는 --ocsp-file과 함께 써야 합니다\n");
+        return -1;
+    }
+    if (config->access_log.sample_rate < 0.0 || config->access_log.sample_rate > 1.0) {
+        fprintf(stderr, "샘플링 비율은 0.0~1.0 사이여야 합니다: %g\n", config->access_log.sample_rate);
+        return -1;
+    }
+    if (config->access_log.max_files < 0) {
+        fprintf(stderr, "보관 파일 수는 0 이상이어야 합니다: %d\n", config->access_log.max_files);
+        return -1;
+    }
+    return 0;
+}
+
+int tls_server_parse_backend(const char* name, TlsServerBackend* backend) {
+    if (strcmp(name, "epoll") == 0) {
+        *backend = SERVER_BACKEND_EPOLL;
+    } else if (strcmp(name, "uring") == 0 || strcmp(name, "io_uring") == 0) {
+        *backend = SERVER_BACKEND_URING;
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+const char* tls_server_backend_name(TlsServerBackend backend) {
+    return backend == SERVER_BACKEND_URING ? "uring" : "epoll";
+}
+
+void tls_server_print_usage(const char* program, int default_port) {
+    printf("사용법: %s [port] [--workers N] [--backend epoll|uring] [--handshake-threads N]\n", program);
+    printf("        [--handshake-timeout SEC] [--header-timeout SEC] [--idle-timeout SEC] [--write-timeout SEC]\n");
+    printf("        [--drain-timeout SEC] [--upgrade-socket PATH] [--socket-profile SPEC]\n");
+    printf("        [--max-connections N] [--max-handshakes N] [--rate-limit R] [--rate-burst N]\n");
+    printf("        [--shed-delay MS] [--reject close|503] [--early-data BYTES]\n");
+    printf("        [--ocsp-file PATH] [--ocsp-refresh SEC] [--ocsp-command CMD]\n");
+    printf("        [--access-log PATH|-] [--access-log-format common|tls|json|capture]\n");
+    printf("        [--access-log-sample RATE] [--access-log-max-size MB] [--access-log-keep N]\n");
+    printf("기본 포트: %d\n", default_port);
+    printf("소켓 프로파일: %s (기본값 default, 옵션을 쉼표로 덧붙임. 예: none,nodelay,fastopen)\n",
+           socket_tuning_profile_names());
+    printf("메트릭: GET /metrics (Prometheus 텍스트 형식)\n\n");
+}
+
+int format_http_response_header(char* buffer, size_t size, const char* status, const char* content_type,
+                                size_t body_len, int keep_alive) {
+    int header_len = snprintf(buffer, size,
+        "HTTP/1.1 %s\r\n"
+        "Content-Type: %s\r\n"
+        "Content-Length: %zu\r\n"
+        "Connection: %s\r\n"
+        "\r\n",
+        status, content_type, body_len, keep_alive ? "keep-alive" : "close");
+    if (header_len < 0 || (size_t)header_len >= size) {
+        return -1;
+    }
+    return header_len;
+}
+
+int send_http_response(SSL* ssl, const char* status, const char* content_type, const char* body, size_t body_len) {
+    char response[SERVER_BUFFER_SIZE];
+    char* message = response;
+
+    int header_len = format_http_response_header(response, sizeof(response), status, content_type, body_len, 0);
+    if (header_len < 0) {
+        return -1;
+    }
+
+    // 헤더와 본문을 한 번의 SSL_write로 보낸다 (큰 본문은 임시 버퍼 사용)
+    size_t total = (size_t)header_len + body_len;
+    if (total > sizeof(response)) {
+        message = (char*)malloc(total);
+        if (!message) {
+            return -1;
+        }
+        memcpy(message, response, (size_t)header_len);
+    }
+    memcpy(message + header_len, body, body_len);
+
+    int written = SSL_write(ssl, message, (int)total);
+
+    if (message != response) {
+        free(message);
+    }
+    return written;
+}
+
+// 요청 줄에서 경로 추출 (예: "GET /metrics HTTP/1.1" -> "/metrics")
+static void parse_request_path(const char* request, char* path, size_t size) {
+    const char* start = strchr(request, ' ');
+    path[0] = '\0';
+    if (!start) {
+        return;
+    }
+    start++;
+
+    size_t len = strcspn(start, " ?\r\n");
+    if (len >= size) {
+        len = size - 1;
+    }
+    memcpy(path, start, len);
+    path[len] = '\0';
+}
+
+// 연결 유지 여부 (HTTP/1.1은 기본 유지, HTTP/1.0은 keep-alive 헤더가 있을 때만)
+static int request_keep_alive(const char* request) {
+    const char* line_end = strstr(request, "\r\n");
+    int http10 = line_end && line_end - request >= 8 && strncmp(line_end - 8, "HTTP/1.0", 8) == 0;
+
+    const char* header = strcasestr(request, "\r\nConnection:");
+    if (header) {
+        header += strlen("\r\nConnection:");
+        header += strspn(header, " \t");
+        if (strncasecmp(header, "close", 5) == 0) {
+            return 0;
+        }
+        if (strncasecmp(header, "keep-alive", 10) == 0) {
+            return 1;
+        }
+    }
+    return !http10;
+}
+
+// 캡처 재생 요청이 원하는 응답 전체 크기 (X-Replay-Size 헤더, 없으면 -1)
+static long request_replay_size(const char* request) {
+    const char* header = strcasestr(request, "\r\nX-Replay-Size:");
+    if (!header) {
+        return -1;
+    }
+    long size = strtol(header + strlen("\r\nX-Replay-Size:"), NULL, 10);
+    if (size < 0) {
+        return -1;
+    }
+    return size > SERVER_REPLAY_MAX_BYTES ? SERVER_REPLAY_MAX_BYTES : size;
+}
+
+size_t http_request_length(const char* data, size_t length) {
+    const char* end = memmem(data, length, "\r\n\r\n", 4);
+    return end ? (size_t)(end - data) + 4 : 0;
+}
+
+// 워커 메모리 풀 상태를 게이지에 반영한다
+static void worker_update_memory(ServerWorker* worker) {
+    ServerMetrics* metrics = worker->metrics;
+    metrics_gauge_set(&metrics->memory[METRICS_MEMORY_CONNECTION_SLAB], (int64_t)slab_bytes(&worker->connections));
+    metrics_gauge_set(&metrics->memory[METRICS_MEMORY_BUFFER_POOL], (int64_t)buffer_pool_bytes(&worker->buffers));
+    metrics_gauge_set(&metrics->memory[METRICS_MEMORY_BUFFERS_LENT],
+                      (int64_t)(worker->buffers.lent * worker->buffers.buffer_size));
+}
+
+// 연결 버퍼를 돌려준다 (풀 버퍼 크기가 아니면 힙에서 따로 할당한 버퍼)
+static void conn_buffer_release(Connection* conn, char** buffer, size_t* capacity) {
+    ServerWorker* worker = conn->worker;
+
+    if (!*buffer) {
+        return;
+    }
+    if (*capacity == worker->buffers.buffer_size) {
+        buffer_pool_put(&worker->buffers, *buffer);
+        worker_update_memory(worker);
+    } else {
+        free(*buffer);
+    }
+    *buffer = NULL;
+    *capacity = 0;
+}
+
+// 연결 버퍼를 needed 바이트 이상으로 빌리거나 늘린다 (앞쪽 used 바이트는 유지).
+// 풀 버퍼보다 큰 응답(/metrics, 파이프라이닝된 응답 묶음)만 힙에서 따로 할당한다
+static int conn_buffer_reserve(Connection* conn, char** buffer, size_t* capacity, size_t used, size_t needed) {
+    ServerWorker* worker = conn->worker;
+    size_t pool_size = worker->buffers.buffer_size;
+
+    if (*buffer && needed <= *capacity) {
+        return 0;
+    }
+    if (!*buffer && needed <= pool_size) {
+        *buffer = (char*)buffer_pool_get(&worker->buffers);
+        if (!*buffer) {
+            return -1;
+        }
+        *capacity = pool_size;
+        worker_update_memory(worker);
+        return 0;
+    }
+
+    size_t grown_capacity = *capacity > pool_size ? *capacity : pool_size;
+    while (grown_capacity < needed) {
+        grown_capacity *= 2;
+    }
+    char* grown = (char*)malloc(grown_capacity);
+    if (!grown) {
+        return -1;
+    }
+    if (used > 0) {
+        memcpy(grown, *buffer, used);
+    }
+    conn_buffer_release(conn, buffer, capacity);
+    *buffer = grown;
+    *capacity = grown_capacity;
+    return 0;
+}
+
+// 응답을 연결의 평문 버퍼에 만든다 (헤더와 본문을 한 번의 SSL_write로 보내기 위함)
+// extra_header는 빈 줄 앞에 붙일 헤더 한 줄 ("Name: value\r\n", NULL 가능)
+static int conn_set_response(Connection* conn, const char* status, const char* content_type,
+                             const char* body, size_t body_len, const char* extra_header) {
+    char header[512];
+    int header_len = format_http_response_header(header, sizeof(header), status, content_type,
+                                                 body_len, conn->keep_alive);
+    if (header_len < 0) {
+        return -1;
+    }
+    if (extra_header) {
+        int extra_len = snprintf(header + header_len - 2, sizeof(header) - (size_t)header_len + 2, "%s\r\n",
+                                 extra_header);
+        if (extra_len < 0 || (size_t)(header_len - 2 + extra_len) >= sizeof(header)) {
+            return -1;
+        }
+        header_len += extra_len - 2;
+    }
+
+    size_t total = (size_t)header_len + body_len;
+    if (conn_buffer_reserve(conn, &conn->out, &conn->out_cap, 0, total) != 0) {
+        return -1;
+    }
+    memcpy(conn->out, header, (size_t)header_len);
+    memcpy(conn->out + header_len, body, body_len);
+    conn->out_len = total;
+    return 0;
+}
+
+// 캡처 재생: 헤더를 포함한 응답 크기가 total이 되도록 기본 페이지를 반복해 본문을 채운다
+// (헤더가 total보다 크면 빈 본문)
+static int conn_set_sized_response(Connection* conn, size_t total) {
+    ServerWorker* worker = conn->worker;
+    const char* page = worker->config->response_body;
+    char header[256];
+
+    int header_len = format_http_response_header(header, sizeof(header), "200 OK", "text/html; charset=utf-8",
+                                                 total, conn->keep_alive);
+    if (header_len < 0) {
+        return -1;
+    }
+    size_t body_len = total > (size_t)header_len ? total - (size_t)header_len : 0;
+    header_len = format_http_response_header(header, sizeof(header), "200 OK", "text/html; charset=utf-8",
+                                             body_len, conn->keep_alive);
+    if (header_len < 0 ||
+        conn_buffer_reserve(conn, &conn->out, &conn->out_cap, 0, (size_t)header_len + body_len) != 0) {
+        return -1;
+    }
+    memcpy(conn->out, header, (size_t)header_len);
+    for (size_t filled = 0; filled < body_len; ) {
+        size_t chunk = worker->body_len > 0 ? worker->body_len : 1;
+        if (chunk > body_len - filled) {
+            chunk = body_len - filled;
+        }
+        memcpy(conn->out + header_len + filled, worker->body_len > 0 ? page : " ", chunk);
+        filled += chunk;
+    }
+    conn->out_len = (size_t)header_len + body_len;
+    return 0;
+}
+
+int handle_http_request(Connection* conn, size_t request_len) {
+    ServerWorker* worker = conn->worker;
+    char path[256];
+    char saved = conn->in[request_len];
+    long replay_size;
+    int result;
+
+    conn->in[request_len] = '\0';
+    conn->request_started = server_now_seconds();
+    conn->keep_alive = request_keep_alive(conn->in) && !worker->draining &&   // 드레인 중에는 응답 뒤 닫는다
+                       !conn->rejected;
+    metrics_add(&worker->metrics->bytes_in, (uint64_t)request_len);
+
+    int status = 200;
+    parse_request_path(conn->in, path, sizeof(path));
+    if (conn->rejected) {
+        static const char busy[] = "Server is busy, retry later.\n";
+        status = 503;
+        result = conn_set_response(conn, "503 Service Unavailable", "text/plain; charset=utf-8",
+                                   busy, sizeof(busy) - 1, "Retry-After: 1");
+    } else if (strcmp(path, "/metrics") == 0) {
+        // 모든 워커의 메트릭은 스크레이프 시점에만 합산한다
+        size_t metrics_len = 0;
+        char* metrics_text = server_metrics_render(worker->config->name,
+                                                   tls_server_backend_name(worker->config->backend), &metrics_len);
+        result = conn_set_response(conn, "200 OK", "text/plain; version=0.0.4; charset=utf-8",
+                                   metrics_text ? metrics_text : "", metrics_text ? metrics_len : 0, NULL);
+        free(metrics_text);
+    } else if ((replay_size = request_replay_size(conn->in)) >= 0) {
+        result = conn_set_sized_response(conn, (size_t)replay_size);
+    } else {
+        result = conn_set_response(conn, "200 OK", "text/html; charset=utf-8",
+                                   worker->config->response_body, worker->body_len, NULL);
+    }
+
+    if (conn->logged) {
+        AccessLogRecord* entry = &conn->entry;
+        size_t method_len = strcspn(conn->in, " \r\n");
+        if (method_len >= sizeof(entry->method)) {
+            method_len = sizeof(entry->method) - 1;
+        }
+        memcpy(entry->method, conn->in, method_len);
+        entry->method[method_len] = '\0';
+        snprintf(entry->path, sizeof(entry->path), "%s", path);
+        entry->timestamp_us = wall_clock_us();
+        entry->status = (uint16_t)status;
+        entry->bytes_in = (uint32_t)request_len;
+    }
+
+    // 처리한 요청은 버퍼에서 제거 (파이프라이닝된 다음 요청은 남긴다)
+    conn->in[request_len] = saved;
+    memmove(conn->in, conn->in + request_len, conn->in_len - request_len);
+    conn->in_len -= request_len;
+    return result;
+}
+
+void conn_record_handshake(Connection* conn) {
+    ServerMetrics* metrics = conn->worker->metrics;
+    SSL* ssl = conn->tls.ssl;
+
+    if (conn->worker->pool) {
+        metrics_observe(&metrics->handshake_queue_time, conn->task.started_at - conn->task.queued_at);
+    }
+    if (conn->worker->admission) {
+        admission_handshake_done(conn->worker->admission, &conn->admission);
+    }
+    conn->handshake_time = server_now_seconds() - conn->accepted_at;
+    metrics_record_handshake(metrics, SSL_get_version(ssl), SSL_get_cipher(ssl),
+                             SSL_session_reused(ssl), conn->handshake_time);
+    if (conn->logged) {
+        conn->entry.tls_version = SSL_get_version(ssl);
+        conn->entry.cipher = SSL_get_cipher(ssl);
+        if (SSL_session_reused(ssl)) {
+            conn->entry.flags |= ACCESS_LOG_FLAG_RESUMED;
+        }
+    }
+    switch (SSL_get_early_data_status(ssl)) {
+        case SSL_EARLY_DATA_ACCEPTED:
+            metrics_add(&metrics->early_data[METRICS_EARLY_ACCEPTED], 1);
+            break;
+        case SSL_EARLY_DATA_REJECTED:
+            metrics_add(&metrics->early_data[METRICS_EARLY_REJECTED], 1);
+            break;
+        default:
+            break;
+    }
+}
+
+void conn_record_handshake_failure(Connection* conn, unsigned long error_code) {
+    ServerWorker* worker = conn->worker;
+
+    metrics_add(&worker->metrics->handshake_failures, 1);
+    if (conn->logged) {
+        conn->entry.flags |= ACCESS_LOG_FLAG_HANDSHAKE_FAILED;
+        conn->entry.ssl_error = (uint32_t)error_code;
+        conn->entry.duration_us = (uint32_t)((server_now_seconds() - conn->accepted_at) * 1e6);
+        access_log_submit(worker->access_log, &conn->entry);
+    }
+}
+
+void conn_record_response(Connection* conn) {
+    ServerWorker* worker = conn->worker;
+    ServerMetrics* metrics = worker->metrics;
+    double elapsed = server_now_seconds() - conn->request_started;
+
+    metrics_add(&metrics->bytes_out, (uint64_t)conn->out_len);
+    metrics_add(&metrics->requests, 1);
+    metrics_observe(&metrics->request_time, elapsed);
+
+    if (conn->logged) {
+        AccessLogRecord* entry = &conn->entry;
+        entry->bytes_out = (uint32_t)conn->out_len;
+        entry->duration_us = (uint32_t)(elapsed * 1e6);
+        entry->handshake_us = conn->requests == 0 ? (uint32_t)(conn->handshake_time * 1e6) : 0;
+        entry->request_index = conn->requests > UINT16_MAX ? UINT16_MAX : (uint16_t)conn->requests;
+        access_log_submit(worker->access_log, entry);
+    }
+    conn->requests++;
+    if (conn->state != CONN_HANDSHAKE) {
+        timer_cancel(&worker->timers, &conn->timer);    // 다음 요청의 헤더 마감은 새로 잡는다 (0-RTT 응답은 핸드셰이크 마감 유지)
+    }
+}
+
+Connection* conn_create(ServerWorker* worker, int fd) {
+    Connection* conn = (Connection*)slab_alloc(&worker->connections);
+    if (!conn) {
+        return NULL;
+    }
+    if (tls_engine_init(&conn->tls, worker->ctx, 1) != 0) {
+        slab_free(&worker->connections, conn);
+        return NULL;
+    }
+    worker_update_memory(worker);
+
+    metrics_add(&worker->metrics->accepts, 1);
+    metrics_gauge_add(&worker->metrics->active_connections, 1);
+
+    conn->worker = worker;
+    conn->fd = fd;
+    conn->state = CONN_HANDSHAKE;
+    conn->accepted_at = server_now_seconds();
+    conn->task.ssl = conn->tls.ssl;
+    conn->task.reply = &worker->completions;
+    conn->task.early = worker->config->early_data > 0;
+
+    conn->logged = worker->access_log && access_log_sampled(worker->access_log);
+    conn->entry.timestamp_us = wall_clock_us();
+    conn->entry.worker = (uint8_t)worker->id;
+    conn->entry.connection = (uint32_t)worker->id << 24 | (worker->connection_seq++ & 0xFFFFFF);
+
+    conn->live_next = worker->live;
+    if (worker->live) {
+        worker->live->live_prev = conn;
+    }
+    worker->live = conn;
+
+    timer_init(&conn->timer);
+    conn_update_timer(conn);
+    return conn;
+}
+
+void conn_set_peer(Connection* conn, const struct sockaddr_in* client_addr) {
+    AccessLogRecord* entry = &conn->entry;
+    entry->family = AF_INET;
+    entry->client_port = ntohs(client_addr->sin_port);
+    memcpy(entry->client_addr, &client_addr->sin_addr, sizeof(client_addr->sin_addr));
+}
+
+// 거절한 소켓은 RST로 닫는다 (클라이언트는 재전송을 기다리지 않고 바로 실패를 안다)
+static void reject_socket(ServerWorker* worker, int fd) {
+    struct linger linger = { 1, 0 };
+    setsockopt(fd, SOL_SOCKET, SO_LINGER, &linger, sizeof(linger));
+    close(fd);
+    metrics_add(&worker->metrics->syscalls[METRICS_SYSCALL_CONTROL], 1);
+    metrics_add(&worker->metrics->syscalls[METRICS_SYSCALL_CLOSE], 1);
+}
+
+Connection* conn_accept(ServerWorker* worker, int fd, const struct sockaddr_in* peer) {
+    AdmissionTicket ticket = { 0, 0 };
+    AdmissionResult result = ADMISSION_ACCEPT;
+    struct sockaddr_in lookup;
+
+    if (worker->admission) {
+        uint32_t addr = 0;
+        if (!peer && admission_needs_peer(worker->admission)) {
+            socklen_t lookup_len = sizeof(lookup);
+            metrics_add(&worker->metrics->syscalls[METRICS_SYSCALL_CONTROL], 1);
+            if (getpeername(fd, (struct sockaddr*)&lookup, &lookup_len) == 0 && lookup.sin_family == AF_INET) {
+                peer = &lookup;
+            }
+        }
+        if (peer) {
+            addr = peer->sin_addr.s_addr;
+        }
+        result = admission_check(worker->admission, addr, server_now_ms(), &ticket);
+        if (result != ADMISSION_ACCEPT) {
+            metrics_add(&worker->metrics->rejections[result - 1], 1);
+            if (!ticket.handshake) {
+                reject_socket(worker, fd);
+                return NULL;
+            }
+        }
+    }
+
+    Connection* conn = conn_create(worker, fd);
+    if (!conn) {
+        if (worker->admission) {
+            admission_release(worker->admission, &ticket);
+        }
+        close(fd);
+        return NULL;
+    }
+    conn->admission = ticket;
+    conn->rejected = result != ADMISSION_ACCEPT;
+    if (peer) {
+        conn_set_peer(conn, peer);
+    }
+    return conn;
+}
+
+void worker_observe_delay(ServerWorker* worker, double seconds) {
+    if (worker->admission) {
+        admission_observe_delay(worker->admission, seconds, server_now_ms());
+    }
+}
+
+void conn_destroy(Connection* conn) {
+    ServerWorker* worker = conn->worker;
+
+    metrics_gauge_add(&worker->metrics->active_connections, -1);
+    if (worker->admission) {
+        admission_release(worker->admission, &conn->admission);
+    }
+    timer_cancel(&worker->timers, &conn->timer);
+    if (conn->live_prev) {
+        conn->live_prev->live_next = conn->live_next;
+    } else {
+        worker->live = conn->live_next;
+    }
+    if (conn->live_next) {
+        conn->live_next->live_prev = conn->live_prev;
+    }
+    tls_engine_free(&conn->tls);
+    conn_buffer_release(conn, &conn->in, &conn->in_cap);
+    conn_buffer_release(conn, &conn->out, &conn->out_cap);
+    conn_buffer_release(conn, &conn->tx, &conn->tx_cap);
+    slab_free(&worker->connections, conn);
+}
+
+int conn_collect_output(Connection* conn) {
+    size_t pending = tls_engine_output_pending(&conn->tls);
+
+    if (pending == 0) {
+        return 0;
+    }
+    if (conn_buffer_reserve(conn, &conn->tx, &conn->tx_cap, conn->tx_len, conn->tx_len + pending) != 0) {
+        return -1;
+    }
+    conn->tx_len += tls_engine_drain(&conn->tls, conn->tx + conn->tx_len, pending);
+    return 0;
+}
+
+void conn_update_timer(Connection* conn) {
+    ServerWorker* worker = conn->worker;
+    const TlsServerTimeouts* timeouts = &worker->config->timeouts;
+    MetricsTimeout kind;
+    double seconds;
+
+    if (conn->state == CONN_HANDSHAKE) {
+        kind = METRICS_TIMEOUT_HANDSHAKE;
+        seconds = timeouts->handshake;
+    } else if (conn->tx_sent < conn->tx_len) {
+        kind = METRICS_TIMEOUT_WRITE;
+        seconds = timeouts->write;
+    } else if (conn->in_len > 0 || conn->requests == 0) {
+        kind = METRICS_TIMEOUT_HEADER;
+        seconds = timeouts->header;
+    } else {
+        kind = METRICS_TIMEOUT_IDLE;
+        seconds = timeouts->idle;
+    }
+
+    // 핸드셰이크/헤더 마감은 처음 정한 시각을 유지한다 (조금씩 보내는 클라이언트가 마감을 미루지 못하게)
+    if (timer_pending(&conn->timer) && conn->timer_kind == kind &&
+        (kind == METRICS_TIMEOUT_HANDSHAKE || kind == METRICS_TIMEOUT_HEADER)) {
+        return;
+    }
+    conn->timer_kind = kind;
+    if (seconds <= 0.0) {
+        timer_cancel(&worker->timers, &conn->timer);
+        return;
+    }
+    timer_schedule(&worker->timers, &conn->timer, server_now_ms() + (uint64_t)(seconds * 1000));
+}
+
+int conn_timer_expired(Connection* conn) {
+    metrics_add(&conn->worker->metrics->timeouts[conn->timer_kind], 1);
+    if (conn->timer_kind == METRICS_TIMEOUT_HANDSHAKE) {
+        conn_record_handshake_failure(conn, 0);
+    }
+    if (conn->in_pool) {
+        conn->close_pending = 1;    // 풀 스레드가 SSL을 만지는 중이므로 돌아온 뒤 닫는다
+        return 0;
+    }
+    return 1;
+}
+
+int worker_wait_timeout_ms(ServerWorker* worker) {
+    uint64_t now = server_now_ms();
+    int timeout = timer_wheel_timeout_ms(&worker->timers, now);
+    uint64_t deadline = atomic_load_explicit(&worker->drain_deadline_ms, memory_order_relaxed);
+
+    if (worker->draining && deadline > now) {
+        uint64_t left = deadline - now;
+        if (timeout < 0 || left < (uint64_t)timeout) {
+            timeout = left > 1000000 ? 1000000 : (int)left;
+        }
+    }
+    return timeout;
+}
+
+// 요청 사이에서 다음 요청을 기다리는 keep-alive 연결 (닫아도 응답이 잘리지 않는다)
+static int conn_idle(const Connection* conn) {
+    return conn->state == CONN_READING && !conn->in_pool && conn->requests > 0 && conn->in_len == 0 &&
+           conn->tx_sent >= conn->tx_len;
+}
+
+int worker_drain(ServerWorker* worker, void (*stop_accept)(ServerWorker*), void (*abort_conn)(Connection*)) {
+    uint64_t deadline = atomic_load_explicit(&worker->drain_deadline_ms, memory_order_relaxed);
+    if (deadline == 0) {
+        return 0;
+    }
+
+    // 처리 중인 연결은 응답에 Connection: close를 붙여 끝내고 (handle_http_request), 쉬고 있는 연결만 바로 닫는다
+    int expired = server_now_ms() >= deadline;
+    if (!worker->draining || expired) {
+        if (!worker->draining) {
+            worker->draining = 1;
+            stop_accept(worker);
+        }
+        Connection* conn = worker->live;
+        while (conn) {
+            Connection* next = conn->live_next;     // abort_conn이 연결을 해제할 수 있다
+            if (expired || conn_idle(conn)) {
+                abort_conn(conn);
+            }
+            conn = next;
+        }
+    }
+    return worker->connections.in_use == 0;
+}
+
+void conn_release_tx(Connection* conn) {
+    conn->tx_len = 0;
+    conn->tx_sent = 0;
+    conn_buffer_release(conn, &conn->tx, &conn->tx_cap);
+}
+
+// 핸드셰이크 완료 전(early data)에 응답해도 되는 요청인지: 재전송되어도 결과가 같은 GET/HEAD만 (RFC 8470)
+static int request_replay_safe(const char* request) {
+    return strncmp(request, "GET ", 4) == 0 || strncmp(request, "HEAD ", 5) == 0;
+}
+
+int conn_serve_requests(Connection* conn) {
+    // 핸드셰이크 중이면 early data로 받은 요청이다: 재전송에 안전한 요청만 바로 응답하고 나머지는 완료 뒤로 미룬다
+    int early = conn->state == CONN_HANDSHAKE;
+
+    // 핸드셰이크 전에 Connection: close 응답을 보냈으면 완료를 기다렸다가 close_notify를 보낸다
+    if (conn->requests > 0 && !conn->keep_alive) {
+        if (early) {
+            return 0;
+        }
+        tls_engine_shutdown(&conn->tls);
+        return 1;
+    }
+
+    for (;;) {
+        size_t request_len = conn->in_len > 0 ? http_request_length(conn->in, conn->in_len) : 0;
+        if (request_len > 0) {
+            if (early && !request_replay_safe(conn->in)) {
+                break;
+            }
+            if (handle_http_request(conn, request_len) != 0 ||
+                (early ? tls_engine_write_early(&conn->tls, conn->out, conn->out_len)
+                       : tls_engine_write(&conn->tls, conn->out, conn->out_len)) != TLS_ENGINE_OK) {
+                return -1;
+            }
+            conn_buffer_release(conn, &conn->out, &conn->out_cap);
+            if (early) {
+                // 핸드셰이크 기록(conn_record_handshake) 전이므로 협상 결과를 여기서 남긴다
+                metrics_add(&conn->worker->metrics->early_requests, 1);
+                conn->entry.flags |= ACCESS_LOG_FLAG_EARLY_DATA | ACCESS_LOG_FLAG_RESUMED;
+                conn->entry.tls_version = SSL_get_version(conn->tls.ssl);
+                conn->entry.cipher = SSL_get_cipher(conn->tls.ssl);
+            }
+            conn_record_response(conn);
+            conn->entry.flags &= (uint8_t)~ACCESS_LOG_FLAG_EARLY_DATA;
+            if (!conn->keep_alive) {
+                if (early) {
+                    break;
+                }
+                tls_engine_shutdown(&conn->tls);
+                return 1;
+            }
+            continue;
+        }
+        if (early) {
+            break;                  // early data는 핸드셰이크 단계가 읽어 in 버퍼에 넣는다
+        }
+
+        if (conn_buffer_reserve(conn, &conn->in, &conn->in_cap, conn->in_len, SERVER_POOL_BUFFER_SIZE) != 0 ||
+            conn->in_len >= conn->in_cap - 1) {
+            return -1;              // 헤더가 버퍼보다 크다
+        }
+        size_t bytes = 0;
+        TlsEngineStatus status = tls_engine_read(&conn->tls, conn->in + conn->in_len,
+                                                 conn->in_cap - 1 - conn->in_len, &bytes);
+        if (status == TLS_ENGINE_WANT_INPUT) {
+            break;
+        }
+        if (status != TLS_ENGINE_OK) {
+            return -1;
+        }
+        conn->in_len += bytes;
+    }
+
+    // 완성되지 않은 요청이 남아 있지 않으면 유휴 연결이 버퍼를 잡고 있지 않게 돌려준다
+    if (conn->in_len == 0) {
+        conn_buffer_release(conn, &conn->in, &conn->in_cap);
+    }
+    return 0;
+}
+
+int conn_handshake_prepare(Connection* conn) {
+    HandshakeTask* task = &conn->task;
+
+    if (!task->early) {
+        return 0;
+    }
+    if (conn_buffer_reserve(conn, &conn->in, &conn->in_cap, conn->in_len, SERVER_POOL_BUFFER_SIZE) != 0) {
+        return -1;
+    }
+    task->early_buffer = conn->in + conn->in_len;
+    task->early_cap = conn->in_cap - 1 - conn->in_len;
+    task->early_len = 0;
+    return 0;
+}
+
+int conn_handshake_early_data(Connection* conn) {
+    HandshakeTask* task = &conn->task;
+
+    conn->in_len += task->early_len;
+    task->early_len = 0;
+    if (task->result == 1 || (task->ssl_error != SSL_ERROR_WANT_READ && task->ssl_error != SSL_ERROR_WANT_WRITE)) {
+        return 0;                   // 완료했으면 남은 요청은 일반 경로에서, 실패했으면 닫는다
+    }
+    return conn_serve_requests(conn) < 0 ? -1 : 0;
+}
+
+static void conn_close(Connection* conn) {
+    close(conn->fd);
+    metrics_add(&conn->worker->metrics->syscalls[METRICS_SYSCALL_CLOSE], 1);
+    conn_destroy(conn);
+}
+
+// 다음 이벤트를 기다린다 (EPOLLONESHOT: 이벤트 하나를 한 번만 받아 소유권이 명확하다)
+static int conn_arm(Connection* conn, uint32_t events) {
+    struct epoll_event event;
+    event.events = events | EPOLLONESHOT | EPOLLRDHUP;
+    event.data.ptr = conn;
+    metrics_add(&conn->worker->metrics->syscalls[METRICS_SYSCALL_CONTROL], 1);
+    return epoll_ctl(conn->worker->epoll_fd, EPOLL_CTL_MOD, conn->fd, &event);
+}
+
+// 모아 둔 암호문을 소켓에 쓴다. 다 보냈으면 0, 소켓이 가득 찼으면 1, 실패하면 -1
+static int conn_send(Connection* conn) {
+    if (conn_collect_output(conn) != 0) {
+        return -1;
+    }
+    while (conn->tx_sent < conn->tx_len) {
+        ssize_t sent = send(conn->fd, conn->tx + conn->tx_sent, conn->tx_len - conn->tx_sent, MSG_NOSIGNAL);
+        metrics_add(&conn->worker->metrics->syscalls[METRICS_SYSCALL_WRITE], 1);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno == EAGAIN || errno == EWOULDBLOCK ? 1 : -1;
+        }
+        conn->tx_sent += (size_t)sent;
+    }
+    conn_release_tx(conn);
+    return 0;
+}
+
+// 소켓에서 암호문을 한 번 읽어 엔진에 넣는다. 읽었으면 1, 아직 없으면 0, EOF/실패면 -1
+// (남은 데이터가 있으면 레벨 트리거로 다시 깨어나므로 EAGAIN을 확인하는 추가 read는 하지 않는다)
+static int conn_receive(Connection* conn) {
+    char buffer[SERVER_POOL_BUFFER_SIZE];
+
+    for (;;) {
+        ssize_t bytes = recv(conn->fd, buffer, sizeof(buffer), 0);
+        metrics_add(&conn->worker->metrics->syscalls[METRICS_SYSCALL_READ], 1);
+        if (bytes > 0) {
+            return tls_engine_feed(&conn->tls, buffer, (size_t)bytes) == 0 ? 1 : -1;
+        }
+        if (bytes < 0 && errno == EINTR) {
+            continue;
+        }
+        return bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+    }
+}
+
+// 출력을 보내고 다음 이벤트를 기다린다 (CONN_CLOSING이면 다 보낸 뒤 닫는다)
+static void conn_flush(Connection* conn) {
+    int result = conn_send(conn);
+
+    if (result < 0 || (result == 0 && conn->state == CONN_CLOSING)) {
+        conn_close(conn);
+        return;
+    }
+    conn_update_timer(conn);
+    if (conn_arm(conn, result > 0 ? EPOLLOUT : EPOLLIN) != 0) {
+        conn_close(conn);
+    }
+}
+
+// 핸드셰이크 이후: 엔진에 쌓인 요청을 모두 처리한 뒤 응답을 한 번에 보낸다 (파이프라이닝 포함)
+static void conn_drive(Connection* conn) {
+    int result = conn_serve_requests(conn);
+    if (result < 0) {
+        conn_close(conn);
+        return;
+    }
+    if (result > 0) {
+        conn->state = CONN_CLOSING;
+    }
+    conn_flush(conn);
+}
+
+// 핸드셰이크 한 단계가 끝났을 때 (풀 스레드에서 돌아왔거나 인라인으로 실행한 직후)
+static void conn_handshake_done(Connection* conn) {
+    HandshakeTask* task = &conn->task;
+
+    if (conn->in_pool) {
+        worker_observe_delay(conn->worker, task->started_at - task->queued_at);
+    }
+    conn->in_pool = 0;
+    if (conn->close_pending || conn_handshake_early_data(conn) != 0) {
+        conn_close(conn);
+        return;
+    }
+    if (task->result == 1) {
+        conn_record_handshake(conn);
+        conn->state = CONN_READING;
+        conn_drive(conn);
+        return;
+    }
+
+    if (task->ssl_error != SSL_ERROR_WANT_READ && task->ssl_error != SSL_ERROR_WANT_WRITE) {
+        conn_record_handshake_failure(conn, task->error_code);
+        conn->state = CONN_CLOSING;     // 경고(alert) 레코드가 있으면 보내고 닫는다
+    }
+    conn_flush(conn);
+}
+
+// 핸드셰이크 진행: 풀이 있으면 넘기고 I/O 스레드는 바로 다른 연결로 돌아간다
+static void conn_handshake(Connection* conn) {
+    if (conn_handshake_prepare(conn) != 0) {
+        conn_close(conn);
+        return;
+    }
+    if (conn->worker->pool) {
+        conn->in_pool = 1;
+        handshake_pool_submit(conn->worker->pool, &conn->task);
+        return;
+    }
+    handshake_step(&conn->task);
+    conn_handshake_done(conn);
+}
+
+// 연결을 바로 닫는다 (epoll에서는 소켓을 닫으면 등록도 함께 사라진다). 풀에 가 있으면 돌아온 뒤 닫는다
+static void conn_abort(Connection* conn) {
+    if (conn->in_pool) {
+        conn->close_pending = 1;
+        return;
+    }
+    conn_close(conn);
+}
+
+static void conn_timeout(TimerEntry* timer, void* arg) {
+    Connection* conn = conn_from_timer(timer);
+    (void)arg;
+    if (conn_timer_expired(conn)) {
+        conn_close(conn);
+    }
+}
+
+// 연결 소켓 이벤트: 밀린 송신이 있으면 마저 보내고, 아니면 암호문을 읽어 진행한다
+static void conn_ready(Connection* conn) {
+    if (conn->tx_sent < conn->tx_len) {
+        conn_flush(conn);
+        return;
+    }
+
+    int received = conn_receive(conn);
+    if (received < 0) {
+        if (conn->state == CONN_HANDSHAKE) {
+            conn_record_handshake_failure(conn, 0);
+        }
+        conn_close(conn);
+    } else if (received == 0) {
+        if (conn_arm(conn, EPOLLIN) != 0) {
+            conn_close(conn);
+        }
+    } else if (conn->state == CONN_HANDSHAKE) {
+        conn_handshake(conn);
+    } else {
+        conn_drive(conn);
+    }
+}
+
+static void conn_open(ServerWorker* worker, int fd, const struct sockaddr_in* client_addr) {
+    Connection* conn = conn_accept(worker, fd, client_addr);
+    if (!conn) {
+        return;
+    }
+
+    // ClientHello가 도착하면 핸드셰이크를 시작한다
+    struct epoll_event event;
+    event.events = EPOLLIN | EPOLLONESHOT | EPOLLRDHUP;
+    event.data.ptr = conn;
+    metrics_add(&worker->metrics->syscalls[METRICS_SYSCALL_CONTROL], 1);
+    if (epoll_ctl(worker->epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+        conn_close(conn);
+    }
+}
+
+// 리스닝 소켓이 준비되면 대기 중인 연결을 한 번에 수락한다 (수락한 연결 수)
+static int accept_connections(ServerWorker* worker) {
+    for (int i = 0; i < SERVER_ACCEPT_BATCH; i++) {
+        struct sockaddr_in client_addr;
+        socklen_t client_len = sizeof(client_addr);
+        int client_sock = accept4(worker->server_sock, (struct sockaddr*)&client_addr, &client_len,
+                                  SOCK_NONBLOCK | SOCK_CLOEXEC);
+        metrics_add(&worker->metrics->syscalls[METRICS_SYSCALL_ACCEPT], 1);
+        if (client_sock < 0) {
+            // EINVAL: 드레인하면서 리스닝 소켓을 shutdown했다
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR && errno != ECONNABORTED &&
+                errno != EINVAL) {
+                perror("연결 수락 실패");
+            }
+            return i;
+        }
+        conn_open(worker, client_sock, &client_addr);
+    }
+    return SERVER_ACCEPT_BATCH;
+}
+
+// 드레인: 이 워커의 epoll에서 리스닝 소켓을 빼 더 이상 수락하지 않는다
+// EPOLLEXCLUSIVE는 깨울 워커를 하나만 고르므로, 빼기 직전에 이 워커가 받은 깨움은 새 프로세스에 가지 않는다.
+// 그래서 대기열에 남은 연결은 직접 수락해 마저 처리한다 (드레인 중이므로 응답 뒤 닫힌다)
+static void stop_accepting(ServerWorker* worker) {
+    metrics_add(&worker->metrics->syscalls[METRICS_SYSCALL_CONTROL], 1);
+    epoll_ctl(worker->epoll_fd, EPOLL_CTL_DEL, worker->server_sock, NULL);
+    while (accept_connections(worker) == SERVER_ACCEPT_BATCH) {
+    }
+}
+
+// 워커 스레드: epoll 이벤트 루프
+// (요청 처리 경로에서는 표준 출력이나 로그 파일에 직접 쓰지 않는다. 연결 기록은 접근 로그 링으로만 넘긴다)
+static void* worker_main(void* arg) {
+    ServerWorker* worker = (ServerWorker*)arg;
+    ServerMetrics* metrics = worker->metrics;
+    struct epoll_event events[SERVER_MAX_EVENTS];
+
+    for (;;) {
+        int count = epoll_wait(worker->epoll_fd, events, SERVER_MAX_EVENTS, worker_wait_timeout_ms(worker));
+        metrics_add(&metrics->syscalls[METRICS_SYSCALL_WAIT], 1);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("epoll_wait 실패");
+            break;
+        }
+        // 인라인 핸드셰이크는 이벤트 루프 자체가 대기열이므로 한 바퀴 처리 시간을 대기 시간으로 본다
+        double woke_at = worker->admission && !worker->pool ? server_now_seconds() : 0.0;
+
+        for (int i = 0; i < count; i++) {
+            void* source = events[i].data.ptr;
+            if (source == &worker->server_sock) {
+                accept_connections(worker);
+            } else if (source == &worker->completions) {
+                HandshakeTask* task = handshake_queue_take_all(&worker->completions);
+                metrics_add(&metrics->syscalls[METRICS_SYSCALL_READ], 1);
+                while (task) {
+                    HandshakeTask* next = task->next;
+                    conn_handshake_done((Connection*)task);
+                    task = next;
+                }
+            } else {
+                conn_ready((Connection*)source);
+            }
+        }
+        if (woke_at > 0.0) {
+            worker_observe_delay(worker, server_now_seconds() - woke_at);
+        }
+        timer_wheel_advance(&worker->timers, server_now_ms(), conn_timeout, NULL);
+        if (worker_drain(worker, stop_accepting, conn_abort)) {
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+// 워커의 epoll 인스턴스 준비 (리스닝 소켓은 EPOLLEXCLUSIVE로 공유해 한 워커만 깨운다)
+static int worker_init_loop(ServerWorker* worker) {
+    struct epoll_event event;
+
+    worker->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (worker->epoll_fd < 0) {
+        perror("epoll 생성 실패");
+        return -1;
+    }
+
+    event.events = EPOLLIN | EPOLLEXCLUSIVE;
+    event.data.ptr = &worker->server_sock;
+    if (epoll_ctl(worker->epoll_fd, EPOLL_CTL_ADD, worker->server_sock, &event) != 0) {
+        perror("리스닝 소켓 등록 실패");
+        return -1;
+    }
+
+    event.events = EPOLLIN;
+    event.data.ptr = &worker->completions;
+    if (epoll_ctl(worker->epoll_fd, EPOLL_CTL_ADD, worker->completions.event_fd, &event) != 0) {
+        perror("eventfd 등록 실패");
+        return -1;
+    }
+    return 0;
+}
+
+// 리스닝 소켓 생성 (실패 시 -1)
+// 튜닝 옵션은 bind 전에 건다 (수신 버퍼는 SYN-ACK의 창 배율을 정하고, 연결은 옵션을 물려받는다)
+static int server_listen(int port, int socket_flags, const SocketTuning* tuning) {
+    struct sockaddr_in server_addr;
+    int server_sock = socket(AF_INET, SOCK_STREAM | socket_flags, 0);
+    if (server_sock < 0) {
+        perror("소켓 생성 실패");
+        return -1;
+    }
+
+    // 소켓 옵션 설정 (재사용)
+    int opt = 1;
+    setsockopt(server_sock, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+    socket_tuning_apply(server_sock, tuning, SOCKET_ROLE_LISTEN);
+
+    // 서버 주소 설정
+    memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;
+    server_addr.sin_addr.s_addr = INADDR_ANY;
+    server_addr.sin_port = htons(port);
+
+    // 바인딩
+    if (bind(server_sock, (struct sockaddr*)&server_addr, sizeof(server_addr)) < 0) {
+        perror("바인딩 실패");
+        close(server_sock);
+        return -1;
+    }
+
+    // 리스닝
+    if (listen(server_sock, SERVER_LISTEN_BACKLOG) < 0) {
+        perror("리스닝 실패");
+        close(server_sock);
+        return -1;
+    }
+    return server_sock;
+}
+
+// 메인 스레드의 감독 루프 상태 (워커는 모두 별도 스레드에서 돈다)
+typedef struct {
+    ServerWorker* workers;
+    int worker_count;
+    int running;                // 아직 끝나지 않은 워커 수
+    int server_sock;
+    SSL_CTX* ctx;
+    const TlsServerConfig* config;
+    int signal_fd;              // SIGINT, SIGTERM
+    int exit_fd;                // 워커 종료 통지 (eventfd)
+    int upgrade_fd;             // 인계 요청을 받는 유닉스 소켓 (-1이면 없음)
+    int draining;
+    int handed_off;             // 리스닝 소켓을 새 프로세스에 넘겼음
+} ServerSupervisor;
+
+static void* worker_thread(void* arg) {
+    ServerWorker* worker = (ServerWorker*)arg;
+
+    if (worker->config->backend == SERVER_BACKEND_URING) {
+        uring_worker_main(worker);
+    } else {
+        worker_main(worker);
+    }
+
+    uint64_t one = 1;
+    if (write(worker->exit_event_fd, &one, sizeof(one)) < 0) {
+        // eventfd 카운터는 워커 수보다 훨씬 크므로 포화되지 않는다
+    }
+    return NULL;
+}
+
+// 모든 워커에 드레인을 요청한다 (이미 드레인 중이면 마감을 앞당기기만 한다)
+static void supervisor_drain(ServerSupervisor* sup, double seconds) {
+    uint64_t deadline = server_now_ms() + (uint64_t)(seconds * 1000);
+
+    for (int i = 0; i < sup->worker_count; i++) {
+        ServerWorker* worker = &sup->workers[i];
+        uint64_t current = atomic_load_explicit(&worker->drain_deadline_ms, memory_order_relaxed);
+        if (current == 0 || deadline < current) {
+            atomic_store_explicit(&worker->drain_deadline_ms, deadline, memory_order_relaxed);
+        }
+        handshake_queue_wake(&worker->completions);
+    }
+    if (sup->draining) {
+        return;
+    }
+    sup->draining = 1;
+
+    // 넘겨준 리스닝 소켓은 새 프로세스가 쓰고 있다. 그렇지 않으면 대기열의 연결이 마감까지 기다리지 않게 바로 거절한다
+    if (!sup->handed_off) {
+        shutdown(sup->server_sock, SHUT_RD);
+    }
+    if (sup->upgrade_fd >= 0) {
+        close(sup->upgrade_fd);
+        sup->upgrade_fd = -1;
+        if (!sup->handed_off) {
+            unlink(sup->config->upgrade_socket);    // 인계했다면 이미 새 프로세스의 소켓 파일이다
+        }
+    }
+}
+
+// 새 프로세스에 리스닝 소켓과 세션 티켓 키를 넘기고, 준비되었다고 하면 드레인한다
+static void supervisor_upgrade(ServerSupervisor* sup) {
+    unsigned char keys[HANDOFF_TICKET_KEYS_SIZE];
+    pid_t pid = 0;
+
+    int client = accept4(sup->upgrade_fd, NULL, NULL, SOCK_CLOEXEC);
+    if (client < 0) {
+        return;
+    }
+    int has_keys = SSL_CTX_get_tlsext_ticket_keys(sup->ctx, keys, sizeof(keys)) == 1;
+    int result = handoff_send(client, sup->server_sock, has_keys ? keys : NULL, has_keys ? sizeof(keys) : 0,
+                              SERVER_HANDOFF_TIMEOUT_MS, &pid);
+    OPENSSL_cleanse(keys, sizeof(keys));
+    close(client);
+    if (result != 0) {
+        fprintf(stderr, "리스닝 소켓 인계 실패 (계속 실행합니다)\n");
+        return;
+    }
+
+    printf("새 프로세스(PID %d)에 리스닝 소켓을 넘겼습니다. 드레인을 시작합니다 (최대 %g초).\n",
+           (int)pid, sup->config->timeouts.drain);
+    fflush(stdout);
+    sup->handed_off = 1;
+    supervisor_drain(sup, sup->config->timeouts.drain);
+}
+
+// 종료 시그널, 인계 요청, 워커 종료를 기다린다 (워커가 모두 끝나면 돌아온다)
+static void server_supervise(ServerSupervisor* sup) {
+    while (sup->running > 0) {
+        struct pollfd fds[3];
+        nfds_t count = 2;
+        fds[0].fd = sup->signal_fd;
+        fds[0].events = POLLIN;
+        fds[1].fd = sup->exit_fd;
+        fds[1].events = POLLIN;
+        if (sup->upgrade_fd >= 0) {
+            fds[2].fd = sup->upgrade_fd;
+            fds[2].events = POLLIN;
+            count = 3;
+        }
+        if (poll(fds, count, -1) < 0) {
+            if (errno != EINTR) {
+                perror("poll 실패");
+                supervisor_drain(sup, 0.0);
+            }
+            continue;
+        }
+
+        if (fds[0].revents & POLLIN) {
+            struct signalfd_siginfo info;
+            if (read(sup->signal_fd, &info, sizeof(info)) == (ssize_t)sizeof(info)) {
+                if (!sup->draining) {
+                    printf("\n%s 수신: 새 연결 수락을 멈추고 드레인합니다 (최대 %g초, 다시 보내면 즉시 종료).\n",
+                           strsignal((int)info.ssi_signo), sup->config->timeouts.drain);
+                    supervisor_drain(sup, sup->config->timeouts.drain);
+                } else {
+                    printf("\n남은 연결을 닫고 종료합니다.\n");
+                    supervisor_drain(sup, 0.0);
+                }
+                fflush(stdout);
+            }
+        }
+        if (fds[1].revents & POLLIN) {
+            uint64_t exited = 0;
+            if (read(sup->exit_fd, &exited, sizeof(exited)) == (ssize_t)sizeof(exited)) {
+                sup->running -= (int)exited;
+            }
+            if (!sup->draining && sup->running > 0) {
+                fprintf(stderr, "워커가 비정상 종료해 서버를 드레인합니다.\n");
+                supervisor_drain(sup, sup->config->timeouts.drain);
+            }
+        }
+        if (count == 3 && (fds[2].revents & POLLIN)) {
+            supervisor_upgrade(sup);
+        }
+    }
+}
+
+// TLS 서버 실행 함수
+int run_tls_server(const TlsServerConfig* config) {
+    SSL_CTX* ctx;
+    int server_sock;
+    ServerWorker workers[SERVER_MAX_WORKERS];
+    AccessLog* access_log = NULL;
+    HandshakePool* pool = NULL;
+    TlsServerConfig effective = *config;
+    HandoffInherited inherited;
+    sigset_t signals;
+    sigset_t saved_mask;
+    int port = config->port;
+
+    // io_uring을 쓸 수 없는 커널/샌드박스에서는 epoll로 대신한다
+    if (effective.backend == SERVER_BACKEND_URING && !uring_available()) {
+        fprintf(stderr, "io_uring을 사용할 수 없어 epoll 백엔드로 실행합니다.\n");
+        effective.backend = SERVER_BACKEND_EPOLL;
+    }
+    config = &effective;
+
+    // 실행 중인 이전 프로세스가 있으면 리스닝 소켓을 넘겨받는다 (없으면 새로 연다)
+    memset(&inherited, 0, sizeof(inherited));
+    inherited.listener = -1;
+    inherited.channel = -1;
+    if (config->upgrade_socket && handoff_acquire(config->upgrade_socket, &inherited) < 0) {
+        return -1;
+    }
+    if (inherited.listener >= 0) {
+        struct sockaddr_in bound;
+        socklen_t bound_len = sizeof(bound);
+        if (getsockname(inherited.listener, (struct sockaddr*)&bound, &bound_len) == 0 && bound.sin_family == AF_INET) {
+            port = ntohs(bound.sin_port);
+        }
+    }
+
+    printf("=== TLS 서버 시작%s ===\n", config->title ? config->title : "");
+    printf("포트: %d\n", port);
+    if (inherited.listener >= 0) {
+        printf("리스닝 소켓: 이전 프로세스(PID %d)에서 인계%s\n", (int)inherited.peer_pid,
+               inherited.has_ticket_keys ? " (세션 티켓 키 포함)" : "");
+    }
+    printf("워커 수: %d\n", config->workers);
+    printf("I/O 백엔드: %s\n", tls_server_backend_name(config->backend));
+    char socket_options[160];
+    socket_tuning_describe(&config->socket, socket_options, sizeof(socket_options));
+    printf("소켓 프로파일: %s (%s)\n", config->socket.name, socket_options);
+    if (config->handshake_threads > 0) {
+        printf("핸드셰이크 스레드 수: %d\n", config->handshake_threads);
+    } else {
+        printf("핸드셰이크: I/O 스레드에서 직접 처리\n");
+    }
+    printf("타임아웃 (초, 0은 없음): 핸드셰이크 %g, 헤더 %g, 유휴 %g, 송신 %g\n",
+           config->timeouts.handshake, config->timeouts.header, config->timeouts.idle, config->timeouts.write);
+    if (admission_enabled(&config->admission)) {
+        printf("수락 제한 (0은 없음): 연결 %d, 핸드셰이크 %d, IP별 초당 %g, 부하 차단 %gms, 거절 방식 %s\n",
+               config->admission.max_connections, config->admission.max_handshakes, config->admission.rate,
+               config->admission.shed_delay * 1000.0,
+               config->admission.reject == ADMISSION_REJECT_503 ? "503" : "close");
+    }
+    if (config->early_data > 0) {
+        printf("TLS 1.3 early data: 최대 %ld바이트 (티켓 1회 사용으로 재전송 방지, GET/HEAD만 핸드셰이크 완료 전 응답)\n",
+               config->early_data);
+    }
+    if (config->ocsp.response_file) {
+        printf("OCSP 스테이플링: %s (%g초마다 갱신%s)\n", config->ocsp.response_file, config->ocsp.refresh,
+               config->ocsp.command ? ", 갱신 명령 실행" : "");
+    }
+    printf("서버 주소: https://localhost:%d\n", port);
+    printf("메트릭 주소: https://localhost:%d/metrics\n\n", port);
+
+    // 먼저 끊은 클라이언트에 쓰면 SIGPIPE 대신 EPIPE로 받는다
+    signal(SIGPIPE, SIG_IGN);
+
+    // SSL 컨텍스트 생성 (이전 프로세스의 티켓 키를 이어 써서 재시작 뒤에도 세션 재개가 된다)
+    ctx = config->create_context();
+    if (!ctx) {
+        handoff_release(&inherited);
+        return -1;
+    }
+    if (inherited.has_ticket_keys &&
+        SSL_CTX_set_tlsext_ticket_keys(ctx, inherited.ticket_keys, sizeof(inherited.ticket_keys)) != 1) {
+        fprintf(stderr, "세션 티켓 키 설정 실패 (새 키로 계속합니다)\n");
+    }
+    OPENSSL_cleanse(inherited.ticket_keys, sizeof(inherited.ticket_keys));
+
+    // 0-RTT 재전송 방지: early data를 켜면 OpenSSL은 TLS 1.3 티켓을 서버 세션 캐시에 두는 상태 저장 티켓으로 발급하고
+    // 재개할 때 캐시에서 지운다. 티켓 하나로는 early data를 한 번만 받고, 나이가 맞지 않는 티켓의 early data도 거절한다.
+    // (세션 캐시는 프로세스 안의 워커끼리만 공유하므로 재시작 전에 받은 티켓은 전체 핸드셰이크로 돌아간다)
+    if (config->early_data > 0 &&
+        (SSL_CTX_set_max_early_data(ctx, (uint32_t)config->early_data) != 1 ||
+         SSL_CTX_set_recv_max_early_data(ctx, (uint32_t)config->early_data) != 1)) {
+        fprintf(stderr, "early data 설정 실패\n");
+        ERR_print_errors_fp(stderr);
+        SSL_CTX_free(ctx);
+        handoff_release(&inherited);
+        return -1;
+    }
+
+    // 소켓 생성 (워커들이 공유하므로 비블로킹. io_uring accept는 비블로킹 소켓에서도 poll로 기다린다)
+    // 드레인하는 워커가 대기열을 마지막으로 비울 때 블로킹되지 않아야 한다
+    if (inherited.listener >= 0) {
+        server_sock = inherited.listener;
+        inherited.listener = -1;
+        fcntl(server_sock, F_SETFL, fcntl(server_sock, F_GETFL) | O_NONBLOCK);
+        // 새 프로세스의 프로파일로 바꾼다 (이후 수락하는 연결부터 적용)
+        socket_tuning_apply(server_sock, &config->socket, SOCKET_ROLE_LISTEN);
+    } else {
+        server_sock = server_listen(port, SOCK_NONBLOCK | SOCK_CLOEXEC, &config->socket);
+        if (server_sock < 0) {
+            SSL_CTX_free(ctx);
+            return -1;
+        }
+    }
+
+    // 종료 시그널은 감독 루프가 signalfd로 받는다 (이후 만드는 모든 스레드가 막힌 마스크를 물려받는다)
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, &saved_mask);
+
+    // 접근 로그 (구조화 결과 레코드도 같은 writer 스레드에서 출력)
+    AccessLogConfig log_config = config->access_log;
+    log_config.socket_profile = config->socket.name;
+    log_config.results = result_writer_structured(config->results) ? config->results : NULL;
+    if (log_config.path || log_config.results) {
+        access_log = access_log_start(&log_config);
+        if (!access_log) {
+            fprintf(stderr, "접근 로그 시작 실패\n");
+            handoff_release(&inherited);
+            pthread_sigmask(SIG_SETMASK, &saved_mask, NULL);
+            close(server_sock);
+            SSL_CTX_free(ctx);
+            return -1;
+        }
+    }
+    if (log_config.path) {
+        printf("접근 로그: %s (형식: %s, 샘플링: %g)\n",
+               strcmp(log_config.path, "-") == 0 ? "stdout" : log_config.path,
+               access_log_format_name(log_config.format), log_config.sample_rate);
+    }
+
+    // 핸드셰이크 풀 (모든 워커가 공유)
+    if (config->handshake_threads > 0) {
+        pool = handshake_pool_start(config->handshake_threads);
+        if (!pool) {
+            fprintf(stderr, "핸드셰이크 풀 시작 실패\n");
+            handoff_release(&inherited);
+            pthread_sigmask(SIG_SETMASK, &saved_mask, NULL);
+            access_log_stop(access_log);
+            close(server_sock);
+            SSL_CTX_free(ctx);
+            return -1;
+        }
+    }
+
+    // 수락 제어 (모든 워커가 공유)
+    AdmissionControl* admission = NULL;
+    if (admission_enabled(&config->admission)) {
+        admission = admission_create(&config->admission);
+        if (!admission) {
+            fprintf(stderr, "수락 제어 초기화 실패\n");
+            handoff_release(&inherited);
+            pthread_sigmask(SIG_SETMASK, &saved_mask, NULL);
+            handshake_pool_stop(pool);
+            access_log_stop(access_log);
+            close(server_sock);
+            SSL_CTX_free(ctx);
+            return -1;
+        }
+    }
+
+    // OCSP 스테이플링 (첫 응답을 읽은 뒤 갱신 스레드 시작)
+    OcspStapler* stapler = NULL;
+    if (config->ocsp.response_file) {
+        stapler = ocsp_stapler_start(&config->ocsp, ctx);
+        if (!stapler) {
+            fprintf(stderr, "OCSP 스테이플링 시작 실패\n");
+            handoff_release(&inherited);
+            pthread_sigmask(SIG_SETMASK, &saved_mask, NULL);
+            handshake_pool_stop(pool);
+            admission_destroy(admission);
+            access_log_stop(access_log);
+            close(server_sock);
+            SSL_CTX_free(ctx);
+            return -1;
+        }
+    }
+
+    // 워커 준비 (메트릭은 워커별로 등록)
+    ServerSupervisor sup;
+    memset(&sup, 0, sizeof(sup));
+    sup.workers = workers;
+    sup.worker_count = config->workers;
+    sup.server_sock = server_sock;
+    sup.ctx = ctx;
+    sup.config = config;
+    sup.upgrade_fd = -1;
+    sup.signal_fd = signalfd(-1, &signals, SFD_CLOEXEC);
+    sup.exit_fd = eventfd(0, EFD_CLOEXEC);
+
+    size_t body_len = strlen(config->response_body);
+    for (int i = 0; i < config->workers; i++) {
+        memset(&workers[i], 0, sizeof(workers[i]));
+        workers[i].id = i;
+        workers[i].pool = pool;
+        workers[i].admission = admission;
+        workers[i].server_sock = server_sock;
+        workers[i].ctx = ctx;
+        workers[i].config = config;
+        workers[i].body_len = body_len;
+        workers[i].metrics = server_metrics_register();
+        workers[i].access_log = access_log ? access_log_producer(access_log) : NULL;
+        workers[i].epoll_fd = -1;
+        workers[i].uring = NULL;
+        workers[i].exit_event_fd = sup.exit_fd;
+        slab_init(&workers[i].connections, sizeof(Connection), SERVER_CONN_SLAB_SIZE);
+        buffer_pool_init(&workers[i].buffers, SERVER_POOL_BUFFER_SIZE, SERVER_POOL_MAX_FREE);
+        timer_wheel_init(&workers[i].timers, server_now_ms(), SERVER_TIMER_TICK_MS);
+        if (sup.signal_fd < 0 || sup.exit_fd < 0 || !workers[i].metrics || (access_log && !workers[i].access_log) ||
+            handshake_queue_init(&workers[i].completions) != 0 ||
+            (config->backend == SERVER_BACKEND_URING ? uring_worker_init(&workers[i])
+                                                     : worker_init_loop(&workers[i])) != 0) {
+            fprintf(stderr, "워커 초기화 실패\n");
+            if (sup.signal_fd >= 0) {
+                close(sup.signal_fd);
+            }
+            if (sup.exit_fd >= 0) {
+                close(sup.exit_fd);
+            }
+            handoff_release(&inherited);
+            pthread_sigmask(SIG_SETMASK, &saved_mask, NULL);
+            handshake_pool_stop(pool);
+            ocsp_stapler_stop(stapler);
+            admission_destroy(admission);
+            access_log_stop(access_log);
+            close(server_sock);
+            SSL_CTX_free(ctx);
+            return -1;
+        }
+    }
+
+    // 워커는 모두 별도 스레드로 실행하고, 현재 스레드는 시그널과 인계 요청을 처리한다
+    int started = 0;
+    for (int i = 0; i < config->workers; i++) {
+        if (pthread_create(&workers[i].thread, NULL, worker_thread, &workers[i]) != 0) {
+            perror("워커 스레드 생성 실패");
+            break;
+        }
+        started++;
+    }
+    sup.running = started;
+    if (started < config->workers) {
+        supervisor_drain(&sup, 0.0);
+    }
+
+    // 새 워커가 수락을 시작했으므로 이전 프로세스는 이제 드레인해도 된다
+    if (inherited.channel >= 0 && handoff_notify_ready(&inherited) != 0) {
+        fprintf(stderr, "이전 프로세스에 준비 완료를 알리지 못했습니다\n");
+    }
+    if (config->upgrade_socket && !sup.draining) {
+        sup.upgrade_fd = handoff_listen(config->upgrade_socket);
+        if (sup.upgrade_fd >= 0) {
+            printf("업그레이드 소켓: %s (새 프로세스를 같은 옵션으로 실행하면 리스닝 소켓을 넘깁니다)\n",
+                   config->upgrade_socket);
+        }
+    }
+
+    printf("서버가 연결을 기다리는 중...\n");
+    printf("(Ctrl+C 또는 SIGTERM으로 드레인 후 종료)\n\n");
+    fflush(stdout);
+
+    server_supervise(&sup);
+    for (int i = 0; i < started; i++) {
+        pthread_join(workers[i].thread, NULL);
+    }
+
+    // 정리 (남은 접근 로그 레코드는 여기서 모두 기록된다)
+    handshake_pool_stop(pool);
+    for (int i = 0; i < config->workers; i++) {
+        if (workers[i].epoll_fd >= 0) {
+            close(workers[i].epoll_fd);
+        }
+        uring_worker_destroy(&workers[i]);
+        handshake_queue_destroy(&workers[i].completions);
+        buffer_pool_destroy(&workers[i].buffers);
+        slab_destroy(&workers[i].connections);
+    }
+    ocsp_stapler_stop(stapler);
+    admission_destroy(admission);
+    access_log_stop(access_log);
+    if (sup.upgrade_fd >= 0) {
+        close(sup.upgrade_fd);
+        unlink(config->upgrade_socket);
+    }
+    close(sup.signal_fd);
+    close(sup.exit_fd);
+    close(server_sock);
+    SSL_CTX_free(ctx);
+    pthread_sigmask(SIG_SETMASK, &saved_mask, NULL);
+
+    return 0;
+}
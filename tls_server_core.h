@@ -0,0 +1,82 @@
+#ifndef TLS_SERVER_CORE_H
+#define TLS_SERVER_CORE_H
+
+// TLS 테스트 서버 공용 루프 (tls_server_test, tls_server_file_test)
+// 두 서버는 인증서를 준비하는 방법만 다르고, 연결 수락/요청 처리/메트릭은 여기서 공유한다.
+
+#include <openssl/ssl.h>
+#include "result_output.h"
+#include "access_log.h"
+#include "server_admission.h"
+#include "server_ocsp.h"
+#include "socket_tuning.h"
+
+#define SERVER_BUFFER_SIZE 4096
+#define SERVER_POOL_BUFFER_SIZE 16384   // 연결에 빌려주는 버퍼 크기 (TLS 레코드 최대 평문 크기, 요청 헤더 최대 크기)
+#define SERVER_MAX_WORKERS 64
+
+// 워커의 소켓 I/O 방식
+typedef enum {
+    SERVER_BACKEND_EPOLL = 0,   // 비블로킹 소켓 + epoll
+    SERVER_BACKEND_URING        // io_uring (멀티샷 accept, 제공 버퍼 링)
+} TlsServerBackend;
+
+// 연결 타임아웃 (초, 0이면 사용하지 않음)
+typedef struct {
+    double handshake;                   // 수락부터 핸드셰이크 완료까지
+    double header;                      // 요청 헤더를 다 받을 때까지 (첫 바이트 이후 연장되지 않음)
+    double idle;                        // keep-alive 연결이 다음 요청 없이 기다리는 시간
+    double write;                       // 응답 송신이 진전 없이 막혀 있는 시간
+    double drain;                       // 종료/인계 뒤 진행 중인 연결을 기다리는 최대 시간 (0이면 바로 닫음)
+} TlsServerTimeouts;
+
+typedef struct {
+    const char* name;                   // 메트릭/결과 레코드에 쓰이는 서버 이름
+    const char* title;                  // 시작 배너에 붙는 설명 (NULL 가능)
+    const char* response_body;          // 기본 페이지 HTML
+    SSL_CTX* (*create_context)(void);   // 인증서가 설정된 SSL 컨텍스트 생성 함수
+    int port;
+    int workers;                        // 연결을 수락하는 워커(epoll 이벤트 루프) 스레드 수
+    int handshake_threads;              // 핸드셰이크 암호 연산을 맡는 스레드 수 (0이면 워커가 직접 처리)
+    TlsServerBackend backend;
+    TlsServerTimeouts timeouts;
+    AdmissionConfig admission;          // 동시 연결/핸드셰이크, IP별 속도, 적응형 부하 차단
+    long early_data;                    // TLS 1.3 early data(0-RTT)로 받을 최대 바이트 (0이면 받지 않음)
+    OcspConfig ocsp;                    // OCSP 스테이플링 (response_file이 NULL이면 사용하지 않음)
+    ResultWriter* results;              // 연결별 구조화 결과 출력 (NULL 가능)
+    AccessLogConfig access_log;         // 접근 로그 설정 (path가 NULL이면 파일 출력 없음)
+    const char* upgrade_socket;         // 리스닝 소켓을 주고받을 유닉스 소켓 경로 (NULL이면 무중단 재시작 없음)
+    SocketTuning socket;                // 리스닝 소켓 튜닝 (accept한 연결이 물려받음)
+} TlsServerConfig;
+
+// 기본값으로 설정을 채운다
+void tls_server_default_config(TlsServerConfig* config, const char* name, int port);
+
+// 명령행 인수 파싱: [port] [--workers N] [--backend B] [--handshake-threads N] [--*-timeout SEC]
+// [--max-connections N] [--max-handshakes N] [--rate-limit R] [--shed-delay MS] [--reject close|503]
+// [--early-data BYTES] [--ocsp-file PATH] [--ocsp-refresh SEC] [--ocsp-command CMD]
+// [--upgrade-socket PATH] [--socket-profile SPEC] [--access-log ...].
+// 잘못된 인수이면 -1
+int tls_server_parse_args(TlsServerConfig* config, int argc, char* argv[]);
+
+// "epoll", "uring" 파싱. 성공 시 0
+int tls_server_parse_backend(const char* name, TlsServerBackend* backend);
+const char* tls_server_backend_name(TlsServerBackend backend);
+
+// 사용법 출력
+void tls_server_print_usage(const char* program, int default_port);
+
+// 서버 실행 (정상 종료 시 0, 초기화 실패 시 -1)
+// SIGINT/SIGTERM을 받으면 수락을 멈추고 진행 중인 연결을 드레인한 뒤 돌아온다 (두 번째 시그널은 즉시 닫음).
+// upgrade_socket이 있으면 시작할 때 실행 중인 이전 프로세스에서 리스닝 소켓을 넘겨받고,
+// 이후 새 프로세스가 같은 경로로 접속하면 리스닝 소켓을 넘기고 드레인한다.
+int run_tls_server(const TlsServerConfig* config);
+
+// HTTP 응답 헤더 작성 (헤더 길이, 버퍼가 부족하면 -1)
+int format_http_response_header(char* buffer, size_t size, const char* status, const char* content_type,
+                                size_t body_len, int keep_alive);
+
+// 블로킹 소켓용 HTTP 응답 전송 함수 (Connection: close, 전송한 바이트 수, 실패 시 -1)
+int send_http_response(SSL* ssl, const char* status, const char* content_type, const char* body, size_t body_len);
+
+#endif
@@ -2,14 +2,11 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
-#include <sys/socket.h>
-#include <netinet/in.h>
-#include <arpa/inet.h>
 #include <openssl/ssl.h>
 #include <openssl/err.h>
 #include <openssl/rand.h>
+#include "tls_server_core.h"
 
-#define BUFFER_SIZE 4096
 #define DEFAULT_PORT 8443
 #define CERT_DIR "certs"
 #define CERT_FILE CERT_DIR "/server.crt"
@@ -85,161 +82,39 @@ SSL_CTX* create_context() {
     return ctx;
 }
 
-// HTTP 응답 생성 함수
-void send_http_response(SSL* ssl, const char* status, const char* content_type, const char* body) {
-    char response[BUFFER_SIZE];
-    char content_length[32];
-    
-    snprintf(content_length, sizeof(content_length), "%zu", strlen(body));
-    
-    snprintf(response, sizeof(response),
-        "HTTP/1.1 %s\r\n"
-        "Content-Type: %s\r\n"
-        "Content-Length: %s\r\n"
-        "Connection: close\r\n"
-        "\r\n"
-        "%s",
-        status, content_type, content_length, body);
-    
-    SSL_write(ssl, response, strlen(response));
-}
-
-// HTTP 요청 처리 함수
-void handle_http_request(SSL* ssl) {
-    char buffer[BUFFER_SIZE];
-    int bytes = SSL_read(ssl, buffer, sizeof(buffer) - 1);
-    
-    if (bytes > 0) {
-        buffer[bytes] = '\0';
-        printf("=== 수신된 HTTP 요청 ===\n%s\n", buffer);
-        
-        // 간단한 응답 전송
-        const char* response_body = 
-            "<html><head><title>TLS Test Server (File-based Cert)</title></head>"
-            "<body><h1>TLS 연결 성공!</h1>"
-            "<p>이 페이지는 파일 기반 인증서를 사용하는 OpenSSL TLS 서버에서 제공됩니다.</p>"
-            "<p>현재 시간: " __DATE__ " " __TIME__ "</p>"
-            "<p>인증서: 파일에서 로드됨</p>"
-            "</body></html>";
-        
-        send_http_response(ssl, "200 OK", "text/html; charset=utf-8", response_body);
-        printf("=== HTTP 응답 전송 완료 ===\n");
-    }
-}
+// 기본 페이지
+static const char* const RESPONSE_BODY =
+    "<html><head><title>TLS Test Server (File-based Cert)</title></head>"
+    "<body><h1>TLS 연결 성공!</h1>"
+    "<p>이 페이지는 파일 기반 인증서를 사용하는 OpenSSL TLS 서버에서 제공됩니다.</p>"
+    "<p>현재 시간: " __DATE__ " " __TIME__ "</p>"
+    "<p>인증서: 파일에서 로드됨</p>"
+    "</body></html>";
 
-// TLS 서버 실행 함수
-int run_tls_server(int port) {
-    SSL_CTX* ctx;
-    int server_sock, client_sock;
-    struct sockaddr_in server_addr, client_addr;
-    socklen_t client_len = sizeof(client_addr);
-    
-    printf("=== TLS 서버 시작 (파일 기반 인증서) ===\n");
-    printf("포트: %d\n", port);
-    printf("서버 주소: https://localhost:%d\n\n", port);
-    
-    // SSL 컨텍스트 생성
-    ctx = create_context();
-    if (!ctx) {
-        return -1;
-    }
-    
-    // 소켓 생성
-    server_sock = socket(AF_INET, SOCK_STREAM, 0);
-    if (server_sock < 0) {
-        perror("소켓 생성 실패");
-        SSL_CTX_free(ctx);
-        return -1;
-    }
-    
-    // 소켓 옵션 설정 (재사용)
-    int opt = 1;
-    setsockopt(server_sock, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
-    
-    // 서버 주소 설정
-    memset(&server_addr, 0, sizeof(server_addr));
-    server_addr.sin_family = AF_INET;
-    server_addr.sin_addr.s_addr = INADDR_ANY;
-    server_addr.sin_port = htons(port);
-    
-    // 바인딩
-    if (bind(server_sock, (struct sockaddr*)&server_addr, sizeof(server_addr)) < 0) {
-        perror("바인딩 실패");
-        close(server_sock);
-        SSL_CTX_free(ctx);
-        return -1;
-    }
+int main(int argc, char* argv[]) {
+    TlsServerConfig config;
     
-    // 리스닝
-    if (listen(server_sock, 5) < 0) {
-        perror("리스닝 실패");
-        close(server_sock);
-        SSL_CTX_free(ctx);
-        return -1;
-    }
+    tls_server_default_config(&config, "tls_server_file_test", DEFAULT_PORT);
+    config.title = " (파일 기반 인증서)";
+    config.response_body = RESPONSE_BODY;
+    config.create_context = create_context;
     
-    printf("서버가 연결을 기다리는 중...\n");
-    printf("(Ctrl+C로 종료)\n\n");
-    
-    // 클라이언트 연결 처리
-    while ((client_sock = accept(server_sock, (struct sockaddr*)&client_addr, &client_len))) {
-        char client_ip[INET_ADDRSTRLEN];
-        inet_ntop(AF_INET, &client_addr.sin_addr, client_ip, INET_ADDRSTRLEN);
-        
-        printf("=== 클라이언트 연결 수락 ===\n");
-        printf("클라이언트 IP: %s:%d\n", client_ip, ntohs(client_addr.sin_port));
-        
-        // SSL 생성
-        SSL* ssl = SSL_new(ctx);
-        SSL_set_fd(ssl, client_sock);
-        
-        // SSL 핸드셰이크
-        if (SSL_accept(ssl) <= 0) {
-            ERR_print_errors_fp(stderr);
-            SSL_free(ssl);
-            close(client_sock);
-            continue;
-        }
-        
-        printf("=== TLS 연결 정보 ===\n");
-        printf("프로토콜: %s\n", SSL_get_version(ssl));
-        printf("암호화 스위트: %s\n", SSL_get_cipher(ssl));
-        printf("=====================\n");
-        
-        // HTTP 요청 처리
-        handle_http_request(ssl);
-        
-        // 연결 종료
-        SSL_shutdown(ssl);
-        SSL_free(ssl);
-        close(client_sock);
-        
-        printf("=== 클라이언트 연결 종료 ===\n\n");
+    if (tls_server_parse_args(&config, argc, argv) != 0) {
+        tls_server_print_usage(argv[0], DEFAULT_PORT);
+        return 1;
     }
     
-    // 정리
-    close(server_sock);
-    SSL_CTX_free(ctx);
-    
-    return 0;
-}
-
-int main(int argc, char* argv[]) {
-    int port = DEFAULT_PORT;
-    
-    if (argc > 1) {
-        port = atoi(argv[1]);
-    }
+    // 구조화 결과 출력 초기화 (RESULT_FORMAT=jsonl|csv이면 사람용 출력은 stderr로 이동)
+    config.results = result_writer_from_env();
     
     printf("OpenSSL TLS 서버 테스트 (파일 기반 인증서)\n");
-    printf("사용법: %s [port]\n", argv[0]);
-    printf("기본 포트: %d\n\n", DEFAULT_PORT);
+    tls_server_print_usage(argv[0], DEFAULT_PORT);
     
     // OpenSSL 초기화
     init_openssl();
     
     // TLS 서버 실행
-    if (run_tls_server(port) == 0) {
+    if (run_tls_server(&config) == 0) {
         printf("✅ TLS 서버가 정상적으로 종료되었습니다.\n");
     } else {
         printf("❌ TLS 서버 실행 중 오류가 발생했습니다.\n");
@@ -247,6 +122,7 @@ int main(int argc, char* argv[]) {
     
     // OpenSSL 정리
     cleanup_openssl();
+    result_writer_close(config.results);
     
     return 0;
 } 
\ No newline at end of file
@@ -0,0 +1,164 @@
+#ifndef TLS_SERVER_INTERNAL_H
+#define TLS_SERVER_INTERNAL_H
+
+// tls_server_core.c와 I/O 백엔드(server_uring.c)가 공유하는 내부 구조체와 함수
+// - HTTP 처리, 메트릭, 접근 로그 기록은 백엔드와 무관하게 여기 선언된 함수로 처리한다.
+// - TLS는 두 백엔드 모두 메모리 BIO 엔진(tls_engine.h)으로 처리하고, 백엔드는 암호문을 소켓과 주고받는 방식만 다르다.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <netinet/in.h>
+#include "tls_server_core.h"
+#include "server_metrics.h"
+#include "access_log.h"
+#include "handshake_pool.h"
+#include "tls_engine.h"
+#include "memory_pool.h"
+#include "timer_wheel.h"
+
+typedef struct UringLoop UringLoop;
+typedef struct Connection Connection;
+
+// 워커 스레드 상태 (각 워커는 자기 메트릭만 갱신한다)
+typedef struct {
+    int id;
+    int server_sock;
+    int epoll_fd;                   // epoll 백엔드
+    UringLoop* uring;               // io_uring 백엔드
+    SSL_CTX* ctx;
+    const TlsServerConfig* config;
+    size_t body_len;
+    ServerMetrics* metrics;
+    AccessLogProducer* access_log;  // NULL이면 접근 로그 없음
+    HandshakePool* pool;            // NULL이면 I/O 스레드에서 직접 핸드셰이크
+    HandshakeQueue completions;     // 풀에서 돌아온 핸드셰이크
+    SlabAllocator connections;      // Connection 객체 slab (워커 스레드만 사용)
+    BufferPool buffers;             // 연결에 빌려주는 I/O 버퍼 (SERVER_POOL_BUFFER_SIZE)
+    TimerWheel timers;              // 연결 타임아웃
+    AdmissionControl* admission;    // 모든 워커가 공유 (NULL이면 수락 제한 없음)
+    _Atomic uint64_t drain_deadline_ms; // 0이 아니면 드레인 요청 (감독 스레드가 설정, 이 시각이 지나면 남은 연결을 닫는다)
+    int draining;                   // 수락을 멈추고 연결이 끝나기를 기다리는 중
+    Connection* live;               // 살아 있는 연결 목록 (드레인할 때 순회)
+    uint32_t connection_seq;        // 접근 로그/캡처의 연결 번호
+    int exit_event_fd;              // 워커 스레드가 끝나면 감독 스레드에 알린다
+    pthread_t thread;
+} ServerWorker;
+
+typedef enum {
+    CONN_HANDSHAKE = 0,
+    CONN_READING,
+    CONN_WRITING,
+    CONN_CLOSING
+} ConnState;
+
+// 클라이언트 연결 하나 (I/O 스레드나 핸드셰이크 풀 중 한 곳만 소유한다)
+// 버퍼(in, out, tx)는 처리할 데이터가 있는 동안에만 워커의 버퍼 풀에서 빌리고, 유휴 연결은 버퍼를 갖지 않는다.
+struct Connection {
+    HandshakeTask task;             // 첫 멤버: 완료 큐에서 꺼낸 작업을 연결로 되돌린다
+    ServerWorker* worker;
+    int fd;
+    TlsEngine tls;
+    ConnState state;
+    int keep_alive;
+    int logged;                     // 샘플링되어 접근 로그에 남길 연결인지
+    int in_pool;                    // 핸드셰이크 풀 스레드가 SSL을 처리 중
+    int close_pending;              // 풀에 가 있는 동안 타임아웃/드레인 마감 (돌아오면 닫는다)
+    int rejected;                   // 수락 제한에 걸려 503으로 응답하고 닫을 연결
+    AdmissionTicket admission;      // 잡고 있는 동시 연결/핸드셰이크 자리
+    TimerEntry timer;               // 현재 상태의 마감 (상태마다 하나만)
+    MetricsTimeout timer_kind;
+    unsigned requests;
+    double accepted_at;
+    double handshake_time;
+    double request_started;
+    AccessLogRecord entry;
+    int inflight;                   // io_uring: 완료되지 않은 SQE 수
+    char* in;                       // 아직 처리하지 않은 평문 요청 (완성되지 않은 요청이 있을 때만)
+    size_t in_len;
+    size_t in_cap;
+    char* out;                      // 평문 응답 (엔진에 넘기면 바로 반납)
+    size_t out_len;
+    size_t out_cap;
+    char* tx;                       // 소켓으로 보낼 암호문 (송신이 끝나면 반납)
+    size_t tx_len;
+    size_t tx_sent;
+    size_t tx_cap;
+    Connection* live_prev;
+    Connection* live_next;
+};
+
+// 단조 시계 기준 현재 시각 (초, 밀리초)
+double server_now_seconds(void);
+uint64_t server_now_ms(void);
+
+#define conn_from_timer(entry) ((Connection*)((char*)(entry) - offsetof(Connection, timer)))
+
+// 연결 객체 생성 (TLS 엔진, 메트릭, 접근 로그 기본값)
+Connection* conn_create(ServerWorker* worker, int fd);
+
+// 수락한 소켓을 수락 제어에 통과시키고 연결 객체를 만든다 (peer를 모르면 NULL, 필요하면 조회한다).
+// 거절하거나 실패하면 소켓을 닫고 NULL
+Connection* conn_accept(ServerWorker* worker, int fd, const struct sockaddr_in* peer);
+
+// 부하 차단용 대기 시간 표본 (핸드셰이크 풀 대기, 인라인 모드는 이벤트 루프 한 바퀴 처리 시간)
+void worker_observe_delay(ServerWorker* worker, double seconds);
+
+// 접근 로그용 클라이언트 주소 기록
+void conn_set_peer(Connection* conn, const struct sockaddr_in* client_addr);
+
+// TLS 엔진과 버퍼 해제 (소켓은 백엔드가 닫는다)
+void conn_destroy(Connection* conn);
+
+// 엔진이 만든 암호문을 tx 뒤에 붙인다. 메모리 부족이면 -1
+int conn_collect_output(Connection* conn);
+
+// 연결 상태에 맞는 마감을 건다: 핸드셰이크 -> 요청 헤더 -> keep-alive 유휴, 송신이 막혀 있으면 송신 정체
+// (I/O를 기다리기 직전마다 호출한다)
+void conn_update_timer(Connection* conn);
+
+// 타이머 만료 공통 처리 (메트릭, 핸드셰이크 실패 기록). 지금 닫아야 하면 1,
+// 핸드셰이크 풀에 가 있어 돌아온 뒤 닫아야 하면 0
+int conn_timer_expired(Connection* conn);
+
+// 이벤트 루프 대기 시간 (다음 타이머 틱, 드레인 중이면 드레인 마감까지 중 가까운 쪽. 없으면 -1)
+int worker_wait_timeout_ms(ServerWorker* worker);
+
+// 이벤트 루프가 매 반복 끝에 호출한다. 드레인이 요청되면 처음 한 번 stop_accept를 부르고 유휴 keep-alive 연결을,
+// 마감이 지나면 남은 연결을 abort_conn으로 닫는다. 드레인 중이고 연결이 모두 정리되었으면 1 (루프 종료)
+int worker_drain(ServerWorker* worker, void (*stop_accept)(ServerWorker*), void (*abort_conn)(Connection*));
+
+// 송신이 끝난 tx 버퍼를 풀에 돌려준다
+void conn_release_tx(Connection* conn);
+
+// 엔진에 쌓인 평문 요청을 모두 처리하고 응답을 엔진 출력에 쌓는다 (파이프라이닝 포함).
+// 핸드셰이크 중(CONN_HANDSHAKE)에 부르면 early data로 받아 둔 요청 중 재전송에 안전한 것만 처리한다.
+// 암호문이 더 필요하면 0, 응답 뒤 연결을 닫아야 하면 1 (close_notify 포함), 오류면 -1
+int conn_serve_requests(Connection* conn);
+
+// 완성된 요청 헤더 길이 ("\r\n\r\n" 포함). 아직 덜 왔으면 0
+size_t http_request_length(const char* data, size_t length);
+
+// 요청 처리 (in 버퍼 앞쪽 request_len 바이트). 평문 응답을 out에 만들고 요청은 버퍼에서 제거한다
+int handle_http_request(Connection* conn, size_t request_len);
+
+// 핸드셰이크 단계를 실행(또는 풀에 제출)하기 전에 호출: early data 단계이면 받은 평문을 쌓을 요청 버퍼를 작업에 연결한다.
+// 메모리 부족이면 -1
+int conn_handshake_prepare(Connection* conn);
+
+// 핸드셰이크 단계가 돌아온 뒤 호출: 받은 early data를 요청 버퍼에 붙이고, 핸드셰이크가 아직 진행 중이면
+// 재전송에 안전한 요청(GET/HEAD)에 바로 응답한다 (클라이언트 Finished를 기다리지 않는 0.5-RTT 응답). 오류면 -1
+int conn_handshake_early_data(Connection* conn);
+
+// 핸드셰이크/응답 결과를 메트릭과 접근 로그에 기록
+void conn_record_handshake(Connection* conn);
+void conn_record_handshake_failure(Connection* conn, unsigned long error_code);
+void conn_record_response(Connection* conn);
+
+// io_uring 백엔드 (server_uring.c)
+int uring_available(void);
+int uring_worker_init(ServerWorker* worker);
+void* uring_worker_main(void* arg);
+void uring_worker_destroy(ServerWorker* worker);
+
+#endif
@@ -0,0 +1,321 @@
+#include "tls_trust.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+#include <arpa/inet.h>
+#include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/ocsp.h>
+#include <openssl/sha.h>
+#include <openssl/x509v3.h>
+
+#define TRUST_DEFAULT_CACHE_ENTRIES 256
+#define TRUST_DEFAULT_CACHE_TTL 300.0
+#define TRUST_OCSP_CLOCK_SKEW 300           // OCSP thisUpdate/nextUpdate 허용 시계 오차 (초)
+
+// 검증 결과 캐시 항목 (직접 사상: 키의 앞 4바이트로 자리를 정하고 충돌하면 덮어쓴다)
+typedef struct {
+    unsigned char key[SHA256_DIGEST_LENGTH];
+    int error;                              // X509_V_OK 또는 검증 오류 코드
+    double expires;                         // 단조 시계 기준, 0이면 빈 자리
+} TrustCacheEntry;
+
+struct TlsTrust {
+    TlsTrustConfig config;
+    X509_STORE* store;
+
+    pthread_mutex_t lock;                   // 캐시와 통계
+    TrustCacheEntry* cache;
+    int cache_entries;
+    TlsTrustStats stats;
+};
+
+// 연결별 OCSP 확인 결과를 둘 SSL ex_data 자리 (프로세스에서 한 번만 할당)
+static int g_ocsp_index = -1;
+static pthread_once_t g_ocsp_index_once = PTHREAD_ONCE_INIT;
+
+static void trust_alloc_index(void) {
+    g_ocsp_index = SSL_get_ex_new_index(0, NULL, NULL, NULL, NULL);
+}
+
+static double trust_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+void tls_trust_default_config(TlsTrustConfig* config) {
+    memset(config, 0, sizeof(*config));
+    config->cache_entries = TRUST_DEFAULT_CACHE_ENTRIES;
+    config->cache_ttl = TRUST_DEFAULT_CACHE_TTL;
+}
+
+TlsTrust* tls_trust_create(const TlsTrustConfig* config) {
+    TlsTrust* trust = (TlsTrust*)calloc(1, sizeof(TlsTrust));
+    if (!trust) {
+        return NULL;
+    }
+    trust->config = *config;
+    pthread_mutex_init(&trust->lock, NULL);
+    pthread_once(&g_ocsp_index_once, trust_alloc_index);
+
+    trust->store = X509_STORE_new();
+    int loaded = trust->store != NULL;
+    if (loaded) {
+        if (config->ca_file || config->ca_path) {
+            loaded = X509_STORE_load_locations(trust->store, config->ca_file, config->ca_path) == 1;
+        } else {
+            loaded = X509_STORE_set_default_paths(trust->store) == 1;
+        }
+    }
+    if (!loaded) {
+        fprintf(stderr, "신뢰 저장소 로드 실패: %s\n",
+                config->ca_file ? config->ca_file : config->ca_path ? config->ca_path : "시스템 기본 경로");
+        ERR_print_errors_fp(stderr);
+        tls_trust_free(trust);
+        return NULL;
+    }
+
+    if (config->cache_entries > 0) {
+        trust->cache = (TrustCacheEntry*)calloc((size_t)config->cache_entries, sizeof(TrustCacheEntry));
+        if (!trust->cache) {
+            tls_trust_free(trust);
+            return NULL;
+        }
+        trust->cache_entries = config->cache_entries;
+    }
+    return trust;
+}
+
+void tls_trust_free(TlsTrust* trust) {
+    if (!trust) {
+        return;
+    }
+    X509_STORE_free(trust->store);
+    free(trust->cache);
+    pthread_mutex_destroy(&trust->lock);
+    free(trust);
+}
+
+// 캐시 키: 검증 대상 호스트(이름 또는 IP) + 서버가 보낸 체인의 인증서별 SHA-256
+static int trust_cache_key(X509_STORE_CTX* store_ctx, unsigned char* key) {
+    X509_VERIFY_PARAM* param = X509_STORE_CTX_get0_param(store_ctx);
+    STACK_OF(X509)* chain = X509_STORE_CTX_get0_untrusted(store_ctx);
+    X509* leaf = X509_STORE_CTX_get0_cert(store_ctx);
+    EVP_MD_CTX* md = EVP_MD_CTX_new();
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int digest_len;
+    int ok = md && EVP_DigestInit_ex(md, EVP_sha256(), NULL) == 1;
+
+    // IP 검증 대상이 없으면 get1_ip_asc가 오류를 남기므로 되돌린다
+    const char* host = X509_VERIFY_PARAM_get0_host(param, 0);
+    ERR_set_mark();
+    char* ip = host ? NULL : X509_VERIFY_PARAM_get1_ip_asc(param);
+    ERR_pop_to_mark();
+    ok = ok && EVP_DigestUpdate(md, host ? host : "", host ? strlen(host) + 1 : 1) == 1;
+    ok = ok && EVP_DigestUpdate(md, ip ? ip : "", ip ? strlen(ip) + 1 : 1) == 1;
+    OPENSSL_free(ip);
+
+    // 클라이언트 쪽 untrusted 목록은 서버 인증서부터 시작한다
+    int count = chain ? sk_X509_num(chain) : 0;
+    for (int i = 0; ok && i < (count > 0 ? count : 1); i++) {
+        X509* cert = count > 0 ? sk_X509_value(chain, i) : leaf;
+        ok = X509_digest(cert, EVP_sha256(), digest, &digest_len) == 1 &&
+             EVP_DigestUpdate(md, digest, digest_len) == 1;
+    }
+    ok = ok && EVP_DigestFinal_ex(md, key, NULL) == 1;
+    EVP_MD_CTX_free(md);
+    return ok ? 0 : -1;
+}
+
+static TrustCacheEntry* trust_cache_slot(TlsTrust* trust, const unsigned char* key) {
+    uint32_t hash;
+    memcpy(&hash, key, sizeof(hash));
+    return &trust->cache[hash % (uint32_t)trust->cache_entries];
+}
+
+// 캐시 항목 수명: TTL과 서버 인증서 만료까지 남은 시간 중 짧은 쪽
+static double trust_entry_lifetime(const TlsTrust* trust, X509* leaf) {
+    double lifetime = trust->config.cache_ttl;
+    int days = 0, seconds = 0;
+    if (leaf && ASN1_TIME_diff(&days, &seconds, NULL, X509_get0_notAfter(leaf)) == 1) {
+        double remaining = (double)days * 86400.0 + seconds;
+        if (remaining > 0.0 && remaining < lifetime) {
+            lifetime = remaining;
+        }
+    }
+    return lifetime;
+}
+
+// SSL_CTX_set_cert_verify_callback: 캐시에 있으면 결과만 돌려주고, 없으면 체인을 검증해 저장한다.
+// 검증 강제가 아니면 실패를 돌려줘도 OpenSSL은 결과만 기록하고 핸드셰이크를 계속한다
+static int trust_verify(X509_STORE_CTX* store_ctx, void* arg) {
+    TlsTrust* trust = (TlsTrust*)arg;
+    unsigned char key[SHA256_DIGEST_LENGTH];
+    int cached = trust->cache && trust_cache_key(store_ctx, key) == 0;
+
+    if (cached) {
+        double now = trust_now();
+        pthread_mutex_lock(&trust->lock);
+        TrustCacheEntry* entry = trust_cache_slot(trust, key);
+        if (entry->expires > now && memcmp(entry->key, key, sizeof(key)) == 0) {
+            int error = entry->error;
+            trust->stats.cache_hits++;
+            pthread_mutex_unlock(&trust->lock);
+            X509_STORE_CTX_set_error(store_ctx, error);
+            return error == X509_V_OK;
+        }
+        pthread_mutex_unlock(&trust->lock);
+    }
+
+    double started = trust_now();
+    int result = X509_verify_cert(store_ctx);
+    int error = X509_STORE_CTX_get_error(store_ctx);
+    double finished = trust_now();
+
+    pthread_mutex_lock(&trust->lock);
+    trust->stats.verifications++;
+    trust->stats.verify_seconds += finished - started;
+    if (cached && result >= 0) {
+        TrustCacheEntry* entry = trust_cache_slot(trust, key);
+        memcpy(entry->key, key, sizeof(key));
+        entry->error = error;
+        entry->expires = finished + trust_entry_lifetime(trust, X509_STORE_CTX_get0_cert(store_ctx));
+    }
+    pthread_mutex_unlock(&trust->lock);
+    return result;
+}
+
+// 서버 인증서의 발급자 (받은 체인에서 먼저 찾고, 없으면 신뢰 저장소에서).
+// 자체 발급 인증서는 keyCertSign이 없어도 자기 자신이 발급자다 (OCSP 인증서 ID에는 이름과 공개 키만 쓴다)
+static X509* trust_find_issuer(TlsTrust* trust, X509* leaf, STACK_OF(X509)* chain) {
+    if (X509_NAME_cmp(X509_get_subject_name(leaf), X509_get_issuer_name(leaf)) == 0) {
+        X509_up_ref(leaf);
+        return leaf;
+    }
+    for (int i = 0; chain && i < sk_X509_num(chain); i++) {
+        X509* candidate = sk_X509_value(chain, i);
+        if (X509_check_issued(candidate, leaf) == X509_V_OK) {
+            X509_up_ref(candidate);
+            return candidate;
+        }
+    }
+    X509* issuer = NULL;
+    X509_STORE_CTX* store_ctx = X509_STORE_CTX_new();
+    if (store_ctx && X509_STORE_CTX_init(store_ctx, trust->store, leaf, chain) == 1 &&
+        X509_STORE_CTX_get1_issuer(&issuer, store_ctx, leaf) != 1) {
+        issuer = NULL;
+    }
+    X509_STORE_CTX_free(store_ctx);
+    return issuer;
+}
+
+// 스테이플링된 응답 확인: 응답자 서명(체인 또는 신뢰 저장소), 서버 인증서 상태, thisUpdate/nextUpdate
+static TlsOcspStatus trust_check_ocsp(TlsTrust* trust, SSL* ssl) {
+    const unsigned char* data = NULL;
+    long len = SSL_get_tlsext_status_ocsp_resp(ssl, &data);
+    if (len <= 0 || !data) {
+        return TLS_OCSP_NONE;
+    }
+
+    TlsOcspStatus status = TLS_OCSP_INVALID;
+    OCSP_RESPONSE* response = d2i_OCSP_RESPONSE(NULL, &data, len);
+    OCSP_BASICRESP* basic = NULL;
+    X509* leaf = SSL_get_peer_certificate(ssl);
+    X509* issuer = NULL;
+    OCSP_CERTID* id = NULL;
+    STACK_OF(X509)* chain = SSL_get_peer_cert_chain(ssl);
+
+    if (!response || OCSP_response_status(response) != OCSP_RESPONSE_STATUS_SUCCESSFUL || !leaf) {
+        goto done;
+    }
+    basic = OCSP_response_get1_basic(response);
+    if (!basic || OCSP_basic_verify(basic, chain, trust->store, 0) <= 0) {
+        goto done;
+    }
+    issuer = trust_find_issuer(trust, leaf, chain);
+    id = issuer ? OCSP_cert_to_id(NULL, leaf, issuer) : NULL;
+
+    int cert_status, reason;
+    ASN1_GENERALIZEDTIME *revoked_at, *this_update, *next_update;
+    if (!id || OCSP_resp_find_status(basic, id, &cert_status, &reason, &revoked_at, &this_update, &next_update) != 1 ||
+        OCSP_check_validity(this_update, next_update, TRUST_OCSP_CLOCK_SKEW, -1) != 1) {
+        goto done;
+    }
+    status = cert_status == V_OCSP_CERTSTATUS_GOOD ? TLS_OCSP_GOOD
+           : cert_status == V_OCSP_CERTSTATUS_REVOKED ? TLS_OCSP_REVOKED : TLS_OCSP_UNKNOWN;
+
+done:
+    ERR_clear_error();
+    OCSP_CERTID_free(id);
+    X509_free(issuer);
+    X509_free(leaf);
+    OCSP_BASICRESP_free(basic);
+    OCSP_RESPONSE_free(response);
+    return status;
+}
+
+// SSL_CTX_set_tlsext_status_cb: 검증 강제 모드에서는 폐기되었거나 잘못된 응답이면 핸드셰이크를 실패시킨다
+// (응답이 없는 것은 허용: 스테이플링을 하지 않는 서버가 많다)
+static int trust_status_callback(SSL* ssl, void* arg) {
+    TlsTrust* trust = (TlsTrust*)arg;
+    TlsOcspStatus status = trust_check_ocsp(trust, ssl);
+    SSL_set_ex_data(ssl, g_ocsp_index, (void*)(intptr_t)status);
+    if (trust->config.enforce && (status == TLS_OCSP_REVOKED || status == TLS_OCSP_INVALID)) {
+        return 0;
+    }
+    return 1;
+}
+
+int tls_trust_attach(TlsTrust* trust, SSL_CTX* ctx) {
+    SSL_CTX_set1_cert_store(ctx, trust->store);
+    SSL_CTX_set_cert_verify_callback(ctx, trust_verify, trust);
+    SSL_CTX_set_verify(ctx, trust->config.enforce ? SSL_VERIFY_PEER : SSL_VERIFY_NONE, NULL);
+    if (trust->config.ocsp) {
+        if (SSL_CTX_set_tlsext_status_type(ctx, TLSEXT_STATUSTYPE_ocsp) != 1) {
+            return -1;
+        }
+        SSL_CTX_set_tlsext_status_cb(ctx, trust_status_callback);
+        SSL_CTX_set_tlsext_status_arg(ctx, trust);
+    }
+    return 0;
+}
+
+int tls_trust_set_host(SSL* ssl, const char* hostname) {
+    unsigned char address[16];
+    if (inet_pton(AF_INET, hostname, address) == 1 || inet_pton(AF_INET6, hostname, address) == 1) {
+        return X509_VERIFY_PARAM_set1_ip_asc(SSL_get0_param(ssl), hostname) == 1 ? 0 : -1;
+    }
+    return SSL_set1_host(ssl, hostname) == 1 ? 0 : -1;
+}
+
+TlsOcspStatus tls_trust_ocsp_status(const TlsTrust* trust, SSL* ssl) {
+    if (!trust || !trust->config.ocsp) {
+        return TLS_OCSP_NOT_REQUESTED;
+    }
+    // 콜백이 불리지 않았으면 (TLS 1.3 세션 재개는 인증서를 다시 받지 않는다) 응답도 없다
+    TlsOcspStatus status = (TlsOcspStatus)(intptr_t)SSL_get_ex_data(ssl, g_ocsp_index);
+    return status == TLS_OCSP_NOT_REQUESTED ? TLS_OCSP_NONE : status;
+}
+
+const char* tls_ocsp_status_name(TlsOcspStatus status) {
+    switch (status) {
+        case TLS_OCSP_NOT_REQUESTED: return "요청 안 함";
+        case TLS_OCSP_NONE: return "응답 없음";
+        case TLS_OCSP_GOOD: return "정상 (good)";
+        case TLS_OCSP_REVOKED: return "폐기됨 (revoked)";
+        case TLS_OCSP_UNKNOWN: return "알 수 없음 (unknown)";
+        case TLS_OCSP_INVALID: return "잘못된 응답";
+    }
+    return "?";
+}
+
+void tls_trust_stats(TlsTrust* trust, TlsTrustStats* stats) {
+    pthread_mutex_lock(&trust->lock);
+    *stats = trust->stats;
+    pthread_mutex_unlock(&trust->lock);
+}
@@ -0,0 +1,67 @@
+#ifndef TLS_TRUST_H
+#define TLS_TRUST_H
+
+// 클라이언트 서버 인증서 검증
+// - 신뢰 저장소(CA 번들)는 한 번만 읽어 모든 SSL_CTX와 연결이 공유한다 (연결마다 파일을 다시 파싱하지 않는다).
+// - 검증 결과 캐시: 호스트 이름 + 받은 인증서 체인의 SHA-256을 키로 X509_verify_cert 결과를 보관해
+//   같은 서버에 다시 연결할 때 체인 서명 검증을 건너뛴다 (만료는 캐시 TTL과 인증서 notAfter 중 이른 쪽).
+// - OCSP 스테이플링: 핸드셰이크 중 서버가 보낸 OCSP 응답의 서명, 유효 기간, 인증서 상태를 확인한다.
+// - 여러 스레드가 같은 TlsTrust를 함께 쓸 수 있다 (캐시는 잠금으로 보호).
+
+#include <stdint.h>
+#include <openssl/ssl.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    const char* ca_file;        // PEM CA 번들 (NULL이면 ca_path 또는 시스템 기본 경로)
+    const char* ca_path;        // 해시 이름 CA 디렉터리 (NULL 가능)
+    int enforce;                // 검증 실패(또는 OCSP 폐기)면 핸드셰이크를 실패시킨다 (SSL_VERIFY_PEER)
+    int ocsp;                   // 서버에 OCSP 스테이플링을 요청한다
+    int cache_entries;          // 검증 결과 캐시 크기 (0이면 캐시하지 않음)
+    double cache_ttl;           // 캐시 항목 유지 시간 (초)
+} TlsTrustConfig;
+
+// 스테이플링된 OCSP 응답 확인 결과
+typedef enum {
+    TLS_OCSP_NOT_REQUESTED = 0,
+    TLS_OCSP_NONE,              // 요청했지만 서버가 보내지 않았다
+    TLS_OCSP_GOOD,
+    TLS_OCSP_REVOKED,
+    TLS_OCSP_UNKNOWN,           // 응답자가 인증서를 모른다
+    TLS_OCSP_INVALID            // 서명, 유효 기간, 응답 형식 중 하나가 잘못되었다
+} TlsOcspStatus;
+
+typedef struct {
+    uint64_t verifications;     // 실제로 체인을 검증한 횟수 (캐시 미스)
+    uint64_t cache_hits;
+    double verify_seconds;      // 체인 검증에 쓴 시간 합계
+} TlsTrustStats;
+
+typedef struct TlsTrust TlsTrust;
+
+void tls_trust_default_config(TlsTrustConfig* config);
+
+// 신뢰 저장소를 읽는다. 실패하면 NULL
+TlsTrust* tls_trust_create(const TlsTrustConfig* config);
+void tls_trust_free(TlsTrust* trust);
+
+// SSL_CTX에 공유 저장소, 캐시 검증 콜백, (설정했으면) OCSP 요청과 확인 콜백을 붙인다. 성공 시 0
+int tls_trust_attach(TlsTrust* trust, SSL_CTX* ctx);
+
+// 연결별 호스트 검증 대상 (IP 주소면 IP SAN, 아니면 DNS 이름). 성공 시 0
+int tls_trust_set_host(SSL* ssl, const char* hostname);
+
+// 핸드셰이크 중 확인한 OCSP 상태
+TlsOcspStatus tls_trust_ocsp_status(const TlsTrust* trust, SSL* ssl);
+const char* tls_ocsp_status_name(TlsOcspStatus status);
+
+void tls_trust_stats(TlsTrust* trust, TlsTrustStats* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
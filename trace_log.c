@@ -0,0 +1,428 @@
+#include "trace_log.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#define TRACE_DEFAULT_RING_CAPACITY 4096
+#define TRACE_DEFAULT_FLUSH_INTERVAL_MS 10
+#define TRACE_CACHE_LINE 64
+#define TRACE_BATCH_SIZE (64 * 1024)
+
+// 링에 저장되는 고정 크기 레코드 (128바이트)
+typedef struct {
+    uint64_t timestamp_ns;
+    uint32_t thread_id;
+    uint32_t original_size;
+    uint16_t type;
+    uint16_t size;
+    char payload[TRACE_PAYLOAD_MAX];
+} TraceRecord;
+
+_Static_assert(sizeof(TraceRecord) == 128, "TraceRecord는 128바이트여야 합니다");
+
+// 스레드별 SPSC 링 (생산자: 소유 스레드, 소비자: writer 스레드)
+typedef struct TraceRing {
+    _Alignas(TRACE_CACHE_LINE) _Atomic size_t head; // 생산자만 갱신
+    size_t cached_tail;                             // 생산자가 마지막으로 본 tail
+    _Atomic uint64_t dropped;
+    _Alignas(TRACE_CACHE_LINE) _Atomic size_t tail; // 소비자만 갱신
+    _Alignas(TRACE_CACHE_LINE) size_t mask;
+    uint32_t thread_id;
+    TraceRecord* records;
+    struct TraceRing* next;
+} TraceRing;
+
+static TraceConfig g_config;
+static _Atomic unsigned g_type_mask;
+static _Atomic unsigned g_generation;
+static _Atomic uint32_t g_next_thread_id;
+static _Atomic(TraceRing*) g_rings;
+static _Atomic int g_stop;
+static _Atomic int g_in_flight;             // trace_event 안에서 링에 쓰고 있는 생산자 수
+static _Atomic uint64_t g_flush_requested;
+static _Atomic uint64_t g_flush_completed;
+static pthread_t g_writer;
+static int g_running = 0;
+static uint64_t g_start_ns;
+
+// writer 스레드 전용 출력 배치 버퍼 (한 번의 fwrite로 여러 줄을 내보낸다)
+static char g_batch[TRACE_BATCH_SIZE];
+static size_t g_batch_len;
+
+static _Thread_local TraceRing* tls_ring;
+static _Thread_local unsigned tls_generation;
+
+static const char* const TRACE_TYPE_NAMES[TRACE_TYPE_COUNT] = {
+    "TEXT", "HEADER_IN", "HEADER_OUT", "DATA_IN", "DATA_OUT", "SSL_DATA_IN", "SSL_DATA_OUT"
+};
+
+// 단조 시계 (나노초)
+static uint64_t trace_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static size_t round_up_pow2(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+const char* trace_type_name(TraceType type) {
+    if ((unsigned)type >= TRACE_TYPE_COUNT) {
+        return "UNKNOWN";
+    }
+    return TRACE_TYPE_NAMES[type];
+}
+
+unsigned trace_parse_types(const char* spec) {
+    unsigned mask = 0;
+    char token[32];
+
+    if (!spec) {
+        return TRACE_MASK_ALL;
+    }
+
+    while (*spec) {
+        size_t len = strcspn(spec, ",");
+        if (len > 0 && len < sizeof(token)) {
+            memcpy(token, spec, len);
+            token[len] = '\0';
+
+            if (strcasecmp(token, "all") == 0) {
+                mask |= TRACE_MASK_ALL;
+            } else if (strcasecmp(token, "none") == 0) {
+                mask = 0;
+            } else if (strcasecmp(token, "headers") == 0) {
+                mask |= TRACE_MASK_HEADERS;
+            } else if (strcasecmp(token, "data") == 0) {
+                mask |= TRACE_MASK(TRACE_DATA_IN) | TRACE_MASK(TRACE_DATA_OUT);
+            } else if (strcasecmp(token, "ssl") == 0) {
+                mask |= TRACE_MASK(TRACE_SSL_DATA_IN) | TRACE_MASK(TRACE_SSL_DATA_OUT);
+            } else {
+                for (int i = 0; i < TRACE_TYPE_COUNT; i++) {
+                    if (strcasecmp(token, TRACE_TYPE_NAMES[i]) == 0) {
+                        mask |= TRACE_MASK(i);
+                    }
+                }
+            }
+        }
+        spec += len;
+        if (*spec == ',') {
+            spec++;
+        }
+    }
+
+    return mask;
+}
+
+void trace_default_config(TraceConfig* config) {
+    memset(config, 0, sizeof(*config));
+    config->out = stdout;
+    config->label = "DEBUG";
+    config->type_mask = TRACE_MASK_ALL;
+    config->max_payload = TRACE_PAYLOAD_MAX;
+    config->ring_capacity = TRACE_DEFAULT_RING_CAPACITY;
+    config->flush_interval_ms = TRACE_DEFAULT_FLUSH_INTERVAL_MS;
+
+    const char* types = getenv("TRACE_TYPES");
+    if (types && *types) {
+        config->type_mask = trace_parse_types(types);
+    }
+
+    const char* max_payload = getenv("TRACE_MAX_PAYLOAD");
+    if (max_payload && *max_payload) {
+        config->max_payload = (size_t)strtoul(max_payload, NULL, 10);
+    }
+}
+
+int trace_enabled(TraceType type) {
+    return (atomic_load_explicit(&g_type_mask, memory_order_relaxed) & TRACE_MASK(type)) != 0;
+}
+
+// 현재 스레드의 링을 가져온다 (처음 호출 시 한 번만 할당 후 전역 목록에 등록)
+static TraceRing* trace_current_ring(void) {
+    unsigned generation = atomic_load_explicit(&g_generation, memory_order_acquire);
+    if (tls_ring && tls_generation == generation) {
+        return tls_ring;
+    }
+
+    TraceRing* ring = (TraceRing*)aligned_alloc(TRACE_CACHE_LINE, sizeof(TraceRing));
+    if (!ring) {
+        return NULL;
+    }
+    memset(ring, 0, sizeof(*ring));
+
+    size_t capacity = g_config.ring_capacity;
+    ring->records = (TraceRecord*)aligned_alloc(TRACE_CACHE_LINE, capacity * sizeof(TraceRecord));
+    if (!ring->records) {
+        free(ring);
+        return NULL;
+    }
+    ring->mask = capacity - 1;
+    ring->thread_id = atomic_fetch_add_explicit(&g_next_thread_id, 1, memory_order_relaxed);
+
+    // lock-free push (writer는 next가 설정된 뒤에만 링을 보게 된다)
+    TraceRing* head = atomic_load_explicit(&g_rings, memory_order_relaxed);
+    do {
+        ring->next = head;
+    } while (!atomic_compare_exchange_weak_explicit(&g_rings, &head, ring,
+                                                    memory_order_release, memory_order_relaxed));
+
+    tls_ring = ring;
+    tls_generation = generation;
+    return ring;
+}
+
+// 현재 스레드의 링에 레코드 하나를 넣는다 (trace_event가 g_in_flight를 잡은 상태에서 호출)
+static void trace_push(TraceType type, const char* data, size_t size) {
+    TraceRing* ring = trace_current_ring();
+    if (!ring) {
+        return;
+    }
+
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    if (head - ring->cached_tail > ring->mask) {
+        ring->cached_tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+        if (head - ring->cached_tail > ring->mask) {
+            atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+            return;
+        }
+    }
+
+    TraceRecord* record = &ring->records[head & ring->mask];
+    size_t copy = size < g_config.max_payload ? size : g_config.max_payload;
+
+    record->timestamp_ns = trace_now_ns();
+    record->thread_id = ring->thread_id;
+    record->original_size = size > UINT32_MAX ? UINT32_MAX : (uint32_t)size;
+    record->type = (uint16_t)type;
+    record->size = (uint16_t)copy;
+    if (copy > 0) {
+        memcpy(record->payload, data, copy);
+    }
+
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+void trace_event(TraceType type, const char* data, size_t size) {
+    if (!trace_enabled(type)) {
+        return;
+    }
+
+    // trace_shutdown은 마스크를 끈 뒤 g_in_flight가 0이 될 때까지 기다렸다가 링을 해제한다.
+    // 카운터를 올린 뒤 마스크를 다시 확인하므로, 종료가 시작된 뒤 들어온 생산자는 링에 손대지 않는다
+    atomic_fetch_add(&g_in_flight, 1);
+    if (atomic_load(&g_type_mask) & TRACE_MASK(type)) {
+        trace_push(type, data, size);
+    }
+    atomic_fetch_sub_explicit(&g_in_flight, 1, memory_order_release);
+}
+
+static void trace_flush_batch(void) {
+    if (g_batch_len > 0) {
+        fwrite(g_batch, 1, g_batch_len, g_config.out);
+        g_batch_len = 0;
+    }
+}
+
+// 레코드 하나를 텍스트 한 줄로 변환해 배치 버퍼에 추가
+static void trace_write_record(const TraceRecord* record) {
+    static const char hex[] = "0123456789abcdef";
+    char line[TRACE_PAYLOAD_MAX * 3 + 128];
+    size_t size = record->size;
+    size_t pos;
+    uint64_t elapsed = record->timestamp_ns - g_start_ns;
+
+    pos = (size_t)snprintf(line, sizeof(line), "[%.16s][+%llu.%06llus][T%u][%s] ",
+                           g_config.label,
+                           (unsigned long long)(elapsed / 1000000000ull),
+                           (unsigned long long)(elapsed % 1000000000ull / 1000ull),
+                           record->thread_id, trace_type_name((TraceType)record->type));
+
+    if (record->type == TRACE_SSL_DATA_IN || record->type == TRACE_SSL_DATA_OUT) {
+        // TLS 레코드는 바이너리이므로 16진수로 출력
+        for (size_t i = 0; i < size; i++) {
+            unsigned char c = (unsigned char)record->payload[i];
+            line[pos++] = hex[c >> 4];
+            line[pos++] = hex[c & 0x0f];
+        }
+    } else {
+        // 끝의 개행 제거 (truncate되지 않은 경우에만)
+        if (size == record->original_size) {
+            while (size > 0 && (record->payload[size - 1] == '\n' || record->payload[size - 1] == '\r')) {
+                size--;
+            }
+        }
+        for (size_t i = 0; i < size; i++) {
+            unsigned char c = (unsigned char)record->payload[i];
+            // UTF-8 바이트는 그대로 두고 제어 문자만 치환
+            line[pos++] = (c >= 0x20 && c != 0x7f) || c >= 0x80 ? (char)c : '.';
+        }
+    }
+
+    if (record->original_size > record->size) {
+        pos += (size_t)snprintf(line + pos, sizeof(line) - pos, " ...(+%u bytes)",
+                                record->original_size - record->size);
+    }
+    line[pos++] = '\n';
+
+    if (g_batch_len + pos > sizeof(g_batch)) {
+        trace_flush_batch();
+    }
+    memcpy(g_batch + g_batch_len, line, pos);
+    g_batch_len += pos;
+}
+
+// 모든 링을 비운다. 출력한 레코드 수를 반환
+static size_t trace_drain_rings(void) {
+    size_t written = 0;
+
+    for (TraceRing* ring = atomic_load_explicit(&g_rings, memory_order_acquire); ring; ring = ring->next) {
+        size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        size_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+
+        while (tail != head) {
+            trace_write_record(&ring->records[tail & ring->mask]);
+            tail++;
+            written++;
+        }
+        atomic_store_explicit(&ring->tail, tail, memory_order_release);
+    }
+
+    return written;
+}
+
+static void* trace_writer_main(void* arg) {
+    (void)arg;
+    struct timespec idle = {
+        .tv_sec = g_config.flush_interval_ms / 1000,
+        .tv_nsec = (long)(g_config.flush_interval_ms % 1000) * 1000000L
+    };
+
+    for (;;) {
+        int stopping = atomic_load_explicit(&g_stop, memory_order_acquire);
+        uint64_t flush_seq = atomic_load_explicit(&g_flush_requested, memory_order_acquire);
+
+        size_t written = trace_drain_rings();
+        if (written > 0) {
+            trace_flush_batch();
+            fflush(g_config.out);
+        }
+        atomic_store_explicit(&g_flush_completed, flush_seq, memory_order_release);
+
+        if (stopping) {
+            break;
+        }
+        if (written == 0) {
+            nanosleep(&idle, NULL);
+        }
+    }
+
+    return NULL;
+}
+
+int trace_init(const TraceConfig* config) {
+    if (g_running) {
+        return 0;
+    }
+
+    if (config) {
+        g_config = *config;
+    } else {
+        trace_default_config(&g_config);
+    }
+    if (!g_config.out) {
+        g_config.out = stdout;
+    }
+    if (!g_config.label) {
+        g_config.label = "DEBUG";
+    }
+    if (g_config.max_payload > TRACE_PAYLOAD_MAX) {
+        g_config.max_payload = TRACE_PAYLOAD_MAX;
+    }
+    if (g_config.ring_capacity < 2) {
+        g_config.ring_capacity = TRACE_DEFAULT_RING_CAPACITY;
+    }
+    g_config.ring_capacity = round_up_pow2(g_config.ring_capacity);
+    if (g_config.flush_interval_ms == 0) {
+        g_config.flush_interval_ms = TRACE_DEFAULT_FLUSH_INTERVAL_MS;
+    }
+
+    g_start_ns = trace_now_ns();
+    atomic_store(&g_stop, 0);
+    atomic_fetch_add(&g_generation, 1);
+
+    if (pthread_create(&g_writer, NULL, trace_writer_main, NULL) != 0) {
+        return -1;
+    }
+
+    g_running = 1;
+    atomic_store_explicit(&g_type_mask, g_config.type_mask, memory_order_release);
+    return 0;
+}
+
+void trace_flush(void) {
+    if (!g_running) {
+        return;
+    }
+
+    uint64_t seq = atomic_fetch_add_explicit(&g_flush_requested, 1, memory_order_acq_rel) + 1;
+    struct timespec wait = { .tv_sec = 0, .tv_nsec = 200000L };
+    while (atomic_load_explicit(&g_flush_completed, memory_order_acquire) < seq) {
+        nanosleep(&wait, NULL);
+    }
+}
+
+uint64_t trace_dropped(void) {
+    uint64_t dropped = 0;
+    for (TraceRing* ring = atomic_load_explicit(&g_rings, memory_order_acquire); ring; ring = ring->next) {
+        dropped += atomic_load_explicit(&ring->dropped, memory_order_relaxed);
+    }
+    return dropped;
+}
+
+void trace_shutdown(void) {
+    if (!g_running) {
+        return;
+    }
+
+    // 새 레코드를 막고, 이미 trace_event에 들어온 생산자가 끝나기를 기다린다
+    atomic_store(&g_type_mask, 0);
+    struct timespec wait = { .tv_sec = 0, .tv_nsec = 100000L };
+    while (atomic_load_explicit(&g_in_flight, memory_order_acquire) > 0) {
+        nanosleep(&wait, NULL);
+    }
+
+    atomic_store_explicit(&g_stop, 1, memory_order_release);
+    pthread_join(g_writer, NULL);
+    g_running = 0;
+
+    // writer가 끝난 뒤 남은 레코드를 마저 출력한 다음에 링을 해제한다
+    trace_drain_rings();
+    trace_flush_batch();
+
+    uint64_t dropped = trace_dropped();
+    if (dropped > 0) {
+        fprintf(g_config.out, "[%s] 링 버퍼 포화로 %llu개의 레코드가 버려졌습니다.\n",
+                g_config.label, (unsigned long long)dropped);
+    }
+    fflush(g_config.out);
+
+    // 다음 trace_init에서는 새 링을 쓰도록 세대를 올리고 기존 링을 해제
+    atomic_fetch_add(&g_generation, 1);
+    TraceRing* ring = atomic_exchange(&g_rings, NULL);
+    while (ring) {
+        TraceRing* next = ring->next;
+        free(ring->records);
+        free(ring);
+        ring = next;
+    }
+}
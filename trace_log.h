@@ -0,0 +1,76 @@
+#ifndef TRACE_LOG_H
+#define TRACE_LOG_H
+
+// 저비용 디버그/트레이스 로깅
+// - 각 스레드는 자기 전용 lock-free 링 버퍼에 고정 크기 바이너리 레코드만 기록한다.
+// - 백그라운드 writer 스레드가 링들을 비우면서 텍스트로 변환해 출력한다.
+// - 링이 가득 차면 기다리지 않고 레코드를 버린다 (trace_dropped()로 확인).
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 레코드 종류 (값은 libcurl의 curl_infotype과 동일하게 맞춰 둔다)
+typedef enum {
+    TRACE_TEXT = 0,
+    TRACE_HEADER_IN,
+    TRACE_HEADER_OUT,
+    TRACE_DATA_IN,
+    TRACE_DATA_OUT,
+    TRACE_SSL_DATA_IN,
+    TRACE_SSL_DATA_OUT,
+    TRACE_TYPE_COUNT
+} TraceType;
+
+#define TRACE_MASK(type) (1u << (type))
+#define TRACE_MASK_ALL ((1u << TRACE_TYPE_COUNT) - 1u)
+#define TRACE_MASK_HEADERS (TRACE_MASK(TRACE_TEXT) | TRACE_MASK(TRACE_HEADER_IN) | TRACE_MASK(TRACE_HEADER_OUT))
+
+// 레코드 하나에 담을 수 있는 최대 페이로드 (레코드 전체가 128바이트가 되도록)
+#define TRACE_PAYLOAD_MAX 108
+
+typedef struct {
+    FILE* out;                  // 출력 대상 (기본값: stdout)
+    const char* label;          // 출력 줄 앞에 붙는 태그 (기본값: "DEBUG")
+    unsigned type_mask;         // 기록할 레코드 종류 (TRACE_MASK 조합)
+    size_t max_payload;         // 레코드당 저장할 최대 바이트 수 (<= TRACE_PAYLOAD_MAX)
+    size_t ring_capacity;       // 스레드별 링 크기 (레코드 개수, 2의 거듭제곱으로 올림)
+    unsigned flush_interval_ms; // writer 스레드가 유휴 상태일 때 대기하는 시간
+} TraceConfig;
+
+// 기본 설정을 채운다. TRACE_TYPES / TRACE_MAX_PAYLOAD 환경 변수가 있으면 반영한다.
+void trace_default_config(TraceConfig* config);
+
+// "text,header_in,data" 형식의 문자열을 마스크로 변환 ("all", "headers" 지원)
+unsigned trace_parse_types(const char* spec);
+
+// writer 스레드를 시작한다. 성공 시 0, 실패 시 -1
+int trace_init(const TraceConfig* config);
+
+// 남은 레코드를 모두 출력하고 writer 스레드를 종료한다
+void trace_shutdown(void);
+
+// 해당 종류가 기록 대상인지 확인 (초기화 전에는 항상 0)
+int trace_enabled(TraceType type);
+
+// 레코드 하나를 현재 스레드의 링에 기록한다 (블로킹 없음)
+void trace_event(TraceType type, const char* data, size_t size);
+
+// 지금까지 기록된 레코드가 모두 출력될 때까지 기다린다 (핫패스에서 호출 금지)
+void trace_flush(void);
+
+// 링이 가득 차서 버려진 레코드 수
+uint64_t trace_dropped(void);
+
+// 레코드 종류 이름 ("HEADER_IN" 등)
+const char* trace_type_name(TraceType type);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
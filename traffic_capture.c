@@ -0,0 +1,194 @@
+#include "traffic_capture.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define TRAFFIC_CAPTURE_MAGIC "TLSCAP\r\n"
+#define TRAFFIC_RELEASE_BYTES (64u * 1024 * 1024)  // 이만큼 지나갈 때마다 읽은 페이지를 돌려준다
+
+static const char* const METHOD_NAMES[TRAFFIC_METHOD_COUNT] = {
+    "GET", "GET", "HEAD", "POST", "PUT", "DELETE", "OPTIONS", "PATCH"
+};
+
+static void put16(unsigned char* p, uint16_t value) {
+    p[0] = (unsigned char)value;
+    p[1] = (unsigned char)(value >> 8);
+}
+
+static void put32(unsigned char* p, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        p[i] = (unsigned char)(value >> (8 * i));
+    }
+}
+
+static void put64(unsigned char* p, uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        p[i] = (unsigned char)(value >> (8 * i));
+    }
+}
+
+static uint16_t get16(const unsigned char* p) {
+    return (uint16_t)(p[0] | p[1] << 8);
+}
+
+static uint32_t get32(const unsigned char* p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static uint64_t get64(const unsigned char* p) {
+    return (uint64_t)get32(p) | (uint64_t)get32(p + 4) << 32;
+}
+
+static size_t record_size(size_t path_len) {
+    return TRAFFIC_CAPTURE_RECORD_HEAD + ((path_len + 7) & ~(size_t)7);
+}
+
+void traffic_capture_header(unsigned char* buffer, int64_t started_us) {
+    memset(buffer, 0, TRAFFIC_CAPTURE_HEADER_SIZE);
+    memcpy(buffer, TRAFFIC_CAPTURE_MAGIC, 8);
+    put32(buffer + 8, TRAFFIC_CAPTURE_VERSION);
+    put32(buffer + 12, TRAFFIC_CAPTURE_HEADER_SIZE);
+    put64(buffer + 16, (uint64_t)started_us);
+}
+
+size_t traffic_capture_encode(const TrafficEvent* event, unsigned char* buffer, size_t size) {
+    size_t total = record_size(event->path_len);
+    if (total > size) {
+        return 0;
+    }
+    put32(buffer, event->gap_us);
+    put32(buffer + 4, event->connection);
+    put32(buffer + 8, event->bytes_in);
+    put32(buffer + 12, event->bytes_out);
+    put32(buffer + 16, event->duration_us);
+    put32(buffer + 20, event->handshake_us);
+    put16(buffer + 24, event->status);
+    put16(buffer + 26, event->request_index);
+    buffer[28] = event->method;
+    buffer[29] = event->flags;
+    buffer[30] = event->family;
+    buffer[31] = event->path_len;
+    memcpy(buffer + TRAFFIC_CAPTURE_RECORD_HEAD, event->path, event->path_len);
+    memset(buffer + TRAFFIC_CAPTURE_RECORD_HEAD + event->path_len, 0,
+           total - TRAFFIC_CAPTURE_RECORD_HEAD - event->path_len);
+    return total;
+}
+
+TrafficMethod traffic_method_code(const char* method) {
+    for (int i = 1; i < TRAFFIC_METHOD_COUNT; i++) {
+        if (strcasecmp(method, METHOD_NAMES[i]) == 0) {
+            return (TrafficMethod)i;
+        }
+    }
+    return TRAFFIC_METHOD_OTHER;
+}
+
+// 알 수 없는 메서드는 GET으로 재생한다
+const char* traffic_method_name(TrafficMethod method) {
+    return (unsigned)method < TRAFFIC_METHOD_COUNT ? METHOD_NAMES[method] : METHOD_NAMES[0];
+}
+
+int traffic_capture_open(TrafficCaptureReader* reader, const char* path) {
+    memset(reader, 0, sizeof(*reader));
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        fprintf(stderr, "캡처 파일을 열 수 없습니다: %s (%s)\n", path, strerror(errno));
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < TRAFFIC_CAPTURE_HEADER_SIZE) {
+        fprintf(stderr, "캡처 파일이 아니거나 비어 있습니다: %s\n", path);
+        close(fd);
+        return -1;
+    }
+    void* data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        fprintf(stderr, "캡처 파일을 매핑할 수 없습니다: %s (%s)\n", path, strerror(errno));
+        return -1;
+    }
+    // 앞에서부터 한 번만 훑으므로 미리 읽기를 키운다
+    madvise(data, (size_t)st.st_size, MADV_SEQUENTIAL);
+
+    const unsigned char* header = (const unsigned char*)data;
+    uint32_t header_size = get32(header + 12);
+    if (memcmp(header, TRAFFIC_CAPTURE_MAGIC, 8) != 0 || get32(header + 8) != TRAFFIC_CAPTURE_VERSION ||
+        header_size < TRAFFIC_CAPTURE_HEADER_SIZE || header_size > (size_t)st.st_size) {
+        fprintf(stderr, "지원하지 않는 캡처 형식입니다: %s\n", path);
+        munmap(data, (size_t)st.st_size);
+        return -1;
+    }
+
+    reader->data = header;
+    reader->size = (size_t)st.st_size;
+    reader->offset = header_size;
+    reader->started_us = (int64_t)get64(header + 16);
+    return 0;
+}
+
+int traffic_capture_next(TrafficCaptureReader* reader, TrafficEvent* event) {
+    size_t remaining = reader->size - reader->offset;
+    if (remaining == 0) {
+        return 0;
+    }
+    if (remaining < TRAFFIC_CAPTURE_RECORD_HEAD) {
+        reader->truncated = 1;
+        return 0;
+    }
+
+    const unsigned char* p = reader->data + reader->offset;
+    size_t total = record_size(p[31]);
+    if (total > remaining) {
+        reader->truncated = 1;
+        return 0;
+    }
+    if (p[28] >= TRAFFIC_METHOD_COUNT) {
+        return -1;
+    }
+
+    event->gap_us = get32(p);
+    event->connection = get32(p + 4);
+    event->bytes_in = get32(p + 8);
+    event->bytes_out = get32(p + 12);
+    event->duration_us = get32(p + 16);
+    event->handshake_us = get32(p + 20);
+    event->status = get16(p + 24);
+    event->request_index = get16(p + 26);
+    event->method = p[28];
+    event->flags = p[29];
+    event->family = p[30];
+    event->path_len = p[31];
+    event->path = (const char*)p + TRAFFIC_CAPTURE_RECORD_HEAD;
+    if (reader->records > 0) {
+        reader->time_us += event->gap_us;
+    }
+    event->time_us = reader->time_us;
+    reader->records++;
+    reader->offset += total;
+
+    // 지나간 구간의 페이지를 돌려줘 상주 메모리가 파일 크기만큼 자라지 않게 한다
+    // (호출자는 이전 레코드의 path를 다음 호출 전에 복사해 둔다)
+    if (reader->offset - reader->released >= TRAFFIC_RELEASE_BYTES) {
+        size_t page = (size_t)sysconf(_SC_PAGESIZE);
+        size_t end = (reader->offset - total) & ~(page - 1);
+        if (end > reader->released) {
+            madvise((void*)(reader->data + reader->released), end - reader->released, MADV_DONTNEED);
+            reader->released = end;
+        }
+    }
+    return 1;
+}
+
+void traffic_capture_close(TrafficCaptureReader* reader) {
+    if (reader->data) {
+        munmap((void*)reader->data, reader->size);
+    }
+    memset(reader, 0, sizeof(*reader));
+}
@@ -0,0 +1,94 @@
+#ifndef TRAFFIC_CAPTURE_H
+#define TRAFFIC_CAPTURE_H
+
+// 트래픽 캡처 파일 (TLS 서버가 기록하고 tls_load_test --replay가 재생)
+// - 요청 한 건당 32바이트 고정 머리 + 경로(8바이트 정렬)만 남기는 리틀 엔디언 바이너리 형식.
+//   시각은 앞 레코드와의 간격(마이크로초)으로 저장하므로 요청이 몰린 구간일수록 작다.
+// - 읽기는 파일 전체를 mmap해 앞에서부터 훑고, 지나간 구간은 주기적으로 커널에 돌려주므로
+//   수 GB 캡처도 메모리에 올리지 않고 재생할 수 있다.
+//
+// 파일 머리 (32바이트): "TLSCAP\r\n", 버전(u32), 머리 크기(u32), 파일을 연 벽시계 시각(i64, 마이크로초), 예약(u64)
+// 레코드 머리 (32바이트): 간격(u32), 연결 번호(u32), 요청 크기(u32), 응답 크기(u32), 서버 처리 시간(u32),
+//                         핸드셰이크 시간(u32), 상태 코드(u16), 연결 안의 요청 순번(u16), 메서드(u8), 플래그(u8),
+//                         주소 계열(u8), 경로 길이(u8) 뒤에 경로
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TRAFFIC_CAPTURE_VERSION 1
+#define TRAFFIC_CAPTURE_HEADER_SIZE 32
+#define TRAFFIC_CAPTURE_RECORD_HEAD 32
+#define TRAFFIC_CAPTURE_RECORD_MAX (TRAFFIC_CAPTURE_RECORD_HEAD + 256)
+
+// 레코드 플래그 (접근 로그 플래그와 같은 값)
+#define TRAFFIC_FLAG_RESUMED          0x01
+#define TRAFFIC_FLAG_HANDSHAKE_FAILED 0x02  // 요청 없이 실패한 핸드셰이크 (재생은 건너뛴다)
+#define TRAFFIC_FLAG_EARLY_DATA       0x04
+
+typedef enum {
+    TRAFFIC_METHOD_OTHER = 0,
+    TRAFFIC_METHOD_GET,
+    TRAFFIC_METHOD_HEAD,
+    TRAFFIC_METHOD_POST,
+    TRAFFIC_METHOD_PUT,
+    TRAFFIC_METHOD_DELETE,
+    TRAFFIC_METHOD_OPTIONS,
+    TRAFFIC_METHOD_PATCH,
+    TRAFFIC_METHOD_COUNT
+} TrafficMethod;
+
+// 레코드 하나 (읽을 때 path는 파일 매핑 안을 가리키며 NUL로 끝나지 않는다)
+typedef struct {
+    uint64_t time_us;           // 읽을 때: 첫 레코드 기준 누적 시각 (첫 레코드의 간격은 세지 않는다)
+    uint32_t gap_us;            // 앞 레코드와의 간격
+    uint32_t connection;        // 서버 연결 번호 (워커 번호 << 24 | 워커 안의 순번)
+    uint32_t bytes_in;          // 요청 헤더 크기
+    uint32_t bytes_out;         // 응답 전체 크기 (헤더 포함)
+    uint32_t duration_us;
+    uint32_t handshake_us;      // 연결의 첫 요청에만
+    uint16_t status;
+    uint16_t request_index;     // 연결 안에서 몇 번째 요청인지 (0이면 새 연결)
+    uint8_t method;             // TrafficMethod
+    uint8_t flags;
+    uint8_t family;             // AF_INET / AF_INET6
+    uint8_t path_len;
+    const char* path;
+} TrafficEvent;
+
+// 파일 머리를 buffer에 쓴다 (TRAFFIC_CAPTURE_HEADER_SIZE 바이트)
+void traffic_capture_header(unsigned char* buffer, int64_t started_us);
+
+// 레코드를 buffer에 쓰고 쓴 바이트 수를 돌려준다 (size가 모자라면 0). gap_us는 호출자가 채운다
+size_t traffic_capture_encode(const TrafficEvent* event, unsigned char* buffer, size_t size);
+
+TrafficMethod traffic_method_code(const char* method);
+const char* traffic_method_name(TrafficMethod method);
+
+typedef struct {
+    const unsigned char* data;
+    size_t size;
+    size_t offset;
+    size_t released;            // 여기까지는 커널에 돌려주었다
+    int64_t started_us;
+    uint64_t time_us;
+    uint64_t records;
+    int truncated;              // 마지막 레코드가 잘려 있었다 (기록 중인 파일)
+} TrafficCaptureReader;
+
+// 캡처 파일을 매핑한다. 실패하면 이유를 출력하고 -1
+int traffic_capture_open(TrafficCaptureReader* reader, const char* path);
+
+// 다음 레코드. 있으면 1, 끝이면 0, 형식이 깨졌으면 -1
+int traffic_capture_next(TrafficCaptureReader* reader, TrafficEvent* event);
+
+void traffic_capture_close(TrafficCaptureReader* reader);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif